@@ -26,8 +26,12 @@
 #include "ac/spritecache.h"
 #include "core/assetmanager.h"
 #include "gfx/bitmap.h"
+#include "util/bbop.h"
 #include "util/compress.h"
 #include "util/file.h"
+#include "util/filemapping.h"
+#include "util/filestream.h"
+#include "util/lz4.h"
 #include "util/stream.h"
 
 using AGS::Common::Bitmap;
@@ -56,15 +60,23 @@ extern int spritewidth[], spriteheight[];
 
 const char *spindexid = "SPRINDEX";
 const char *spindexfilename = "sprindex.dat";
+// First sprite file version which stores compression type of each sprite
+const int SPRFILE_VERSION_COMPRESSIONTYPE = 7;
 
 
 SpriteCache::SpriteCache(int32_t maxElements)
 {
   elements = maxElements;
   cache_stream = NULL;
+  cache_mapping = new Common::FileMapping();
+  cacheMappedData = NULL;
+  cacheMappedSize = 0;
+  cacheMappingOffset = 0;
+  prefetch = NULL;
   offsets = NULL;
   sprite0InitialOffset = 0;
-  spritesAreCompressed = false;
+  spriteCompression = kSprCompress_None;
+  spriteFileVersion = 0;
   init();
 }
 
@@ -89,6 +101,8 @@ void SpriteCache::changeMaxSize(int32_t maxElements) {
 
 void SpriteCache::init()
 {
+  stopPrefetch();
+  unmapCacheFile();
   delete cache_stream;
   cache_stream = NULL;
   changeMaxSize(elements);
@@ -369,80 +383,263 @@ void SpriteCache::seekToSprite(int index) {
       cache_stream->Seek(Common::kSeekBegin, offsets[index]);
 }
 
-int SpriteCache::loadSprite(int index)
+void SpriteCache::mapCacheFile(int32_t fileOffset, size_t size) {
+  unmapCacheFile();
+#if !defined (AGS_BIG_ENDIAN)
+  // sprite headers and uncompressed pixels are stored in little-endian
+  // order, and are copied as is
+  cacheMappedData = cache_stream->GetDataAt(fileOffset);
+  if (cacheMappedData)
+    cacheMappedSize = size;
+  else if (cache_mapping->Map(((Common::FileStream*)cache_stream)->GetHandle(), fileOffset, size)) {
+    cacheMappedData = cache_mapping->GetData();
+    cacheMappedSize = cache_mapping->GetSize();
+  }
+  cacheMappingOffset = fileOffset;
+#endif
+}
+
+void SpriteCache::unmapCacheFile() {
+  cache_mapping->Unmap();
+  cacheMappedData = NULL;
+  cacheMappedSize = 0;
+}
+
+const uint8_t *SpriteCache::getMappedSpriteData(int32_t offset, int &coldep, int &wdd, int &htt,
+                                                SpriteCompression &compression, size_t &dataSize)
 {
-  int hh = 0;
+  if (!cacheMappedData || (offset < cacheMappingOffset))
+    return NULL;
 
-  while (cachesize > maxCacheSize) {
-    removeOldest();
-    hh++;
-    if (hh > 1000) {
-      write_log("!!!! RUNTIME CACHE ERROR: STUCK IN FREE_UP_MEM; RESETTING CACHE");
-      removeAll();
-    }
+  size_t pos = offset - cacheMappingOffset;
+  size_t mappedSize = cacheMappedSize;
+  const uint8_t *data = cacheMappedData;
+  int16_t header[3];
+  if (pos + sizeof(int16_t) > mappedSize)
+    return NULL;
+  memcpy(&header[0], data + pos, sizeof(int16_t));
+  coldep = header[0];
+  if (coldep == 0)
+    return data + pos;
+
+  if (pos + sizeof(header) > mappedSize)
+    return NULL;
+  memcpy(&header[0], data + pos, sizeof(header));
+  wdd = header[1];
+  htt = header[2];
+  pos += sizeof(header);
+  if ((wdd < 0) || (htt < 0))
+    return NULL;
 
+  compression = this->spriteCompression;
+  if (this->spriteFileVersion >= SPRFILE_VERSION_COMPRESSIONTYPE) {
+    if (pos + 1 > mappedSize)
+      return NULL;
+    compression = (SpriteCompression)data[pos++];
+  }
+  if ((compression != kSprCompress_None) || (this->spriteFileVersion >= SPRFILE_VERSION_COMPRESSIONTYPE)) {
+    int32_t packedSize;
+    if (pos + sizeof(packedSize) > mappedSize)
+      return NULL;
+    memcpy(&packedSize, data + pos, sizeof(packedSize));
+    pos += sizeof(packedSize);
+    if (packedSize < 0)
+      return NULL;
+    dataSize = packedSize;
+  }
+  else {
+    dataSize = (size_t)wdd * htt * coldep;
   }
+  if (pos + dataSize > mappedSize)
+    return NULL;
+  return data + pos;
+}
 
-  if ((index < 0) || (index >= elements))
-    quit("sprite cache array index out of bounds");
+void SpriteCache::readSpriteHeader(Stream *in, int coldep, int &wdd, int &htt, SpriteCompression &compression, int32_t &dataSize)
+{
+  wdd = in->ReadInt16();
+  htt = in->ReadInt16();
+  compression = this->spriteCompression;
+  if (this->spriteFileVersion >= SPRFILE_VERSION_COMPRESSIONTYPE) {
+    compression = (SpriteCompression)in->ReadInt8();
+    dataSize = in->ReadInt32();
+  }
+  else if (compression != kSprCompress_None) {
+    dataSize = in->ReadInt32();
+  }
+  else {
+    dataSize = wdd * htt * coldep;
+  }
+}
 
-  // If we didn't just load the previous sprite, seek to it
-  seekToSprite(index);
+// Decompresses the whole sprite in one call, straight into the bitmap
+// if its lines follow each other in memory
+static void unpack_sprite_lz4(Bitmap *image, const uint8_t *data, size_t dataSize)
+{
+  const int lineSize = image->GetLineLength();
+  const int height = image->GetHeight();
+  const size_t imageSize = (size_t)lineSize * height;
+  if (imageSize == 0)
+    return;
 
-  int coldep = cache_stream->ReadInt16();
+  uint8_t *pixels = image->GetDataForWriting();
+  if (image->GetScanLineForWriting(height - 1) == pixels + (height - 1) * lineSize) {
+    lz4_decompress(data, dataSize, pixels, imageSize);
+  }
+  else {
+    uint8_t *buffer = (uint8_t*)malloc(imageSize);
+    if (buffer == NULL)
+      return;
+    lz4_decompress(data, dataSize, buffer, imageSize);
+    for (int hh = 0; hh < height; hh++)
+      memcpy(&image->GetScanLineForWriting(hh)[0], buffer + hh * lineSize, lineSize);
+    free(buffer);
+  }
 
-  if (coldep == 0) {
-    lastLoad = index;
-    return 0;
+#if defined (AGS_BIG_ENDIAN)
+  // pixels are stored in little-endian order
+  const int width = image->GetWidth();
+  for (int hh = 0; hh < height; hh++) {
+    uint8_t *line = &image->GetScanLineForWriting(hh)[0];
+    if (image->GetBPP() == 2) {
+      for (int ww = 0; ww < width; ww++)
+        AGS::Common::BitByteOperations::SwapBytesInt16(((int16_t*)line)[ww]);
+    }
+    else if (image->GetBPP() == 4) {
+      for (int ww = 0; ww < width; ww++)
+        AGS::Common::BitByteOperations::SwapBytesInt32(((int32_t*)line)[ww]);
+    }
   }
+#endif
+}
 
-  int wdd = cache_stream->ReadInt16();
-  int htt = cache_stream->ReadInt16();
-  // update the stored width/height
-  spritewidth[index] = wdd;
-  spriteheight[index] = htt;
+Bitmap *SpriteCache::decodeSprite(int32_t offset, Stream *in, bool seek, int &coldep, bool &readStream)
+{
+  int wdd, htt, hh;
+  SpriteCompression compression = kSprCompress_None;
+  size_t dataSize = 0;
+  const uint8_t *data = getMappedSpriteData(offset, coldep, wdd, htt, compression, dataSize);
+  uint8_t *buffer = NULL;
+  readStream = (data == NULL);
+  if (data == NULL) {
+    if (seek)
+      in->Seek(Common::kSeekBegin, offset);
+
+    coldep = in->ReadInt16();
+    if (coldep == 0)
+      return NULL;
+
+    int32_t packedSize;
+    readSpriteHeader(in, coldep, wdd, htt, compression, packedSize);
+    if (compression != kSprCompress_None) {
+      // read all the packed data at once
+      if (packedSize > 0) {
+        buffer = (uint8_t*)malloc(packedSize);
+        dataSize = buffer ? in->Read(buffer, packedSize) : 0;
+      }
+      data = buffer;
+    }
+  }
+  else if (coldep == 0) {
+    return NULL;
+  }
 
-  images[index] = BitmapHelper::CreateBitmap(wdd, htt, coldep * 8);
-  if (images[index] == NULL) {
-    offsets[index] = 0;
-    return 0;
+  Bitmap *image = BitmapHelper::CreateBitmap(wdd, htt, coldep * 8);
+  if (image == NULL) {
+    free(buffer);
+    return NULL;
   }
 
-  if (this->spritesAreCompressed) 
+  if (compression == kSprCompress_LZ4)
   {
-    cache_stream->ReadInt32(); // skip data size
+    unpack_sprite_lz4(image, data, dataSize);
+  }
+  else if (compression == kSprCompress_RLE)
+  {
+    const uint8_t *dataEnd = data + dataSize;
     if (coldep == 1) {
       for (hh = 0; hh < htt; hh++)
-        cunpackbitl(&images[index]->GetScanLineForWriting(hh)[0], wdd, cache_stream);
+        cunpackbitl(&image->GetScanLineForWriting(hh)[0], wdd, data, dataEnd);
     }
     else if (coldep == 2) {
       for (hh = 0; hh < htt; hh++)
-        cunpackbitl16((unsigned short*)&images[index]->GetScanLine(hh)[0], wdd, cache_stream);
+        cunpackbitl16((unsigned short*)&image->GetScanLineForWriting(hh)[0], wdd, data, dataEnd);
     }
     else {
       for (hh = 0; hh < htt; hh++)
-        cunpackbitl32((unsigned int*)&images[index]->GetScanLine(hh)[0], wdd, cache_stream);
+        cunpackbitl32((unsigned int*)&image->GetScanLineForWriting(hh)[0], wdd, data, dataEnd);
     }
   }
+  else if (data != NULL)
+  {
+    // copy the scanlines right from the file mapping
+    const int lineSize = wdd * coldep;
+    for (hh = 0; hh < htt; hh++)
+      memcpy(&image->GetScanLineForWriting(hh)[0], data + hh * lineSize, lineSize);
+  }
   else {
     if (coldep == 1)
     {
       for (hh = 0; hh < htt; hh++)
-        cache_stream->ReadArray(&images[index]->GetScanLineForWriting(hh)[0], coldep, wdd);
+        in->ReadArray(&image->GetScanLineForWriting(hh)[0], coldep, wdd);
     }
     else if (coldep == 2)
     {
       for (hh = 0; hh < htt; hh++)
-        cache_stream->ReadArrayOfInt16((int16_t*)&images[index]->GetScanLineForWriting(hh)[0], wdd);
+        in->ReadArrayOfInt16((int16_t*)&image->GetScanLineForWriting(hh)[0], wdd);
     }
     else
     {
       for (hh = 0; hh < htt; hh++)
-        cache_stream->ReadArrayOfInt32((int32_t*)&images[index]->GetScanLineForWriting(hh)[0], wdd);
+        in->ReadArrayOfInt32((int32_t*)&image->GetScanLineForWriting(hh)[0], wdd);
     }
   }
+  free(buffer);
+  return image;
+}
 
-  lastLoad = index;
+int SpriteCache::loadSprite(int index)
+{
+  int hh = 0;
+
+  while (cachesize > maxCacheSize) {
+    removeOldest();
+    hh++;
+    if (hh > 1000) {
+      write_log("!!!! RUNTIME CACHE ERROR: STUCK IN FREE_UP_MEM; RESETTING CACHE");
+      removeAll();
+    }
+
+  }
+
+  if ((index < 0) || (index >= elements))
+    quit("sprite cache array index out of bounds");
+
+  int coldep = 0;
+  // the sprite may have been decoded in advance by the prefetch thread
+  images[index] = takePrefetchedSprite(index);
+  if (images[index] != NULL) {
+    coldep = images[index]->GetColorDepth() / 8;
+  }
+  else {
+    // If we didn't just load the previous sprite, seek to it
+    bool readStream;
+    images[index] = decodeSprite(offsets[index], cache_stream, index - 1 != lastLoad, coldep, readStream);
+    // the stream position is not changed when the sprite is copied from the mapping
+    if (readStream)
+      lastLoad = index;
+
+    if (coldep == 0)
+      return 0;
+    if (images[index] == NULL) {
+      offsets[index] = 0;
+      return 0;
+    }
+  }
+
+  // update the stored width/height
+  spritewidth[index] = images[index]->GetWidth();
+  spriteheight[index] = images[index]->GetHeight();
 
   // Stop it adding the sprite to the used list just because it's loaded
   int32_t offs = offsets[index];
@@ -488,13 +685,39 @@ void SpriteCache::compressSprite(Bitmap *sprite, Stream *out) {
 
 }
 
-int SpriteCache::saveToFile(const char *filnam, int lastElement, bool compressOutput)
+void SpriteCache::compressSpriteLZ4(Bitmap *sprite, Stream *out) {
+
+  const int lineSize = sprite->GetLineLength();
+  const size_t imageSize = (size_t)lineSize * sprite->GetHeight();
+  unsigned char *pixels = (unsigned char*)malloc(imageSize);
+  unsigned char *packed = (unsigned char*)malloc(imageSize);
+  for (int yy = 0; yy < sprite->GetHeight(); yy++)
+    memcpy(pixels + yy * lineSize, sprite->GetScanLine(yy), lineSize);
+
+  // the packed data is not allowed to be bigger than the pixels
+  size_t packedSize = lz4_compress(pixels, imageSize, packed, imageSize);
+  if (packedSize > 0) {
+    out->WriteInt8(kSprCompress_LZ4);
+    out->WriteInt32(packedSize);
+    out->Write(packed, packedSize);
+  }
+  else {
+    out->WriteInt8(kSprCompress_None);
+    out->WriteInt32(imageSize);
+    out->Write(pixels, imageSize);
+  }
+
+  free(pixels);
+  free(packed);
+}
+
+int SpriteCache::saveToFile(const char *filnam, int lastElement, SpriteCompression compressOutput)
 {
   Stream *output = Common::File::CreateFile(filnam);
   if (output == NULL)
     return -1;
 
-  if (compressOutput) {
+  if (compressOutput == kSprCompress_RLE) {
     // re-open the file so that it can be seeked
     delete output;
     output = File::OpenFile(filnam, Common::kFile_Open, Common::kFile_ReadWrite); // CHECKME why mode was "r+" here?
@@ -504,12 +727,13 @@ int SpriteCache::saveToFile(const char *filnam, int lastElement, bool compressOu
 
   int spriteFileIDCheck = (int)time(NULL);
 
-  // version 6
-  output->WriteInt16(6);
+  // version 6, unless the new compression requires version 7
+  const int fileVersion = (compressOutput == kSprCompress_LZ4) ? SPRFILE_VERSION_COMPRESSIONTYPE : 6;
+  output->WriteInt16(fileVersion);
 
   output->WriteArray(spriteFileSig, strlen(spriteFileSig), 1);
 
-  output->WriteInt8(compressOutput ? 1 : 0);
+  output->WriteInt8(compressOutput);
   output->WriteInt32(spriteFileIDCheck);
 
   int i, lastslot = 0;
@@ -538,7 +762,7 @@ int SpriteCache::saveToFile(const char *filnam, int lastElement, bool compressOu
     spriteoffs[i] = output->GetPosition();
 
     // if compressing uncompressed sprites, load the sprite into memory
-    if ((images[i] == NULL) && (this->spritesAreCompressed != compressOutput))
+    if ((images[i] == NULL) && (this->spriteCompression != compressOutput))
       (*this)[i];
 
     if (images[i] != NULL) {
@@ -551,7 +775,10 @@ int SpriteCache::saveToFile(const char *filnam, int lastElement, bool compressOu
       output->WriteInt16(spritewidths[i]);
       output->WriteInt16(spriteheights[i]);
 
-      if (compressOutput) {
+      if (compressOutput == kSprCompress_LZ4) {
+        compressSpriteLZ4(images[i], output);
+      }
+      else if (compressOutput == kSprCompress_RLE) {
         size_t lenloc = output->GetPosition();
         // write some space for the length data
         output->WriteInt32(0);
@@ -590,7 +817,7 @@ int SpriteCache::saveToFile(const char *filnam, int lastElement, bool compressOu
       continue;
     }
 
-    if (this->spritesAreCompressed != compressOutput) {
+    if (this->spriteCompression != compressOutput) {
       // shouldn't be able to get here
       free(memBuffer);
       delete output;
@@ -598,8 +825,10 @@ int SpriteCache::saveToFile(const char *filnam, int lastElement, bool compressOu
     }
 
     // and copy the data across
-    int width = cache_stream->ReadInt16();
-    int height = cache_stream->ReadInt16();
+    int width, height;
+    SpriteCompression compression;
+    int32_t sizeToCopy;
+    readSpriteHeader(cache_stream, colDepth, width, height, compression, sizeToCopy);
 
     spritewidths[i] = width;
     spriteheights[i] = height;
@@ -607,13 +836,12 @@ int SpriteCache::saveToFile(const char *filnam, int lastElement, bool compressOu
     output->WriteInt16(width);
     output->WriteInt16(height);
 
-    int sizeToCopy;
-    if (this->spritesAreCompressed) {
-      sizeToCopy = cache_stream->ReadInt32();
+    if (fileVersion >= SPRFILE_VERSION_COMPRESSIONTYPE) {
+      output->WriteInt8(compression);
       output->WriteInt32(sizeToCopy);
     }
-    else {
-      sizeToCopy = width * height * (int)colDepth;
+    else if (compressOutput != kSprCompress_None) {
+      output->WriteInt32(sizeToCopy);
     }
 
     while (sizeToCopy > memBufferSize) {
@@ -671,13 +899,14 @@ int SpriteCache::initFile(const char *filnam)
   if (cache_stream == NULL)
     return -1;
 
+  size_t spr_file_size = Common::AssetManager::GetLastAssetSize();
   spr_initial_offs = cache_stream->GetPosition();
 
   vers = cache_stream->ReadInt16();
   // read the "Sprite File" signature
   cache_stream->ReadArray(&buff[0], 13, 1);
 
-  if ((vers < 4) || (vers > 6)) {
+  if ((vers < 4) || (vers > SPRFILE_VERSION_COMPRESSIONTYPE)) {
     delete cache_stream;
     cache_stream = NULL;
     return -1;
@@ -691,16 +920,21 @@ int SpriteCache::initFile(const char *filnam)
     return -1;
   }
 
+  this->spriteFileVersion = vers;
   if (vers == 4)
-    this->spritesAreCompressed = false;
+    this->spriteCompression = kSprCompress_None;
   else if (vers == 5)
-    this->spritesAreCompressed = true;
+    this->spriteCompression = kSprCompress_RLE;
   else if (vers >= 6)
   {
-    this->spritesAreCompressed = (cache_stream->ReadInt8() == 1);
+    this->spriteCompression = (SpriteCompression)cache_stream->ReadInt8();
+    if ((vers == 6) && (this->spriteCompression != kSprCompress_RLE))
+      this->spriteCompression = kSprCompress_None;
     spriteFileID = cache_stream->ReadInt32();
   }
 
+  mapCacheFile(spr_initial_offs, spr_file_size);
+
   if (vers < 5) {
     // skip the palette
       cache_stream->Seek(Common::kSeekCurrent, 256 * 3);
@@ -752,26 +986,14 @@ int SpriteCache::initFile(const char *filnam)
 
     images[vv] = NULL;
 
-    wdd = cache_stream->ReadInt16();
-    htt = cache_stream->ReadInt16();
+    SpriteCompression compression;
+    int32_t spriteDataSize;
+    readSpriteHeader(cache_stream, coldep, wdd, htt, compression, spriteDataSize);
 
     spritewidth[vv] = wdd;
     spriteheight[vv] = htt;
     get_new_size_for_sprite(vv, wdd, htt, spritewidth[vv], spriteheight[vv]);
 
-    int32_t spriteDataSize;
-    if (vers == 5) {
-      spriteDataSize = cache_stream->ReadInt32();
-    }
-    else if (vers >= 6)
-    {
-      spriteDataSize = this->spritesAreCompressed ? cache_stream->ReadInt32() :
-        wdd * coldep * htt;
-    }
-    else {
-      spriteDataSize = wdd * coldep * htt;
-    }
-
     cache_stream->Seek(Common::kSeekCurrent, spriteDataSize);
   }
 
@@ -852,6 +1074,7 @@ bool SpriteCache::loadSpriteIndexFile(int expectedFileID, int32_t spr_initial_of
 }
 
 void SpriteCache::detachFile() {
+  unmapCacheFile();
   delete cache_stream;
   cache_stream = NULL;
   lastLoad = -2;
@@ -861,6 +1084,7 @@ int SpriteCache::attachFile(const char *filename) {
   cache_stream = Common::AssetManager::OpenAsset((char *)filename);
   if (cache_stream == NULL)
     return -1;
+  mapCacheFile(cache_stream->GetPosition(), Common::AssetManager::GetLastAssetSize());
   return 0;
 }
 
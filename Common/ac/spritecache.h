@@ -21,7 +21,7 @@
 
 #include "core/types.h"
 
-namespace AGS { namespace Common { class Stream; class Bitmap; } }
+namespace AGS { namespace Common { class Stream; class Bitmap; class FileMapping; } }
 using namespace AGS; // FIXME later
 
 // We can't rely on offsets[slot]==0 because when the engine is running
@@ -29,6 +29,18 @@ using namespace AGS; // FIXME later
 // a definite way of knowing whether the sprite existed in the sprite file.
 #define SPRCACHEFLAG_DOESNOTEXIST 1
 
+// Sprite data compression; files saved with LZ4 are only read by the
+// engines which know about it, others stay compatible with older ones
+enum SpriteCompression
+{
+  kSprCompress_None,
+  kSprCompress_RLE,
+  kSprCompress_LZ4
+};
+
+// Sprites decoded in background, only implemented by the engine
+struct SpritePrefetchQueue;
+
 class SpriteCache
 {
 public:
@@ -48,10 +60,18 @@ public:
   int  enlargeTo(int32_t);
   void removeAll();             // removes all items from the cache
   int  findFreeSlot();
-  int  saveToFile(const char *, int lastElement, bool compressOutput);
+  int  saveToFile(const char *, int lastElement, SpriteCompression compressOutput);
   int  doesSpriteExist(int index);
   void detachFile();
   int  attachFile(const char *);
+  // Decodes given sprites in background, so that they are ready by the time
+  // they are first drawn; replaces the previous prefetch list
+  void prefetchSprites(const int *indexes, int count);
+  // Stops background decoding and frees sprites which were not used
+  void stopPrefetch();
+  // Reads the sprite at given file offset into a new bitmap; does not change
+  // the cache state, so may be called by another thread with its own stream
+  Common::Bitmap *decodeSprite(int32_t offset, Common::Stream *in, bool seek, int &coldep, bool &readStream);
 
   Common::Bitmap *operator[] (int index);
 
@@ -62,16 +82,37 @@ public:
   int *sizes;
   unsigned char *flags;
   Common::Stream *cache_stream;
-  bool spritesAreCompressed;
+  // Sprite data is read right from the file mapped into memory, either
+  // by the cache itself or by the stream it was opened with
+  Common::FileMapping *cache_mapping;
+  const uint8_t *cacheMappedData;
+  size_t cacheMappedSize;
+  int32_t cacheMappingOffset;      // file position of the first mapped byte
+  SpriteCompression spriteCompression; // compression the file was saved with
+  int spriteFileVersion;
   int32_t cachesize;               // size in bytes of currently cached images
   int *mrulist, *mrubacklink;
   int liststart, listend;
   int lastLoad;
   int32_t maxCacheSize;
   int32_t lockedSize;              // size in bytes of currently locked images
+  SpritePrefetchQueue *prefetch;
 
 private:
     void compressSprite(Common::Bitmap *sprite, Common::Stream *out);
+  // Writes the sprite in one LZ4 block, or uncompressed if it does not shrink
+  void compressSpriteLZ4(Common::Bitmap *sprite, Common::Stream *out);
+  // Reads the rest of the sprite header after its colour depth
+  void readSpriteHeader(Common::Stream *in, int coldep, int &wdd, int &htt, SpriteCompression &compression, int32_t &dataSize);
+  void mapCacheFile(int32_t fileOffset, size_t size);
+  void unmapCacheFile();
+  // Returns pointer to the mapped pixel data of the sprite, packed or not,
+  // or NULL if the sprite has to be read from the stream
+  const uint8_t *getMappedSpriteData(int32_t offset, int &coldep, int &wdd, int &htt, SpriteCompression &compression, size_t &dataSize);
+  // Gives away the sprite decoded by the prefetch thread, or NULL
+  Common::Bitmap *takePrefetchedSprite(int index);
+  void runPrefetch();
+  static void prefetchThreadEntry();
   bool loadSpriteIndexFile(int expectedFileID, int32_t spr_initial_offs, short numspri);
 
   void initFile_adjustBuffers(short numspri);
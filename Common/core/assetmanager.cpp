@@ -12,11 +12,13 @@
 //
 //=============================================================================
 
+#include <ctype.h>
 #include <string.h>
 #include <stdlib.h>
 #include "core/assetmanager.h"
 #include "debug/assert.h"
-#include "util/stream.h"
+#include "util/filestream.h"
+#include "util/memorymappedstream.h"
 #include "util/bbop.h"
 
 #if defined (WINDOWS_VERSION)
@@ -38,6 +40,8 @@ namespace Common
 
 #define MAX_FILES 10000
 #define MAXMULTIFILES 25
+// Number of asset lookup slots; a power of two, larger than MAX_FILES
+#define ASSET_LOOKUP_SIZE 16384
 
 // Information on single asset
 struct AssetInfo
@@ -47,6 +51,8 @@ struct AssetInfo
     int32_t     LibUid;     // uid of library, containing this asset
     int         Offset;     // asset's position in library file (in bytes)
     int         Size;       // asset's size (in bytes)
+    uint32_t    NameHash;   // hash of the lowercased filename
+    int         NextInLookup; // next asset in the same lookup slot, or -1
 
     AssetInfo();
 };
@@ -58,14 +64,25 @@ struct AssetLibInfo
     String      BasePath;                    // library's parent path (directory)
     int         PartCount;                   // number of parts this library is split to
     String      LibFileNames[MAXMULTIFILES]; // filename for each library part
+    // whole library part mapped into memory, shared by the opened assets;
+    // made on first use, NULL if not made yet or when mapping has failed
+    SharedFileMapping *LibMappings[MAXMULTIFILES];
+    bool        LibMappingFailed[MAXMULTIFILES];
 
     // Library contents
     int         AssetCount; // total number of assets in library
     AssetInfo   AssetInfos[MAX_FILES]; // information on contained assets
+    // first asset for every slot of the filename hash, or -1; the assets
+    // in a slot are chained in the order they are stored in library
+    int         AssetLookup[ASSET_LOOKUP_SIZE];
 
     AssetLibInfo();
+    ~AssetLibInfo();
     void AssignFromMFL(const MultiFileLib &mflib);
     void Unload();
+    void BuildLookup();
+    void ReleaseMappings();
+    AssetInfo *FindAsset(const String &asset_name);
 };
 
 struct MultiFileLib
@@ -86,17 +103,40 @@ AssetInfo::AssetInfo()
     : LibUid(0)
     , Offset(0)
     , Size(0)
+    , NameHash(0)
+    , NextInLookup(-1)
 {
 }
 
+// Case-insensitive hash of asset filename, as names are compared
+// ignoring case
+uint32_t HashAssetName(const char *name)
+{
+    uint32_t hash = 2166136261u;
+    for (const unsigned char *c = (const unsigned char*)name; *c; ++c)
+    {
+        hash = (hash ^ tolower(*c)) * 16777619u;
+    }
+    return hash;
+}
+
 AssetLibInfo::AssetLibInfo()
     : AssetCount(0)
     , PartCount(0)
 {
+    memset(AssetLookup, -1, sizeof(AssetLookup));
+    memset(LibMappings, 0, sizeof(LibMappings));
+    memset(LibMappingFailed, 0, sizeof(LibMappingFailed));
+}
+
+AssetLibInfo::~AssetLibInfo()
+{
+    ReleaseMappings();
 }
 
 void AssetLibInfo::AssignFromMFL(const MultiFileLib &mflib)
 {
+    ReleaseMappings();
     PartCount = mflib.num_data_files;
     for (int i = 0; i < PartCount; ++i)
     {
@@ -110,6 +150,7 @@ void AssetLibInfo::AssignFromMFL(const MultiFileLib &mflib)
         AssetInfos[i].Offset = mflib.offset[i];
         AssetInfos[i].Size = mflib.length[i];
     }
+    BuildLookup();
 }
 
 void AssetLibInfo::Unload()
@@ -118,6 +159,51 @@ void AssetLibInfo::Unload()
     BasePath        = "";
     PartCount       = 0;
     AssetCount      = 0;
+    memset(AssetLookup, -1, sizeof(AssetLookup));
+    ReleaseMappings();
+}
+
+void AssetLibInfo::ReleaseMappings()
+{
+    // assets which are still open keep their own references
+    for (int i = 0; i < MAXMULTIFILES; ++i)
+    {
+        if (LibMappings[i])
+        {
+            LibMappings[i]->Release();
+        }
+        LibMappings[i] = NULL;
+        LibMappingFailed[i] = false;
+    }
+}
+
+void AssetLibInfo::BuildLookup()
+{
+    memset(AssetLookup, -1, sizeof(AssetLookup));
+    // added from the end, so that the first of the assets with same name
+    // is found first
+    for (int i = AssetCount - 1; i >= 0; --i)
+    {
+        AssetInfo &asset = AssetInfos[i];
+        asset.NameHash = HashAssetName(asset.FileName);
+        int slot = asset.NameHash & (ASSET_LOOKUP_SIZE - 1);
+        asset.NextInLookup = AssetLookup[slot];
+        AssetLookup[slot] = i;
+    }
+}
+
+AssetInfo *AssetLibInfo::FindAsset(const String &asset_name)
+{
+    uint32_t hash = HashAssetName(asset_name);
+    for (int i = AssetLookup[hash & (ASSET_LOOKUP_SIZE - 1)]; i >= 0; i = AssetInfos[i].NextInLookup)
+    {
+        if (AssetInfos[i].NameHash == hash &&
+            AssetInfos[i].FileName.CompareNoCase(asset_name) == 0)
+        {
+            return &AssetInfos[i];
+        }
+    }
+    return NULL;
 }
 
 MultiFileLib::MultiFileLib()
@@ -298,7 +384,7 @@ bool AssetManager::_IsDataFile(const String &data_file)
     }
 
     // open data library
-    Stream *ci_s = ci_fopen(data_file, Common::kFile_Open, Common::kFile_Read);
+    Stream *ci_s = ci_fopen_buffered(data_file, Common::kFile_Open, Common::kFile_Read);
     if (ci_s == NULL)
     {
         return false;
@@ -434,7 +520,7 @@ AssetError AssetManager::RegisterAssetLib(const String &data_file, const String
     _assetLib.BasePath = ".";
 
     // open data library
-    Stream *ci_s = ci_fopen(data_file, Common::kFile_Open, Common::kFile_Read);
+    Stream *ci_s = ci_fopen_buffered(data_file, Common::kFile_Open, Common::kFile_Read);
     if (ci_s == NULL)
     {
         return kAssetErrNoLibFile; // can't be opened, return error code
@@ -706,24 +792,22 @@ AssetError AssetManager::ReadAssetLibV21(MultiFileLib * mfl, Stream *ci_s, int l
 
 AssetInfo *AssetManager::FindAssetByFileName(const String &asset_name)
 {
-    for (int i = 0; i < _assetLib.AssetCount; ++i)
-    {
-        if (_assetLib.AssetInfos[i].FileName.CompareNoCase(asset_name) == 0)
-        {
-            return &_assetLib.AssetInfos[i];
-        }
-    }
-    return NULL;
+    return _assetLib.FindAsset(asset_name);
 }
 
 String AssetManager::MakeLibraryFileNameForAsset(const AssetInfo *asset)
 {
     // deduce asset library file containing this asset
+    return MakeLibraryFileName(asset->LibUid);
+}
+
+String AssetManager::MakeLibraryFileName(int lib_uid)
+{
     String lib_filename;
 #if defined (WINDOWS_VERSION)
-    lib_filename.Format("%s\\%s",_assetLib.BasePath.GetCStr(), _assetLib.LibFileNames[asset->LibUid].GetCStr());
+    lib_filename.Format("%s\\%s",_assetLib.BasePath.GetCStr(), _assetLib.LibFileNames[lib_uid].GetCStr());
 #else
-    lib_filename.Format("%s/%s", _assetLib.BasePath.GetCStr(), _assetLib.LibFileNames[asset->LibUid].GetCStr());
+    lib_filename.Format("%s/%s", _assetLib.BasePath.GetCStr(), _assetLib.LibFileNames[lib_uid].GetCStr());
 #endif
     return lib_filename;
 }
@@ -743,9 +827,17 @@ Stream *AssetManager::OpenAssetFromLib(const String &asset_name, Common::FileOpe
         return NULL;
     }
 
+    // read from the library mapped into memory when possible
+    SharedFileMapping *mapping = GetLibraryMapping(asset->LibUid);
+    if (mapping)
+    {
+        _lastAssetSize = asset->Size;
+        return new MemoryMappedStream(mapping, asset->Offset, asset->Size);
+    }
+
     String lib_filename = MakeLibraryFileNameForAsset(asset);
     // open library datafile
-    Stream *lib_s = ci_fopen(lib_filename, open_mode, work_mode);
+    Stream *lib_s = ci_fopen_buffered(lib_filename, open_mode, work_mode);
     if (lib_s)
     {
         // set stream ptr at the beginning of wanted section
@@ -756,9 +848,33 @@ Stream *AssetManager::OpenAssetFromLib(const String &asset_name, Common::FileOpe
     return lib_s;
 }
 
+SharedFileMapping *AssetManager::GetLibraryMapping(int lib_uid)
+{
+    if (lib_uid < 0 || lib_uid >= MAXMULTIFILES)
+    {
+        return NULL;
+    }
+    if (!_assetLib.LibMappings[lib_uid] && !_assetLib.LibMappingFailed[lib_uid])
+    {
+        Stream *lib_s = ci_fopen(MakeLibraryFileName(lib_uid), Common::kFile_Open, Common::kFile_Read);
+        if (lib_s)
+        {
+            _assetLib.LibMappings[lib_uid] =
+                SharedFileMapping::MapFile(((FileStream*)lib_s)->GetHandle(), lib_s->GetLength());
+            delete lib_s;
+        }
+        // do not try again if the file could not be mapped
+        _assetLib.LibMappingFailed[lib_uid] = _assetLib.LibMappings[lib_uid] == NULL;
+    }
+    return _assetLib.LibMappings[lib_uid];
+}
+
 Stream *AssetManager::OpenAssetFromDir(const String &file_name, Common::FileOpenMode open_mode, Common::FileWorkMode work_mode)
 {
-    Stream *asset_s = ci_fopen(file_name, open_mode, work_mode);
+    // only reading is buffered, as the code writing files may need to
+    // access them directly
+    Stream *asset_s = work_mode == Common::kFile_Read ?
+        ci_fopen_buffered(file_name, open_mode, work_mode) : ci_fopen(file_name, open_mode, work_mode);
     if (asset_s)
     {
         // remember size of opened file
@@ -52,6 +52,7 @@ class Stream;
 struct MultiFileLib;
 struct AssetLibInfo;
 struct AssetInfo;
+class SharedFileMapping;
 
 enum AssetSearchPriority
 {
@@ -139,6 +140,10 @@ private:
 
     AssetInfo   *FindAssetByFileName(const String &asset_name);
     String      MakeLibraryFileNameForAsset(const AssetInfo *asset);
+    String      MakeLibraryFileName(int lib_uid);
+    // Returns memory mapping of the library part, making it on first use,
+    // or NULL if the part cannot be mapped
+    SharedFileMapping *GetLibraryMapping(int lib_uid);
     Stream      *OpenAssetFromLib(const String &asset_name, Common::FileOpenMode open_mode, Common::FileWorkMode work_mode);
     Stream      *OpenAssetFromDir(const String &asset_name, Common::FileOpenMode open_mode, Common::FileWorkMode work_mode);
     Stream      *OpenAssetByPriority(const String &asset_name, Common::FileOpenMode open_mode, Common::FileWorkMode work_mode);
@@ -65,6 +65,17 @@ int wgettextwidth(const char *texx, int fontNumber)
   return fontRenderers[fontNumber]->GetTextWidth(texx, fontNumber);
 }
 
+int wgetcharwidth(unsigned char chr, int fontNumber)
+{
+  // only the built-in renderers are known to measure text as the sum of
+  // its characters; plugin renderers are asked for whole strings
+  if (fontRenderers[fontNumber] == &ttfRenderer)
+    return ttfRenderer.GetCharWidth(chr, fontNumber);
+  if (fontRenderers[fontNumber] == &wfnRenderer)
+    return wfnRenderer.GetCharWidth(chr, fontNumber);
+  return -1;
+}
+
 int wgettextheight(const char *text, int fontNumber)
 {
   return fontRenderers[fontNumber]->GetTextHeight(text, fontNumber);
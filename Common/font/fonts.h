@@ -24,6 +24,9 @@ void shutdown_font_renderer();
 void adjust_y_coordinate_for_text(int* ypos, int fontnum);
 void ensure_text_valid_for_font(char *text, int fontnum);
 int wgettextwidth(const char *texx, int fontNumber);
+// Returns the width that the character adds to the text, or -1 if the font
+// can only measure whole strings
+int wgetcharwidth(unsigned char chr, int fontNumber);
 int wgettextheight(const char *text, int fontNumber);
 void wouttextxy(Common::Bitmap *ds, int xxx, int yyy, int fontNumber, color_t text_color, const char *texx);
 // Loads a font from disk
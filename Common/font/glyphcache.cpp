@@ -0,0 +1,224 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+
+#include <stdlib.h>
+#include <string.h>
+#include "font/glyphcache.h"
+#include "debug/out.h"
+#include "util/wgt2allg.h"
+
+namespace Out = AGS::Common::Out;
+
+// the blender alfont draws anti-aliased text with
+extern "C" void set_preservedalpha_trans_blender(int r, int g, int b, int a);
+
+#define GLYPH_CACHE_BUCKETS 1024
+
+struct CachedGlyph {
+  GlyphKey key;
+  unsigned int hash;
+  GlyphSpan *spans;
+  int span_count;
+  int size;
+  CachedGlyph *next_in_bucket;
+  // neighbours in the order of use, most recent first
+  CachedGlyph *prev_used;
+  CachedGlyph *next_used;
+};
+
+CachedGlyph *glyph_buckets[GLYPH_CACHE_BUCKETS];
+CachedGlyph *most_recent_glyph = NULL;
+CachedGlyph *least_recent_glyph = NULL;
+int glyph_cache_size = 0;
+int glyph_cache_max_size = 1024 * 1024;
+unsigned int glyph_cache_hits = 0;
+unsigned int glyph_cache_misses = 0;
+unsigned int glyph_cache_drops = 0;
+
+GlyphSpan *glyph_span_buffer = NULL;
+int glyph_span_buffer_size = 0;
+
+unsigned int hash_glyph_key(const GlyphKey &key) {
+  const int *fields = (const int*)&key;
+  unsigned int hash = 2166136261u;
+  for (size_t i = 0; i < sizeof(GlyphKey) / sizeof(int); ++i)
+    hash = (hash ^ (unsigned int)fields[i]) * 16777619u;
+  return hash;
+}
+
+void unlink_cached_glyph(CachedGlyph *entry) {
+  if (entry->prev_used)
+    entry->prev_used->next_used = entry->next_used;
+  else
+    most_recent_glyph = entry->next_used;
+  if (entry->next_used)
+    entry->next_used->prev_used = entry->prev_used;
+  else
+    least_recent_glyph = entry->prev_used;
+}
+
+void link_cached_glyph_first(CachedGlyph *entry) {
+  entry->prev_used = NULL;
+  entry->next_used = most_recent_glyph;
+  if (most_recent_glyph)
+    most_recent_glyph->prev_used = entry;
+  else
+    least_recent_glyph = entry;
+  most_recent_glyph = entry;
+}
+
+void free_cached_glyph(CachedGlyph *entry) {
+  CachedGlyph **link = &glyph_buckets[entry->hash % GLYPH_CACHE_BUCKETS];
+  while (*link != entry)
+    link = &(*link)->next_in_bucket;
+  *link = entry->next_in_bucket;
+  unlink_cached_glyph(entry);
+  glyph_cache_size -= entry->size;
+  free(entry->spans);
+  delete entry;
+}
+
+void set_glyph_cache_size(int max_size) {
+  glyph_cache_max_size = max_size;
+  while (least_recent_glyph && (glyph_cache_size > glyph_cache_max_size))
+    free_cached_glyph(least_recent_glyph);
+}
+
+bool is_glyph_cache_enabled() {
+  return glyph_cache_max_size > 0;
+}
+
+bool get_cached_glyph(const GlyphKey &key, const GlyphSpan **spans, int *span_count) {
+  if (glyph_cache_max_size <= 0)
+    return false;
+
+  unsigned int hash = hash_glyph_key(key);
+  for (CachedGlyph *entry = glyph_buckets[hash % GLYPH_CACHE_BUCKETS];
+    entry; entry = entry->next_in_bucket) {
+    if ((entry->hash == hash) && (memcmp(&entry->key, &key, sizeof(key)) == 0)) {
+      if (entry != most_recent_glyph) {
+        unlink_cached_glyph(entry);
+        link_cached_glyph_first(entry);
+      }
+      glyph_cache_hits++;
+      *spans = entry->spans;
+      *span_count = entry->span_count;
+      return true;
+    }
+  }
+  glyph_cache_misses++;
+  return false;
+}
+
+void put_cached_glyph(const GlyphKey &key, const GlyphSpan *spans, int span_count) {
+  int size = sizeof(CachedGlyph) + span_count * sizeof(GlyphSpan);
+  if (size > glyph_cache_max_size)
+    return;
+  while (least_recent_glyph && (glyph_cache_size + size > glyph_cache_max_size)) {
+    free_cached_glyph(least_recent_glyph);
+    glyph_cache_drops++;
+  }
+
+  CachedGlyph *entry = new CachedGlyph();
+  entry->key = key;
+  entry->hash = hash_glyph_key(key);
+  entry->spans = NULL;
+  if (span_count > 0) {
+    entry->spans = (GlyphSpan*)malloc(span_count * sizeof(GlyphSpan));
+    memcpy(entry->spans, spans, span_count * sizeof(GlyphSpan));
+  }
+  entry->span_count = span_count;
+  entry->size = size;
+  CachedGlyph **bucket = &glyph_buckets[entry->hash % GLYPH_CACHE_BUCKETS];
+  entry->next_in_bucket = *bucket;
+  *bucket = entry;
+  link_cached_glyph_first(entry);
+  glyph_cache_size += size;
+}
+
+void remove_cached_glyphs(int font) {
+  CachedGlyph *entry = most_recent_glyph;
+  while (entry) {
+    CachedGlyph *next = entry->next_used;
+    if (entry->key.font == font)
+      free_cached_glyph(entry);
+    entry = next;
+  }
+}
+
+void clear_cached_glyphs() {
+  while (least_recent_glyph)
+    free_cached_glyph(least_recent_glyph);
+}
+
+void log_glyph_cache_stats() {
+  Out::FPrint("Glyph cache: %u hits, %u misses, %u dropped; %d KB used (limit %d KB)",
+    glyph_cache_hits, glyph_cache_misses, glyph_cache_drops,
+    glyph_cache_size / 1024, glyph_cache_max_size / 1024);
+}
+
+const GlyphSpan *make_glyph_spans(const unsigned char *coverage, int width, int height,
+                                  int offset_x, int offset_y, int scale, int *span_count) {
+  // every pixel may have a coverage of its own
+  int max_spans = width * height;
+  if (max_spans > glyph_span_buffer_size) {
+    glyph_span_buffer_size = max_spans;
+    glyph_span_buffer = (GlyphSpan*)realloc(glyph_span_buffer, max_spans * sizeof(GlyphSpan));
+  }
+
+  int count = 0;
+  for (int y = 0; y < height; ++y) {
+    const unsigned char *row = coverage + y * width;
+    for (int x = 0; x < width; ) {
+      unsigned char alpha = row[x];
+      int start = x;
+      for (++x; (x < width) && (row[x] == alpha); ++x);
+      if (alpha == 0)
+        continue;
+      GlyphSpan &span = glyph_span_buffer[count++];
+      span.x = offset_x + start * scale;
+      span.y = offset_y + y * scale;
+      span.width = (x - start) * scale;
+      span.height = scale;
+      span.alpha = alpha;
+    }
+  }
+  *span_count = count;
+  return glyph_span_buffer;
+}
+
+void draw_glyph_spans(BITMAP *ds, int x, int y, const GlyphSpan *spans, int span_count, int colour) {
+  int blend_alpha = 255;
+  for (int i = 0; i < span_count; ++i) {
+    const GlyphSpan &span = spans[i];
+    if (span.alpha != blend_alpha) {
+      if (span.alpha == 255)
+        solid_mode();
+      else {
+        drawing_mode(DRAW_MODE_TRANS, NULL, 0, 0);
+        set_preservedalpha_trans_blender(0, 0, 0, span.alpha);
+      }
+      blend_alpha = span.alpha;
+    }
+
+    int x1 = x + span.x;
+    int y1 = y + span.y;
+    if (span.height == 1)
+      hline(ds, x1, y1, x1 + span.width - 1, colour);
+    else
+      rectfill(ds, x1, y1, x1 + span.width - 1, y1 + span.height - 1, colour);
+  }
+  if (blend_alpha != 255)
+    solid_mode();
+}
@@ -0,0 +1,67 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+//
+// Cache of rasterised characters for the built-in font renderers.
+//
+// A character is kept as a list of horizontal spans of equal coverage,
+// which are drawn with line fills instead of one pixel at a time. Coverage
+// does not depend on the colour depth of the destination: the spans are
+// blended when drawn, the same way the renderers blend each pixel. The
+// cache is limited to a number of bytes, and the characters that were used
+// least recently are dropped first.
+//
+//=============================================================================
+#ifndef __AGS_CN_FONT__GLYPHCACHE_H
+#define __AGS_CN_FONT__GLYPHCACHE_H
+
+struct BITMAP;
+
+// Everything that decides how a character is rasterised
+struct GlyphKey {
+  int font;
+  int code;
+  int antialias;
+  int scale;
+};
+
+struct GlyphSpan {
+  short x, y;           // offset from the position the character is drawn at
+  short width, height;
+  unsigned char alpha;  // coverage, 255 for solid pixels
+};
+
+// Sets the cache limit in bytes; 0 disables the cache
+void set_glyph_cache_size(int max_size);
+bool is_glyph_cache_enabled();
+// Finds the spans of the cached character; returns false if there is none
+bool get_cached_glyph(const GlyphKey &key, const GlyphSpan **spans, int *span_count);
+// Stores a copy of the character spans
+void put_cached_glyph(const GlyphKey &key, const GlyphSpan *spans, int span_count);
+// Drops the characters of the font, which is being loaded or freed
+void remove_cached_glyphs(int font);
+void clear_cached_glyphs();
+// Writes the cache hit and miss counts to the log
+void log_glyph_cache_stats();
+
+// Turns the rows of coverage values into spans, each pixel becoming a
+// square of scale pixels. The spans are kept in a buffer which is reused by
+// the next call.
+const GlyphSpan *make_glyph_spans(const unsigned char *coverage, int width, int height,
+                                  int offset_x, int offset_y, int scale, int *span_count);
+// Draws the spans of the character at x, y. Coverage below 255 is blended
+// with the colour through the font library blender, and the drawing mode
+// is solid again afterwards.
+void draw_glyph_spans(BITMAP *ds, int x, int y, const GlyphSpan *spans, int span_count, int colour);
+
+#endif // __AGS_CN_FONT__GLYPHCACHE_H
@@ -49,6 +49,18 @@ ALFONT_FONT *get_ttf_block(IFont *fontptr)
 // ***** TTF RENDERER *****
 #ifdef USE_ALFONT	// declaration was not under USE_ALFONT though
 
+TTFFontRenderer::TTFFontRenderer()
+{
+  for (int i = 0; i < MAX_FONTS; i++)
+    ResetCharWidths(i);
+}
+
+void TTFFontRenderer::ResetCharWidths(int fontNumber)
+{
+  for (int i = 0; i < CACHED_CHAR_COUNT; i++)
+    _charWidths[fontNumber][i] = -1;
+}
+
 void TTFFontRenderer::AdjustYCoordinateForFont(int *ycoord, int fontNumber)
 {
   // TTF fonts already have space at the top, so try to remove the gap
@@ -65,6 +77,21 @@ int TTFFontRenderer::GetTextWidth(const char *text, int fontNumber)
   return alfont_text_length(get_ttf_block(fonts[fontNumber]), text);
 }
 
+int TTFFontRenderer::GetCharWidth(unsigned char chr, int fontNumber)
+{
+  if (chr >= CACHED_CHAR_COUNT)
+    return -1;
+  short &width = _charWidths[fontNumber][chr];
+  if (width < 0)
+  {
+    // alfont does not apply kerning, so text width is the sum of the
+    // character widths
+    char text[2] = { (char)chr, 0 };
+    width = alfont_text_length(get_ttf_block(fonts[fontNumber]), text);
+  }
+  return width;
+}
+
 int TTFFontRenderer::GetTextHeight(const char *text, int fontNumber)
 {
   return alfont_text_height(get_ttf_block(fonts[fontNumber]));
@@ -76,13 +103,102 @@ void TTFFontRenderer::RenderText(const char *text, int fontNumber, BITMAP *desti
     return;
 
   ALFONT_FONT *alfpt = get_ttf_block(fonts[fontNumber]);
+  const bool antialias = (ShouldAntiAliasText()) && (bitmap_color_depth(destination) > 8);
   // Y - 1 because it seems to get drawn down a bit
-  if ((ShouldAntiAliasText()) && (bitmap_color_depth(destination) > 8))
+  if (RenderCachedText(text, fontNumber, antialias, destination, x, y - 1, colour))
+    return;
+  if (antialias)
     alfont_textout_aa(destination, alfpt, text, x, y - 1, colour);
   else
     alfont_textout(destination, alfpt, text, x, y - 1, colour);
 }
 
+bool TTFFontRenderer::RenderCachedText(const char *text, int fontNumber, bool antialias, BITMAP *destination, int x, int y, int colour)
+{
+  // rendering a character alone costs more than drawing the text
+  // through alfont, so it only pays off if the result is kept
+  if (!is_glyph_cache_enabled())
+    return false;
+  // only the characters which alfont never joins with others are cached
+  for (const char *ch = text; *ch; ++ch)
+  {
+    if ((unsigned char)*ch >= CACHED_CHAR_COUNT)
+      return false;
+  }
+
+  // same as alfont, skip the text if it is clipped as a whole
+  ALFONT_FONT *alfpt = get_ttf_block(fonts[fontNumber]);
+  if ((y + alfont_text_height(alfpt) < destination->ct) || (y > destination->cb) || (x > destination->cr))
+    return true;
+
+  GlyphKey key;
+  key.font = fontNumber;
+  key.antialias = antialias ? 1 : 0;
+  key.scale = 1;
+  solid_mode();
+  for (; *text; ++text)
+  {
+    // alfont stops at the first character past the clipping rectangle
+    if (x > destination->cr)
+      break;
+    key.code = (unsigned char)*text;
+    const GlyphSpan *spans;
+    int span_count;
+    if (!get_cached_glyph(key, &spans, &span_count))
+    {
+      spans = MakeCharSpans(key.code, fontNumber, antialias, &span_count);
+      put_cached_glyph(key, spans, span_count);
+    }
+    draw_glyph_spans(destination, x, y, spans, span_count, colour);
+    x += GetCharWidth(key.code, fontNumber);
+  }
+  return true;
+}
+
+const GlyphSpan *TTFFontRenderer::MakeCharSpans(int chr, int fontNumber, bool antialias, int *span_count)
+{
+  // The character is drawn by alfont on a 32-bit bitmap filled with the
+  // mask colour. Solid pixels are drawn in the given colour; alfont's
+  // blender writes the coverage of the others in the alpha byte when the
+  // destination has the mask colour, and leaves the colour black.
+  ALFONT_FONT *alfpt = get_ttf_block(fonts[fontNumber]);
+  const int margin = alfont_text_height(alfpt);
+  const int width = GetCharWidth(chr, fontNumber) + margin * 2;
+  const int height = margin * 3;
+  const int mask_color = 0x00FF00FF;
+  const int char_color = 0x00000000;
+  BITMAP *canvas = create_bitmap_ex(32, width, height);
+  clear_to_color(canvas, mask_color);
+  char text[2] = { (char)chr, 0 };
+  if (antialias)
+    alfont_textout_aa(canvas, alfpt, text, margin, margin, char_color);
+  else
+    alfont_textout(canvas, alfpt, text, margin, margin, char_color);
+
+  unsigned char *coverage = (unsigned char*)malloc(width * height);
+  for (int cy = 0; cy < height; ++cy)
+  {
+    const uint32_t *row = (const uint32_t*)canvas->line[cy];
+    for (int cx = 0; cx < width; ++cx)
+    {
+      const uint32_t pixel = row[cx];
+      unsigned char alpha;
+      if (pixel == mask_color)
+        alpha = 0;
+      else if (pixel == char_color)
+        alpha = 255;
+      else
+        alpha = pixel >> 24;
+      coverage[cy * width + cx] = alpha;
+    }
+  }
+  destroy_bitmap(canvas);
+
+  const GlyphSpan *spans = make_glyph_spans(coverage, width, height, -margin, -margin, 1, span_count);
+  free(coverage);
+  return spans;
+}
+
 bool TTFFontRenderer::LoadFromDisk(int fontNumber, int fontSize)
 {
   String file_name = String::FromFormat("agsfnt%d.ttf", fontNumber);
@@ -117,6 +233,8 @@ bool TTFFontRenderer::LoadFromDisk(int fontNumber, int fontSize)
 
   if (fontSize > 0)
     alfont_set_font_size(alfptr, fontSize);
+  ResetCharWidths(fontNumber);
+  remove_cached_glyphs(fontNumber);
 
   IFont *tempalloc = (IFont*) malloc(20);
   strcpy((char *)tempalloc, "TTF");
@@ -130,6 +248,8 @@ void TTFFontRenderer::FreeMemory(int fontNumber)
   alfont_destroy_font(get_ttf_block(fonts[fontNumber]));
   free(fonts[fontNumber]);
   fonts[fontNumber] = NULL;
+  ResetCharWidths(fontNumber);
+  remove_cached_glyphs(fontNumber);
 }
 
 #endif   // USE_ALFONT
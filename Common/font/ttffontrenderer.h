@@ -16,9 +16,12 @@
 #define __AC_TTFFONTRENDERER_H
 
 #include "font/agsfontrenderer.h"
+#include "font/glyphcache.h"
 
 class TTFFontRenderer : public IAGSFontRenderer {
 public:
+  TTFFontRenderer();
+
   virtual bool LoadFromDisk(int fontNumber, int fontSize);
   virtual void FreeMemory(int fontNumber);
   virtual bool SupportsExtendedCharacters(int fontNumber) { return true; }
@@ -27,6 +30,23 @@ public:
   virtual void RenderText(const char *text, int fontNumber, BITMAP *destination, int x, int y, int colour) ;
   virtual void AdjustYCoordinateForFont(int *ycoord, int fontNumber);
   virtual void EnsureTextValidForFont(char *text, int fontNumber);
+
+  // Width that the character adds to a line of text; returns -1 for the
+  // characters that can only be measured as part of the whole text
+  int GetCharWidth(unsigned char chr, int fontNumber);
+
+private:
+  // Measured widths of the ASCII characters, -1 if not measured yet.
+  // The rest may be parts of multibyte characters for alfont.
+  static const int CACHED_CHAR_COUNT = 128;
+  short _charWidths[MAX_FONTS][CACHED_CHAR_COUNT];
+
+  void ResetCharWidths(int fontNumber);
+  // Draws the text from the cached characters; returns false if the text
+  // has characters which are not cached
+  bool RenderCachedText(const char *text, int fontNumber, bool antialias, BITMAP *destination, int x, int y, int colour);
+  // Returns the spans of the character rendered by alfont
+  const GlyphSpan *MakeCharSpans(int chr, int fontNumber, bool antialias, int *span_count);
 };
 
 extern TTFFontRenderer ttfRenderer;
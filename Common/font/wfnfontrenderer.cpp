@@ -64,6 +64,12 @@ int WFNFontRenderer::GetTextWidth(const char *text, int fontNumber)
   return text_width * wtext_multiply;
 }
 
+int WFNFontRenderer::GetCharWidth(unsigned char chr, int fontNumber)
+{
+  const WFNFont *font = (WFNFont*)fonts[fontNumber];
+  return font->GetChar(GetCharCode(chr, font)).Width * wtext_multiply;
+}
+
 int WFNFontRenderer::GetTextHeight(const char *text, int fontNumber)
 {
   const WFNFont *font = (WFNFont*)fonts[fontNumber];
@@ -79,52 +85,63 @@ int WFNFontRenderer::GetTextHeight(const char *text, int fontNumber)
   return max_height * wtext_multiply;
 }
 
-Common::Bitmap render_wrapper;
+unsigned char *wfn_coverage = NULL;
+int wfn_coverage_size = 0;
+
 void WFNFontRenderer::RenderText(const char *text, int fontNumber, BITMAP *destination, int x, int y, int colour)
 {
   int oldeip = get_our_eip();
   set_our_eip(415);
 
   const WFNFont *font = (WFNFont*)fonts[fontNumber];
-  render_wrapper.WrapAllegroBitmap(destination, true);
-
+  // unscaled characters used to be plotted pixel by pixel, which is only
+  // limited by the bitmap size and not by its clipping rectangle
+  int cl = destination->cl, ct = destination->ct, cr = destination->cr, cb = destination->cb;
+  if (wtext_multiply == 1)
+    set_clip_rect(destination, 0, 0, destination->w - 1, destination->h - 1);
+
+  GlyphKey key;
+  key.font = fontNumber;
+  key.antialias = 0;
+  key.scale = wtext_multiply;
   for (; *text; ++text)
-    x += RenderChar(&render_wrapper, x, y, font->GetChar(GetCharCode(*text, font)), colour);
+  {
+    key.code = GetCharCode(*text, font);
+    const WFNFont::WFNChar &wfn_char = font->GetChar(key.code);
+    const GlyphSpan *spans;
+    int span_count;
+    if (!get_cached_glyph(key, &spans, &span_count))
+    {
+      spans = MakeCharSpans(wfn_char, &span_count);
+      put_cached_glyph(key, spans, span_count);
+    }
+    draw_glyph_spans(destination, x, y, spans, span_count, colour);
+    x += wfn_char.Width * wtext_multiply;
+  }
 
+  if (wtext_multiply == 1)
+    set_clip_rect(destination, cl, ct, cr, cb);
   set_our_eip(oldeip);
 }
 
-int WFNFontRenderer::RenderChar(Common::Bitmap *ds, const int at_x, const int at_y, const WFNFont::WFNChar &wfn_char, const color_t text_color)
+const GlyphSpan *WFNFontRenderer::MakeCharSpans(const WFNFont::WFNChar &wfn_char, int *span_count)
 {
   const int width = wfn_char.Width;
   const int height = wfn_char.Height;
   const unsigned char *actdata = wfn_char.Data;
   const int bytewid = wfn_char.GetRowByteCount();
 
-  int x = at_x;
-  int y = at_y;
+  if (width * height > wfn_coverage_size)
+  {
+    wfn_coverage_size = width * height;
+    wfn_coverage = (unsigned char*)realloc(wfn_coverage, wfn_coverage_size);
+  }
   for (int h = 0; h < height; ++h)
   {
     for (int w = 0; w < width; ++w)
-    {
-      if (((actdata[h * bytewid + (w / 8)] & (0x80 >> (w % 8))) != 0)) {
-        if (wtext_multiply > 1)
-        {
-          ds->FillRect(Rect(x + w, y + h, x + w + (wtext_multiply - 1),
-              y + h + (wtext_multiply - 1)), text_color);
-        } 
-        else
-        {
-          ds->PutPixel(x + w, y + h, text_color);
-        }
-      }
-
-      x += wtext_multiply - 1;
-    }
-    y += wtext_multiply - 1;
-    x = at_x;
+      wfn_coverage[h * width + w] = (actdata[h * bytewid + (w / 8)] & (0x80 >> (w % 8))) != 0 ? 255 : 0;
   }
-  return width * wtext_multiply;
+  return make_glyph_spans(wfn_coverage, width, height, 0, 0, wtext_multiply, span_count);
 }
 
 bool WFNFontRenderer::LoadFromDisk(int fontNumber, int fontSize)
@@ -152,6 +169,7 @@ bool WFNFontRenderer::LoadFromDisk(int fontNumber, int fontSize)
       return false;
   }
   fonts[fontNumber] = (IFont*)font;
+  remove_cached_glyphs(fontNumber);
   return true;
 }
 
@@ -159,6 +177,7 @@ void WFNFontRenderer::FreeMemory(int fontNumber)
 {
   delete (WFNFont*)fonts[fontNumber];
   fonts[fontNumber] = NULL;
+  remove_cached_glyphs(fontNumber);
 }
 
 bool WFNFontRenderer::SupportsExtendedCharacters(int fontNumber)
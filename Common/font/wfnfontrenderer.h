@@ -16,6 +16,7 @@
 #define __AC_WFNFONTRENDERER_H
 
 #include "font/agsfontrenderer.h"
+#include "font/glyphcache.h"
 #include "font/wfnfont.h"
 
 class WFNFontRenderer : public IAGSFontRenderer {
@@ -29,12 +30,16 @@ public:
   virtual void AdjustYCoordinateForFont(int *ycoord, int fontNumber);
   virtual void EnsureTextValidForFont(char *text, int fontNumber);
 
+  // Width that the character adds to a line of text
+  int GetCharWidth(unsigned char chr, int fontNumber);
+
 private:
   inline unsigned char GetCharCode(unsigned char wanted_code, const WFNFont *font) const
   {
     return wanted_code < font->GetCharCount() ? wanted_code : '?';
   }
-  int RenderChar(Common::Bitmap *ds, const int at_x, const int at_y, const WFNFont::WFNChar &wfn_char, const color_t text_color);
+  // Returns the character pixels as spans scaled by wtext_multiply
+  const GlyphSpan *MakeCharSpans(const WFNFont::WFNChar &wfn_char, int *span_count);
 };
 
 extern WFNFontRenderer wfnRenderer;
@@ -14,6 +14,7 @@
 
 #include <aastr.h>
 #include "gfx/allegrobitmap.h"
+#include "gfx/blendspan.h"
 #include "debug/assert.h"
 
 extern void __my_setcolor(int *ctset, int newcol, int wantColDep);
@@ -291,13 +292,15 @@ void Bitmap::AAStretchBlt(Bitmap *src, const Rect &src_rc, const Rect &dst_rc, B
 void Bitmap::TransBlendBlt(Bitmap *src, int dst_x, int dst_y)
 {
 	BITMAP *al_src_bmp = src->_alBitmap;
-	draw_trans_sprite(_alBitmap, al_src_bmp, dst_x, dst_y);
+	if (!BlendSpan::DrawTransSprite(_alBitmap, al_src_bmp, dst_x, dst_y))
+		draw_trans_sprite(_alBitmap, al_src_bmp, dst_x, dst_y);
 }
 
 void Bitmap::LitBlendBlt(Bitmap *src, int dst_x, int dst_y, int light_amount)
 {
 	BITMAP *al_src_bmp = src->_alBitmap;
-	draw_lit_sprite(_alBitmap, al_src_bmp, dst_x, dst_y, light_amount);
+	if (!BlendSpan::DrawLitSprite(_alBitmap, al_src_bmp, dst_x, dst_y, light_amount))
+		draw_lit_sprite(_alBitmap, al_src_bmp, dst_x, dst_y, light_amount);
 }
 
 void Bitmap::FlipBlt(Bitmap *src, int dst_x, int dst_y, BitmapFlip flip)
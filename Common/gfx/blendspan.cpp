@@ -0,0 +1,150 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+
+#include "gfx/blendspan.h"
+#include "allegro/internal/aintern.h"
+
+namespace AGS
+{
+namespace Common
+{
+
+namespace BlendSpan
+{
+
+#define MAX_SPAN_BLENDERS 16
+
+struct SpanBlender
+{
+    BLENDER_FUNC    Blender;
+    TRANS_SPAN_FUNC TransSpan;
+    LIT_SPAN_FUNC   LitSpan;
+};
+
+SpanBlender SpanBlenders[MAX_SPAN_BLENDERS];
+int NumSpanBlenders = 0;
+
+SpanBlender *FindBlender(BLENDER_FUNC blender)
+{
+    for (int i = 0; i < NumSpanBlenders; ++i)
+    {
+        if (SpanBlenders[i].Blender == blender)
+            return &SpanBlenders[i];
+    }
+    return NULL;
+}
+
+void Register(BLENDER_FUNC blender, TRANS_SPAN_FUNC trans_span, LIT_SPAN_FUNC lit_span)
+{
+    SpanBlender *span_blender = FindBlender(blender);
+    if (!span_blender)
+    {
+        if (NumSpanBlenders == MAX_SPAN_BLENDERS)
+            return;
+        span_blender = &SpanBlenders[NumSpanBlenders++];
+    }
+    span_blender->Blender = blender;
+    span_blender->TransSpan = trans_span;
+    span_blender->LitSpan = lit_span;
+}
+
+void UnregisterAll()
+{
+    NumSpanBlenders = 0;
+}
+
+TRANS_SPAN_FUNC GetTransSpan(BLENDER_FUNC blender)
+{
+    const SpanBlender *span_blender = FindBlender(blender);
+    return span_blender ? span_blender->TransSpan : NULL;
+}
+
+LIT_SPAN_FUNC GetLitSpan(BLENDER_FUNC blender)
+{
+    const SpanBlender *span_blender = FindBlender(blender);
+    return span_blender ? span_blender->LitSpan : NULL;
+}
+
+// Clips the sprite to the destination in the same way as Allegro's sprite
+// drawing functions; returns false if nothing is left to draw
+bool ClipSprite(BITMAP *dst, BITMAP *src, int &dst_x, int &dst_y, int &src_x, int &src_y, int &w, int &h)
+{
+    src_x = 0;
+    src_y = 0;
+    w = src->w;
+    h = src->h;
+    if (dst->clip)
+    {
+        int tmp = dst->cl - dst_x;
+        src_x = tmp < 0 ? 0 : tmp;
+        tmp = dst->cr - dst_x;
+        w = (tmp > src->w ? src->w : tmp) - src_x;
+        tmp = dst->ct - dst_y;
+        src_y = tmp < 0 ? 0 : tmp;
+        tmp = dst->cb - dst_y;
+        h = (tmp > src->h ? src->h : tmp) - src_y;
+        dst_x += src_x;
+        dst_y += src_y;
+    }
+    return w > 0 && h > 0;
+}
+
+bool CanUseSpans(BITMAP *dst, BITMAP *src, int dst_x, int dst_y)
+{
+    if (bitmap_color_depth(dst) != 32 || bitmap_color_depth(src) != 32 ||
+        !is_memory_bitmap(dst) || !is_memory_bitmap(src))
+        return false;
+    // pixels are blended several at a time, so they must not be overwritten
+    // before they are read
+    return !is_same_bitmap(dst, src) || (dst_x == 0 && dst_y == 0);
+}
+
+bool DrawTransSprite(BITMAP *dst, BITMAP *src, int dst_x, int dst_y)
+{
+    TRANS_SPAN_FUNC span = GetTransSpan(_blender_func32);
+    if (!span || !CanUseSpans(dst, src, dst_x, dst_y))
+        return false;
+
+    int src_x, src_y, w, h;
+    if (!ClipSprite(dst, src, dst_x, dst_y, src_x, src_y, w, h))
+        return true;
+    for (int y = 0; y < h; ++y)
+    {
+        span((uint32_t*)dst->line[dst_y + y] + dst_x,
+            (const uint32_t*)src->line[src_y + y] + src_x, w, _blender_alpha);
+    }
+    return true;
+}
+
+bool DrawLitSprite(BITMAP *dst, BITMAP *src, int dst_x, int dst_y, int light)
+{
+    LIT_SPAN_FUNC span = GetLitSpan(_blender_func32);
+    if (!span || !CanUseSpans(dst, src, dst_x, dst_y))
+        return false;
+
+    int src_x, src_y, w, h;
+    if (!ClipSprite(dst, src, dst_x, dst_y, src_x, src_y, w, h))
+        return true;
+    for (int y = 0; y < h; ++y)
+    {
+        span((uint32_t*)dst->line[dst_y + y] + dst_x,
+            (const uint32_t*)src->line[src_y + y] + src_x, w, _blender_col_32, light);
+    }
+    return true;
+}
+
+} // namespace BlendSpan
+
+} // namespace Common
+} // namespace AGS
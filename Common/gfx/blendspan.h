@@ -0,0 +1,58 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+//
+// Line blenders for 32-bit bitmaps.
+//
+// Allegro calls the blender function set by set_blender_mode once for every
+// pixel. The engine may register functions that do the same to a whole line
+// of pixels at once; they are used instead of the Allegro ones whenever the
+// blender they stand for is the current one.
+//
+//=============================================================================
+#ifndef __AGS_CN_GFX__BLENDSPAN_H
+#define __AGS_CN_GFX__BLENDSPAN_H
+
+#include <allegro.h>
+#include "core/types.h"
+
+namespace AGS
+{
+namespace Common
+{
+
+// Blends source pixels over the destination ones, as blender(src, dst, alpha)
+typedef void (*TRANS_SPAN_FUNC)(uint32_t *dst, const uint32_t *src, int count, int alpha);
+// Sets destination pixels to a blend of the source and the blender colour,
+// as blender(color, src, light)
+typedef void (*LIT_SPAN_FUNC)(uint32_t *dst, const uint32_t *src, int count, int color, int light);
+
+namespace BlendSpan
+{
+    // Registers line functions for the given 32-bit blender; either may be NULL
+    void Register(BLENDER_FUNC blender, TRANS_SPAN_FUNC trans_span, LIT_SPAN_FUNC lit_span);
+    void UnregisterAll();
+    TRANS_SPAN_FUNC GetTransSpan(BLENDER_FUNC blender);
+    LIT_SPAN_FUNC   GetLitSpan(BLENDER_FUNC blender);
+
+    // Do the same as draw_trans_sprite and draw_lit_sprite, if both bitmaps
+    // are 32-bit memory bitmaps and the current blender has a line function;
+    // return false without drawing anything otherwise
+    bool DrawTransSprite(BITMAP *dst, BITMAP *src, int dst_x, int dst_y);
+    bool DrawLitSprite(BITMAP *dst, BITMAP *src, int dst_x, int dst_y, int light);
+} // namespace BlendSpan
+
+} // namespace Common
+} // namespace AGS
+
+#endif // __AGS_CN_GFX__BLENDSPAN_H
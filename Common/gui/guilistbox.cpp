@@ -113,7 +113,7 @@ int GUIListBox::AddItem(const char *toadd)
   if (numItems >= MAX_LISTBOX_ITEMS)
     return -1;
 
-  guis_need_update = 1;
+  Invalidate();
   items[numItems] = (char *)malloc(strlen(toadd) + 5);
   strcpy(items[numItems], toadd);
   saveGameIndex[numItems] = -1;
@@ -131,7 +131,7 @@ int GUIListBox::InsertItem(int index, const char *toadd)
   if ((index < 0) || (index > numItems))
     return -1;
 
-  guis_need_update = 1;
+  Invalidate();
 
   for (aa = numItems; aa > index; aa--) {
     items[aa] = items[aa - 1];
@@ -154,7 +154,7 @@ void GUIListBox::SetItemText(int item, const char *newtext)
   if ((item >= numItems) || (item < 0))
     return;
 
-  guis_need_update = 1;
+  Invalidate();
   free(items[item]);
   items[item] = (char *)malloc(strlen(newtext) + 5);
   strcpy(items[item], newtext);
@@ -169,7 +169,7 @@ void GUIListBox::Clear()
   numItems = 0;
   selected = 0;
   topItem = 0;
-  guis_need_update = 1;
+  Invalidate();
 }
 
 void GUIListBox::RemoveItem(int index)
@@ -191,7 +191,7 @@ void GUIListBox::RemoveItem(int index)
   if (selected >= numItems)
     selected = -1;
 
-  guis_need_update = 1;
+  Invalidate();
 }
 
 void GUIListBox::Draw(Common::Bitmap *ds)
@@ -68,6 +68,7 @@ void GUIMain::init()
   fgcol = 1;
   bgcol = 8;
   flags = 0;
+  needsUpdate = true;
 }
 
 void GUIMain::FixupGuiName(char* name)
@@ -385,6 +386,11 @@ void GUIMain::control_positions_changed()
   mousewasy = -1;
 }
 
+void GUIMain::invalidate()
+{
+  needsUpdate = true;
+}
+
 void GUIMain::poll()
 {
   int mxwas = mousex, mywas = mousey;
@@ -414,7 +420,7 @@ void GUIMain::poll()
           objs[mouseover]->MouseMove(mousex, mousey);
         }
       }
-      guis_need_update = 1;
+      invalidate();
     } 
     else if (mouseover >= 0)
       objs[mouseover]->MouseMove(mousex, mousey);
@@ -439,7 +445,7 @@ void GUIMain::mouse_but_down()
   if (objs[mouseover]->MouseDown())
     mouseover = MOVER_MOUSEDOWNLOCKED;
   objs[mousedownon]->MouseMove(mousex - x, mousey - y);
-  guis_need_update = 1;
+  invalidate();
 }
 
 void GUIMain::mouse_but_up()
@@ -456,7 +462,7 @@ void GUIMain::mouse_but_up()
 
   objs[mousedownon]->MouseUp();
   mousedownon = -1;
-  guis_need_update = 1;
+  invalidate();
 }
 
 GuiVersion GameGuiVersion = kGuiVersion_Initial;
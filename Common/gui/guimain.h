@@ -60,6 +60,7 @@ struct GUIMain
   GUIObject *objs[MAX_OBJS_ON_GUI];
   int objrefptr[MAX_OBJS_ON_GUI];       // for re-building objs array
   short drawOrder[MAX_OBJS_ON_GUI];
+  bool needsUpdate;             // has to be drawn again, unlike the other GUIs
 
   static char oNameBuffer[20];
 
@@ -85,6 +86,8 @@ struct GUIMain
   bool bring_to_front(int objNum);
   void control_positions_changed();
   bool is_alpha();
+  // marks this GUI to be drawn again; guis_need_update redraws them all
+  void invalidate();
 
   void FixupGuiName(char* name);
   void SetTransparencyAsPercentage(int percent);
@@ -21,6 +21,8 @@
 
 using AGS::Common::Stream;
 
+extern GUIMain *guis;
+
 void GUIObject::init() {
   int jj;
   scriptName[0] = 0;
@@ -36,6 +38,11 @@ int GUIObject::IsDisabled() {
   return 0;
 }
 
+void GUIObject::Invalidate() {
+  if ((guis != NULL) && (guin >= 0))
+    guis[guin].invalidate();
+}
+
 void GUIObject::WriteToFile(Stream *out)
 {
   // MACPORT FIX: swap
@@ -113,6 +113,8 @@ struct GUIObject
     flags |= GUIF_INVISIBLE;
   }
   int IsClickable();
+  // marks the GUI the control is on to be drawn again
+  void Invalidate();
   void SetClickable(bool newValue) {
     flags &= ~GUIF_NOCLICKS;
     if (!newValue)
@@ -62,7 +62,7 @@ void GUITextBox::Draw(Common::Bitmap *ds)
 
 void GUITextBox::KeyPress(int kp)
 {
-  guis_need_update = 1;
+  Invalidate();
   // backspace, remove character
   if ((kp == 8) && (strlen(text) > 0)) {
     text[strlen(text) - 1] = 0;
@@ -27,6 +27,8 @@
 #define SCOPT_NOIMPORTOVERRIDE 0x20 // do not allow an import to be re-declared
 #define SCOPT_LEFTTORIGHT 0x40   // left-to-right operator precedance
 #define SCOPT_OLDSTRINGS  0x80   // allow old-style strings
+#define SCOPT_LEGACYRUN  0x100   // run scripts using legacy instruction decoder
+#define SCOPT_PROFILERUN 0x200   // count executed instruction sequences and write them to log file
 
 extern void ccSetOption(int, int);
 extern int ccGetOption(int);
@@ -55,6 +55,39 @@ namespace BitByteOperations
               ((val << 24) & 0xFF0000000000LL) | ((val << 40) & 0xFF000000000000LL) | ((val << 56) & 0xFF00000000000000LL);
     }
 
+    // Array versions work on unsigned values and have no dependencies
+    // between elements, so that compilers can turn them into vector code
+    inline void SwapBytesArrayOfInt16(int16_t *buffer, size_t count)
+    {
+        uint16_t *p = (uint16_t*)buffer;
+        for (size_t i = 0; i < count; ++i)
+        {
+            p[i] = (uint16_t)((p[i] >> 8) | (p[i] << 8));
+        }
+    }
+
+    inline void SwapBytesArrayOfInt32(int32_t *buffer, size_t count)
+    {
+        uint32_t *p = (uint32_t*)buffer;
+        for (size_t i = 0; i < count; ++i)
+        {
+            const uint32_t v = p[i];
+            p[i] = (v >> 24) | ((v >> 8) & 0xFF00) | ((v << 8) & 0xFF0000) | (v << 24);
+        }
+    }
+
+    inline void SwapBytesArrayOfInt64(int64_t *buffer, size_t count)
+    {
+        uint64_t *p = (uint64_t*)buffer;
+        for (size_t i = 0; i < count; ++i)
+        {
+            const uint64_t v = p[i];
+            p[i] = (v >> 56) | ((v >> 40) & 0xFF00) | ((v >> 24) & 0xFF0000) | ((v >> 8) & 0xFF000000) |
+                ((v << 8) & 0xFF00000000ULL) | ((v << 24) & 0xFF0000000000ULL) |
+                ((v << 40) & 0xFF000000000000ULL) | (v << 56);
+        }
+    }
+
 } // namespace BitByteOperations
 
 
@@ -0,0 +1,227 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+
+#include <stdlib.h>
+#include "util/bufferedstream.h"
+
+namespace AGS
+{
+namespace Common
+{
+
+BufferedStream::BufferedStream(const String &file_name, FileOpenMode open_mode, FileWorkMode work_mode,
+                               DataEndianess stream_endianess, size_t buffer_size)
+    : FileStream(file_name, open_mode, work_mode, stream_endianess)
+    , _buffer(NULL)
+    , _bufferSize(buffer_size > 0 ? buffer_size : DefaultBufferSize)
+    , _bufferOffset(0)
+    , _bufferLength(0)
+    , _bufferPos(0)
+    , _writing(false)
+{
+    if (FileStream::IsValid())
+    {
+        _buffer = (uint8_t*)malloc(_bufferSize);
+        _bufferOffset = FileStream::GetPosition();
+    }
+}
+
+BufferedStream::~BufferedStream()
+{
+    Close();
+    free(_buffer);
+}
+
+void BufferedStream::Close()
+{
+    FlushWrites();
+    _bufferLength = 0;
+    _bufferPos = 0;
+    FileStream::Close();
+}
+
+bool BufferedStream::Flush()
+{
+    bool flushed = FlushWrites();
+    DropReadBuffer();
+    return FileStream::Flush() && flushed;
+}
+
+bool BufferedStream::EOS() const
+{
+    return _bufferPos >= _bufferLength && FileStream::EOS();
+}
+
+size_t BufferedStream::GetLength() const
+{
+    size_t length = FileStream::GetLength();
+    // data waiting to be written may extend the file
+    if (_writing && _bufferOffset + _bufferPos > length)
+    {
+        length = _bufferOffset + _bufferPos;
+    }
+    return length;
+}
+
+size_t BufferedStream::GetPosition() const
+{
+    return _bufferOffset + _bufferPos;
+}
+
+size_t BufferedStream::Read(void *buffer, size_t size)
+{
+    if (!_buffer || !buffer)
+    {
+        return 0;
+    }
+    if (_writing)
+    {
+        // C library requires repositioning between writing and reading
+        FlushWrites();
+        FileStream::Seek(kSeekBegin, _bufferOffset);
+    }
+
+    uint8_t *dst = (uint8_t*)buffer;
+    size_t total_read = 0;
+    while (size > 0)
+    {
+        size_t available = _bufferLength - _bufferPos;
+        if (available == 0)
+        {
+            // blocks larger than the buffer are read directly
+            if (size >= _bufferSize)
+            {
+                DropReadBuffer();
+                size_t read_now = FileStream::Read(dst, size);
+                _bufferOffset += read_now;
+                total_read += read_now;
+                break;
+            }
+            if (!FillBuffer())
+            {
+                break;
+            }
+            continue;
+        }
+        size_t chunk = size < available ? size : available;
+        memcpy(dst, _buffer + _bufferPos, chunk);
+        _bufferPos += chunk;
+        dst += chunk;
+        size -= chunk;
+        total_read += chunk;
+    }
+    return total_read;
+}
+
+size_t BufferedStream::Write(const void *buffer, size_t size)
+{
+    if (!_buffer || !buffer)
+    {
+        return 0;
+    }
+    if (!_writing)
+    {
+        // C library requires repositioning between reading and writing
+        DropReadBuffer();
+        FileStream::Seek(kSeekBegin, _bufferOffset);
+        _writing = true;
+    }
+
+    if (_bufferPos + size > _bufferSize)
+    {
+        if (!FlushWrites())
+        {
+            return 0;
+        }
+        // blocks larger than the buffer are written directly
+        if (size >= _bufferSize)
+        {
+            size_t written = FileStream::Write(buffer, size);
+            _bufferOffset += written;
+            return written;
+        }
+        _writing = true;
+    }
+    memcpy(_buffer + _bufferPos, buffer, size);
+    _bufferPos += size;
+    return size;
+}
+
+size_t BufferedStream::Seek(StreamSeek seek, int pos)
+{
+    if (!_buffer)
+    {
+        return 0;
+    }
+
+    if (seek == kSeekCurrent)
+    {
+        seek = kSeekBegin;
+        pos += (int)GetPosition();
+    }
+    // just move inside the read buffer if the new position is in it
+    if (seek == kSeekBegin && !_writing && pos >= 0 &&
+        (size_t)pos >= _bufferOffset && (size_t)pos <= _bufferOffset + _bufferLength)
+    {
+        _bufferPos = pos - _bufferOffset;
+        return GetPosition();
+    }
+
+    FlushWrites();
+    DropReadBuffer();
+    FileStream::Seek(seek, pos);
+    // FileStream::Seek reports the position through the virtual call
+    _bufferOffset = FileStream::GetPosition();
+    return GetPosition();
+}
+
+bool BufferedStream::FillBuffer()
+{
+    _bufferOffset += _bufferLength;
+    _bufferPos = 0;
+    _bufferLength = FileStream::Read(_buffer, _bufferSize);
+    return _bufferLength > 0;
+}
+
+void BufferedStream::DropReadBuffer()
+{
+    if (_writing)
+    {
+        return;
+    }
+    if (_bufferPos != _bufferLength)
+    {
+        FileStream::Seek(kSeekBegin, _bufferOffset + _bufferPos);
+    }
+    _bufferOffset += _bufferPos;
+    _bufferLength = 0;
+    _bufferPos = 0;
+}
+
+bool BufferedStream::FlushWrites()
+{
+    if (!_writing)
+    {
+        return true;
+    }
+    size_t written = _bufferPos > 0 ? FileStream::Write(_buffer, _bufferPos) : 0;
+    bool flushed = written == _bufferPos;
+    _bufferOffset += written;
+    _bufferPos = 0;
+    _writing = false;
+    return flushed;
+}
+
+} // namespace Common
+} // namespace AGS
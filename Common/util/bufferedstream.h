@@ -0,0 +1,139 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+//
+// File stream which reads and writes the file in blocks through its own
+// buffer, so that reading data one value at a time does not call into the
+// C library each time.
+//
+// The position of the FILE handle does not match the stream position while
+// there is buffered data; the handle may be used to read or write the file
+// directly only right after Flush.
+//
+//=============================================================================
+#ifndef __AGS_CN_UTIL__BUFFEREDSTREAM_H
+#define __AGS_CN_UTIL__BUFFEREDSTREAM_H
+
+#include <string.h>
+#include "util/filestream.h"
+
+namespace AGS
+{
+namespace Common
+{
+
+class BufferedStream : public FileStream
+{
+public:
+    static const size_t DefaultBufferSize = 8192;
+
+    BufferedStream(const String &file_name, FileOpenMode open_mode, FileWorkMode work_mode,
+        DataEndianess stream_endianess = kLittleEndian, size_t buffer_size = DefaultBufferSize);
+    virtual ~BufferedStream();
+
+    virtual void    Close();
+    // Writes out buffered data and flushes the file
+    virtual bool    Flush();
+
+    virtual bool    EOS() const;
+    virtual size_t  GetLength() const;
+    virtual size_t  GetPosition() const;
+
+    virtual size_t  Read(void *buffer, size_t size);
+    virtual size_t  Write(const void *buffer, size_t size);
+    virtual size_t  Seek(StreamSeek seek, int pos);
+
+    // Single values are taken right from the buffer when it has enough data
+    virtual inline int32_t ReadByte()
+    {
+        if (_bufferPos < _bufferLength)
+        {
+            return _buffer[_bufferPos++];
+        }
+        uint8_t b;
+        return Read(&b, 1) == 1 ? b : -1;
+    }
+
+    virtual inline int16_t ReadInt16()
+    {
+        int16_t val = 0;
+        ReadValue(&val, sizeof(int16_t));
+        ConvertInt16(val);
+        return val;
+    }
+
+    virtual inline int32_t ReadInt32()
+    {
+        int32_t val = 0;
+        ReadValue(&val, sizeof(int32_t));
+        ConvertInt32(val);
+        return val;
+    }
+
+    virtual inline int64_t ReadInt64()
+    {
+        int64_t val = 0;
+        ReadValue(&val, sizeof(int64_t));
+        ConvertInt64(val);
+        return val;
+    }
+
+    virtual inline int32_t WriteByte(uint8_t b)
+    {
+        if (_writing && _bufferPos < _bufferSize)
+        {
+            _buffer[_bufferPos++] = b;
+            return b;
+        }
+        return Write(&b, 1) == 1 ? b : -1;
+    }
+
+private:
+    inline void     ReadValue(void *val, size_t size)
+    {
+        if (_bufferPos + size <= _bufferLength)
+        {
+            memcpy(val, _buffer + _bufferPos, size);
+            _bufferPos += size;
+        }
+        else
+        {
+            Read(val, size);
+        }
+    }
+
+    // Reads next block of the file into the buffer; returns false at the
+    // end of file
+    bool            FillBuffer();
+    // Forgets the data read ahead, moving the file handle back to the
+    // stream position
+    void            DropReadBuffer();
+    // Writes out the data kept in the buffer
+    bool            FlushWrites();
+
+    uint8_t         *_buffer;
+    size_t          _bufferSize;
+    // File position of the first buffered byte
+    size_t          _bufferOffset;
+    // Number of bytes read ahead into the buffer; 0 when writing
+    size_t          _bufferLength;
+    // Stream position inside the buffer; when writing, the number of bytes
+    // to be written out
+    size_t          _bufferPos;
+    bool            _writing;
+};
+
+} // namespace Common
+} // namespace AGS
+
+#endif // __AGS_CN_UTIL__BUFFEREDSTREAM_H
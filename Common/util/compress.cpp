@@ -14,6 +14,11 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define AGS_SSE2_RLE_FILL
+#endif
 #include "ac/common.h"	// quit()
 #include "ac/roomstruct.h"
 #include "util/compress.h"
@@ -47,112 +52,267 @@ long csavecompressed(char *, __block, color[256], long = 0);
 long cloadcompressed(char *, __block, color *, long = 0);
 #endif
 
-void cpackbitl(unsigned char *line, int size, Stream *out)
+//=============================================================================
+//
+// PackBits-style RLE, used for sprites and room masks. Every line is
+// encoded separately as a number of chunks; each chunk begins with a
+// signed control byte. Negative value N means that the next pixel is
+// repeated (1 - N) times, otherwise the next (N + 1) pixels are stored
+// as is. Pixels are stored in little-endian order.
+//
+//=============================================================================
+
+// Longest chunk which the encoder writes
+const int RLE_MAX_CHUNK = 128;
+// Lines shorter than that are encoded in a buffer on stack
+const int RLE_STACK_BUFFER_SIZE = 4096;
+
+template <typename T> inline T rle_read_pixel(const uint8_t *data)
+{
+  T value;
+  memcpy(&value, data, sizeof(T));
+  return value;
+}
+
+template <typename T> inline void rle_write_pixel(uint8_t *data, T value)
+{
+  memcpy(data, &value, sizeof(T));
+}
+
+#if defined (AGS_BIG_ENDIAN)
+template <> inline unsigned short rle_read_pixel<unsigned short>(const uint8_t *data)
+{
+  return data[0] | (data[1] << 8);
+}
+
+template <> inline unsigned int rle_read_pixel<unsigned int>(const uint8_t *data)
+{
+  return data[0] | (data[1] << 8) | (data[2] << 16) | (data[3] << 24);
+}
+
+template <> inline void rle_write_pixel<unsigned short>(uint8_t *data, unsigned short value)
+{
+  data[0] = value & 0xFF;
+  data[1] = (value >> 8) & 0xFF;
+}
+
+template <> inline void rle_write_pixel<unsigned int>(uint8_t *data, unsigned int value)
+{
+  data[0] = value & 0xFF;
+  data[1] = (value >> 8) & 0xFF;
+  data[2] = (value >> 16) & 0xFF;
+  data[3] = (value >> 24) & 0xFF;
+}
+#endif
+
+// Fills pixels with the run value
+inline void rle_fill(unsigned char *dst, unsigned char value, int count)
+{
+  memset(dst, value, count);
+}
+
+inline void rle_fill(unsigned short *dst, unsigned short value, int count)
+{
+#if defined (AGS_SSE2_RLE_FILL)
+  __m128i wide = _mm_set1_epi16((short)value);
+  for (; count >= 8; count -= 8, dst += 8)
+    _mm_storeu_si128((__m128i*)dst, wide);
+#endif
+  while (count-- > 0)
+    *dst++ = value;
+}
+
+inline void rle_fill(unsigned int *dst, unsigned int value, int count)
+{
+#if defined (AGS_SSE2_RLE_FILL)
+  __m128i wide = _mm_set1_epi32((int)value);
+  for (; count >= 4; count -= 4, dst += 4)
+    _mm_storeu_si128((__m128i*)dst, wide);
+#endif
+  while (count-- > 0)
+    *dst++ = value;
+}
+
+// Copies pixels stored in little-endian order
+template <typename T> inline void rle_copy(T *dst, const uint8_t *src, int count)
+{
+#if defined (AGS_BIG_ENDIAN)
+  for (int i = 0; i < count; i++, src += sizeof(T))
+    dst[i] = rle_read_pixel<T>(src);
+#else
+  memcpy(dst, src, count * sizeof(T));
+#endif
+}
+
+// Returns the largest possible size of the encoded line
+inline int rle_max_packed_size(int size, int pixel_size)
+{
+  // worst case is a control byte per every pixel
+  return size * (pixel_size + 1);
+}
+
+// Encodes the line into the buffer, returns number of bytes written
+template <typename T> int rle_pack_line(const T *line, int size, uint8_t *buffer)
 {
-  int cnt = 0;                  // bytes encoded
+  uint8_t *out = buffer;
+  int cnt = 0;                  // pixels encoded
 
   while (cnt < size) {
     int i = cnt;
     int j = i + 1;
-    int jmax = i + 126;
+    int jmax = i + (RLE_MAX_CHUNK - 2);
     if (jmax >= size)
       jmax = size - 1;
 
-    if (i == size - 1) {        //................last byte alone
-      out->WriteInt8(0);
-      out->WriteInt8(line[i]);
+    if (i == size - 1) {        //................last pixel alone
+      *out++ = 0;
+      rle_write_pixel<T>(out, line[i]);
+      out += sizeof(T);
       cnt++;
 
     } else if (line[i] == line[j]) {    //....run
       while ((j < jmax) && (line[j] == line[j + 1]))
         j++;
-     
-      out->WriteInt8(i - j);
-      out->WriteInt8(line[i]);
+
+      *out++ = (uint8_t)(i - j);
+      rle_write_pixel<T>(out, line[i]);
+      out += sizeof(T);
       cnt += j - i + 1;
 
     } else {                    //.............................sequence
       while ((j < jmax) && (line[j] != line[j + 1]))
         j++;
 
-      out->WriteInt8(j - i);
-      out->WriteArray(line + i, j - i + 1, 1);
+      *out++ = (uint8_t)(j - i);
+      for (int k = i; k <= j; k++, out += sizeof(T))
+        rle_write_pixel<T>(out, line[k]);
       cnt += j - i + 1;
 
     }
   } // end while
+  return out - buffer;
 }
 
-void cpackbitl16(unsigned short *line, int size, Stream *out)
+template <typename T> void rle_pack_line(const T *line, int size, Stream *out)
 {
-  int cnt = 0;                  // bytes encoded
+  uint8_t stack_buffer[RLE_STACK_BUFFER_SIZE];
+  int max_size = rle_max_packed_size(size, sizeof(T));
+  uint8_t *buffer = max_size <= RLE_STACK_BUFFER_SIZE ? stack_buffer : (uint8_t*)malloc(max_size);
+  out->Write(buffer, rle_pack_line(line, size, buffer));
+  if (buffer != stack_buffer)
+    free(buffer);
+}
 
-  while (cnt < size) {
-    int i = cnt;
-    int j = i + 1;
-    int jmax = i + 126;
-    if (jmax >= size)
-      jmax = size - 1;
+// Decodes the line from the buffer and advances data pointer; returns
+// 0 on success, or -1 if the data is corrupt or ends prematurely
+template <typename T> int rle_unpack_line(T *line, int size, const uint8_t *&data, const uint8_t *data_end)
+{
+  const uint8_t *in = data;
+  int n = 0;                    // pixels decoded
 
-    if (i == size - 1) {        //................last byte alone
-      out->WriteInt8(0);
-      out->WriteInt16(line[i]);
-      cnt++;
+  while (n < size) {
+    if (in >= data_end)
+      break;
+    int cx = (signed char)*in++;
+    if (cx == -128)
+      cx = 0;
 
-    } else if (line[i] == line[j]) {    //....run
-      while ((j < jmax) && (line[j] == line[j + 1]))
-        j++;
-     
-      out->WriteInt8(i - j);
-      out->WriteInt16(line[i]);
-      cnt += j - i + 1;
+    if (cx < 0) {                //.............run
+      int count = 1 - cx;
+      if ((n + count > size) || (in + sizeof(T) > data_end))
+        break;
+      rle_fill(line + n, rle_read_pixel<T>(in), count);
+      in += sizeof(T);
+      n += count;
+    } else {                     //.....................seq
+      int count = cx + 1;
+      if ((n + count > size) || (in + count * sizeof(T) > data_end))
+        break;
+      rle_copy(line + n, in, count);
+      in += count * sizeof(T);
+      n += count;
+    }
+  }
 
-    } else {                    //.............................sequence
-      while ((j < jmax) && (line[j] != line[j + 1]))
-        j++;
+  data = in;
+  return n == size ? 0 : -1;
+}
 
-      out->WriteInt8(j - i);
-      out->WriteArray(line + i, j - i + 1, 2);
-      cnt += j - i + 1;
+// Decodes the line reading the stream once per chunk
+template <typename T> int rle_unpack_line(T *line, int size, Stream *in)
+{
+  uint8_t chunk[RLE_MAX_CHUNK * sizeof(T)];
+  int n = 0;                    // pixels decoded
 
+  while (n < size) {
+    int ix = in->ReadByte();     // get control byte
+    if (ix < 0)
+      return -1;
+    int cx = (signed char)ix;
+    if (cx == -128)
+      cx = 0;
+
+    int count = cx < 0 ? 1 - cx : cx + 1;
+    // test for buffer overflow
+    if (n + count > size)
+      return -1;
+    if (cx < 0) {                //.............run
+      if (in->Read(chunk, sizeof(T)) != sizeof(T))
+        return -1;
+      rle_fill(line + n, rle_read_pixel<T>(chunk), count);
+    } else {                     //.....................seq
+      if (in->Read(chunk, count * sizeof(T)) != count * sizeof(T))
+        return -1;
+      rle_copy(line + n, chunk, count);
     }
-  } // end while
+    n += count;
+  }
+  return 0;
+}
+
+void cpackbitl(unsigned char *line, int size, Stream *out)
+{
+  rle_pack_line(line, size, out);
+}
+
+void cpackbitl16(unsigned short *line, int size, Stream *out)
+{
+  rle_pack_line(line, size, out);
 }
 
 void cpackbitl32(unsigned int *line, int size, Stream *out)
 {
-  int cnt = 0;                  // bytes encoded
+  rle_pack_line(line, size, out);
+}
 
-  while (cnt < size) {
-    int i = cnt;
-    int j = i + 1;
-    int jmax = i + 126;
-    if (jmax >= size)
-      jmax = size - 1;
+int cunpackbitl(unsigned char *line, int size, Stream *in)
+{
+  return rle_unpack_line(line, size, in);
+}
 
-    if (i == size - 1) {        //................last byte alone
-      out->WriteInt8(0);
-      out->WriteInt32(line[i]);
-      cnt++;
+int cunpackbitl16(unsigned short *line, int size, Stream *in)
+{
+  return rle_unpack_line(line, size, in);
+}
 
-    } else if (line[i] == line[j]) {    //....run
-      while ((j < jmax) && (line[j] == line[j + 1]))
-        j++;
-     
-      out->WriteInt8(i - j);
-      out->WriteInt32(line[i]);
-      cnt += j - i + 1;
+int cunpackbitl32(unsigned int *line, int size, Stream *in)
+{
+  return rle_unpack_line(line, size, in);
+}
 
-    } else {                    //.............................sequence
-      while ((j < jmax) && (line[j] != line[j + 1]))
-        j++;
+int cunpackbitl(unsigned char *line, int size, const unsigned char *&data, const unsigned char *data_end)
+{
+  return rle_unpack_line(line, size, data, data_end);
+}
 
-      out->WriteInt8(j - i);
-      out->WriteArray(line + i, j - i + 1, 4);
-      cnt += j - i + 1;
+int cunpackbitl16(unsigned short *line, int size, const unsigned char *&data, const unsigned char *data_end)
+{
+  return rle_unpack_line(line, size, data, data_end);
+}
 
-    }
-  } // end while
+int cunpackbitl32(unsigned int *line, int size, const unsigned char *&data, const unsigned char *data_end)
+{
+  return rle_unpack_line(line, size, data, data_end);
 }
 
 
@@ -200,126 +360,6 @@ long csavecompressed(char *finam, __block tobesaved, color pala[256], long exto)
   return ofes;
 }
 
-int cunpackbitl(unsigned char *line, int size, Stream *in)
-{
-  int n = 0;                    // number of bytes decoded
-
-  while (n < size) {
-    int ix = in->ReadByte();     // get index byte
-    // TODO: revise when new error handling system is implemented
-    if (ferror(((Common::FileStream*)in)->GetHandle()))
-      break;
-
-    char cx = ix;
-    if (cx == -128)
-      cx = 0;
-
-    if (cx < 0) {                //.............run
-      int i = 1 - cx;
-      char ch = in->ReadInt8();
-      while (i--) {
-        // test for buffer overflow
-        if (n >= size)
-          return -1;
-
-        line[n++] = ch;
-      }
-    } else {                     //.....................seq
-      int i = cx + 1;
-      while (i--) {
-        // test for buffer overflow
-        if (n >= size)
-          return -1;
-
-        line[n++] = in->ReadByte();
-      }
-    }
-  }
-
-  // TODO: revise when new error handling system is implemented
-  return ferror(((Common::FileStream*)in)->GetHandle());
-}
-
-int cunpackbitl16(unsigned short *line, int size, Stream *in)
-{
-  int n = 0;                    // number of bytes decoded
-
-  while (n < size) {
-    int ix = in->ReadByte();     // get index byte
-    // TODO: revise when new error handling system is implemented
-    if (ferror(((Common::FileStream*)in)->GetHandle()))
-      break;
-
-    char cx = ix;
-    if (cx == -128)
-      cx = 0;
-
-    if (cx < 0) {                //.............run
-      int i = 1 - cx;
-      unsigned short ch = in->ReadInt16();
-      while (i--) {
-        // test for buffer overflow
-        if (n >= size)
-          return -1;
-
-        line[n++] = ch;
-      }
-    } else {                     //.....................seq
-      int i = cx + 1;
-      while (i--) {
-        // test for buffer overflow
-        if (n >= size)
-          return -1;
-
-        line[n++] = in->ReadInt16();
-      }
-    }
-  }
-
-  // TODO: revise when new error handling system is implemented
-  return ferror(((Common::FileStream*)in)->GetHandle());
-}
-
-int cunpackbitl32(unsigned int *line, int size, Stream *in)
-{
-  int n = 0;                    // number of bytes decoded
-
-  while (n < size) {
-    int ix = in->ReadByte();     // get index byte
-    // TODO: revise when new error handling system is implemented
-    if (ferror(((Common::FileStream*)in)->GetHandle()))
-      break;
-
-    char cx = ix;
-    if (cx == -128)
-      cx = 0;
-
-    if (cx < 0) {                //.............run
-      int i = 1 - cx;
-      unsigned int ch = in->ReadInt32();
-      while (i--) {
-        // test for buffer overflow
-        if (n >= size)
-          return -1;
-
-        line[n++] = ch;
-      }
-    } else {                     //.....................seq
-      int i = cx + 1;
-      while (i--) {
-        // test for buffer overflow
-        if (n >= size)
-          return -1;
-
-        line[n++] = (unsigned int)in->ReadInt32();
-      }
-    }
-  }
-
-  // TODO: revise when new error handling system is implemented
-  return ferror(((Common::FileStream*)in)->GetHandle());
-}
-
 //=============================================================================
 
 char *lztempfnm = "~aclzw.tmp";
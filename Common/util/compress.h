@@ -35,6 +35,11 @@ void cpackbitl32(unsigned int *line, int size, Common::Stream *out);
 int  cunpackbitl(unsigned char *line, int size, Common::Stream *in);
 int  cunpackbitl16(unsigned short *line, int size, Common::Stream *in);
 int  cunpackbitl32(unsigned int *line, int size, Common::Stream *in);
+// Decode the line from the memory buffer and advance the data pointer past
+// it; return 0 on success, -1 if the data is corrupt or ends prematurely
+int  cunpackbitl(unsigned char *line, int size, const unsigned char *&data, const unsigned char *data_end);
+int  cunpackbitl16(unsigned short *line, int size, const unsigned char *&data, const unsigned char *data_end);
+int  cunpackbitl32(unsigned int *line, int size, const unsigned char *&data, const unsigned char *data_end);
 
 //=============================================================================
 
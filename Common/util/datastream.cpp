@@ -12,10 +12,14 @@
 //
 //=============================================================================
 
+#include <string.h>
 #include "core/types.h"
 #include "util/datastream.h"
 #include "util/math.h"
 
+// Size of the temporary buffer for writing converted arrays, in bytes
+#define CONVERT_CHUNK_SIZE 1024
+
 namespace AGS
 {
 namespace Common
@@ -80,10 +84,7 @@ size_t DataStream::ReadAndConvertArrayOfInt16(int16_t *buffer, size_t count)
     }
 
     count = ReadArray(buffer, sizeof(int16_t), count);
-    for (size_t i = 0; i < count; ++i, ++buffer)
-    {
-        BBOp::SwapBytesInt16(*buffer);
-    }
+    BBOp::SwapBytesArrayOfInt16(buffer, count);
     return count;
 }
 
@@ -95,10 +96,7 @@ size_t DataStream::ReadAndConvertArrayOfInt32(int32_t *buffer, size_t count)
     }
 
     count = ReadArray(buffer, sizeof(int32_t), count);
-    for (size_t i = 0; i < count; ++i, ++buffer)
-    {
-        BBOp::SwapBytesInt32(*buffer);
-    }
+    BBOp::SwapBytesArrayOfInt32(buffer, count);
     return count;
 }
 
@@ -110,10 +108,7 @@ size_t DataStream::ReadAndConvertArrayOfInt64(int64_t *buffer, size_t count)
     }
 
     count = ReadArray(buffer, sizeof(int64_t), count);
-    for (size_t i = 0; i < count; ++i, ++buffer)
-    {
-        BBOp::SwapBytesInt64(*buffer);
-    }
+    BBOp::SwapBytesArrayOfInt64(buffer, count);
     return count;
 }
 
@@ -124,12 +119,18 @@ size_t DataStream::WriteAndConvertArrayOfInt16(const int16_t *buffer, size_t cou
         return 0;
     }
 
-    size_t elem;
-    for (elem = 0; elem < count && !EOS(); ++elem, ++buffer)
+    // convert a chunk of elements at a time and write it in one go
+    int16_t chunk[CONVERT_CHUNK_SIZE / sizeof(int16_t)];
+    const size_t chunk_count = sizeof(chunk) / sizeof(int16_t);
+    size_t elem = 0;
+    while (elem < count)
     {
-        int16_t val = *buffer;
-        ConvertInt16(val);
-        if (Write(&val, sizeof(int16_t)) < sizeof(int16_t))
+        size_t n = count - elem < chunk_count ? count - elem : chunk_count;
+        memcpy(chunk, buffer + elem, n * sizeof(int16_t));
+        BBOp::SwapBytesArrayOfInt16(chunk, n);
+        size_t written = WriteArray(chunk, sizeof(int16_t), n);
+        elem += written;
+        if (written < n)
         {
             break;
         }
@@ -144,12 +145,18 @@ size_t DataStream::WriteAndConvertArrayOfInt32(const int32_t *buffer, size_t cou
         return 0;
     }
 
-    size_t elem;
-    for (elem = 0; elem < count && !EOS(); ++elem, ++buffer)
+    // convert a chunk of elements at a time and write it in one go
+    int32_t chunk[CONVERT_CHUNK_SIZE / sizeof(int32_t)];
+    const size_t chunk_count = sizeof(chunk) / sizeof(int32_t);
+    size_t elem = 0;
+    while (elem < count)
     {
-        int32_t val = *buffer;
-        ConvertInt32(val);
-        if (Write(&val, sizeof(int32_t)) < sizeof(int32_t))
+        size_t n = count - elem < chunk_count ? count - elem : chunk_count;
+        memcpy(chunk, buffer + elem, n * sizeof(int32_t));
+        BBOp::SwapBytesArrayOfInt32(chunk, n);
+        size_t written = WriteArray(chunk, sizeof(int32_t), n);
+        elem += written;
+        if (written < n)
         {
             break;
         }
@@ -164,12 +171,18 @@ size_t DataStream::WriteAndConvertArrayOfInt64(const int64_t *buffer, size_t cou
         return 0;
     }
 
-    size_t elem;
-    for (elem = 0; elem < count && !EOS(); ++elem, ++buffer)
+    // convert a chunk of elements at a time and write it in one go
+    int64_t chunk[CONVERT_CHUNK_SIZE / sizeof(int64_t)];
+    const size_t chunk_count = sizeof(chunk) / sizeof(int64_t);
+    size_t elem = 0;
+    while (elem < count)
     {
-        int64_t val = *buffer;
-        ConvertInt64(val);
-        if (Write(&val, sizeof(int64_t)) < sizeof(int64_t))
+        size_t n = count - elem < chunk_count ? count - elem : chunk_count;
+        memcpy(chunk, buffer + elem, n * sizeof(int64_t));
+        BBOp::SwapBytesArrayOfInt64(chunk, n);
+        size_t written = WriteArray(chunk, sizeof(int64_t), n);
+        elem += written;
+        if (written < n)
         {
             break;
         }
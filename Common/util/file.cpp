@@ -20,6 +20,7 @@
 #include <errno.h>
 #include <stdio.h>
 #include "util/file.h"
+#include "util/bufferedstream.h"
 #include "util/filestream.h"
 
 namespace AGS
@@ -123,5 +124,16 @@ Stream *File::OpenFile(const String &filename, FileOpenMode open_mode, FileWorkM
     return fs;
 }
 
+Stream *File::OpenFileBuffered(const String &filename, FileOpenMode open_mode, FileWorkMode work_mode)
+{
+    FileStream *fs = new BufferedStream(filename, open_mode, work_mode);
+    if (!fs->IsValid())
+    {
+        delete fs;
+        return NULL;
+    }
+    return fs;
+}
+
 } // namespace Common
 } // namespace AGS
@@ -55,6 +55,9 @@ namespace File
     bool        GetFileModesFromCMode(const String &cmode, FileOpenMode &open_mode, FileWorkMode &work_mode);
 
     Stream      *OpenFile(const String &filename, FileOpenMode open_mode, FileWorkMode work_mode);
+    // Opens file stream which reads and writes the file in blocks; suits
+    // files read a few bytes at a time, but its FILE handle is not in sync
+    Stream      *OpenFileBuffered(const String &filename, FileOpenMode open_mode, FileWorkMode work_mode);
     // Convenience helpers
     // Create a totally new file, overwrite existing one
     inline Stream *CreateFile(const String &filename)
@@ -0,0 +1,164 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+
+#if defined (WINDOWS_VERSION)
+#include <io.h>
+#include <windows.h>
+#elif !defined (AGS_NO_FILE_MAPPING)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include "util/filemapping.h"
+
+namespace AGS
+{
+namespace Common
+{
+
+FileMapping::FileMapping()
+    : _view(NULL)
+    , _viewSize(0)
+    , _data(NULL)
+    , _size(0)
+#if defined (WINDOWS_VERSION)
+    , _mappingHandle(NULL)
+#endif
+{
+}
+
+FileMapping::~FileMapping()
+{
+    Unmap();
+}
+
+#if defined (AGS_NO_FILE_MAPPING)
+
+bool FileMapping::Map(FILE *file, size_t offset, size_t size)
+{
+    return false;
+}
+
+void FileMapping::Unmap()
+{
+}
+
+#elif defined (WINDOWS_VERSION)
+
+bool FileMapping::Map(FILE *file, size_t offset, size_t size)
+{
+    Unmap();
+    if (!file || size == 0)
+    {
+        return false;
+    }
+
+    HANDLE file_handle = (HANDLE)_get_osfhandle(_fileno(file));
+    if (file_handle == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file_handle, &file_size) || (uint64_t)file_size.QuadPart < (uint64_t)offset + size)
+    {
+        return false;
+    }
+    _mappingHandle = CreateFileMapping(file_handle, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!_mappingHandle)
+    {
+        return false;
+    }
+
+    SYSTEM_INFO sys_info;
+    GetSystemInfo(&sys_info);
+    size_t view_offset = offset - offset % sys_info.dwAllocationGranularity;
+    _viewSize = size + (offset - view_offset);
+    _view = MapViewOfFile(_mappingHandle, FILE_MAP_READ, 0, (DWORD)view_offset, _viewSize);
+    if (!_view)
+    {
+        CloseHandle(_mappingHandle);
+        _mappingHandle = NULL;
+        _viewSize = 0;
+        return false;
+    }
+    _data = (const uint8_t*)_view + (offset - view_offset);
+    _size = size;
+    return true;
+}
+
+void FileMapping::Unmap()
+{
+    if (_view)
+    {
+        UnmapViewOfFile(_view);
+    }
+    if (_mappingHandle)
+    {
+        CloseHandle(_mappingHandle);
+    }
+    _view = NULL;
+    _viewSize = 0;
+    _data = NULL;
+    _size = 0;
+    _mappingHandle = NULL;
+}
+
+#else // POSIX
+
+bool FileMapping::Map(FILE *file, size_t offset, size_t size)
+{
+    Unmap();
+    if (!file || size == 0)
+    {
+        return false;
+    }
+
+    int fd = fileno(file);
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (uint64_t)st.st_size < (uint64_t)offset + size)
+    {
+        return false;
+    }
+
+    size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+    size_t view_offset = offset - offset % page_size;
+    _viewSize = size + (offset - view_offset);
+    _view = mmap(NULL, _viewSize, PROT_READ, MAP_SHARED, fd, view_offset);
+    if (_view == MAP_FAILED)
+    {
+        _view = NULL;
+        _viewSize = 0;
+        return false;
+    }
+    _data = (const uint8_t*)_view + (offset - view_offset);
+    _size = size;
+    return true;
+}
+
+void FileMapping::Unmap()
+{
+    if (_view)
+    {
+        munmap(_view, _viewSize);
+    }
+    _view = NULL;
+    _viewSize = 0;
+    _data = NULL;
+    _size = 0;
+}
+
+#endif
+
+} // namespace Common
+} // namespace AGS
@@ -0,0 +1,82 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+//
+// Read-only view of the file contents mapped into memory.
+//
+// The mapping is made for the open FILE handle, so that it does not matter
+// whether the file was found on disk or is a part of the packed game data;
+// any section of the file may be mapped.
+//
+//=============================================================================
+#ifndef __AGS_CN_UTIL__FILEMAPPING_H
+#define __AGS_CN_UTIL__FILEMAPPING_H
+
+#include <stdio.h>
+#include "core/types.h"
+
+// PSP does not have virtual memory to map files into
+#if defined (PSP_VERSION)
+#define AGS_NO_FILE_MAPPING
+#endif
+
+namespace AGS
+{
+namespace Common
+{
+
+class FileMapping
+{
+public:
+    FileMapping();
+    ~FileMapping();
+
+    // Maps size bytes of the file starting at offset; returns false if
+    // the file cannot be mapped, in which case it should be read normally
+    bool            Map(FILE *file, size_t offset, size_t size);
+    void            Unmap();
+
+    inline bool     IsMapped() const
+    {
+        return _data != NULL;
+    }
+    // Pointer to the first byte of the requested section
+    inline const uint8_t *GetData() const
+    {
+        return _data;
+    }
+    // Size of the mapped section
+    inline size_t   GetSize() const
+    {
+        return _size;
+    }
+
+private:
+    // Mapping starts at page boundary, which may be earlier than requested
+    void            *_view;
+    size_t          _viewSize;
+    const uint8_t   *_data;
+    size_t          _size;
+#if defined (WINDOWS_VERSION)
+    void            *_mappingHandle;
+#endif
+
+    // Mappings are not copyable
+    FileMapping(const FileMapping &);
+    FileMapping &operator=(const FileMapping &);
+};
+
+} // namespace Common
+} // namespace AGS
+
+#endif // __AGS_CN_UTIL__FILEMAPPING_H
@@ -0,0 +1,245 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+//
+// The block is a series of sequences, each made of:
+//
+//   token         - high 4 bits are literal count, low 4 bits are match
+//                   length minus 4; value of 15 means that the length
+//                   continues in the following bytes
+//   [length]      - extra literal count bytes, added up until one is < 255
+//   literals      - bytes copied as is
+//   offset        - 2 bytes, little-endian: distance back to the match
+//   [length]      - extra match length bytes, same as for literals
+//
+// The last sequence has only literals. The last 5 bytes of the block are
+// always literals, and the last match starts at least 12 bytes before the
+// end of the block, so that the data stays compatible with other LZ4
+// decoders.
+//
+//=============================================================================
+
+#include <string.h>
+#include "core/types.h"
+#include "util/lz4.h"
+
+#ifdef _MANAGED
+// ensure this doesn't get compiled to .NET IL
+#pragma unmanaged
+#endif
+
+const size_t LZ4_MIN_MATCH     = 4;
+const size_t LZ4_LAST_LITERALS = 5;
+const size_t LZ4_MF_LIMIT      = 12;
+const size_t LZ4_MAX_OFFSET    = 65535;
+const size_t LZ4_RUN_MASK      = 15;
+const int    LZ4_HASH_LOG      = 12;
+
+inline uint32_t lz4_read32(const unsigned char *p)
+{
+  uint32_t value;
+  memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+inline uint32_t lz4_hash(uint32_t sequence)
+{
+  return (sequence * 2654435761U) >> (32 - LZ4_HASH_LOG);
+}
+
+inline unsigned char *lz4_write_length(unsigned char *op, size_t length)
+{
+  for (; length >= 255; length -= 255)
+    *op++ = 255;
+  *op++ = (unsigned char)length;
+  return op;
+}
+
+// Reads the continued length; returns false if the data ends prematurely
+inline bool lz4_read_length(const unsigned char *&ip, const unsigned char *iend, size_t &length)
+{
+  unsigned char s;
+  do {
+    if (ip >= iend)
+      return false;
+    s = *ip++;
+    length += s;
+  } while (s == 255);
+  return true;
+}
+
+// Size of the sequence with given number of literals and match length
+inline size_t lz4_sequence_size(size_t literals, size_t match_length)
+{
+  return 1 + (literals + 255 - LZ4_RUN_MASK) / 255 + literals + 2 + (match_length + 255 - LZ4_RUN_MASK) / 255;
+}
+
+size_t lz4_compress_bound(size_t src_size)
+{
+  return src_size + src_size / 255 + 16;
+}
+
+size_t lz4_compress(const unsigned char *src, size_t src_size, unsigned char *dst, size_t dst_capacity)
+{
+  const unsigned char *ip = src;
+  const unsigned char *anchor = src;
+  const unsigned char *iend = src + src_size;
+  unsigned char *op = dst;
+  unsigned char *oend = dst + dst_capacity;
+
+  if (src_size > LZ4_MF_LIMIT) {
+    // positions of the last seen 4-byte sequences, by their hash
+    uint32_t table[1 << LZ4_HASH_LOG];
+    memset(table, 0, sizeof(table));
+    const unsigned char *mflimit = iend - LZ4_MF_LIMIT;
+    const unsigned char *matchlimit = iend - LZ4_LAST_LITERALS;
+
+    ip++;
+    while (ip <= mflimit) {
+      uint32_t sequence = lz4_read32(ip);
+      uint32_t h = lz4_hash(sequence);
+      const unsigned char *ref = src + table[h];
+      table[h] = (uint32_t)(ip - src);
+      if ((size_t)(ip - ref) > LZ4_MAX_OFFSET || lz4_read32(ref) != sequence) {
+        // skip faster over data which does not compress
+        ip += 1 + ((ip - anchor) >> 6);
+        continue;
+      }
+
+      // extend the match both ways
+      while ((ip > anchor) && (ref > src) && (ip[-1] == ref[-1])) {
+        ip--;
+        ref--;
+      }
+      const unsigned char *mp = ip + LZ4_MIN_MATCH;
+      const unsigned char *rp = ref + LZ4_MIN_MATCH;
+      while ((mp < matchlimit) && (*mp == *rp)) {
+        mp++;
+        rp++;
+      }
+
+      size_t literals = ip - anchor;
+      size_t match_length = (mp - ip) - LZ4_MIN_MATCH;
+      if (lz4_sequence_size(literals, match_length) > (size_t)(oend - op))
+        return 0;
+
+      unsigned char *token = op++;
+      if (literals >= LZ4_RUN_MASK) {
+        *token = LZ4_RUN_MASK << 4;
+        op = lz4_write_length(op, literals - LZ4_RUN_MASK);
+      }
+      else {
+        *token = (unsigned char)(literals << 4);
+      }
+      memcpy(op, anchor, literals);
+      op += literals;
+
+      size_t offset = ip - ref;
+      *op++ = (unsigned char)(offset & 0xFF);
+      *op++ = (unsigned char)(offset >> 8);
+      if (match_length >= LZ4_RUN_MASK) {
+        *token |= LZ4_RUN_MASK;
+        op = lz4_write_length(op, match_length - LZ4_RUN_MASK);
+      }
+      else {
+        *token |= (unsigned char)match_length;
+      }
+
+      ip = mp;
+      anchor = ip;
+      if (ip <= mflimit)
+        table[lz4_hash(lz4_read32(ip - 2))] = (uint32_t)(ip - 2 - src);
+    }
+  }
+
+  // the rest is the last literals
+  size_t literals = iend - anchor;
+  if (1 + (literals + 255 - LZ4_RUN_MASK) / 255 + literals > (size_t)(oend - op))
+    return 0;
+  if (literals >= LZ4_RUN_MASK) {
+    *op++ = LZ4_RUN_MASK << 4;
+    op = lz4_write_length(op, literals - LZ4_RUN_MASK);
+  }
+  else {
+    *op++ = (unsigned char)(literals << 4);
+  }
+  memcpy(op, anchor, literals);
+  op += literals;
+  return op - dst;
+}
+
+bool lz4_decompress(const unsigned char *src, size_t src_size, unsigned char *dst, size_t dst_size)
+{
+  const unsigned char *ip = src;
+  const unsigned char *iend = src + src_size;
+  unsigned char *op = dst;
+  unsigned char *oend = dst + dst_size;
+
+  for (;;) {
+    if (ip >= iend)
+      return false;
+    unsigned char token = *ip++;
+
+    size_t literals = token >> 4;
+    if ((literals == LZ4_RUN_MASK) && !lz4_read_length(ip, iend, literals))
+      return false;
+    if ((literals > (size_t)(iend - ip)) || (literals > (size_t)(oend - op)))
+      return false;
+    memcpy(op, ip, literals);
+    op += literals;
+    ip += literals;
+    if (ip == iend)
+      return op == oend;
+
+    if (iend - ip < 2)
+      return false;
+    size_t offset = ip[0] | (ip[1] << 8);
+    ip += 2;
+    if ((offset == 0) || (offset > (size_t)(op - dst)))
+      return false;
+
+    size_t match_length = token & LZ4_RUN_MASK;
+    if ((match_length == LZ4_RUN_MASK) && !lz4_read_length(ip, iend, match_length))
+      return false;
+    match_length += LZ4_MIN_MATCH;
+    if (match_length > (size_t)(oend - op))
+      return false;
+
+    const unsigned char *match = op - offset;
+    if (offset >= match_length) {
+      memcpy(op, match, match_length);
+      op += match_length;
+    }
+    else if (offset == 1) {
+      memset(op, *match, match_length);
+      op += match_length;
+    }
+    else if (match_length < 32) {
+      for (size_t i = 0; i < match_length; ++i)
+        op[i] = match[i];
+      op += match_length;
+    }
+    else {
+      // overlapping match repeats the pattern; every copy doubles the part
+      // of it which may be taken whole
+      while (match_length > 0) {
+        size_t chunk = op - match;
+        if (chunk > match_length)
+          chunk = match_length;
+        memcpy(op, match, chunk);
+        op += chunk;
+        match_length -= chunk;
+      }
+    }
+  }
+}
@@ -0,0 +1,36 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+//
+// Block compression in LZ4 format.
+//
+// The whole block is compressed and decompressed in memory in one call;
+// the data is not framed, so the caller has to store the sizes of both
+// the compressed and decompressed blocks.
+//
+//=============================================================================
+#ifndef __AGS_CN_UTIL__LZ4_H
+#define __AGS_CN_UTIL__LZ4_H
+
+#include <stddef.h>
+
+// Largest possible size of the compressed block for the given source size
+size_t lz4_compress_bound(size_t src_size);
+// Compresses the block; returns size of the compressed data, or 0 if it
+// does not fit into the destination buffer
+size_t lz4_compress(const unsigned char *src, size_t src_size, unsigned char *dst, size_t dst_capacity);
+// Decompresses the block, which must expand to exactly dst_size bytes;
+// returns false if the data is corrupt
+bool   lz4_decompress(const unsigned char *src, size_t src_size, unsigned char *dst, size_t dst_size);
+
+#endif // __AGS_CN_UTIL__LZ4_H
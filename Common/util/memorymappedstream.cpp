@@ -0,0 +1,205 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+
+#include <string.h>
+#include "util/memorymappedstream.h"
+
+namespace AGS
+{
+namespace Common
+{
+
+SharedFileMapping::SharedFileMapping()
+    : _refCount(1)
+{
+}
+
+/* static */ SharedFileMapping *SharedFileMapping::MapFile(FILE *file, size_t file_size)
+{
+    SharedFileMapping *shared = new SharedFileMapping();
+    if (!shared->_mapping.Map(file, 0, file_size))
+    {
+        delete shared;
+        return NULL;
+    }
+    return shared;
+}
+
+void SharedFileMapping::AddRef()
+{
+    _refCount++;
+}
+
+void SharedFileMapping::Release()
+{
+    if (--_refCount == 0)
+    {
+        delete this;
+    }
+}
+
+MemoryMappedStream::MemoryMappedStream(SharedFileMapping *mapping, size_t offset, size_t size,
+                                       DataEndianess stream_endianess)
+    : DataStream(stream_endianess)
+    , _mapping(mapping)
+    , _data(NULL)
+    , _start(0)
+    , _end(0)
+    , _pos(0)
+{
+    if (_mapping)
+    {
+        _mapping->AddRef();
+        _data = _mapping->GetData();
+        // keep the view within the mapped file
+        size_t file_size = _mapping->GetSize();
+        _start = offset < file_size ? offset : file_size;
+        _end = size < file_size - _start ? _start + size : file_size;
+        _pos = _start;
+    }
+}
+
+MemoryMappedStream::~MemoryMappedStream()
+{
+    Close();
+}
+
+void MemoryMappedStream::Close()
+{
+    if (_mapping)
+    {
+        _mapping->Release();
+    }
+    _mapping = NULL;
+    _data = NULL;
+    _start = 0;
+    _end = 0;
+    _pos = 0;
+}
+
+bool MemoryMappedStream::Flush()
+{
+    return false;
+}
+
+bool MemoryMappedStream::IsValid() const
+{
+    return _data != NULL;
+}
+
+bool MemoryMappedStream::EOS() const
+{
+    return _pos >= _end;
+}
+
+size_t MemoryMappedStream::GetLength() const
+{
+    return _end;
+}
+
+size_t MemoryMappedStream::GetPosition() const
+{
+    return _pos;
+}
+
+bool MemoryMappedStream::CanRead() const
+{
+    return IsValid();
+}
+
+bool MemoryMappedStream::CanWrite() const
+{
+    return false;
+}
+
+bool MemoryMappedStream::CanSeek() const
+{
+    return IsValid();
+}
+
+size_t MemoryMappedStream::Read(void *buffer, size_t size)
+{
+    if (!_data || !buffer)
+    {
+        return 0;
+    }
+    size_t remaining = _end - _pos;
+    if (size > remaining)
+    {
+        size = remaining;
+    }
+    memcpy(buffer, _data + _pos, size);
+    _pos += size;
+    return size;
+}
+
+int32_t MemoryMappedStream::ReadByte()
+{
+    if (_pos >= _end)
+    {
+        return -1;
+    }
+    return _data[_pos++];
+}
+
+size_t MemoryMappedStream::Write(const void *buffer, size_t size)
+{
+    return 0;
+}
+
+int32_t MemoryMappedStream::WriteByte(uint8_t b)
+{
+    return -1;
+}
+
+size_t MemoryMappedStream::Seek(StreamSeek seek, int pos)
+{
+    if (!_data)
+    {
+        return 0;
+    }
+
+    // new position is found as a signed number to clamp it to the section
+    int64_t new_pos;
+    switch (seek)
+    {
+    case kSeekBegin:    new_pos = pos; break;
+    case kSeekCurrent:  new_pos = (int64_t)_pos + pos; break;
+    case kSeekEnd:      new_pos = (int64_t)_end + pos; break;
+    default:
+        return _pos;
+    }
+    if (new_pos < (int64_t)_start)
+    {
+        new_pos = _start;
+    }
+    else if (new_pos > (int64_t)_end)
+    {
+        new_pos = _end;
+    }
+    _pos = (size_t)new_pos;
+    return _pos;
+}
+
+const uint8_t *MemoryMappedStream::GetDataAt(size_t pos) const
+{
+    if (!_data || pos < _start || pos > _end)
+    {
+        return NULL;
+    }
+    return _data + pos;
+}
+
+} // namespace Common
+} // namespace AGS
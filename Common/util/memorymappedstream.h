@@ -0,0 +1,149 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+//
+// Read-only stream over a section of the file mapped into memory.
+//
+// All the streams opened on the same file share one mapping of the whole
+// file, which is released when nobody uses it anymore. Stream positions are
+// counted from the beginning of the file, same as for FileStream seeked to
+// the section start, so that the code remembering file offsets works with
+// either of them; the stream length is the position of the section end.
+//
+// Reference counting is not thread-safe: streams must be opened and deleted
+// by the thread that works with the AssetManager.
+//
+//=============================================================================
+#ifndef __AGS_CN_UTIL__MEMORYMAPPEDSTREAM_H
+#define __AGS_CN_UTIL__MEMORYMAPPEDSTREAM_H
+
+#include <string.h>
+#include "util/datastream.h"
+#include "util/filemapping.h"
+
+namespace AGS
+{
+namespace Common
+{
+
+class SharedFileMapping
+{
+public:
+    // Maps the whole file into memory; returns NULL if it cannot be mapped.
+    // The new mapping has one reference, owned by the caller.
+    static SharedFileMapping *MapFile(FILE *file, size_t file_size);
+
+    void            AddRef();
+    // Unmaps the file and deletes the object when the last reference is gone
+    void            Release();
+
+    inline const uint8_t *GetData() const
+    {
+        return _mapping.GetData();
+    }
+    inline size_t   GetSize() const
+    {
+        return _mapping.GetSize();
+    }
+
+private:
+    SharedFileMapping();
+
+    FileMapping     _mapping;
+    int             _refCount;
+};
+
+class MemoryMappedStream : public DataStream
+{
+public:
+    // Views size bytes of the mapped file starting at offset; adds reference
+    // to the mapping for the stream's lifetime
+    MemoryMappedStream(SharedFileMapping *mapping, size_t offset, size_t size,
+        DataEndianess stream_endianess = kLittleEndian);
+    virtual ~MemoryMappedStream();
+
+    virtual void    Close();
+    virtual bool    Flush();
+
+    // Is stream valid (underlying data initialized properly)
+    virtual bool    IsValid() const;
+    // Is end of stream
+    virtual bool    EOS() const;
+    // Total length of stream (if known)
+    virtual size_t  GetLength() const;
+    // Current position (if known)
+    virtual size_t  GetPosition() const;
+    virtual bool    CanRead() const;
+    virtual bool    CanWrite() const;
+    virtual bool    CanSeek() const;
+
+    virtual size_t  Read(void *buffer, size_t size);
+    virtual int32_t ReadByte();
+
+    // Single values are copied from the mapping without further calls
+    virtual inline int16_t ReadInt16()
+    {
+        int16_t val = 0;
+        ReadValue(&val, sizeof(int16_t));
+        ConvertInt16(val);
+        return val;
+    }
+
+    virtual inline int32_t ReadInt32()
+    {
+        int32_t val = 0;
+        ReadValue(&val, sizeof(int32_t));
+        ConvertInt32(val);
+        return val;
+    }
+
+    virtual inline int64_t ReadInt64()
+    {
+        int64_t val = 0;
+        ReadValue(&val, sizeof(int64_t));
+        ConvertInt64(val);
+        return val;
+    }
+
+    virtual size_t  Write(const void *buffer, size_t size);
+    virtual int32_t WriteByte(uint8_t b);
+
+    virtual size_t  Seek(StreamSeek seek, int pos);
+
+    virtual const uint8_t *GetDataAt(size_t pos) const;
+
+private:
+    inline void         ReadValue(void *val, size_t size)
+    {
+        if (_pos + size <= _end)
+        {
+            memcpy(val, _data + _pos, size);
+            _pos += size;
+        }
+        else
+        {
+            Read(val, size);
+        }
+    }
+
+    SharedFileMapping   *_mapping;
+    const uint8_t       *_data;     // first byte of the file
+    size_t              _start;     // section bounds and current position,
+    size_t              _end;       // in bytes from the file beginning
+    size_t              _pos;
+};
+
+} // namespace Common
+} // namespace AGS
+
+#endif // __AGS_CN_UTIL__MEMORYMAPPEDSTREAM_H
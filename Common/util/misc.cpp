@@ -167,11 +167,16 @@ char *ci_find_file(const char *dir_name, const char *file_name)
 #endif
 
 
-/* Case Insensitive fopen */
-Stream *ci_fopen(const char *file_name, Common::FileOpenMode open_mode, Common::FileWorkMode work_mode)
+static Stream *open_file(const char *file_name, Common::FileOpenMode open_mode, Common::FileWorkMode work_mode, bool buffered)
+{
+  return buffered ? Common::File::OpenFileBuffered(file_name, open_mode, work_mode) :
+      Common::File::OpenFile(file_name, open_mode, work_mode);
+}
+
+static Stream *ci_open_file(const char *file_name, Common::FileOpenMode open_mode, Common::FileWorkMode work_mode, bool buffered)
 {
 #if !defined (AGS_CASE_SENSITIVE_FILESYSTEM)
-  return Common::File::OpenFile(file_name, open_mode, work_mode);
+  return open_file(file_name, open_mode, work_mode, buffered);
 #else
   Stream *fs = NULL;
   char *fullpath = ci_find_file(NULL, (char*)file_name);
@@ -179,12 +184,23 @@ Stream *ci_fopen(const char *file_name, Common::FileOpenMode open_mode, Common::
   /* If I didn't find a file, this could be writing a new file,
       so use whatever file_name they passed */
   if (fullpath == NULL) {
-    fs = Common::File::OpenFile(file_name, open_mode, work_mode);
+    fs = open_file(file_name, open_mode, work_mode, buffered);
   } else {
-    fs = Common::File::OpenFile(fullpath, open_mode, work_mode);
+    fs = open_file(fullpath, open_mode, work_mode, buffered);
     free(fullpath);
   }
 
   return fs;
 #endif
 }
+
+/* Case Insensitive fopen */
+Stream *ci_fopen(const char *file_name, Common::FileOpenMode open_mode, Common::FileWorkMode work_mode)
+{
+  return ci_open_file(file_name, open_mode, work_mode, false);
+}
+
+Stream *ci_fopen_buffered(const char *file_name, Common::FileOpenMode open_mode, Common::FileWorkMode work_mode)
+{
+  return ci_open_file(file_name, open_mode, work_mode, true);
+}
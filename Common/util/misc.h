@@ -61,6 +61,10 @@ using namespace AGS; // FIXME later
 Common::Stream *ci_fopen(const char *file_name,
                              Common::FileOpenMode open_mode = Common::kFile_Open,
                              Common::FileWorkMode work_mode = Common::kFile_Read);
+// Same as ci_fopen, but the stream reads and writes through a buffer
+Common::Stream *ci_fopen_buffered(const char *file_name,
+                             Common::FileOpenMode open_mode = Common::kFile_Open,
+                             Common::FileWorkMode work_mode = Common::kFile_Read);
 char *ci_find_file(const char *dir_name, const char *file_name);
 
 
@@ -37,6 +37,14 @@ public:
     // Flush stream buffer to the underlying device
     virtual bool Flush() = 0;
 
+    // Streams which keep all their contents in memory return the address
+    // of the byte at the given stream position, valid as long as the stream
+    // exists; others return NULL and must be read normally
+    virtual const uint8_t *GetDataAt(size_t pos) const
+    {
+        return NULL;
+    }
+
     //-----------------------------------------------------
     // Helper methods
     //-----------------------------------------------------
@@ -12,6 +12,7 @@
 //
 //=============================================================================
 
+#include "font/fonts.h"
 #include "gui/guidefines.h"
 #include "util/string_utils.h"
 #include "util/stream.h"
@@ -47,6 +48,12 @@ void split_lines_leftright(const char *todis, int wii, int fonnt) {
     char textCopyBuffer[STD_BUFFER_SIZE];
     strcpy(textCopyBuffer, todis);
     theline = textCopyBuffer;
+    // The line width is summed up one character at a time; the project's
+    // compensation adds the same amount to any text, so measure it once.
+    // lineWidth becomes -1 when a character can't be measured separately,
+    // and the rest of the line is then measured as a whole.
+    const int extraWidth = wgettextwidth_compensate("", fonnt);
+    int lineWidth = 0;
 
     while (1) {
         splitAt = -1;
@@ -61,6 +68,11 @@ void split_lines_leftright(const char *todis, int wii, int fonnt) {
             break;
         }
 
+        if (lineWidth >= 0) {
+            int charWidth = wgetcharwidth(theline[i], fonnt);
+            lineWidth = charWidth >= 0 ? lineWidth + charWidth : -1;
+        }
+
         // temporarily terminate the line here and test its width
         nextCharWas = theline[i + 1];
         theline[i + 1] = 0;
@@ -69,7 +81,7 @@ void split_lines_leftright(const char *todis, int wii, int fonnt) {
         if ((theline[i] == '[') && ((i == 0) || (theline[i - 1] != '\\')))
             splitAt = i;
         // otherwise, see if we are too wide
-        else if (wgettextwidth_compensate(theline, fonnt) >= wii) {
+        else if ((lineWidth >= 0 ? lineWidth + extraWidth : wgettextwidth_compensate(theline, fonnt)) >= wii) {
             int endline = i;
             while ((theline[endline] != ' ') && (endline > 0))
                 endline--;
@@ -102,6 +114,7 @@ void split_lines_leftright(const char *todis, int wii, int fonnt) {
             if ((theline[0] == ' ') || (theline[0] == '['))
                 theline++;
             i = -1;
+            lineWidth = 0;
         }
 
         i++;
@@ -4,9 +4,8 @@
 #include <string.h>
 #include "cc_compiledscript.h"
 #include "script/script_common.h"       // macro definitions
-#include "cc_symboltable.h"     // symbolTable
+#include "cc_compilercontext.h"  // ccCompilerContext
 #include "script/cc_options.h"      // ccGetOption
-#include "script/cc_error.h"
 
 void ccCompiledScript::write_cmd(int cmdd) {
     write_code(cmdd);
@@ -114,22 +113,22 @@ int ccCompiledScript::add_new_import(char*namm)
     numimports++;
     return numimports-1;
 }
-int ccCompiledScript::remove_any_import (char*namm, SymbolDef *oldSym) {
+int ccCompiledScript::remove_any_import (ccCompilerContext &ctx, char*namm, SymbolDef *oldSym) {
     // Remove any import with the specified name
     int i, sidx;
-    sidx = sym.find(namm);
+    sidx = ctx.sym.find(namm);
     if (sidx < 0)
         return 0;
-    if ((sym.flags[sidx] & SFLG_IMPORTED) == 0)
+    if ((ctx.sym.flags[sidx] & SFLG_IMPORTED) == 0)
         return 0;
     // if this import has been referenced, flag an error
-    if (sym.flags[sidx] & SFLG_ACCESSED) {
-        cc_error("Already referenced name as import; you must define it before using it");
+    if (ctx.sym.flags[sidx] & SFLG_ACCESSED) {
+        cc_error(ctx, "Already referenced name as import; you must define it before using it");
         return -1;
     }
     // if they set the No Override Imports flag, don't allow it
     if (ccGetOption(SCOPT_NOIMPORTOVERRIDE)) {
-        cc_error("Variable '%s' is already imported", namm);
+        cc_error(ctx, "Variable '%s' is already imported", namm);
         return -1;
     }
 
@@ -137,23 +136,23 @@ int ccCompiledScript::remove_any_import (char*namm, SymbolDef *oldSym) {
         // Copy the import declaration to a backup struct
         // This allows a type comparison to be done
         // strip the imported flag, since it the real def won't be
-        oldSym->flags = sym.flags[sidx] & ~SFLG_IMPORTED;
-        oldSym->stype = sym.stype[sidx];
-        oldSym->sscope = sym.sscope[sidx];
-        oldSym->ssize = sym.ssize[sidx];
-        oldSym->arrsize = sym.arrsize[sidx];
-        if (sym.stype[sidx] == SYM_FUNCTION) {
+        oldSym->flags = ctx.sym.flags[sidx] & ~SFLG_IMPORTED;
+        oldSym->stype = ctx.sym.stype[sidx];
+        oldSym->sscope = ctx.sym.sscope[sidx];
+        oldSym->ssize = ctx.sym.ssize[sidx];
+        oldSym->arrsize = ctx.sym.arrsize[sidx];
+        if (ctx.sym.stype[sidx] == SYM_FUNCTION) {
             // <= because of return type
-            for (i = 0; i <= sym.get_num_args(sidx); i++) {
-                oldSym->funcparamtypes[i] = sym.funcparamtypes[sidx][i];
-                oldSym->funcParamDefaultValues[i] = sym.funcParamDefaultValues[sidx][i];
+            for (i = 0; i <= ctx.sym.get_num_args(sidx); i++) {
+                oldSym->funcparamtypes[i] = ctx.sym.funcparamtypes[sidx][i];
+                oldSym->funcParamDefaultValues[i] = ctx.sym.funcParamDefaultValues[sidx][i];
             }
         }
     }
 
     // remove its type so that it can be declared
-    sym.stype[sidx] = 0;
-    sym.flags[sidx] = 0;
+    ctx.sym.stype[sidx] = 0;
+    ctx.sym.flags[sidx] = 0;
 
     // check also for a number-of-parameters appended version
     char appended[200];
@@ -176,7 +175,7 @@ int ccCompiledScript::remove_any_import (char*namm, SymbolDef *oldSym) {
     return 0;
 }
 
-int ccCompiledScript::add_new_export(char*namm,int etype,long eoffs, int numArgs) 
+int ccCompiledScript::add_new_export(ccCompilerContext &ctx, char*namm,int etype,long eoffs, int numArgs) 
 {
     if (numexports >= exportsCapacity) 
     {
@@ -185,7 +184,7 @@ int ccCompiledScript::add_new_export(char*namm,int etype,long eoffs, int numArgs
         export_addr = (int32_t*)realloc(export_addr, sizeof(int32_t) * exportsCapacity);
     }
     if (eoffs >= 0x00ffffff) {
-        cc_error("export offset too high; script data size too large?");
+        cc_error(ctx, "export offset too high; script data size too large?");
         return -1;
     }
     char *newName = (char*)malloc(strlen(namm)+20);
@@ -319,6 +318,76 @@ void ccCompiledScript::init() {
     sectionOffsets = NULL;
     next_line = 0;
 }
+static char *copy_name(const char *name, size_t extra) {
+    char *copied = (char*)malloc(strlen(name) + extra);
+    strcpy(copied, name);
+    return copied;
+}
+void ccCompiledScript::copy_from(const ccCompiledScript &other) {
+    int aa;
+    // allocate the arrays the same way as the functions that grow them,
+    // so that the copy can be compiled into further
+    globaldatasize = other.globaldatasize;
+    if (globaldatasize > 0) {
+        globaldata = (char*)malloc(globaldatasize);
+        memcpy(globaldata, other.globaldata, globaldatasize);
+    }
+    codesize = other.codesize;
+    codeallocated = other.codeallocated;
+    if (codeallocated > 0) {
+        code = (intptr_t*)malloc(codeallocated * sizeof(intptr_t));
+        memcpy(code, other.code, codesize * sizeof(intptr_t));
+    }
+    stringssize = other.stringssize;
+    if (other.strings != NULL) {
+        strings = (char*)malloc(stringssize + 5);
+        memcpy(strings, other.strings, stringssize);
+    }
+    numfixups = other.numfixups;
+    if (numfixups > 0) {
+        fixuptypes = (char*)malloc(numfixups + 5);
+        memcpy(fixuptypes, other.fixuptypes, numfixups);
+        fixups = (int32_t*)malloc(numfixups * sizeof(int32_t) + 10);
+        memcpy(fixups, other.fixups, numfixups * sizeof(int32_t));
+    }
+
+    importsCapacity = other.importsCapacity;
+    numimports = other.numimports;
+    if (importsCapacity > 0) {
+        imports = (char**)malloc(sizeof(char*) * importsCapacity);
+        for (aa = 0; aa < numimports; aa++)
+            imports[aa] = copy_name(other.imports[aa], 12);
+    }
+    exportsCapacity = other.exportsCapacity;
+    numexports = other.numexports;
+    if (exportsCapacity > 0) {
+        exports = (char**)malloc(sizeof(char*) * exportsCapacity);
+        export_addr = (int32_t*)malloc(sizeof(int32_t) * exportsCapacity);
+        for (aa = 0; aa < numexports; aa++)
+            exports[aa] = copy_name(other.exports[aa], 20);
+        memcpy(export_addr, other.export_addr, sizeof(int32_t) * numexports);
+    }
+    capacitySections = other.capacitySections;
+    numSections = other.numSections;
+    if (capacitySections > 0) {
+        sectionNames = (char**)malloc(sizeof(char*) * capacitySections);
+        sectionOffsets = (int32_t*)malloc(sizeof(int32_t) * capacitySections);
+        for (aa = 0; aa < numSections; aa++)
+            sectionNames[aa] = copy_name(other.sectionNames[aa], 1);
+        memcpy(sectionOffsets, other.sectionOffsets, sizeof(int32_t) * numSections);
+    }
+
+    numfunctions = other.numfunctions;
+    for (aa = 0; aa < numfunctions; aa++) {
+        functions[aa] = copy_name(other.functions[aa], 20);
+        funccodeoffs[aa] = other.funccodeoffs[aa];
+        funcnumparams[aa] = other.funcnumparams[aa];
+    }
+    cur_sp = other.cur_sp;
+    next_line = other.next_line;
+    ax_val_type = other.ax_val_type;
+    ax_val_scope = other.ax_val_scope;
+}
 // free the extra bits that ccScript doesn't have
 void ccCompiledScript::free_extra() {
     int aa;
@@ -5,6 +5,8 @@
 #include "cs_parser_common.h"   // macro definitions
 #include "cc_symboldef.h"       // SymbolDef
 
+struct ccCompilerContext;
+
 
 struct ccCompiledScript: public ccScript {
     long codeallocated;
@@ -20,17 +22,19 @@ struct ccCompiledScript: public ccScript {
     void init();
     void shutdown();
     void free_extra();
+    // makes this freshly initialized script a copy of the other one
+    void copy_from(const ccCompiledScript &other);
     int  add_global(int,char*);
     int  add_string(char*);
     void add_fixup(int32_t,char);
     void fixup_previous(char);
     int  add_new_function(char*, int *idx);
     int  add_new_import(char*);
-    int  add_new_export(char*,int,long, int);
+    int  add_new_export(ccCompilerContext &ctx, char*,int,long, int);
     void write_code(intptr_t);
     void set_line_number(int nlum) { next_line=nlum; }
     void flush_line_numbers();
-    int  remove_any_import(char*, SymbolDef *oldSym);
+    int  remove_any_import(ccCompilerContext &ctx, char*, SymbolDef *oldSym);
     const char* start_new_section(const char *name);
 
     void write_cmd(int cmdd);
@@ -0,0 +1,47 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include "cc_compilercontext.h"
+#include "cc_compiledscript.h"
+
+ccCompilerContext::ccCompilerContext() {
+    currentline = 0;
+    headerCache.key = NULL;
+    headerCache.keySize = 0;
+    headerCache.symbols = NULL;
+    headerCache.script = NULL;
+    error = 0;
+    errorLine = 0;
+    errorString[0] = 0;
+    curScriptName = "";
+    scriptNameBuffer[0] = 0;
+    constructedMemberName[0] = 0;
+    readcmdLastCalledWith = 0;
+    readonlyCannotCauseError = 0;
+    saynoNextChar = 0;
+    nextIsEscaped = 0;
+}
+
+ccCompilerContext::~ccCompilerContext() {
+    free(headerCache.key);
+    delete headerCache.symbols;
+    delete headerCache.script;
+}
+
+void cc_error(ccCompilerContext &ctx, const char *descr, ...) {
+    char displbuf[1000];
+    va_list ap;
+
+    va_start(ap, descr);
+    vsprintf(displbuf, descr, ap);
+    va_end(ap);
+
+    // same text as the editor gives the errors of the common cc_error
+    if (ctx.currentline > 0)
+        sprintf(ctx.errorString, "Error (line %d): %s", ctx.currentline, displbuf);
+    else
+        sprintf(ctx.errorString, "Runtime error: %s", displbuf);
+
+    ctx.error = 1;
+    ctx.errorLine = ctx.currentline;
+}
@@ -0,0 +1,51 @@
+#ifndef __CC_COMPILERCONTEXT_H
+#define __CC_COMPILERCONTEXT_H
+
+#include <stddef.h>
+#include "cs_parser_common.h"   // macro definitions
+#include "cc_symboltable.h"
+#include "cc_macrotable.h"
+
+struct ccCompiledScript;
+
+// State of the compiler right after compiling the headers; it is copied
+// into each following compilation instead of compiling the headers again,
+// as long as the headers, macros and options stay the same
+struct ccHeaderCache {
+    char *key;      // everything that affects the headers' compilation
+    size_t keySize;
+    symbolTable *symbols;
+    ccCompiledScript *script;
+};
+
+// Everything one compilation works with, besides the script it produces.
+// It is passed to every function of the compiler, so that several scripts
+// may be compiled at once, each one with a context of its own.
+struct ccCompilerContext {
+    symbolTable sym;
+    MacroTable  macros;
+    int  currentline;       // line being compiled, -10 after the end
+    ccHeaderCache headerCache;
+
+    // error of the compilation, set by cc_error
+    int  error;
+    int  errorLine;
+    char errorString[400];
+    const char *curScriptName;  // script or header the error is in
+
+    // state kept by the parser between its calls
+    char scriptNameBuffer[256];
+    char constructedMemberName[MAX_SYM_LEN];
+    int  readcmdLastCalledWith;
+    int  readonlyCannotCauseError;  // the variable read was a property
+    int  saynoNextChar;     // the tokenizer has just read a closing quote
+    int  nextIsEscaped;     // the tokenizer has just read a backslash
+
+    ccCompilerContext();
+    ~ccCompilerContext();
+};
+
+// reports an error of the compilation, which then fails
+extern void cc_error(ccCompilerContext &ctx, const char *descr, ...);
+
+#endif // __CC_COMPILERCONTEXT_H
@@ -0,0 +1,130 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+
+#include <stdlib.h>
+#include <string.h>
+#include "cc_hashmap.h"
+
+ccHashMap::ccHashMap() {
+    entries = NULL;
+    numEntries = 0;
+    capacity = 0;
+    freeList = -1;
+    buckets = NULL;
+    numBuckets = 0;
+}
+
+ccHashMap::~ccHashMap() {
+    free(entries);
+    free(buckets);
+}
+
+// FNV-1a
+unsigned int ccHashMap::hashString(const char *key) {
+    unsigned int hash = 2166136261u;
+    for (; *key; key++) {
+        hash ^= (unsigned char)*key;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+int ccHashMap::findEntry(const char *key, unsigned int hash) const {
+    if (numBuckets == 0)
+        return -1;
+    for (int idx = buckets[hash & (numBuckets - 1)]; idx >= 0; idx = entries[idx].next) {
+        if ((entries[idx].hash == hash) && (strcmp(entries[idx].key, key) == 0))
+            return idx;
+    }
+    return -1;
+}
+
+int ccHashMap::findValue(const char *key) const {
+    int idx = findEntry(key, hashString(key));
+    if (idx < 0)
+        return -1;
+    return entries[idx].value;
+}
+
+void ccHashMap::addEntry(const char *key, int value) {
+    unsigned int hash = hashString(key);
+    int idx = findEntry(key, hash);
+    if (idx >= 0) {
+        entries[idx].key = key;
+        entries[idx].value = value;
+        return;
+    }
+
+    if (freeList >= 0) {
+        idx = freeList;
+        freeList = entries[idx].next;
+    }
+    else {
+        if (numEntries >= capacity)
+            grow();
+        idx = numEntries++;
+    }
+
+    int bucket = hash & (numBuckets - 1);
+    entries[idx].key = key;
+    entries[idx].hash = hash;
+    entries[idx].value = value;
+    entries[idx].next = buckets[bucket];
+    buckets[bucket] = idx;
+}
+
+void ccHashMap::removeEntry(const char *key) {
+    if (numBuckets == 0)
+        return;
+    unsigned int hash = hashString(key);
+    int *link = &buckets[hash & (numBuckets - 1)];
+    while (*link >= 0) {
+        Entry &entry = entries[*link];
+        if ((entry.hash == hash) && (strcmp(entry.key, key) == 0)) {
+            int idx = *link;
+            *link = entry.next;
+            entry.key = NULL;
+            entry.next = freeList;
+            freeList = idx;
+            return;
+        }
+        link = &entry.next;
+    }
+}
+
+void ccHashMap::clear() {
+    numEntries = 0;
+    freeList = -1;
+    for (int bb = 0; bb < numBuckets; bb++)
+        buckets[bb] = -1;
+}
+
+void ccHashMap::grow() {
+    // keep the load factor at most 1
+    capacity = (capacity == 0) ? 256 : capacity * 2;
+    entries = (Entry*)realloc(entries, capacity * sizeof(Entry));
+
+    numBuckets = capacity;
+    free(buckets);
+    buckets = (int*)malloc(numBuckets * sizeof(int));
+    for (int bb = 0; bb < numBuckets; bb++)
+        buckets[bb] = -1;
+    // relink the existing entries into the new buckets; there are no freed
+    // ones, since the table only grows when the free list is empty
+    for (int idx = 0; idx < numEntries; idx++) {
+        int bucket = entries[idx].hash & (numBuckets - 1);
+        entries[idx].next = buckets[bucket];
+        buckets[bucket] = idx;
+    }
+}
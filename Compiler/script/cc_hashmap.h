@@ -0,0 +1,60 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+//
+// Hash table mapping strings to integer values, used by the compiler to look
+// up symbols and macros by name.
+//
+// The table does not copy the keys: the strings must stay unchanged for as
+// long as they are in the table.
+//
+//=============================================================================
+
+#ifndef __CC_HASHMAP_H
+#define __CC_HASHMAP_H
+
+struct ccHashMap {
+    ccHashMap();
+    ~ccHashMap();
+    // returns the value stored for the key, or -1
+    int findValue(const char *key) const;
+    // adds the key, or replaces its value if it is already there
+    void addEntry(const char *key, int value);
+    void removeEntry(const char *key);
+    void clear();
+
+private:
+    struct Entry {
+        const char *key;
+        unsigned int hash;
+        int value;
+        int next;   // next entry in the same bucket, or in the free list
+    };
+
+    static unsigned int hashString(const char *key);
+    int  findEntry(const char *key, unsigned int hash) const;
+    void grow();
+
+    Entry *entries;
+    int   numEntries;   // entries used so far, including the freed ones
+    int   capacity;
+    int   freeList;     // first removed entry, available for reuse
+    int  *buckets;      // first entry of each bucket; count is power of 2
+    int   numBuckets;
+
+    // not copyable
+    ccHashMap(const ccHashMap &);
+    ccHashMap &operator=(const ccHashMap &);
+};
+
+#endif // __CC_HASHMAP_H
@@ -2,8 +2,6 @@
 #include <stdlib.h>
 #include "cc_internallist.h"
 
-extern int currentline;
-
 void ccInternalList::startread() {
     pos=0;
 }
@@ -19,18 +17,18 @@ long ccInternalList::getnext() {
     // process line numbers internally
     while (script[pos] == SCODE_META) {
         if (script[pos+1] == SMETA_LINENUM)
-            currentline = script[pos+2];
+            *currentline = script[pos+2];
         else if (script[pos+1] == SMETA_END) {
-            lineAtEnd = currentline;
+            lineAtEnd = *currentline;
             if (cancelCurrentLine)
-                currentline = -10;
+                *currentline = -10;
             break;
         }
         pos+=3;
     }
     if (pos >= length) {
         if (cancelCurrentLine)
-            currentline = -10;
+            *currentline = -10;
         return SCODE_INVALID;
     }
     /*    if ((script[pos] >= 0) && (sym.get_type(script[pos]) == SYM_OPENBRACE))
@@ -76,6 +74,7 @@ void ccInternalList::init() {
     length = 0;
     script = NULL;
     cancelCurrentLine = 1;
+    currentline = NULL;
 }
 ccInternalList::~ccInternalList() {
     shutdown();
@@ -12,6 +12,7 @@ struct ccInternalList {
     int pos;
     int lineAtEnd;
     int cancelCurrentLine;  // whether to set currentline=-10 if end reached
+    int *currentline;       // line of the compilation, set from the line metas
 
     void startread();
     long peeknext();
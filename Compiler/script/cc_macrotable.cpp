@@ -2,55 +2,49 @@
 #include <stdlib.h>
 #include <string.h>
 #include "cc_macrotable.h"
-#include "script/cc_error.h"
+#include "cc_compilercontext.h"
 
 void MacroTable::shutdown() {
     int rr;
     for (rr=0;rr<num;rr++) {
-        free(macro[rr]);
-        free(name[rr]);
         macro[rr]=NULL;
         name[rr]=NULL;
     }
     num = 0;
+    nameLookup.clear();
+    strings.clear();
 }
-void MacroTable::merge(MacroTable *others) {
+void MacroTable::merge(ccCompilerContext &ctx, MacroTable *others) {
 
     for (int aa = 0; aa < others->num; aa++) {
-        this->add(others->name[aa], others->macro[aa]);
+        this->add(ctx, others->name[aa], others->macro[aa]);
     }
 
 }
 int MacroTable::find_name(char* namm) {
-    int ss;
-    for (ss=0;ss<num;ss++) {
-        if (strcmp(namm,name[ss])==0) return ss;
-    }
-    return -1;
+    return nameLookup.findValue(namm);
 }
-void MacroTable::add(char*namm,char*mac) {
+void MacroTable::add(ccCompilerContext &ctx, char*namm,char*mac) {
     if (find_name(namm) >= 0) {
-        cc_error("macro '%s' already defined",namm);
+        cc_error(ctx, "macro '%s' already defined",namm);
         return;
     }
     if (num>=MAXDEFINES) {
-        cc_error("too many macros defined");
+        cc_error(ctx, "too many macros defined");
         return;
     }
-    name[num]=(char*)malloc(strlen(namm)+5);
-    strcpy(name[num],namm);
-    macro[num]=(char*)malloc(strlen(mac)+5);
-    strcpy(macro[num],mac);
+    name[num]=strings.copy(namm);
+    macro[num]=strings.copy(mac);
+    nameLookup.addEntry(name[num], num);
     num++;
 }
-void MacroTable::remove(int index) {
+void MacroTable::remove(ccCompilerContext &ctx, int index) {
     if ((index < 0) || (index >= num)) {
-        cc_error("MacroTable::Remove: index out of range");
+        cc_error(ctx, "MacroTable::Remove: index out of range");
         return;
     }
     // just blank out the entry, don't bother to remove it
+    nameLookup.removeEntry(name[index]);
     name[index][0] = 0;
     macro[index][0] = 0;
-}
-
-MacroTable macros;
\ No newline at end of file
+}
\ No newline at end of file
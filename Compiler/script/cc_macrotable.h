@@ -1,26 +1,32 @@
 #ifndef __CC_MACROTABLE_H
 #define __CC_MACROTABLE_H
 
+#include "cc_hashmap.h"
+#include "cc_namearena.h"
+
+struct ccCompilerContext;
+
 #define MAX_LINE_LENGTH 500
 #define MAXDEFINES 1500
 struct MacroTable {
     int num;
     char*name[MAXDEFINES];
     char*macro[MAXDEFINES];
+    ccHashMap nameLookup;   // macro indexes by name
+    ccNameArena strings;    // holds names and macros
     void init() {
-        num=0; }
+        num=0;
+        nameLookup.clear(); }
     void shutdown();
     int  find_name(char*);
-    void add(char*,char*);
-    void remove(int index);
-    void merge(MacroTable *);
+    // errors are reported to the compilation the table belongs to
+    void add(ccCompilerContext &ctx, char*, char*);
+    void remove(ccCompilerContext &ctx, int index);
+    void merge(ccCompilerContext &ctx, MacroTable *);
 
     MacroTable() {
         init();
     }
 };
 
-
-extern MacroTable macros;
-
 #endif // __CC_MACROTABLE_H
\ No newline at end of file
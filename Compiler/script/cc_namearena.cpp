@@ -0,0 +1,68 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+
+#include <stdlib.h>
+#include <string.h>
+#include "cc_namearena.h"
+
+ccNameArena::ccNameArena() {
+    blocks = NULL;
+}
+
+ccNameArena::~ccNameArena() {
+    while (blocks != NULL) {
+        Block *next = blocks->next;
+        free(blocks);
+        blocks = next;
+    }
+}
+
+char *ccNameArena::allocate(size_t size) {
+    if ((blocks == NULL) || (blocks->used + size > blocks->size)) {
+        // strings longer than a block get a block of their own
+        size_t block_size = size > BLOCK_SIZE ? size : BLOCK_SIZE;
+        Block *block = (Block*)malloc(sizeof(Block) + block_size);
+        if (block == NULL)
+            return NULL;
+        block->size = block_size;
+        block->used = 0;
+        block->next = blocks;
+        blocks = block;
+    }
+    char *ptr = (char*)(blocks + 1) + blocks->used;
+    blocks->used += size;
+    return ptr;
+}
+
+char *ccNameArena::copy(const char *text) {
+    size_t size = strlen(text) + 1;
+    char *ptr = allocate(size);
+    if (ptr != NULL)
+        memcpy(ptr, text, size);
+    return ptr;
+}
+
+void ccNameArena::clear() {
+    if (blocks == NULL)
+        return;
+    // the newest block is kept, the rest are freed
+    Block *block = blocks->next;
+    while (block != NULL) {
+        Block *next = block->next;
+        free(block);
+        block = next;
+    }
+    blocks->next = NULL;
+    blocks->used = 0;
+}
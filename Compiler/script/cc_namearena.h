@@ -0,0 +1,51 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+//
+// Storage for the names of symbols and macros. Strings are put one after
+// another into large blocks, and are all freed at once when the table that
+// owns them is cleared.
+//
+//=============================================================================
+
+#ifndef __CC_NAMEARENA_H
+#define __CC_NAMEARENA_H
+
+#include <stddef.h>
+
+struct ccNameArena {
+    ccNameArena();
+    ~ccNameArena();
+    // returns uninitialized space for size bytes
+    char *allocate(size_t size);
+    // returns a copy of the string
+    char *copy(const char *text);
+    // frees all the strings; keeps the first block for reuse
+    void clear();
+
+private:
+    struct Block {
+        Block *next;
+        size_t size;
+        size_t used;
+    };
+    static const size_t BLOCK_SIZE = 16384;
+
+    Block *blocks;
+
+    // not copyable
+    ccNameArena(const ccNameArena &);
+    ccNameArena &operator=(const ccNameArena &);
+};
+
+#endif // __CC_NAMEARENA_H
@@ -45,8 +45,7 @@ int symbolTable::get_propset(int symb) {
 
 
 void symbolTable::reset() {
-    int rr;
-    for (rr=0;rr<numsymbols;rr++) free(sname[rr]);
+    nameArena.clear();
     numsymbols=0;
     currentscope=0;
     stringStructSym = 0;
@@ -129,6 +128,38 @@ void symbolTable::reset() {
     add_ex("autoptr", SYM_AUTOPTR, 0);
     add_ex("noloopcheck", SYM_LOOPCHECKOFF, 0);
 }
+void symbolTable::copy_from(const symbolTable &other) {
+    nameArena.clear();
+    symbolTree.clear();
+    numsymbols = other.numsymbols;
+    currentscope = other.currentscope;
+    normalIntSym = other.normalIntSym;
+    normalStringSym = other.normalStringSym;
+    normalFloatSym = other.normalFloatSym;
+    normalVoidSym = other.normalVoidSym;
+    nullSym = other.nullSym;
+    stringStructSym = other.stringStructSym;
+
+    int count = numsymbols;
+    memcpy(stype, other.stype, count * sizeof(stype[0]));
+    memcpy(flags, other.flags, count * sizeof(flags[0]));
+    memcpy(vartype, other.vartype, count * sizeof(vartype[0]));
+    memcpy(soffs, other.soffs, count * sizeof(soffs[0]));
+    memcpy(ssize, other.ssize, count * sizeof(ssize[0]));
+    memcpy(sscope, other.sscope, count * sizeof(sscope[0]));
+    memcpy(arrsize, other.arrsize, count * sizeof(arrsize[0]));
+    memcpy(extends, other.extends, count * sizeof(extends[0]));
+    memcpy(funcparamtypes, other.funcparamtypes, count * sizeof(funcparamtypes[0]));
+    memcpy(funcParamDefaultValues, other.funcParamDefaultValues, count * sizeof(funcParamDefaultValues[0]));
+
+    for (int ss = 0; ss < count; ss++) {
+        // the name and its pointer version, see add_ex
+        size_t size = strlen(other.sname[ss]) * 2 + 3;
+        sname[ss] = nameArena.allocate(size);
+        memcpy(sname[ss], other.sname[ss], size);
+        symbolTree.addEntry(sname[ss], ss);
+    }
+}
 int symbolTable::operatorToVCPUCmd(int opprec) {
     //return ssize[opprec] + 8;
     return vartype[opprec];
@@ -189,11 +220,12 @@ int symbolTable::add(char*nta) {
 int symbolTable::add_ex(char*nta,int typo,char sizee) {
     if (find(nta) >= 0) return -1;
     if (numsymbols >= MAXSYMBOLS) return -1;
-    sname[numsymbols]=(char*)malloc(strlen(nta) * 2 + 5);
+    size_t namelen = strlen(nta);
+    sname[numsymbols]=nameArena.allocate(namelen * 2 + 3);
     // put the name, followed by the pointer-equivalent
-    strcpy(sname[numsymbols], nta);
-    strcpy(&sname[numsymbols][strlen(nta) + 1], nta);
-    strcat(&sname[numsymbols][strlen(nta) + 1], "*");
+    memcpy(sname[numsymbols], nta, namelen + 1);
+    memcpy(&sname[numsymbols][namelen + 1], nta, namelen);
+    strcpy(&sname[numsymbols][namelen * 2 + 1], "*");
 
     stype[numsymbols]=typo;
     ssize[numsymbols]=sizee;
@@ -212,5 +244,3 @@ int symbolTable::add_operator(char *nta, int priority, int vcpucmd) {
         vartype[nss] = vcpucmd;
     return nss;
 }
-
-symbolTable sym;
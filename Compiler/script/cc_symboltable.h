@@ -2,7 +2,8 @@
 #define __CC_SYMBOLTABLE_H
 
 #include "cs_parser_common.h"   // macro definitions
-#include "script/cc_treemap.h"
+#include "cc_hashmap.h"
+#include "cc_namearena.h"
 
 struct symbolTable {
     int numsymbols;
@@ -28,10 +29,12 @@ struct symbolTable {
     char tempBuffer[2][MAX_SYM_LEN];
     int  usingTempBuffer;
 
-    ccTreeMap symbolTree;
+    ccHashMap symbolTree;
+    ccNameArena nameArena; // holds sname strings
 
     symbolTable();
     void reset();    // clears table
+    void copy_from(const symbolTable &other); // replaces contents with a copy of other
     int  find(const char*);  // returns ID of symbol, or -1
     int  add_ex(char*,int,char);  // adds new symbol of type and size
     int  add_operator(char*, int priority, int vcpucmd); // adds new operator
@@ -47,8 +50,4 @@ struct symbolTable {
     int get_propset(int symb);
 };
 
-
-
-extern symbolTable sym;
-
 #endif //__CC_SYMBOLTABLE_H
\ No newline at end of file
@@ -5,7 +5,7 @@
 #include "cs_compiler.h"
 #include "cc_macrotable.h"
 #include "cc_compiledscript.h"
-#include "cc_symboltable.h"
+#include "cc_compilercontext.h"
 #include "script/cc_error.h"
 #include "script/cc_options.h"
 #include "script/script_common.h"
@@ -13,6 +13,13 @@
 #include "cs_prepro.h"
 #include "cs_parser.h"
 
+#if defined(WINDOWS_VERSION)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
 const char *ccSoftwareVersion = "1.0";
 
 char**defaultheaders = NULL;
@@ -22,6 +29,9 @@ static int capacityHeaders=0;
 
 MacroTable predefinedMacros;
 
+// Compiler state of ccCompileText
+static ccCompilerContext mainContext;
+
 int ccAddDefaultHeader(char* nhead, char *nName) 
 {
     if (numheaders >= capacityHeaders)
@@ -42,7 +52,13 @@ void ccRemoveDefaultHeaders() {
 }
 
 void ccDefineMacro(const char *macro, const char *definition) {
-    predefinedMacros.add((char*)macro, (char*)definition);
+    // defined on the main thread, between the compilations
+    mainContext.error = 0;
+    predefinedMacros.add(mainContext, (char*)macro, (char*)definition);
+    if (mainContext.error) {
+        ccError = mainContext.error;
+        strcpy(ccErrorString, mainContext.errorString);
+    }
 }
 
 void ccClearAllMacros() {
@@ -54,44 +70,126 @@ void ccSetSoftwareVersion(const char *versionNumber) {
     ccSoftwareVersion = versionNumber;
 }
 
-ccScript* ccCompileText(const char *texo, const char *scriptName) {
+static void append_key(char *&buf, size_t &size, const void *data, size_t data_size) {
+    if (buf != NULL)
+        memcpy(buf + size, data, data_size);
+    size += data_size;
+}
+
+static void append_key_string(char *&buf, size_t &size, const char *text) {
+    append_key(buf, size, text, strlen(text) + 1);
+}
+
+// Puts the header texts, macros and options into one block, which is
+// compared with the one of the cached headers
+static char *make_header_cache_key(char **headers, char **headerNames, int count, size_t *key_size) {
+    int options = 0;
+    for (int bit = 0; bit < 16; bit++) {
+        if (ccGetOption(1 << bit))
+            options |= 1 << bit;
+    }
+
+    char *buf = NULL;
+    size_t size = 0;
+    // first pass counts the size, second one fills the block
+    for (int pass = 0; pass < 2; pass++) {
+        if (pass == 1)
+            buf = (char*)malloc(size);
+        size = 0;
+        append_key(buf, size, &options, sizeof(options));
+        append_key(buf, size, &count, sizeof(count));
+        for (int t = 0; t < count; t++) {
+            append_key_string(buf, size, (headerNames != NULL) && (headerNames[t] != NULL) ? headerNames[t] : "");
+            append_key_string(buf, size, headers[t]);
+        }
+        append_key(buf, size, &predefinedMacros.num, sizeof(predefinedMacros.num));
+        for (int mm = 0; mm < predefinedMacros.num; mm++) {
+            append_key_string(buf, size, predefinedMacros.name[mm]);
+            append_key_string(buf, size, predefinedMacros.macro[mm]);
+        }
+    }
+    *key_size = size;
+    return buf;
+}
+
+static void save_header_cache(ccCompilerContext &ctx, char *key, size_t key_size, ccCompiledScript *scrip) {
+    ccHeaderCache &headerCache = ctx.headerCache;
+    free(headerCache.key);
+    headerCache.key = key;
+    headerCache.keySize = key_size;
+    if (headerCache.symbols == NULL)
+        headerCache.symbols = new symbolTable();
+    headerCache.symbols->copy_from(ctx.sym);
+    delete headerCache.script;
+    headerCache.script = new ccCompiledScript();
+    headerCache.script->copy_from(*scrip);
+}
+
+// Fills the symbol table and the script with the headers, either compiled
+// now or copied from the ones the context compiled last time
+static void compile_headers(ccCompilerContext &ctx, ccCompiledScript *cctemp, char **headers, char **headerNames, int count) {
+    int t;
+    size_t key_size = 0;
+    char *key = count > 0 ? make_header_cache_key(headers, headerNames, count, &key_size) : NULL;
+    ccHeaderCache &headerCache = ctx.headerCache;
+    if ((key != NULL) && (headerCache.key != NULL) && (key_size == headerCache.keySize) &&
+        (memcmp(key, headerCache.key, key_size) == 0)) {
+        // the headers were compiled before, just take the result
+        free(key);
+        ctx.sym.copy_from(*headerCache.symbols);
+        cctemp->copy_from(*headerCache.script);
+    }
+    else {
+        ctx.sym.reset();
+        for (t=0;t<count;t++) {
+            if ((headerNames != NULL) && (headerNames[t] != NULL))
+                ctx.curScriptName = headerNames[t];
+            else
+                ctx.curScriptName = "Internal header file";
+
+            cctemp->start_new_section(ctx.curScriptName);
+            cc_compile(ctx, headers[t],cctemp);
+            if (ctx.error) break;
+        }
+
+        if ((key != NULL) && !ctx.error)
+            save_header_cache(ctx, key, key_size, cctemp);
+        else
+            free(key);
+    }
+}
+
+static ccScript *compile_text(ccCompilerContext &ctx, const char *texo, const char *scriptName,
+                              char **headers, char **headerNames, int numHeaders) {
     int t;
     ccCompiledScript *cctemp = new ccCompiledScript();
     cctemp->init();
 
-    sym.reset();
-    preproc_startup(&predefinedMacros);
-
     if (scriptName == NULL)
         scriptName = "Main script";
 
-    ccError = 0;
-    ccErrorLine = 0;
+    ctx.error = 0;
+    ctx.errorLine = 0;
 
-    for (t=0;t<numheaders;t++) {
-        if (defaultHeaderNames[t] != NULL)
-            ccCurScriptName = defaultHeaderNames[t];
-        else
-            ccCurScriptName = "Internal header file";
+    preproc_startup(ctx, &predefinedMacros);
 
-        cctemp->start_new_section(ccCurScriptName);
-        cc_compile(defaultheaders[t],cctemp);
-        if (ccError) break;
-    }
+    if (!ctx.error)
+        compile_headers(ctx, cctemp, headers, headerNames, numHeaders);
 
-    if (!ccError) {
-        ccCurScriptName = scriptName;
-        cctemp->start_new_section(ccCurScriptName);
-        cc_compile(texo,cctemp);
+    if (!ctx.error) {
+        ctx.curScriptName = scriptName;
+        cctemp->start_new_section(ctx.curScriptName);
+        cc_compile(ctx, texo,cctemp);
     }
-    preproc_shutdown();
+    preproc_shutdown(ctx);
 
-    if (ccError) {
+    if (ctx.error) {
         cctemp->shutdown();
         delete cctemp;
         return NULL;
     }
 
+    symbolTable &sym = ctx.sym;
     for (t=0;t<sym.numsymbols;t++) {
         int stype = sym.get_type(t);
         // blank out the name for imports that are not used, to save space
@@ -126,7 +224,7 @@ ccScript* ccCompileText(const char *texo, const char *scriptName) {
     if (ccGetOption(SCOPT_EXPORTALL)) {
         // export all functions
         for (t=0;t<cctemp->numfunctions;t++) {
-            if (cctemp->add_new_export(cctemp->functions[t],EXPORT_FUNCTION,
+            if (cctemp->add_new_export(ctx, cctemp->functions[t],EXPORT_FUNCTION,
                 cctemp->funccodeoffs[t], cctemp->funcnumparams[t]) == -1) {
                     cctemp->shutdown();
                     return NULL;
@@ -138,3 +236,111 @@ ccScript* ccCompileText(const char *texo, const char *scriptName) {
     cctemp->free_extra();
     return cctemp;
 }
+
+ccScript* ccCompileText(const char *texo, const char *scriptName) {
+    ccScript *compiled = compile_text(mainContext, texo, scriptName, defaultheaders, defaultHeaderNames, numheaders);
+    ccError = mainContext.error;
+    ccErrorLine = mainContext.errorLine;
+    strcpy(ccErrorString, mainContext.errorString);
+    ccCurScriptName = mainContext.curScriptName;
+    return compiled;
+}
+
+struct CompileBatch {
+    ccCompileJob *jobs;
+    int count;
+    volatile long nextJob;
+};
+
+static int take_next_job(CompileBatch *batch) {
+#if defined(WINDOWS_VERSION)
+    return InterlockedIncrement(&batch->nextJob) - 1;
+#else
+    return __sync_fetch_and_add(&batch->nextJob, 1);
+#endif
+}
+
+static void run_batch_jobs(ccCompilerContext &ctx, CompileBatch *batch) {
+    for (int idx = take_next_job(batch); idx < batch->count; idx = take_next_job(batch)) {
+        ccCompileJob *job = &batch->jobs[idx];
+        if (job->headers != NULL)
+            job->compiled = compile_text(ctx, job->script, job->scriptName, job->headers, job->headerNames, job->numHeaders);
+        else
+            job->compiled = compile_text(ctx, job->script, job->scriptName, defaultheaders, defaultHeaderNames, numheaders);
+        if (job->compiled == NULL) {
+            job->errorLine = ctx.errorLine;
+            strcpy(job->errorString, ctx.errorString);
+            strncpy(job->errorScriptName, ctx.curScriptName, sizeof(job->errorScriptName) - 1);
+            job->errorScriptName[sizeof(job->errorScriptName) - 1] = 0;
+        }
+        else {
+            job->errorLine = 0;
+            job->errorString[0] = 0;
+            job->errorScriptName[0] = 0;
+        }
+    }
+}
+
+#define MAX_BATCH_THREADS 32
+
+// Compiles the jobs in a context of its own
+static void run_batch_thread(CompileBatch *batch) {
+    ccCompilerContext *ctx = new ccCompilerContext();
+    run_batch_jobs(*ctx, batch);
+    delete ctx;
+}
+
+#if defined(WINDOWS_VERSION)
+typedef HANDLE BatchThread;
+
+static DWORD WINAPI batch_thread_proc(LPVOID data) {
+    run_batch_thread((CompileBatch*)data);
+    return 0;
+}
+
+static bool start_batch_thread(BatchThread *thread, CompileBatch *batch) {
+    *thread = CreateThread(NULL, 0, batch_thread_proc, batch, 0, NULL);
+    return *thread != NULL;
+}
+
+static void join_batch_thread(BatchThread thread) {
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+}
+#else
+typedef pthread_t BatchThread;
+
+static void *batch_thread_proc(void *data) {
+    run_batch_thread((CompileBatch*)data);
+    return NULL;
+}
+
+static bool start_batch_thread(BatchThread *thread, CompileBatch *batch) {
+    return pthread_create(thread, NULL, batch_thread_proc, batch) == 0;
+}
+
+static void join_batch_thread(BatchThread thread) {
+    pthread_join(thread, NULL);
+}
+#endif
+
+void ccCompileBatch(ccCompileJob *jobs, int count, int numThreads) {
+    CompileBatch batch;
+    batch.jobs = jobs;
+    batch.count = count;
+    batch.nextJob = 0;
+
+    // the calling thread compiles too, in the context of ccCompileText
+    int extraThreads = (numThreads < count ? numThreads : count) - 1;
+    if (extraThreads > MAX_BATCH_THREADS)
+        extraThreads = MAX_BATCH_THREADS;
+    BatchThread threads[MAX_BATCH_THREADS];
+    int numStarted = 0;
+    while ((numStarted < extraThreads) && start_batch_thread(&threads[numStarted], &batch))
+        numStarted++;
+
+    run_batch_jobs(mainContext, &batch);
+
+    for (int tt = 0; tt < numStarted; tt++)
+        join_batch_thread(threads[tt]);
+}
@@ -34,6 +34,24 @@ extern void ccSetSoftwareVersion(const char *version);
 // compile the script supplied, returns NULL on failure
 extern ccScript *ccCompileText(const char *script, const char *scriptName);
 
+// a script given to ccCompileBatch, and the result of its compilation
+struct ccCompileJob {
+    const char *scriptName;
+    const char *script;
+    char      **headers;              // NULL for the default headers
+    char      **headerNames;
+    int         numHeaders;
+    ccScript   *compiled;             // NULL on failure
+    int         errorLine;
+    char        errorString[400];
+    char        errorScriptName[256]; // script or header with the error
+};
+
+// compile several scripts which do not depend on each other, on up to
+// numThreads threads at once; the results are stored in the jobs.
+// Headers, macros and options must not change until it returns.
+extern void ccCompileBatch(ccCompileJob *jobs, int count, int numThreads);
+
 extern const char *ccSoftwareVersion;
 
 #endif // __CS_COMPILER_H
\ No newline at end of file
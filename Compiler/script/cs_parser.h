@@ -35,7 +35,8 @@ start
 #define __CS_PARSER_H
 
 #include "cc_compiledscript.h"
+#include "cc_compilercontext.h"
 
-extern int cc_compile(const char*inpl, ccCompiledScript*scrip);
+extern int cc_compile(ccCompilerContext &ctx, const char*inpl, ccCompiledScript*scrip);
 
 #endif // __CS_PARSER_H
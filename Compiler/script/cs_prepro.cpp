@@ -1,12 +1,12 @@
 
 #include "cs_prepro.h"
 
-void preproc_startup(MacroTable *preDefinedMacros) {
-    macros.init();
+void preproc_startup(ccCompilerContext &ctx, MacroTable *preDefinedMacros) {
+    ctx.macros.init();
     if (preDefinedMacros)
-        macros.merge(preDefinedMacros);
+        ctx.macros.merge(ctx, preDefinedMacros);
 }
 
-void preproc_shutdown() {
-    macros.shutdown();
+void preproc_shutdown(ccCompilerContext &ctx) {
+    ctx.macros.shutdown();
 }
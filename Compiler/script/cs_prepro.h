@@ -8,9 +8,9 @@
 #ifndef __CS_PREPRO_H
 #define __CS_PREPRO_H
 
-#include "cc_macrotable.h"
+#include "cc_compilercontext.h"
 
-extern void preproc_startup(MacroTable *preDefinedMacros);
-extern void preproc_shutdown();
+extern void preproc_startup(ccCompilerContext &ctx, MacroTable *preDefinedMacros);
+extern void preproc_shutdown(ccCompilerContext &ctx);
 
 #endif // __CS_PREPRO_H
@@ -0,0 +1,282 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+
+#ifdef _DEBUG
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "script/cs_compiler.h"
+#include "script/cc_error.h"
+#include "script/cc_compilercontext.h"
+#include "script/cc_macrotable.h"
+#include "debug/assert.h"
+#include "debug/out.h"
+
+namespace Out = AGS::Common::Out;
+
+const int TEST_MACRO_COUNT = 1000;
+const int TEST_IMPORT_COUNT = 3000;
+const int TEST_STRUCT_COUNT = 200;
+const int TEST_FUNCTION_COUNT = 50;
+const int TEST_CALLS_PER_FUNCTION = 40;
+const int TEST_MODULE_COUNT = 20;
+
+void Test_MacroTable()
+{
+    ccCompilerContext ctx;
+    MacroTable table;
+    table.add(ctx, "FIRST", "1");
+    table.add(ctx, "SECOND", "2");
+    assert(table.find_name("FIRST") == 0);
+    assert(table.find_name("SECOND") == 1);
+    assert(table.find_name("THIRD") < 0);
+
+    table.remove(ctx, 0);
+    assert(table.find_name("FIRST") < 0);
+    assert(table.find_name("SECOND") == 1);
+    table.add(ctx, "FIRST", "3");
+    assert(table.find_name("FIRST") == 2);
+    assert(ctx.error == 0);
+
+    // errors go to the context the table is used by
+    table.add(ctx, "SECOND", "4");
+    assert(ctx.error == 1);
+    ctx.error = 0;
+
+    MacroTable merged;
+    merged.merge(ctx, &table);
+    assert(merged.find_name("SECOND") == 1);
+    assert(merged.find_name("FIRST") == 2);
+    assert(ctx.error == 0);
+    table.shutdown();
+    assert(table.find_name("SECOND") < 0);
+    merged.shutdown();
+}
+
+// memcmp may not be given NULL, which the empty sections are
+bool Test_SameData(const void *a, const void *b, size_t size)
+{
+    return (size == 0) || (memcmp(a, b, size) == 0);
+}
+
+bool Test_ScriptsEqual(const ccScript *a, const ccScript *b)
+{
+    if (a->globaldatasize != b->globaldatasize || a->codesize != b->codesize ||
+        a->stringssize != b->stringssize || a->numfixups != b->numfixups ||
+        a->numimports != b->numimports || a->numexports != b->numexports ||
+        a->numSections != b->numSections)
+    {
+        return false;
+    }
+    if (!Test_SameData(a->globaldata, b->globaldata, a->globaldatasize) ||
+        !Test_SameData(a->code, b->code, a->codesize * sizeof(intptr_t)) ||
+        !Test_SameData(a->strings, b->strings, a->stringssize) ||
+        !Test_SameData(a->fixups, b->fixups, a->numfixups * sizeof(int32_t)) ||
+        !Test_SameData(a->fixuptypes, b->fixuptypes, a->numfixups) ||
+        !Test_SameData(a->export_addr, b->export_addr, a->numexports * sizeof(int32_t)) ||
+        !Test_SameData(a->sectionOffsets, b->sectionOffsets, a->numSections * sizeof(int32_t)))
+    {
+        return false;
+    }
+    for (int i = 0; i < a->numimports; ++i)
+    {
+        if (strcmp(a->imports[i], b->imports[i]) != 0)
+            return false;
+    }
+    for (int i = 0; i < a->numexports; ++i)
+    {
+        if (strcmp(a->exports[i], b->exports[i]) != 0)
+            return false;
+    }
+    for (int i = 0; i < a->numSections; ++i)
+    {
+        if (strcmp(a->sectionNames[i], b->sectionNames[i]) != 0)
+            return false;
+    }
+    return true;
+}
+
+// Scripts compiled after the headers were cached must come out the same as
+// the first one, and changing the headers must not reuse the stale state
+void Test_HeaderCache()
+{
+    char header1[] = "import int Sum(int a, int b);\nstruct Point {\n  int x;\n  int y;\n};\nint counter;\n";
+    char header2[] = "import int Twice(int a);\n";
+    const char *script =
+        "int Calc(int n) {\n  Point p;\n  p.x = Sum(n, counter);\n  counter++;\n  return p.x;\n}\n"
+        "export counter;\n";
+    const char *script2 = "int Calc2(int n) {\n  return Twice(Sum(n, 1));\n}\n";
+
+    ccAddDefaultHeader(header1, "Header1.ash");
+    ccScript *first = ccCompileText(script, "Test.asc");
+    ccScript *second = ccCompileText(script, "Test.asc");
+    assert(first != NULL && second != NULL);
+    assert(Test_ScriptsEqual(first, second));
+    delete second;
+
+    // the module must not change the cached header state
+    second = ccCompileText(script2, "Test2.asc");
+    assert(second == NULL);
+    ccAddDefaultHeader(header2, "Header2.ash");
+    second = ccCompileText(script2, "Test2.asc");
+    assert(second != NULL);
+    delete second;
+
+    ccRemoveDefaultHeaders();
+    ccAddDefaultHeader(header1, "Header1.ash");
+    second = ccCompileText(script, "Test.asc");
+    assert(second != NULL);
+    assert(Test_ScriptsEqual(first, second));
+    delete second;
+    delete first;
+    ccRemoveDefaultHeaders();
+}
+
+// Batch compilation must give the same scripts and errors as compiling the
+// scripts one by one, whatever the number of threads
+void Test_CompileBatch()
+{
+    const int job_count = 12;
+    char header[] = "import int Sum(int a, int b);\nstruct Point {\n  int x;\n  int y;\n};\n";
+    char scripts[job_count][300];
+    char names[job_count][20];
+    for (int i = 0; i < job_count; ++i)
+    {
+        sprintf(names[i], "Room%d.asc", i);
+        if (i % 5 == 3)
+        {
+            // errors are reported for their own job only
+            sprintf(scripts[i], "int Calc%d(int n) {\n  return Missing%d(n);\n}\n", i, i);
+        }
+        else
+        {
+            sprintf(scripts[i], "int Calc%d(int n) {\n  Point p;\n  p.x = Sum(n, %d);\n  return p.x;\n}\n"
+                "int value%d = %d;\nexport value%d;\n", i, i, i, i, i);
+        }
+    }
+
+    ccAddDefaultHeader(header, "Header.ash");
+    ccScript *expected[job_count];
+    char expected_errors[job_count][400];
+    for (int i = 0; i < job_count; ++i)
+    {
+        expected[i] = ccCompileText(scripts[i], names[i]);
+        strcpy(expected_errors[i], expected[i] == NULL ? ccErrorString : "");
+    }
+
+    // half of the jobs give the same header themselves
+    char *job_headers[] = { header };
+    char *job_header_names[] = { "Header.ash" };
+    ccCompileJob jobs[job_count];
+    for (int threads = 1; threads <= 4; threads += 3)
+    {
+        for (int i = 0; i < job_count; ++i)
+        {
+            jobs[i].scriptName = names[i];
+            jobs[i].script = scripts[i];
+            jobs[i].headers = (i % 2 == 0) ? job_headers : NULL;
+            jobs[i].headerNames = job_header_names;
+            jobs[i].numHeaders = 1;
+        }
+        ccCompileBatch(jobs, job_count, threads);
+        for (int i = 0; i < job_count; ++i)
+        {
+            assert((jobs[i].compiled == NULL) == (expected[i] == NULL));
+            if (expected[i] != NULL)
+            {
+                assert(Test_ScriptsEqual(expected[i], jobs[i].compiled));
+                delete jobs[i].compiled;
+            }
+            else
+            {
+                assert(strcmp(jobs[i].errorString, expected_errors[i]) == 0);
+                assert(strcmp(jobs[i].errorScriptName, names[i]) == 0);
+            }
+        }
+    }
+
+    for (int i = 0; i < job_count; ++i)
+    {
+        delete expected[i];
+    }
+    ccRemoveDefaultHeaders();
+}
+
+// Compiles the same large generated script several times, against a header
+// with many imports and macros, which is what most of the time goes to when
+// building a big game
+void Test_CompilerBenchmark()
+{
+    char name[40], value[20];
+    for (int i = 0; i < TEST_MACRO_COUNT; ++i)
+    {
+        sprintf(name, "CONST_%05d", i);
+        sprintf(value, "%d", i);
+        ccDefineMacro(name, value);
+    }
+
+    char *header = (char*)malloc(TEST_IMPORT_COUNT * 64 + TEST_STRUCT_COUNT * 128);
+    char *p = header;
+    for (int i = 0; i < TEST_IMPORT_COUNT; ++i)
+    {
+        p += sprintf(p, "import int Func_%05d(int a, int b);\n", i);
+    }
+    for (int i = 0; i < TEST_STRUCT_COUNT; ++i)
+    {
+        p += sprintf(p, "struct Obj_%03d {\n  int x;\n  int y;\n  import int Method(int v);\n};\n", i);
+    }
+
+    char *script = (char*)malloc(TEST_FUNCTION_COUNT * (TEST_CALLS_PER_FUNCTION + 4) * 64);
+    p = script;
+    for (int f = 0; f < TEST_FUNCTION_COUNT; ++f)
+    {
+        p += sprintf(p, "int run_%03d(int n) {\n  int total = 0;\n  Obj_%03d o;\n", f, f % TEST_STRUCT_COUNT);
+        for (int i = 0; i < TEST_CALLS_PER_FUNCTION; ++i)
+        {
+            p += sprintf(p, "  total += Func_%05d(%d, n) + o.x;\n", (f * 61 + i * 37) % TEST_IMPORT_COUNT, i);
+        }
+        p += sprintf(p, "  return total;\n}\n");
+    }
+
+    ccAddDefaultHeader(header, "Test.ash");
+    clock_t start = clock();
+    for (int m = 0; m < TEST_MODULE_COUNT; ++m)
+    {
+        ccScript *compiled = ccCompileText(script, "Test.asc");
+        assert(compiled != NULL);
+        delete compiled;
+    }
+    clock_t elapsed = clock() - start;
+    Out::FPrint("Compiled %d scripts in %d ms", TEST_MODULE_COUNT, (int)(elapsed * 1000 / CLOCKS_PER_SEC));
+
+    ccRemoveDefaultHeaders();
+    ccClearAllMacros();
+    free(script);
+    free(header);
+}
+
+void Test_Compiler()
+{
+    Test_MacroTable();
+    Test_HeaderCache();
+    Test_CompileBatch();
+    // the tests run at every start of the debug editor, so the timing
+    // is only done on demand
+    if (getenv("AGS_BENCHMARK") != NULL)
+        Test_CompilerBenchmark();
+}
+
+#endif // _DEBUG
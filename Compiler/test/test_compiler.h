@@ -0,0 +1,22 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+
+#ifdef _DEBUG
+
+// Runs the compiler tests; called when the editor's native library is
+// initialized, as the engine runs its own ones at start
+void Test_Compiler();
+void Test_CompilerBenchmark();
+
+#endif // _DEBUG
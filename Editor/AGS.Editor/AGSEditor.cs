@@ -758,6 +758,19 @@ namespace AGS.Editor
 		/// Preprocesses and then compiles the script using the supplied headers.
 		/// </summary>
 		public void CompileScript(Script script, List<Script> headers, CompileMessages errors, bool isRoomScript)
+		{
+			string[] preProcessedCode = PreprocessScript(script, headers, errors);
+			if (preProcessedCode != null)
+			{
+				Factory.NativeProxy.CompileScript(script, preProcessedCode, _game, isRoomScript);
+			}
+		}
+
+		/// <summary>
+		/// Preprocesses the headers and then the script, returns their texts
+		/// or null if the preprocessor reported errors.
+		/// </summary>
+		private string[] PreprocessScript(Script script, List<Script> headers, CompileMessages errors)
 		{
 			IPreprocessor preprocessor = CompilerFactory.CreatePreprocessor(AGS.Types.Version.AGS_EDITOR_VERSION);
 			DefineMacrosAccordingToGameSettings(preprocessor);
@@ -792,11 +805,9 @@ namespace AGS.Editor
 					}
 					errors.Add(newError);
 				}
+				return null;
 			}
-			else
-			{
-				Factory.NativeProxy.CompileScript(script, preProcessedCode.ToArray(), _game, isRoomScript);
-			}
+			return preProcessedCode.ToArray();
 		}
 
         private Script CompileDialogs(CompileMessages errors, bool rebuildAll)
@@ -814,6 +825,16 @@ namespace AGS.Editor
             return dialogScripts;
         }
 
+        private void PreprocessScriptForBatch(Script script, List<Script> headers, CompileMessages errors, List<Script> scriptsToCompile, List<string[]> preProcessedScripts)
+        {
+            string[] preProcessedCode = PreprocessScript(script, headers, errors);
+            if (preProcessedCode != null)
+            {
+                scriptsToCompile.Add(script);
+                preProcessedScripts.Add(preProcessedCode);
+            }
+        }
+
         private object CompileScripts(object parameter)
         {
             CompileScriptsParameters parameters = (CompileScriptsParameters)parameter;
@@ -827,22 +848,28 @@ namespace AGS.Editor
                 Script dialogScripts = CompileDialogs(errors, parameters.RebuildAll);
 
                 _game.ScriptsToCompile = new ScriptsAndHeaders();
+                List<Script> scriptsToCompile = new List<Script>();
+                List<string[]> preProcessedScripts = new List<string[]>();
 
                 foreach (Script script in GetInternalScriptModules())
                 {
-                    CompileScript(script, headers, errors, false);
+                    PreprocessScriptForBatch(script, headers, errors, scriptsToCompile, preProcessedScripts);
                     _game.ScriptsToCompile.Add(new ScriptAndHeader(null, script));
                 }
 
                 foreach (ScriptAndHeader scripts in _game.RootScriptFolder.AllItemsFlat)
                 {
                     headers.Add(scripts.Header);
-                    CompileScript(scripts.Script, headers, errors, false);
+                    PreprocessScriptForBatch(scripts.Script, headers, errors, scriptsToCompile, preProcessedScripts);
                     _game.ScriptsToCompile.Add(scripts);					
                 }
 
-                CompileScript(dialogScripts, headers, errors, false);
+                PreprocessScriptForBatch(dialogScripts, headers, errors, scriptsToCompile, preProcessedScripts);
                 _game.ScriptsToCompile.Add(new ScriptAndHeader(null, dialogScripts));
+
+                // Every script brings its own headers, so they are all compiled
+                // at once, on as many threads as there are processors
+                Factory.NativeProxy.CompileScripts(scriptsToCompile.ToArray(), preProcessedScripts.ToArray(), _game);
 			}
             catch (CompileMessage ex)
             {
@@ -380,6 +380,11 @@ namespace AGS.Editor
             _native.CompileScript(script, preProcessedData, game, isRoomScript);
         }
 
+        public void CompileScripts(Script[] scripts, string[][] preProcessedData, Game game)
+        {
+            _native.CompileScripts(scripts, preProcessedData, game);
+        }
+
         public void CompileGameToDTAFile(Game game, string fileName)
         {
             _native.CompileGameToDTAFile(game, fileName);
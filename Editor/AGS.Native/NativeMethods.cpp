@@ -12,6 +12,9 @@ see the license.txt for details.
 #include <stdlib.h>
 #include "NativeMethods.h"
 #include "util/string.h"
+#ifdef _DEBUG
+#include "test/test_compiler.h"
+#endif
 
 using namespace System::Runtime::InteropServices;
 
@@ -54,7 +57,7 @@ extern int extract_template_files(const char *templateFileName);
 extern int extract_room_template_files(const char *templateFileName, int newRoomNumber);
 extern void change_sprite_number(int oldNumber, int newNumber);
 extern void update_sprite_resolution(int spriteNum, bool isHighRes);
-extern void save_game(bool compressSprites);
+extern void save_game(bool compressSprites, bool lz4Sprites);
 extern bool reset_sprite_file();
 extern int GetSpriteResolutionMultiplier(int slot);
 extern void PaletteUpdated(cli::array<PaletteEntry^>^ newPalette);
@@ -135,6 +138,9 @@ namespace AGS
 
 		void NativeMethods::Initialize()
 		{
+#ifdef _DEBUG
+			Test_Compiler();
+#endif
 			if (!initialize_native())
 			{
 				throw gcnew AGS::Types::InvalidDataException("Native initialization failed.");
@@ -164,7 +170,7 @@ namespace AGS
 
 		void NativeMethods::SaveGame(Game ^game)
 		{
-			save_game(game->Settings->CompressSprites);
+			save_game(game->Settings->CompressSprites, game->Settings->SpriteCompressionMethod == SpriteCompressionMethod::LZ4);
 		}
 
 		void NativeMethods::GameSettingsChanged(Game ^game)
@@ -80,6 +80,7 @@ namespace AGS
 			void RenderBufferToHDC(int hDC) ;
 			String ^LoadRoomScript(String ^roomFileName);
 			void CompileScript(Script ^script, cli::array<String^> ^preProcessedScripts, Game ^game, bool isRoomScript);
+			void CompileScripts(cli::array<Script^> ^scripts, cli::array<cli::array<String^>^> ^preProcessedScripts, Game ^game);
 			void CompileGameToDTAFile(Game ^game, String^ fileName);
 			void CreateDataFile(cli::array<String^> ^fileList, long splitSize, String ^baseFileName, bool isGameEXE);
 			void CreateVOXFile(String ^fileName, cli::array<String^> ^fileList);
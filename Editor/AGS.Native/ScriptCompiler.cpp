@@ -106,6 +106,78 @@ namespace AGS
 			  script->CompiledData = gcnew CompiledScript(scrpt);
 		}
 
+		void NativeMethods::CompileScripts(cli::array<Script^> ^scripts, cli::array<cli::array<String^>^> ^preProcessedScripts, Game ^game)
+		{
+			// each script is compiled against headers of its own, given
+			// as the preprocessed texts before the script's own one
+			int count = scripts->Length;
+			ccCompileJob *jobs = new ccCompileJob[count];
+
+			ccRemoveDefaultHeaders();
+			ccSetSoftwareVersion(editorVersionNumber);
+
+			ccSetOption(SCOPT_EXPORTALL, 1);
+			ccSetOption(SCOPT_LINENUMBERS, 1);
+			ccSetOption(SCOPT_NOIMPORTOVERRIDE, 0);
+
+			ccSetOption(SCOPT_LEFTTORIGHT, game->Settings->LeftToRightPrecedence);
+			ccSetOption(SCOPT_OLDSTRINGS, !game->Settings->EnforceNewStrings);
+
+			for (int i = 0; i < count; i++)
+			{
+				scripts[i]->CompiledData = nullptr;
+
+				cli::array<String^> ^texts = preProcessedScripts[i];
+				int headerCount = texts->Length - 1;
+				jobs[i].headers = new char*[headerCount + 1];
+				jobs[i].headerNames = new char*[headerCount + 1];
+				jobs[i].numHeaders = headerCount;
+				for (int h = 0; h < headerCount; h++)
+				{
+					jobs[i].headers[h] = (char*)System::Runtime::InteropServices::Marshal::StringToHGlobalAnsi(texts[h]).ToPointer();
+					jobs[i].headerNames[h] = "Header";
+				}
+				jobs[i].script = (char*)System::Runtime::InteropServices::Marshal::StringToHGlobalAnsi(texts[headerCount]).ToPointer();
+				jobs[i].scriptName = (char*)System::Runtime::InteropServices::Marshal::StringToHGlobalAnsi(scripts[i]->FileName).ToPointer();
+			}
+
+			ccCompileBatch(jobs, count, System::Environment::ProcessorCount);
+
+			// report the first error, as if the scripts were compiled one by one
+			CompileMessage ^exceptionToThrow = nullptr;
+			for (int i = 0; i < count; i++)
+			{
+				if ((exceptionToThrow == nullptr) && (jobs[i].compiled == NULL))
+				{
+					exceptionToThrow = gcnew CompileError(gcnew String(jobs[i].errorString), gcnew String(jobs[i].errorScriptName), jobs[i].errorLine);
+				}
+
+				if (exceptionToThrow == nullptr)
+				{
+					scripts[i]->CompiledData = gcnew CompiledScript(jobs[i].compiled);
+				}
+				else
+				{
+					delete jobs[i].compiled;
+				}
+
+				System::Runtime::InteropServices::Marshal::FreeHGlobal(IntPtr((char*)jobs[i].script));
+				System::Runtime::InteropServices::Marshal::FreeHGlobal(IntPtr((char*)jobs[i].scriptName));
+				for (int h = 0; h < jobs[i].numHeaders; h++)
+				{
+					System::Runtime::InteropServices::Marshal::FreeHGlobal(IntPtr(jobs[i].headers[h]));
+				}
+				delete [] jobs[i].headers;
+				delete [] jobs[i].headerNames;
+			}
+			delete [] jobs;
+
+			if (exceptionToThrow != nullptr)
+			{
+				throw exceptionToThrow;
+			}
+		}
+
 		void NativeMethods::CompileGameToDTAFile(Game ^game, String^ fileName)
 		{
 			char fileNameBuffer[MAX_PATH];
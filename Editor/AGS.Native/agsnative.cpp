@@ -570,13 +570,13 @@ int load_template_file(const char *fileName, char **iconDataBuffer, long *iconDa
   return 0;
 }
 
-const char* save_sprites(bool compressSprites) 
+const char* save_sprites(SpriteCompression compressSprites) 
 {
   const char *errorMsg = NULL;
   char backupname[100];
   sprintf(backupname, "backup_%s", sprsetname);
 
-  if ((spritesModified) || (compressSprites != spriteset.spritesAreCompressed))
+  if ((spritesModified) || (compressSprites != spriteset.spriteCompression))
   {
     spriteset.detachFile();
     if (exists(backupname) && (unlink(backupname) != 0)) {
@@ -2646,9 +2646,12 @@ void ThrowManagedException(const char *message)
 	throw gcnew AGS::Types::AGSEditorException(gcnew String((const char*)message));
 }
 
-void save_game(bool compressSprites)
+void save_game(bool compressSprites, bool lz4Sprites)
 {
-	const char *errorMsg = save_sprites(compressSprites);
+	SpriteCompression compression = kSprCompress_None;
+	if (compressSprites)
+		compression = lz4Sprites ? kSprCompress_LZ4 : kSprCompress_RLE;
+	const char *errorMsg = save_sprites(compression);
 	if (errorMsg != NULL)
 	{
 		throw gcnew AGSEditorException(gcnew String(errorMsg));
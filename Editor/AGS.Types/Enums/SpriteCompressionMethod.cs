@@ -0,0 +1,15 @@
+﻿using System;
+using System.Collections.Generic;
+using System.ComponentModel;
+using System.Text;
+
+namespace AGS.Types
+{
+    public enum SpriteCompressionMethod
+    {
+        [Description("Run-length encoding (compatible with older engines)")]
+        RLE = 0,
+        [Description("LZ4 (faster loading, smaller high-colour sprites)")]
+        LZ4 = 1,
+    }
+}
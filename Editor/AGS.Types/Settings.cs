@@ -43,6 +43,7 @@ namespace AGS.Types
         private RoomTransitionStyle _roomTransition = RoomTransitionStyle.FadeOutAndIn;
         private bool _saveScreenshots = false;
         private bool _compressSprites = false;
+        private SpriteCompressionMethod _spriteCompressionMethod = SpriteCompressionMethod.RLE;
         private bool _inventoryCursors = true;
         private bool _handleInvInScript = false;
         private bool _displayMultipleInv = false;
@@ -170,6 +171,17 @@ namespace AGS.Types
             set { _compressSprites = value; }
         }
 
+        [DisplayName("Sprite file compression method")]
+        [Description("How to compress the sprite file, if it is compressed. LZ4 loads faster, but the game will not run on older engines")]
+        [DefaultValue(SpriteCompressionMethod.RLE)]
+        [Category("Compiler")]
+        [TypeConverter(typeof(EnumTypeConverter))]
+        public SpriteCompressionMethod SpriteCompressionMethod
+        {
+            get { return _spriteCompressionMethod; }
+            set { _spriteCompressionMethod = value; }
+        }
+
         [DisplayName("Save screenshots in save games")]
         [Description("A screenshot of the player's current position will be saved into the save games")]
         [DefaultValue(false)]
@@ -864,6 +876,7 @@ namespace AGS.Types
             _binaryFilesInSourceControl = false;
             _guiAlphaStyle = GUIAlphaStyle.Classic;
             _spriteAlphaStyle = SpriteAlphaStyle.Classic;
+            _spriteCompressionMethod = SpriteCompressionMethod.RLE;
             _runGameLoopsWhileDialogOptionsDisplayed = false;
             _inventoryHotspotMarker = new InventoryHotspotMarker();
             _useLowResCoordinatesInScript = true;
@@ -34,3 +34,18 @@ void SpriteCache::initFile_initNullSpriteParams(int vv)
   spriteheight[vv] = 0;
   offsets[vv] = 0;
 }
+
+void SpriteCache::prefetchSprites(const int *indexes, int count)
+{
+  // sprites are always loaded on demand
+}
+
+void SpriteCache::stopPrefetch()
+{
+  // do nothing
+}
+
+Common::Bitmap *SpriteCache::takePrefetchedSprite(int index)
+{
+  return NULL;
+}
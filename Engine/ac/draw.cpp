@@ -53,6 +53,7 @@
 #include "platform/base/agsplatformdriver.h"
 #include "plugin/agsplugin.h"
 #include "ac/spritecache.h"
+#include "ac/spritetransformcache.h"
 #include "gfx/ddb.h"
 #include "gfx/gfx_util.h"
 #include "gfx/graphicsdriver.h"
@@ -170,6 +171,8 @@ int thingsToDrawSize = 0;
 //GUIButton dummyguicontrol;
 Bitmap **guibg = NULL;
 IDriverDependantBitmap **guibgbmp = NULL;
+// GUIs are drawn there to compare with the last image
+Bitmap *gui_redraw_buffer = NULL;
 
 
 Bitmap *debugConsoleBuffer = NULL;
@@ -442,6 +445,9 @@ int _dirtyRowSize;
 InvalidRect dirtyRegions[MAXDIRTYREGIONS];
 int numDirtyRegions = 0;
 int numDirtyBytes = 0;
+// set for the room frames which the driver composes itself, redrawing
+// only the parts that changed since the last frame
+bool partial_room_redraw = false;
 
 int IRSpan::mergeSpan(int tx1, int tx2) {
     if ((tx1 > x2) || (tx2 < x1))
@@ -524,12 +530,10 @@ void update_invalid_region(Bitmap *ds, int x, int y, Bitmap *src) {
 }
 
 
-void update_invalid_region_and_reset(Bitmap *ds, int x, int y, Bitmap *src) {
+void reset_invalid_region() {
 
     int i;
 
-    update_invalid_region(ds, x, y, src);
-
     // screen has been updated, no longer dirty
     numDirtyRegions = 0;
     numDirtyBytes = 0;
@@ -539,6 +543,40 @@ void update_invalid_region_and_reset(Bitmap *ds, int x, int y, Bitmap *src) {
 
 }
 
+void update_invalid_region_and_reset(Bitmap *ds, int x, int y, Bitmap *src) {
+
+    update_invalid_region(ds, x, y, src);
+
+    reset_invalid_region();
+}
+
+// passes the dirty spans on to the graphics driver, which redraws
+// them along with the sprites that changed
+void invalidate_driver_region_and_reset() {
+
+    if (numDirtyRegions == WHOLESCREENDIRTY) {
+        gfxDriver->InvalidateRect(0, 0, scrnwid - 1, scrnhit - 1);
+    }
+    else {
+        int i, k, rowsInOne;
+        for (i = 0; i < scrnhit; i++) {
+            rowsInOne = 1;
+
+            // if there are rows with identical masks, do them all in one go
+            while ((i+rowsInOne < scrnhit) && (memcmp(&dirtyRow[i], &dirtyRow[i+rowsInOne], sizeof(IRRow)) == 0))
+                rowsInOne++;
+
+            const IRRow &dirty_row = dirtyRow[i];
+            for (k = 0; k < dirty_row.numSpans; k++)
+                gfxDriver->InvalidateRect(dirty_row.span[k].x1, i, dirty_row.span[k].x2, i + rowsInOne - 1);
+
+            i += (rowsInOne - 1);
+        }
+    }
+
+    reset_invalid_region();
+}
+
 int combine_new_rect(InvalidRect *r1, InvalidRect *r2) {
 
     // check if new rect is within old rect X-wise
@@ -652,6 +690,9 @@ void invalidate_rect(int x1, int y1, int x2, int y2) {
 
 
 void invalidate_sprite(int x1, int y1, IDriverDependantBitmap *pic) {
+    // the driver compares the sprites with the last frame's by itself
+    if (partial_room_redraw)
+        return;
     invalidate_rect(x1, y1, x1 + pic->GetWidth(), y1 + pic->GetHeight());
 }
 
@@ -1468,6 +1509,16 @@ int scale_and_flip_sprite(int useindx, int coldept, int zoom_level,
 }
 
 
+// Copies the image made before with the same transform into actsps[useindx];
+// returns false if there is none in the cache
+bool copy_transformed_sprite(int useindx, const SpriteTransform &transform) {
+    Bitmap *cached = get_transformed_sprite(transform);
+    if (cached == NULL)
+        return false;
+    actsps[useindx] = recycle_bitmap(actsps[useindx], cached->GetColorDepth(), cached->GetWidth(), cached->GetHeight());
+    actsps[useindx]->Blit(cached, 0, 0, 0, 0, cached->GetWidth(), cached->GetHeight());
+    return true;
+}
 
 // create the actsps[aa] image with the object drawn correctly
 // returns 1 if nothing at all has changed and actsps is still
@@ -1599,37 +1650,49 @@ int construct_object_gfx(int aa, int *drawnWidth, int *drawnHeight, bool alwaysU
             return 0;
     }
 
-    // Not cached, so draw the image
+    // Not cached, so draw the image, unless another object or character
+    // has needed the same one lately
+    SpriteTransform transform;
+    bool cacheTransform = (!hardwareAccelerated) &&
+        ((zoom_level != 100) || (isMirrored) || (tint_level > 0) || (light_level != 0)) &&
+        make_sprite_transform(transform, objs[aa].num, sprwidth, sprheight, isMirrored,
+            tint_level, tint_red, tint_green, tint_blue, tint_light, light_level);
 
-    int actspsUsed = 0;
-    if (!hardwareAccelerated)
-    {
-        // draw the base sprite, scaled and flipped as appropriate
-        actspsUsed = scale_and_flip_sprite(useindx, coldept, zoom_level,
-            objs[aa].num, sprwidth, sprheight, isMirrored);
-    }
-    else
+    if (!cacheTransform || !copy_transformed_sprite(useindx, transform))
     {
-        // ensure actsps exists
-        actsps[useindx] = recycle_bitmap(actsps[useindx], coldept, spritewidth[objs[aa].num], spriteheight[objs[aa].num]);
-    }
+        int actspsUsed = 0;
+        if (!hardwareAccelerated)
+        {
+            // draw the base sprite, scaled and flipped as appropriate
+            actspsUsed = scale_and_flip_sprite(useindx, coldept, zoom_level,
+                objs[aa].num, sprwidth, sprheight, isMirrored);
+        }
+        else
+        {
+            // ensure actsps exists
+            actsps[useindx] = recycle_bitmap(actsps[useindx], coldept, spritewidth[objs[aa].num], spriteheight[objs[aa].num]);
+        }
 
-    // direct read from source bitmap, where possible
-    Bitmap *comeFrom = NULL;
-    if (!actspsUsed)
-        comeFrom = spriteset[objs[aa].num];
+        // direct read from source bitmap, where possible
+        Bitmap *comeFrom = NULL;
+        if (!actspsUsed)
+            comeFrom = spriteset[objs[aa].num];
 
-    // apply tints or lightenings where appropriate, else just copy
-    // the source bitmap
-    if (((tint_level > 0) || (light_level != 0)) &&
-        (!hardwareAccelerated))
-    {
-        apply_tint_or_light(useindx, light_level, tint_level, tint_red,
-            tint_green, tint_blue, tint_light, coldept,
-            comeFrom);
-    }
-    else if (!actspsUsed) {
-        actsps[useindx]->Blit(spriteset[objs[aa].num],0,0,0,0,spritewidth[objs[aa].num],spriteheight[objs[aa].num]);
+        // apply tints or lightenings where appropriate, else just copy
+        // the source bitmap
+        if (((tint_level > 0) || (light_level != 0)) &&
+            (!hardwareAccelerated))
+        {
+            apply_tint_or_light(useindx, light_level, tint_level, tint_red,
+                tint_green, tint_blue, tint_light, coldept,
+                comeFrom);
+        }
+        else if (!actspsUsed) {
+            actsps[useindx]->Blit(spriteset[objs[aa].num],0,0,0,0,spritewidth[objs[aa].num],spriteheight[objs[aa].num]);
+        }
+
+        if (cacheTransform)
+            put_transformed_sprite(transform, actsps[useindx]);
     }
 
     // Re-use the bitmap if it's the same size
@@ -1934,38 +1997,51 @@ void prepare_characters_for_drawing() {
         // If cache needs to be re-drawn
         if (!charcache[aa].inUse) {
 
-            // create the base sprite in actsps[useindx], which will
-            // be scaled and/or flipped, as appropriate
-            int actspsUsed = 0;
-            if (!gfxDriver->HasAcceleratedStretchAndFlip())
-            {
-                actspsUsed = scale_and_flip_sprite(
-                    useindx, coldept, zoom_level, sppic,
-                    newwidth, newheight, isMirrored);
-            }
-            else 
-            {
-                // ensure actsps exists
-                actsps[useindx] = recycle_bitmap(actsps[useindx], coldept, spritewidth[sppic], spriteheight[sppic]);
-            }
+            // the same image may have been made lately for another
+            // character or object, or for this one in an earlier frame
+            SpriteTransform transform;
+            bool cacheTransform = (!gfxDriver->HasAcceleratedStretchAndFlip()) &&
+                ((zoom_level != 100) || (isMirrored) || (light_level != 0) || (tint_amount != 0)) &&
+                make_sprite_transform(transform, sppic, newwidth, newheight, isMirrored,
+                    tint_amount, tint_red, tint_green, tint_blue, tint_light, light_level);
+
+            if (!cacheTransform || !copy_transformed_sprite(useindx, transform)) {
+                // create the base sprite in actsps[useindx], which will
+                // be scaled and/or flipped, as appropriate
+                int actspsUsed = 0;
+                if (!gfxDriver->HasAcceleratedStretchAndFlip())
+                {
+                    actspsUsed = scale_and_flip_sprite(
+                        useindx, coldept, zoom_level, sppic,
+                        newwidth, newheight, isMirrored);
+                }
+                else 
+                {
+                    // ensure actsps exists
+                    actsps[useindx] = recycle_bitmap(actsps[useindx], coldept, spritewidth[sppic], spriteheight[sppic]);
+                }
 
-            our_eip = 335;
+                our_eip = 335;
 
-            if (((light_level != 0) || (tint_amount != 0)) &&
-                (!gfxDriver->HasAcceleratedStretchAndFlip())) {
-                    // apply the lightening or tinting
-                    Bitmap *comeFrom = NULL;
-                    // if possible, direct read from the source image
-                    if (!actspsUsed)
-                        comeFrom = spriteset[sppic];
+                if (((light_level != 0) || (tint_amount != 0)) &&
+                    (!gfxDriver->HasAcceleratedStretchAndFlip())) {
+                        // apply the lightening or tinting
+                        Bitmap *comeFrom = NULL;
+                        // if possible, direct read from the source image
+                        if (!actspsUsed)
+                            comeFrom = spriteset[sppic];
 
-                    apply_tint_or_light(useindx, light_level, tint_amount, tint_red,
-                        tint_green, tint_blue, tint_light, coldept,
-                        comeFrom);
-            }
-            else if (!actspsUsed) {
-                // no scaling, flipping or tinting was done, so just blit it normally
-                actsps[useindx]->Blit (spriteset[sppic], 0, 0, 0, 0, actsps[useindx]->GetWidth(), actsps[useindx]->GetHeight());
+                        apply_tint_or_light(useindx, light_level, tint_amount, tint_red,
+                            tint_green, tint_blue, tint_light, coldept,
+                            comeFrom);
+                }
+                else if (!actspsUsed) {
+                    // no scaling, flipping or tinting was done, so just blit it normally
+                    actsps[useindx]->Blit (spriteset[sppic], 0, 0, 0, 0, actsps[useindx]->GetWidth(), actsps[useindx]->GetHeight());
+                }
+
+                if (cacheTransform)
+                    put_transformed_sprite(transform, actsps[useindx]);
             }
 
             // update the character cache with the new image
@@ -2080,7 +2156,13 @@ void draw_screen_background(Bitmap *ds) {
     if (play.screen_tint >= 0)
         invalidate_screen();
 
-    if (gfxDriver->RequiresFullRedrawEachFrame())
+    if (partial_room_redraw)
+    {
+        invalidate_driver_region_and_reset();
+        gfxDriver->EnablePartialRedraw(true);
+    }
+
+    if (gfxDriver->RequiresFullRedrawEachFrame() || partial_room_redraw)
     {
         if (roomBackgroundBmp == NULL) 
         {
@@ -2166,6 +2248,103 @@ void draw_fps()
     draw_and_invalidate_text(ds, get_fixed_pixel_size(250), yp, FONT_SPEECH, text_color, tbuffer);
 }
 
+// Finds the rectangle around the pixels which differ between the images
+bool find_changed_rect(Bitmap *was, Bitmap *now, Rect &changed)
+{
+    const int height = now->GetHeight();
+    const int bpp = now->GetBPP();
+    const int line_size = now->GetWidth() * bpp;
+    int top = 0;
+    while ((top < height) && (memcmp(was->GetScanLine(top), now->GetScanLine(top), line_size) == 0))
+        top++;
+    if (top == height)
+        return false;
+    int bottom = height - 1;
+    while (memcmp(was->GetScanLine(bottom), now->GetScanLine(bottom), line_size) == 0)
+        bottom--;
+
+    // only the bytes outside of the columns found so far are compared
+    int left = now->GetWidth();
+    int right = -1;
+    for (int y = top; y <= bottom; y++)
+    {
+        const uint8_t *line_was = was->GetScanLine(y);
+        const uint8_t *line_now = now->GetScanLine(y);
+        int first = 0;
+        while ((first < left * bpp) && (line_was[first] == line_now[first]))
+            first++;
+        if (first < left * bpp)
+            left = first / bpp;
+        int last = line_size - 1;
+        while ((last >= (right + 1) * bpp) && (line_was[last] == line_now[last]))
+            last--;
+        if (last >= (right + 1) * bpp)
+            right = last / bpp;
+    }
+    changed = Rect(left, top, right, bottom);
+    return true;
+}
+
+// Draws the GUI again and updates its texture. The first time the image is
+// drawn right into the GUI bitmap; later it is drawn into a spare one, and
+// only the part that differs is copied over and updated in the texture.
+void redraw_gui_image(int guinum)
+{
+    GUIMain *gui = &guis[guinum];
+    if (guibg[guinum] == NULL)
+        recreate_guibg_image(gui);
+
+    Bitmap *image = guibg[guinum];
+    if (guibgbmp[guinum] != NULL)
+    {
+        if ((gui_redraw_buffer == NULL) ||
+            (gui_redraw_buffer->GetWidth() < gui->wid) || (gui_redraw_buffer->GetHeight() < gui->hit) ||
+            (gui_redraw_buffer->GetColorDepth() != image->GetColorDepth()))
+        {
+            int width = (gui_redraw_buffer && (gui_redraw_buffer->GetWidth() > gui->wid)) ? gui_redraw_buffer->GetWidth() : gui->wid;
+            int height = (gui_redraw_buffer && (gui_redraw_buffer->GetHeight() > gui->hit)) ? gui_redraw_buffer->GetHeight() : gui->hit;
+            delete gui_redraw_buffer;
+            gui_redraw_buffer = BitmapHelper::CreateBitmap(width, height, image->GetColorDepth());
+        }
+        image = BitmapHelper::CreateSubBitmap(gui_redraw_buffer, RectWH(0, 0, gui->wid, gui->hit));
+    }
+
+    our_eip = 370;
+    image->ClearTransparent();
+    our_eip = 372;
+    gui->draw_at(image, 0, 0);
+    our_eip = 373;
+
+    bool isAlpha = false;
+    if (gui->is_alpha()) 
+    {
+        isAlpha = true;
+
+        if ((game.options[OPT_NEWGUIALPHA] == kGuiAlphaRender_Classic) && (gui->bgpic > 0))
+        {
+            // old-style (pre-3.0.2) GUI alpha rendering
+            repair_alpha_channel(image, spriteset[gui->bgpic]);
+        }
+    }
+
+    if (guibgbmp[guinum] == NULL)
+    {
+        guibgbmp[guinum] = gfxDriver->CreateDDBFromBitmap(image, isAlpha);
+    }
+    else
+    {
+        Rect changed;
+        if (find_changed_rect(guibg[guinum], image, changed))
+        {
+            guibg[guinum]->Blit(image, changed.Left, changed.Top, changed.Left, changed.Top,
+                changed.GetWidth(), changed.GetHeight());
+            gfxDriver->UpdateDDBFromBitmapRect(guibgbmp[guinum], guibg[guinum], isAlpha, changed);
+        }
+        delete image;
+    }
+    our_eip = 374;
+}
+
 // draw_screen_overlay: draws any stuff currently on top of the background,
 // like a message box or popup interface
 void draw_screen_overlay() {
@@ -2205,45 +2384,17 @@ void draw_screen_overlay() {
         }*/
         our_eip = 37;
         if (guis_need_update) {
-            //Bitmap *abufwas = ds;
             guis_need_update = 0;
-            for (aa=0;aa<game.numgui;aa++) {
-                if (guis[aa].on<1) continue;
-
-                if (guibg[aa] == NULL)
-                    recreate_guibg_image(&guis[aa]);
-
-                eip_guinum = aa;
-                our_eip = 370;
-                guibg[aa]->ClearTransparent();
-                //ds = guibg[aa];
-                our_eip = 372;
-                guis[aa].draw_at(guibg[aa], 0,0);
-                our_eip = 373;
-
-                bool isAlpha = false;
-                if (guis[aa].is_alpha()) 
-                {
-                    isAlpha = true;
-
-                    if ((game.options[OPT_NEWGUIALPHA] == kGuiAlphaRender_Classic) && (guis[aa].bgpic > 0))
-                    {
-                        // old-style (pre-3.0.2) GUI alpha rendering
-                        repair_alpha_channel(guibg[aa], spriteset[guis[aa].bgpic]);
-                    }
-                }
+            for (aa=0;aa<game.numgui;aa++)
+                guis[aa].invalidate();
+        }
+        // the GUIs which are off keep the flag until they are turned on
+        for (aa=0;aa<game.numgui;aa++) {
+            if ((guis[aa].on<1) || !guis[aa].needsUpdate) continue;
 
-                if (guibgbmp[aa] != NULL) 
-                {
-                    gfxDriver->UpdateDDBFromBitmap(guibgbmp[aa], guibg[aa], isAlpha);
-                }
-                else
-                {
-                    guibgbmp[aa] = gfxDriver->CreateDDBFromBitmap(guibg[aa], isAlpha);
-                }
-                our_eip = 374;
-            }
-            //ds = abufwas;
+            guis[aa].needsUpdate = false;
+            eip_guinum = aa;
+            redraw_gui_image(aa);
         }
         our_eip = 38;
         // Draw the GUIs
@@ -2520,6 +2671,17 @@ void update_screen() {
 extern volatile int psp_audio_multithreaded; // in ac_audio
 
 
+// Tells whether the driver may keep the last room frame and redraw only
+// what changed; anything that draws straight onto the virtual screen
+// in the middle of the frame rules it out
+bool can_redraw_room_partially()
+{
+    return (displayed_room >= 0) && (!is_complete_overlay) &&
+        gfxDriver->UsesMemoryBackBuffer() && !gfxDriver->RequiresFullRedrawEachFrame() &&
+        !display_fps && !play.recording && !play.playback &&
+        !pl_any_want_hook(AGSE_PRESCREENDRAW | AGSE_PREGUIDRAW | AGSE_POSTSCREENDRAW | AGSE_FINALSCREENDRAW);
+}
+
 void construct_virtual_screen(bool fullRedraw) 
 {
     gfxDriver->ClearDrawList();
@@ -2529,6 +2691,12 @@ void construct_virtual_screen(bool fullRedraw)
 
     our_eip=3;
 
+    bool was_partial = partial_room_redraw;
+    partial_room_redraw = can_redraw_room_partially();
+    // the sprites of the last frame were not marked dirty
+    if (was_partial && !partial_room_redraw)
+        invalidate_screen();
+
     Bitmap *ds = GetVirtualScreen();
 
     gfxDriver->UseSmoothScaling(IS_ANTIALIAS_SPRITES);
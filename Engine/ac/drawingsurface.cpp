@@ -30,6 +30,7 @@
 #include "font/fonts.h"
 #include "gui/guimain.h"
 #include "ac/spritecache.h"
+#include "ac/spritetransformcache.h"
 #include "script/runtimescriptvalue.h"
 #include "gfx/gfx_util.h"
 
@@ -87,14 +88,11 @@ void DrawingSurface_Release(ScriptDrawingSurface* sds)
                 if (charcache[tt].sppic == sds->dynamicSpriteNumber)
                     charcache[tt].sppic = -31999;
             }
+            remove_transformed_sprites(sds->dynamicSpriteNumber);
             for (tt = 0; tt < game.numgui; tt++) 
             {
-                if ((guis[tt].bgpic == sds->dynamicSpriteNumber) &&
-                    (guis[tt].on == 1))
-                {
-                    guis_need_update = 1;
-                    break;
-                }
+                if (guis[tt].bgpic == sds->dynamicSpriteNumber)
+                    guis[tt].invalidate();
             }
         }
 
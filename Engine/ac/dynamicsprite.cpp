@@ -30,6 +30,7 @@
 #include "gui/dynamicarray.h"
 #include "gui/guibutton.h"
 #include "ac/spritecache.h"
+#include "ac/spritetransformcache.h"
 #include "platform/base/override_defines.h"
 #include "gfx/graphicsdriver.h"
 #include "script/runtimescriptvalue.h"
@@ -217,6 +218,8 @@ void DynamicSprite_CopyTransparencyMask(ScriptDynamicSprite *sds, int sourceSpri
             targetPixel += bytesPerPixel;
         }
     }
+
+    remove_transformed_sprites(sds->slot);
 }
 
 void DynamicSprite_ChangeCanvasSize(ScriptDynamicSprite *sds, int width, int height, int x, int y) 
@@ -534,6 +537,8 @@ void add_dynamic_sprite(int gotSlot, Bitmap *redin, bool hasAlpha) {
 
   spritewidth[gotSlot] = redin->GetWidth();
   spriteheight[gotSlot] = redin->GetHeight();
+
+  remove_transformed_sprites(gotSlot);
 }
 
 void free_dynamic_sprite (int gotSlot) {
@@ -551,6 +556,7 @@ void free_dynamic_sprite (int gotSlot) {
   game.spriteflags[gotSlot] = 0;
   spritewidth[gotSlot] = 0;
   spriteheight[gotSlot] = 0;
+  remove_transformed_sprites(gotSlot);
 
   // ensure it isn't still on any GUI buttons
   for (tt = 0; tt < numguibuts; tt++) {
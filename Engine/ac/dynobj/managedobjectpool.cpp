@@ -15,6 +15,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 #include "ac/dynobj/managedobjectpool.h"
 #include "ac/dynobj/cc_dynamicarray.h" // globalDynamicArray, constants
 #include "util/string_utils.h"               // fputstring, etc
@@ -23,6 +24,21 @@
 
 using AGS::Common::Stream;
 
+const int ADDRESS_INDEX_INITIAL_SIZE = 256;
+
+// Spreads pointer bits over the 32-bit hash (murmur3 finalizer)
+inline uint32_t HashAddress(const char *addr)
+{
+    uint64_t v = (uint64_t)(uintptr_t)addr;
+    uint32_t h = (uint32_t)(v ^ (v >> 32));
+    h ^= h >> 16;
+    h *= 0x85ebca6b;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35;
+    h ^= h >> 16;
+    return h;
+}
+
 void ManagedObjectPool::ManagedObject::init(int32_t theHandle, const char *theAddress,
                                             ICCDynamicObject *theCallback, ScriptValueType objType) {
     obj_type = objType;
@@ -102,32 +118,45 @@ int32_t ManagedObjectPool::AddRef(int32_t handle) {
 }
 
 int ManagedObjectPool::CheckDispose(int32_t handle) {
-    return objects[handle].CheckDispose();
+    const char *addr = objects[handle].addr;
+    if (objects[handle].CheckDispose()) {
+        OnObjectRemoved(handle, addr);
+        return 1;
+    }
+    return 0;
 }
 
 int32_t ManagedObjectPool::SubRef(int32_t handle) {
     if ((disableDisposeForObject != NULL) && 
         (objects[handle].addr == disableDisposeForObject))
         objects[handle].SubRefNoDispose();
-    else
-        objects[handle].SubRef();
+    else {
+        const char *addr = objects[handle].addr;
+        if (objects[handle].SubRef()) {
+            OnObjectRemoved(handle, addr);
+            return objects[handle].refCount;
+        }
+    }
+    // object was not disposed right away; let collector check it later
+    if (objects[handle].refCount < 1)
+        AddGCCandidate(handle);
     return objects[handle].refCount;
 }
 
 int32_t ManagedObjectPool::AddressToHandle(const char *addr) {
-    // this function is only called when a pointer is set
-    // SLOW LOOP ALERT, improve at some point
-    // [IKM] 2013-01-01: search in reverse order, as suggested by rofl0r:
-    // it appears that, statistically, the given address is more often
-    // located closer to the end of the managed array.
-    for (size_t i = numObjects - 1; i >= 1; --i)
+    // this function is called when a pointer is set
+    if (addr == NULL)
+        return 0;
+    // if same address was registered more than once, the highest handle
+    // wins, as it was when the object array was scanned in reverse order
+    int32_t handle = 0;
+    const uint32_t mask = addrIndexSize - 1;
+    for (uint32_t i = HashAddress(addr) & mask; addrIndex[i].addr != NULL; i = (i + 1) & mask)
     {
-        if (objects[i].addr == addr)
-        {
-            return objects[i].handle;
-        }
+        if (addrIndex[i].addr == addr && addrIndex[i].handle > handle)
+            handle = addrIndex[i].handle;
     }
-    return 0;
+    return handle;
 }
 
 const char* ManagedObjectPool::HandleToAddress(int32_t handle) {
@@ -157,69 +186,271 @@ int ManagedObjectPool::RemoveObject(const char *address) {
     if (handl == 0)
         return 0;
 
-    objects[handl].remove(true);
+    RemoveAt(handl, true);
+    return 1;
+}
+
+int ManagedObjectPool::RemoveAt(int32_t handle, bool force) {
+    const char *addr = objects[handle].addr;
+    if (objects[handle].remove(force) == 0)
+        return 0;
+    OnObjectRemoved(handle, addr);
     return 1;
 }
 
+void ManagedObjectPool::OnObjectRemoved(int32_t handle, const char *addr) {
+    IndexRemoveObject(handle, addr);
+    PushFreeSlot(handle);
+    numLiveObjects--;
+}
+
+void ManagedObjectPool::IndexAddObject(int32_t handle, const char *addr) {
+    if (addr == NULL)
+        return;
+    // keep the index at most half full, so that probe sequences stay short
+    if ((addrIndexCount + 1) * 2 > addrIndexSize)
+        ResizeIndex(addrIndexSize * 2);
+
+    const uint32_t mask = addrIndexSize - 1;
+    uint32_t i = HashAddress(addr) & mask;
+    while (addrIndex[i].addr != NULL)
+        i = (i + 1) & mask;
+    addrIndex[i].addr = addr;
+    addrIndex[i].handle = handle;
+    addrIndexCount++;
+}
+
+void ManagedObjectPool::IndexRemoveObject(int32_t handle, const char *addr) {
+    if (addr == NULL)
+        return;
+
+    const uint32_t mask = addrIndexSize - 1;
+    uint32_t i = HashAddress(addr) & mask;
+    for (; addrIndex[i].addr != NULL; i = (i + 1) & mask)
+    {
+        if (addrIndex[i].addr == addr && addrIndex[i].handle == handle)
+            break;
+    }
+    if (addrIndex[i].addr == NULL)
+        return; // not indexed
+
+    // shift back the following entries of the probe sequence, so that
+    // no "deleted" markers are required
+    uint32_t j = i;
+    while (true)
+    {
+        j = (j + 1) & mask;
+        if (addrIndex[j].addr == NULL)
+            break;
+        uint32_t home = HashAddress(addrIndex[j].addr) & mask;
+        // the entry may be moved into the hole only if its home slot
+        // does not lie cyclically between the hole and the entry itself
+        bool home_in_between = (i <= j) ? (i < home && home <= j) : (i < home || home <= j);
+        if (!home_in_between)
+        {
+            addrIndex[i] = addrIndex[j];
+            i = j;
+        }
+    }
+    addrIndex[i].addr = NULL;
+    addrIndex[i].handle = 0;
+    addrIndexCount--;
+}
+
+void ManagedObjectPool::ResizeIndex(int new_size) {
+    AddressIndexEntry *old_index = addrIndex;
+    int old_size = addrIndexSize;
+    addrIndex = (AddressIndexEntry*)calloc(sizeof(AddressIndexEntry), new_size);
+    addrIndexSize = new_size;
+    addrIndexCount = 0;
+    for (int i = 0; i < old_size; i++) {
+        if (old_index[i].addr != NULL)
+            IndexAddObject(old_index[i].handle, old_index[i].addr);
+    }
+    free(old_index);
+}
+
+void ManagedObjectPool::PushFreeSlot(int32_t handle) {
+    if (numFreeSlots == freeSlotsLimit) {
+        freeSlotsLimit += ARRAY_INCREMENT_SIZE;
+        freeSlots = (int32_t*)realloc(freeSlots, sizeof(int32_t) * freeSlotsLimit);
+    }
+    freeSlots[numFreeSlots++] = handle;
+}
+
+void ManagedObjectPool::AddGCCandidate(int32_t handle) {
+    // an entry stays valid after the object is removed, and is checked
+    // against whatever object occupies the slot at the time
+    if (objects[handle].gcCandidate)
+        return;
+    if (numGCCandidates == gcCandidatesLimit) {
+        gcCandidatesLimit += gcCandidatesLimit / 2 > ARRAY_INCREMENT_SIZE ? gcCandidatesLimit / 2 : ARRAY_INCREMENT_SIZE;
+        gcCandidates = (int32_t*)realloc(gcCandidates, sizeof(int32_t) * gcCandidatesLimit);
+    }
+    objects[handle].gcCandidate = true;
+    gcCandidates[numGCCandidates++] = handle;
+}
+
+void ManagedObjectPool::ResetIndex() {
+    memset(addrIndex, 0, sizeof(AddressIndexEntry) * addrIndexSize);
+    addrIndexCount = 0;
+    numFreeSlots = 0;
+    numGCCandidates = 0;
+    numLiveObjects = 0;
+}
+
+void ManagedObjectPool::RebuildIndex() {
+    ResetIndex();
+    for (int i = 1; i < numObjects; i++) {
+        objects[i].gcCandidate = false;
+        if (objects[i].handle) {
+            IndexAddObject(i, objects[i].addr);
+            numLiveObjects++;
+            if (objects[i].refCount < 1)
+                AddGCCandidate(i);
+        }
+        else
+            PushFreeSlot(i);
+    }
+}
+
+void ManagedObjectPool::CollectCandidates(int count)
+{
+    clock_t start = clock();
+
+    if (count > numGCCandidates)
+        count = numGCCandidates;
+    // the most recent candidates are checked first, as temporary objects
+    // usually lose their last reference soon after being created
+    for (; count > 0; count--)
+    {
+        int32_t handle = gcCandidates[--numGCCandidates];
+        objects[handle].gcCandidate = false;
+        if ((objects[handle].handle) && (objects[handle].refCount < 1) &&
+            (objects[handle].callback != NULL))
+        {
+            if (RemoveAt(handle, false))
+                gcStats.objectsFreed++;
+        }
+    }
+
+    gcStats.sweepTimeUs += (int)((clock() - start) * 1000000 / CLOCKS_PER_SEC);
+}
+
 void ManagedObjectPool::RunGarbageCollectionIfAppropriate()
 {
-    if (objectCreationCounter > GARBAGE_COLLECTION_INTERVAL)
+    // This is called after every script call, nested ones too, when the
+    // outer script may still hold a new object it has not stored yet; so
+    // the collection is only started every so many creations, as it was
+    // with the full sweeps, and goes on until every candidate was checked
+    if (objectCreationCounter <= GARBAGE_COLLECTION_INTERVAL)
+        return;
+    if (gcBudget <= 0)
     {
         objectCreationCounter = 0;
         RunGarbageCollection();
+        return;
     }
+
+    int count = numGCCandidates < gcBudgetLeft ? numGCCandidates : gcBudgetLeft;
+    // do not let the list grow indefinitely if scripts create temporary
+    // objects faster than the budget allows to dispose them
+    if (numGCCandidates - count > GARBAGE_COLLECTION_MAX_PENDING)
+        count = numGCCandidates - GARBAGE_COLLECTION_MAX_PENDING;
+    if (count == 0)
+        return;
+    gcBudgetLeft -= count < gcBudgetLeft ? count : gcBudgetLeft;
+    CollectCandidates(count);
+    if (numGCCandidates == 0)
+        objectCreationCounter = 0;
 }
 
 void ManagedObjectPool::RunGarbageCollection()
 {
     //write_log("Running garbage collection");
+    clock_t start = clock();
 
     for (int i = 1; i < numObjects; i++) 
     {
         if ((objects[i].refCount < 1) && (objects[i].callback != NULL)) 
         {
-            objects[i].remove(false);
+            if (RemoveAt(i, false))
+                gcStats.objectsFreed++;
         }
     }
+    // every object was checked, so pending candidates are not needed anymore
+    for (int i = 0; i < numGCCandidates; i++)
+        objects[gcCandidates[i]].gcCandidate = false;
+    numGCCandidates = 0;
+
+    gcStats.sweepTimeUs += (int)((clock() - start) * 1000000 / CLOCKS_PER_SEC);
 }
 
-int ManagedObjectPool::AddObject(const char *address, ICCDynamicObject *callback, bool plugin_object, int useSlot) {
-    if (useSlot == -1)
-        useSlot = numObjects;
+void ManagedObjectPool::SetGarbageCollectionBudget(int budget)
+{
+    gcBudget = budget;
+    gcBudgetLeft = budget;
+}
 
-    objectCreationCounter++;
+void ManagedObjectPool::StartGarbageCollectionTick()
+{
+    gcBudgetLeft = gcBudget;
+}
 
-    if (useSlot < arrayAllocLimit) {
-        // still space in the array, so use it
-        objects[useSlot].init(useSlot, address, callback, plugin_object ? kScValPluginObject : kScValDynamicObject);
-        if (useSlot == numObjects)
-            numObjects++;
-        return useSlot;
-    }
-    else {
-        // array has been used up
-        if (useSlot == numObjects) {
-            // if adding new (not un-serializing) check for empty slot
-            // check backwards, since newer objects don't tend to last
-            // long
-            for (int i = arrayAllocLimit - 1; i >= 1; i--) {
-                if (objects[i].handle == 0) {
-                    objects[i].init(i, address, callback, plugin_object ? kScValPluginObject : kScValDynamicObject);
-                    return i;
-                }
+const ManagedObjectPoolStats &ManagedObjectPool::GetGarbageCollectionStats()
+{
+    gcStats.poolSize = numLiveObjects;
+    gcStats.pendingCandidates = numGCCandidates;
+    return gcStats;
+}
+
+void ManagedObjectPool::ResetGarbageCollectionStats()
+{
+    gcStats.objectsFreed = 0;
+    gcStats.sweepTimeUs = 0;
+}
+
+int ManagedObjectPool::AddObject(const char *address, ICCDynamicObject *callback, bool plugin_object, int useSlot) {
+    if (useSlot == -1) {
+        // if adding new (not un-serializing) reuse the slot of removed object;
+        // entries may be outdated if slot was taken by un-serialized object
+        while (numFreeSlots > 0) {
+            int32_t slot = freeSlots[--numFreeSlots];
+            if ((slot < numObjects) && (objects[slot].handle == 0)) {
+                useSlot = slot;
+                break;
             }
         }
-        // no empty slots, expand array
+        if (useSlot == -1)
+            useSlot = numObjects;
+    }
+
+    objectCreationCounter++;
+
+    if (useSlot >= arrayAllocLimit) {
+        // array has been used up, expand it
+        int oldAllocLimit = arrayAllocLimit;
         while (useSlot >= arrayAllocLimit)
-            arrayAllocLimit += ARRAY_INCREMENT_SIZE;
+            arrayAllocLimit += arrayAllocLimit / 2 > ARRAY_INCREMENT_SIZE ? arrayAllocLimit / 2 : ARRAY_INCREMENT_SIZE;
 
         objects = (ManagedObject*)realloc(objects, sizeof(ManagedObject) * arrayAllocLimit);
-        memset(&objects[useSlot], 0, sizeof(ManagedObject) * ARRAY_INCREMENT_SIZE);
-        objects[useSlot].init(useSlot, address, callback, plugin_object ? kScValPluginObject : kScValDynamicObject);
-        if (useSlot == numObjects)
-            numObjects++;
-        return useSlot;
+        memset(&objects[oldAllocLimit], 0, sizeof(ManagedObject) * (arrayAllocLimit - oldAllocLimit));
     }
+    else if (objects[useSlot].handle) {
+        // un-serialized object replaces existing one
+        IndexRemoveObject(useSlot, objects[useSlot].addr);
+        numLiveObjects--;
+    }
+
+    objects[useSlot].init(useSlot, address, callback, plugin_object ? kScValPluginObject : kScValDynamicObject);
+    IndexAddObject(useSlot, address);
+    numLiveObjects++;
+    if (useSlot >= numObjects)
+        numObjects = useSlot + 1;
+    // new object has no references yet, and is disposed unless script
+    // stores it somewhere before the next collection
+    AddGCCandidate(useSlot);
+    return useSlot;
 }
 
 void ManagedObjectPool::WriteToDisk(Stream *out) {
@@ -282,6 +513,7 @@ int ManagedObjectPool::ReadFromDisk(Stream *in, ICCObjectReader *reader) {
         objects = (ManagedObject*)calloc(sizeof(ManagedObject), arrayAllocLimit);
     }
     numObjects = numObjs;
+    ResetIndex();
 
     for (int i = 1; i < numObjs; i++) {
         fgetstring_limit(typeNameBuffer, in, 199);
@@ -307,6 +539,7 @@ int ManagedObjectPool::ReadFromDisk(Stream *in, ICCObjectReader *reader) {
     }
 
     free(serializeBuffer);
+    RebuildIndex();
     return 0;
 }
 
@@ -318,12 +551,27 @@ void ManagedObjectPool::reset() {
     }
     memset(&objects[0], 0, sizeof(ManagedObject) * arrayAllocLimit);
     numObjects = 1;
+    ResetIndex();
 }
 
 ManagedObjectPool::ManagedObjectPool() {
     numObjects = 1;
     arrayAllocLimit = 10;
     objects = (ManagedObject*)calloc(sizeof(ManagedObject), arrayAllocLimit);
+    addrIndexSize = ADDRESS_INDEX_INITIAL_SIZE;
+    addrIndexCount = 0;
+    addrIndex = (AddressIndexEntry*)calloc(sizeof(AddressIndexEntry), addrIndexSize);
+    freeSlots = NULL;
+    numFreeSlots = 0;
+    freeSlotsLimit = 0;
+    gcCandidates = NULL;
+    numGCCandidates = 0;
+    gcCandidatesLimit = 0;
+    gcBudget = GARBAGE_COLLECTION_DEFAULT_BUDGET;
+    gcBudgetLeft = gcBudget;
+    memset(&gcStats, 0, sizeof(gcStats));
+    numLiveObjects = 0;
+    objectCreationCounter = 0;
     disableDisposeForObject = NULL;
 }
 
@@ -24,6 +24,18 @@ using namespace AGS; // FIXME later
 #define SERIALIZE_BUFFER_SIZE 10240
 const int ARRAY_INCREMENT_SIZE = 100;
 const int GARBAGE_COLLECTION_INTERVAL = 100;
+// Default number of collection candidates checked per game tick
+const int GARBAGE_COLLECTION_DEFAULT_BUDGET = 500;
+// When more candidates are pending, the excess is collected regardless of budget
+const int GARBAGE_COLLECTION_MAX_PENDING = 10000;
+
+// Counters of the incremental garbage collector
+struct ManagedObjectPoolStats {
+    int objectsFreed;       // objects disposed by the collector since last reset
+    int poolSize;           // number of live objects
+    int pendingCandidates;  // candidates waiting to be checked
+    int sweepTimeUs;        // time spent collecting since last reset, in microseconds
+};
 
 struct ManagedObjectPool {
     struct ManagedObject {
@@ -32,6 +44,7 @@ struct ManagedObjectPool {
         const char *addr;
         ICCDynamicObject * callback;
         int  refCount;
+        bool gcCandidate; // handle is registered in the collection candidate list
 
         void init(int32_t theHandle, const char *theAddress,
             ICCDynamicObject *theCallback, ScriptValueType objType);
@@ -42,11 +55,49 @@ struct ManagedObjectPool {
         void SubRefNoDispose();
     };
 private:
+    // Entry of the open-addressing hash table, which maps object's
+    // address to its handle
+    struct AddressIndexEntry {
+        const char *addr;   // NULL means free slot
+        int32_t handle;
+    };
 
     ManagedObject *objects;
     int arrayAllocLimit;
     int numObjects;  // not actually numObjects, but the highest index used
     int objectCreationCounter;  // used to do garbage collection every so often
+    int numLiveObjects;
+
+    AddressIndexEntry *addrIndex;
+    int addrIndexSize;  // number of index slots, always power of two
+    int addrIndexCount; // number of used index slots
+    // Handles of removed objects, reused before the array is expanded
+    int32_t *freeSlots;
+    int numFreeSlots;
+    int freeSlotsLimit;
+    // Handles of objects which had no references at some point; these are
+    // the only ones checked by the incremental collector
+    int32_t *gcCandidates;
+    int numGCCandidates;
+    int gcCandidatesLimit;
+    int gcBudget;       // candidates to check per game tick, 0 for full sweeps
+    int gcBudgetLeft;   // candidates which may still be checked during this tick
+    ManagedObjectPoolStats gcStats;
+
+    // Removes object and unregisters it from the address index
+    int  RemoveAt(int32_t handle, bool force);
+    void OnObjectRemoved(int32_t handle, const char *addr);
+    void IndexAddObject(int32_t handle, const char *addr);
+    void IndexRemoveObject(int32_t handle, const char *addr);
+    void ResizeIndex(int new_size);
+    void PushFreeSlot(int32_t handle);
+    void AddGCCandidate(int32_t handle);
+    // Checks given number of candidates from the end of the list, removing
+    // the ones which are still not referenced
+    void CollectCandidates(int count);
+    void ResetIndex();
+    // Recreates address index and list of free slots from the object array
+    void RebuildIndex();
 
 public:
 
@@ -57,8 +108,17 @@ public:
     const char* HandleToAddress(int32_t handle);
     ScriptValueType HandleToAddressAndManager(int32_t handle, void *&object, ICCDynamicObject *&manager);
     int RemoveObject(const char *address);
+    // Collects garbage once GARBAGE_COLLECTION_INTERVAL objects were created
+    // since the last collection was finished
     void RunGarbageCollectionIfAppropriate();
     void RunGarbageCollection();
+    // Sets number of candidates checked per game tick; 0 or less makes
+    // the pool sweep all objects every GARBAGE_COLLECTION_INTERVAL creations
+    void SetGarbageCollectionBudget(int budget);
+    // Renews the collection budget, should be called once per game tick
+    void StartGarbageCollectionTick();
+    const ManagedObjectPoolStats &GetGarbageCollectionStats();
+    void ResetGarbageCollectionStats();
     int AddObject(const char *address, ICCDynamicObject *callback, bool plugin_object, int useSlot = -1);
     void WriteToDisk(Common::Stream *out);
     int ReadFromDisk(Common::Stream *in, ICCObjectReader *reader);
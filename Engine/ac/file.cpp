@@ -191,17 +191,11 @@ int File_GetError(sc_File *fil) {
 
 //=============================================================================
 
-// [IKM] NOTE: this function is used only by few media/audio units
-// TODO: find a way to hide allegro behind some interface/wrapper function
-#if ALLEGRO_DATE > 19991010
-PACKFILE *pack_fopen(const char *filnam1, const char *modd1) {
-#else
-PACKFILE *pack_fopen(char *filnam1, char *modd1) {
-#endif
-  char  *filnam = (char *)filnam1;
-  char  *modd = (char *)modd1;
-  int   needsetback = 0;
-
+// Makes the data file named in "~library~asset" form of the asset name
+// the current one, and advances the name past it; returns whether the game
+// data file should be set back after the asset is opened
+static bool set_asset_library_from_name(char *&filnam)
+{
   if (filnam[0] == '~') {
     // ~ signals load from specific data file, not the main default one
     char gfname[80];
@@ -233,9 +227,43 @@ PACKFILE *pack_fopen(char *filnam1, char *modd1) {
       Common::AssetManager::SetDataFile(libname);
     }
     free(libname);
-    
-    needsetback = 1;
+    return true;
   }
+  return false;
+}
+
+// Opens the asset for reading right from the game data mapped into memory;
+// returns NULL if it is overridden by a file on disk, or is not in a library
+// which could be mapped
+Stream *open_mapped_asset(const char *filnam1)
+{
+  char *filnam = (char *)filnam1;
+  bool needsetback = set_asset_library_from_name(filnam);
+
+  Stream *in = NULL;
+  if ((Common::AssetManager::GetAssetOffset(filnam) >= 1) && !Common::File::TestReadFile(filnam)) {
+    in = Common::AssetManager::OpenAsset(filnam);
+    if (in && !in->GetDataAt(in->GetPosition())) {
+      delete in;
+      in = NULL;
+    }
+  }
+
+  if (needsetback)
+    Common::AssetManager::SetDataFile(game_file_name);
+  return in;
+}
+
+// [IKM] NOTE: this function is used only by few media/audio units
+// TODO: find a way to hide allegro behind some interface/wrapper function
+#if ALLEGRO_DATE > 19991010
+PACKFILE *pack_fopen(const char *filnam1, const char *modd1) {
+#else
+PACKFILE *pack_fopen(char *filnam1, char *modd1) {
+#endif
+  char  *filnam = (char *)filnam1;
+  char  *modd = (char *)modd1;
+  int   needsetback = set_asset_library_from_name(filnam) ? 1 : 0;
 
   // if the file exists, override the internal file
   bool file_exists = Common::File::TestReadFile(filnam);
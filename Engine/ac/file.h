@@ -41,6 +41,9 @@ int		File_GetError(sc_File *fil);
 
 void	get_current_dir_path(char* buffer, const char *fileName);
 bool	validate_user_file_path(const char *fnmm, char *output, bool currentDirOnly);
+// Opens the asset, named the same way as for pack_fopen, if its data can be
+// read straight from memory; otherwise returns NULL
+Common::Stream *open_mapped_asset(const char *filnam);
 
 struct ScriptFileHandle
 {
@@ -54,6 +54,7 @@
 #include "ac/runtime_defines.h"
 #include "ac/screenoverlay.h"
 #include "ac/spritecache.h"
+#include "ac/spritetransformcache.h"
 #include "ac/string.h"
 #include "ac/system.h"
 #include "ac/timer.h"
@@ -1677,6 +1678,8 @@ void restore_game_spriteset(Stream *in)
 
 void restore_game_clean_gfx()
 {
+    // the restored dynamic sprites may reuse the slots of the current ones
+    clear_transformed_sprites();
     for (int vv = 0; vv < game.numgui; vv++) {
         delete guibg[vv];
         guibg[vv] = NULL;
@@ -2711,12 +2714,9 @@ void display_switch_out() {
     if (set_display_switch_mode(SWITCH_BACKGROUND) == -1)
         set_display_switch_mode(SWITCH_BACKAMNESIA);
 
-    // stop the sound stuttering
-    for (int i = 0; i <= MAX_SOUND_CHANNELS; i++) {
-        if ((channels[i] != NULL) && (channels[i]->done == 0)) {
-            channels[i]->pause();
-        }
-    }
+    // stop the sound stuttering; the game thread pauses the clips
+    // while it is allowed to run in the background
+    audio_switched_out = 1;
 
     rest(1000);
 
@@ -2727,11 +2727,8 @@ void display_switch_out() {
 }
 
 void display_switch_in() {
-    for (int i = 0; i <= MAX_SOUND_CHANNELS; i++) {
-        if ((channels[i] != NULL) && (channels[i]->done == 0)) {
-            channels[i]->resume();
-        }
-    }
+    // the game thread resumes the clips on its next audio update
+    audio_switched_out = 0;
 
     // This can cause a segfault on Linux
 #if !defined (LINUX_VERSION)
@@ -59,7 +59,7 @@ void InterfaceOn(int ifn) {
     DEBUG_CONSOLE("GUIOn(%d) ignored (already on)", ifn);
     return;
   }
-  guis_need_update = 1;
+  guis[ifn].invalidate();
   guis[ifn].on=1;
   DEBUG_CONSOLE("GUI %d turned on", ifn);
   // modal interface
@@ -84,7 +84,7 @@ void InterfaceOff(int ifn) {
     guis[ifn].mouseover = -1;
   }
   guis[ifn].control_positions_changed();
-  guis_need_update = 1;
+  guis[ifn].invalidate();
   // modal interface
   if (guis[ifn].popup==POPUP_SCRIPT) UnPauseGame();
   else if (guis[ifn].popup==POPUP_MOUSEY) guis[ifn].on=-1;
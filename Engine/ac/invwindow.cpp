@@ -66,7 +66,7 @@ void InvWindow_SetCharacterToUse(GUIInv *guii, CharacterInfo *chaa) {
   // reset to top of list
   guii->topIndex = 0;
 
-  guis_need_update = 1;
+  guii->Invalidate();
 }
 
 CharacterInfo* InvWindow_GetCharacterToUse(GUIInv *guii) {
@@ -97,7 +97,7 @@ int InvWindow_GetItemHeight(GUIInv *guii) {
 void InvWindow_SetTopItem(GUIInv *guii, int topitem) {
   if (guii->topIndex != topitem) {
     guii->topIndex = topitem;
-    guis_need_update = 1;
+    guii->Invalidate();
   }
 }
 
@@ -121,7 +121,7 @@ void InvWindow_ScrollDown(GUIInv *guii) {
   if ((charextra[guii->CharToDisplay()].invorder_count) >
       (guii->topIndex + (guii->itemsPerLine * guii->numLines))) { 
     guii->topIndex += guii->itemsPerLine;
-    guis_need_update = 1;
+    guii->Invalidate();
   }
 }
 
@@ -131,7 +131,7 @@ void InvWindow_ScrollUp(GUIInv *guii) {
     if (guii->topIndex < 0)
       guii->topIndex = 0;
 
-    guis_need_update = 1;
+    guii->Invalidate();
   }
 }
 
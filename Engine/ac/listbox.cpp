@@ -22,7 +22,6 @@
 #include "ac/string.h"
 #include "gui/guimain.h"
 
-extern int guis_need_update;
 extern char saveGameDirectory[260];
 extern GameState play;
 extern GUIMain*guis;
@@ -34,7 +33,7 @@ int ListBox_AddItem(GUIListBox *lbb, const char *text) {
   if (lbb->AddItem(text) < 0)
     return 0;
 
-  guis_need_update = 1;
+  lbb->Invalidate();
   return 1;
 }
 
@@ -42,13 +41,13 @@ int ListBox_InsertItemAt(GUIListBox *lbb, int index, const char *text) {
   if (lbb->InsertItem(index, text) < 0)
     return 0;
 
-  guis_need_update = 1;
+  lbb->Invalidate();
   return 1;
 }
 
 void ListBox_Clear(GUIListBox *listbox) {
   listbox->Clear();
-  guis_need_update = 1;
+  listbox->Invalidate();
 }
 
 void ListBox_FillDirList(GUIListBox *listbox, const char *filemask) {
@@ -63,7 +62,7 @@ void ListBox_FillDirList(GUIListBox *listbox, const char *filemask) {
     dun = al_findnext(&dfb);
   }
   al_findclose(&dfb);
-  guis_need_update = 1;
+  listbox->Invalidate();
 }
 
 int ListBox_GetSaveGameSlots(GUIListBox *listbox, int index) {
@@ -128,7 +127,7 @@ int ListBox_FillSaveGameList(GUIListBox *listbox) {
     play.filenumbers[nn] = listbox->saveGameIndex[nn];
   }
 
-  guis_need_update = 1;
+  listbox->Invalidate();
   listbox->exflags |= GLF_SGINDEXVALID;
 
   if (numsaves >= MAXSAVEGAMES)
@@ -172,7 +171,7 @@ void ListBox_SetItemText(GUIListBox *listbox, int index, const char *newtext) {
 
   if (strcmp(listbox->items[index], newtext)) {
     listbox->SetItemText(index, newtext);
-    guis_need_update = 1;
+    listbox->Invalidate();
   }
 }
 
@@ -182,7 +181,7 @@ void ListBox_RemoveItem(GUIListBox *listbox, int itemIndex) {
     quit("!ListBoxRemove: invalid listindex specified");
 
   listbox->RemoveItem(itemIndex);
-  guis_need_update = 1;
+  listbox->Invalidate();
 }
 
 int ListBox_GetItemCount(GUIListBox *listbox) {
@@ -200,7 +199,7 @@ void ListBox_SetFont(GUIListBox *listbox, int newfont) {
 
   if (newfont != listbox->font) {
     listbox->ChangeFont(newfont);
-    guis_need_update = 1;
+    listbox->Invalidate();
   }
 
 }
@@ -213,7 +212,7 @@ void ListBox_SetHideBorder(GUIListBox *listbox, int newValue) {
   listbox->exflags &= ~GLF_NOBORDER;
   if (newValue)
     listbox->exflags |= GLF_NOBORDER;
-  guis_need_update = 1;
+  listbox->Invalidate();
 }
 
 int ListBox_GetHideScrollArrows(GUIListBox *listbox) {
@@ -224,7 +223,7 @@ void ListBox_SetHideScrollArrows(GUIListBox *listbox, int newValue) {
   listbox->exflags &= ~GLF_NOARROWS;
   if (newValue)
     listbox->exflags |= GLF_NOARROWS;
-  guis_need_update = 1;
+  listbox->Invalidate();
 }
 
 int ListBox_GetSelectedIndex(GUIListBox *listbox) {
@@ -246,7 +245,7 @@ void ListBox_SetSelectedIndex(GUIListBox *guisl, int newsel) {
       if (newsel >= guisl->topItem + guisl->num_items_fit)
         guisl->topItem = (newsel - guisl->num_items_fit) + 1;
     }
-    guis_need_update = 1;
+    guisl->Invalidate();
   }
 
 }
@@ -262,7 +261,7 @@ void ListBox_SetTopItem(GUIListBox *guisl, int item) {
     quit("!ListBoxSetTopItem: tried to set top to beyond top or bottom of list");
 
   guisl->topItem = item;
-  guis_need_update = 1;
+  guisl->Invalidate();
 }
 
 int ListBox_GetRowCount(GUIListBox *listbox) {
@@ -272,14 +271,14 @@ int ListBox_GetRowCount(GUIListBox *listbox) {
 void ListBox_ScrollDown(GUIListBox *listbox) {
   if (listbox->topItem + listbox->num_items_fit < listbox->numItems) {
     listbox->topItem++;
-    guis_need_update = 1;
+    listbox->Invalidate();
   }
 }
 
 void ListBox_ScrollUp(GUIListBox *listbox) {
   if (listbox->topItem > 0) {
     listbox->topItem--;
-    guis_need_update = 1;
+    listbox->Invalidate();
   }
 }
 
@@ -289,7 +288,7 @@ GUIListBox* is_valid_listbox (int guin, int objn) {
   if ((objn<0) | (objn>=guis[guin].numobjs)) quit("!ListBox: invalid object number");
   if (guis[guin].get_control_type(objn)!=GOBJ_LISTBOX)
     quit("!ListBox: specified control is not a list box");
-  guis_need_update = 1;
+  guis[guin].invalidate();
   return (GUIListBox*)guis[guin].objs[objn];
 }
 
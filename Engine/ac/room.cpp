@@ -40,7 +40,9 @@
 #include "ac/roomobject.h"
 #include "ac/roomstatus.h"
 #include "ac/screen.h"
+#include "ac/spritetransformcache.h"
 #include "ac/string.h"
+#include "ac/view.h"
 #include "ac/viewport.h"
 #include "ac/walkablearea.h"
 #include "ac/walkbehind.h"
@@ -50,6 +52,9 @@
 #include "debug/debug_log.h"
 #include "debug/debugger.h"
 #include "debug/out.h"
+#include "font/glyphcache.h"
+#include "gui/guibutton.h"
+#include "gui/guimain.h"
 #include "media/audio/audio.h"
 #include "platform/base/agsplatformdriver.h"
 #include "plugin/agsplugin.h"
@@ -127,6 +132,8 @@ extern Bitmap **guibg;
 extern IDriverDependantBitmap **guibgbmp;
 
 extern CCHotspot ccDynamicHotspot;
+extern ViewStruct*views;
+extern GUIMain*guis;
 extern CCObject ccDynamicObject;
 
 RGB_MAP rgb_table;  // for 256-col antialiasing
@@ -248,6 +255,8 @@ void unload_old_room() {
         return;
 
     Out::FPrint("Unloading room %d", displayed_room);
+    log_sprite_transform_cache_stats();
+    log_glyph_cache_stats();
 
     current_fade_out_effect();
 
@@ -392,6 +401,59 @@ extern int convert_16bit_bgr;
 
 #define NO_GAME_ID_IN_ROOM_FILE 16325
 // forchar = playerchar on NewRoom, or NULL if restore saved game
+// Adds all frames of the view to the sprite list
+void add_view_sprites(int view, int *&sprites, int &count, int &limit)
+{
+    if ((view < 0) || (view >= game.numviews))
+        return;
+    for (int loop = 0; loop < views[view].numLoops; loop++) {
+        ViewLoopNew &vloop = views[view].loops[loop];
+        if (count + vloop.numFrames > limit) {
+            limit = (count + vloop.numFrames) * 2;
+            sprites = (int*)realloc(sprites, limit * sizeof(int));
+        }
+        for (int frame = 0; frame < vloop.numFrames; frame++)
+            sprites[count++] = vloop.frames[frame].pic;
+    }
+}
+
+void prefetch_room_sprites()
+{
+    int count = 0;
+    int limit = croom->numobj + game.numgui + numguibuts * 3;
+    int *sprites = (int*)malloc((limit > 0 ? limit : 1) * sizeof(int));
+
+    // things seen first go first: the GUI and the room objects, then
+    // the animations of objects and characters
+    for (int cc = 0; cc < game.numgui; cc++) {
+        if (guis[cc].bgpic > 0)
+            sprites[count++] = guis[cc].bgpic;
+    }
+    for (int cc = 0; cc < numguibuts; cc++) {
+        if (guibuts[cc].pic > 0)
+            sprites[count++] = guibuts[cc].pic;
+        if (guibuts[cc].overpic > 0)
+            sprites[count++] = guibuts[cc].overpic;
+        if (guibuts[cc].pushedpic > 0)
+            sprites[count++] = guibuts[cc].pushedpic;
+    }
+    for (int cc = 0; cc < croom->numobj; cc++) {
+        if (objs[cc].on)
+            sprites[count++] = objs[cc].num;
+    }
+    for (int cc = 0; cc < croom->numobj; cc++) {
+        if (objs[cc].on)
+            add_view_sprites(objs[cc].view, sprites, count, limit);
+    }
+    for (int cc = 0; cc < game.numcharacters; cc++) {
+        if ((game.chars[cc].room == displayed_room) && (game.chars[cc].on))
+            add_view_sprites(game.chars[cc].view, sprites, count, limit);
+    }
+
+    spriteset.prefetchSprites(sprites, count);
+    free(sprites);
+}
+
 void load_new_room(int newnum, CharacterInfo*forchar) {
 
     Out::FPrint("Loading room %d", newnum);
@@ -929,6 +991,9 @@ void load_new_room(int newnum, CharacterInfo*forchar) {
     }
     color_map = NULL;
 
+    // start decoding the sprites while the rest of the room is set up
+    prefetch_room_sprites();
+
     our_eip = 209;
     update_polled_stuff_if_runtime();
     generate_light_table();
@@ -41,6 +41,9 @@ Common::Bitmap *fix_bitmap_size(Common::Bitmap *todubl);
 void  save_room_data_segment ();
 void  unload_old_room();
 void  convert_room_coordinates_to_low_res(roomstruct *rstruc);
+// Queues sprites which are likely to be drawn in the current room for
+// decoding in background
+void  prefetch_room_sprites();
 void  load_new_room(int newnum,CharacterInfo*forchar);
 void  new_room(int newnum,CharacterInfo*forchar);
 int   find_highest_room_entered();
@@ -63,7 +63,7 @@ int lastcx, lastcy;
 void line_callback(BITMAP *bmpp, int x, int y, int d)
 {
 /*  if ((x>=320) | (y>=200) | (x<0) | (y<0)) line_failed=1;
-  else */ if (getpixel(bmpp, x, y) < 1)
+  else */ if ((x < 0) || (y < 0) || (x >= bmpp->w) || (y >= bmpp->h) || (bmpp->line[y][x] < 1))
     line_failed = 1;
   else if (line_failed == 0) {
     lastcx = x;
@@ -129,27 +129,53 @@ int find_nearest_walkable_area(Bitmap *tempw, int fromX, int fromY, int toX, int
 
 #define MAX_GRANULARITY 3
 int walk_area_granularity[MAX_WALK_AREAS + 1];
-int is_route_possible(int fromx, int fromy, int tox, int toy, Bitmap *wss)
-{
-  wallscreen = wss;
-  suggestx = -1;
-
-  // ensure it's a memory bitmap, so we can use direct access to line[] array
-  if ((wss == NULL) || (!wss->IsMemoryBitmap()) || (wss->GetColorDepth() != 8))
-    quit("is_route_possible: invalid walkable areas bitmap supplied");
-
-  if (wallscreen->GetPixel(fromx, fromy) < 1)
-    return 0;
 
-  Bitmap *tempw = BitmapHelper::CreateBitmapCopy(wallscreen, 8);
+// Navigation data of the room's walkable areas. It only changes when the
+// areas are turned on or off, so it is made once rather than for every
+// route; characters and objects in the way are not taken into account.
+#define NAV_TILE_SIZE 8
+#define NAV_TILE_MIXED -1
+Bitmap *nav_walls = NULL;       // walkable areas the data was made for
+bool nav_walls_changed = false; // nav_walls were changed since then
+int nav_width = 0, nav_height = 0;
+// Connected part of the walkable areas each pixel belongs to, or 0 for
+// a wall; same pixels are joined as by the flood fill
+int *nav_labels = NULL;
+int nav_label_cells = 0;
+// Label of all the walkable pixels in the tile, 0 if there are none, or
+// NAV_TILE_MIXED if they belong to different parts
+int *nav_tiles = NULL;
+int nav_tiles_wide = 0, nav_tiles_high = 0;
+int nav_tile_cells = 0;
+// Label merges made while labelling the pixels
+int *nav_merge = NULL;
+int nav_merge_capacity = 0;
+// Walkable areas copy which the route check fills in
+Bitmap *route_fill_bitmap = NULL;
+
+int nav_find_label(int label)
+{
+  while (nav_merge[label] != label) {
+    nav_merge[label] = nav_merge[nav_merge[label]];
+    label = nav_merge[label];
+  }
+  return label;
+}
 
-  if (tempw == NULL)
-    quit("no memory for route calculation");
-  if (!tempw->IsMemoryBitmap())
-    quit("tempw is not memory bitmap");
+void nav_join_labels(int label1, int label2)
+{
+  label1 = nav_find_label(label1);
+  label2 = nav_find_label(label2);
+  if (label1 < label2)
+    nav_merge[label2] = label1;
+  else if (label2 < label1)
+    nav_merge[label1] = label2;
+}
 
+// Finds the average "width" of a path in each walkable area
+void calculate_walk_area_granularity(Bitmap *walls)
+{
   int dd, ff;
-  // initialize array for finding widths of walkable areas
   int thisar, inarow = 0, lastarea = 0;
   int walk_area_times[MAX_WALK_AREAS + 1];
   for (dd = 0; dd <= MAX_WALK_AREAS; dd++) {
@@ -157,10 +183,10 @@ int is_route_possible(int fromx, int fromy, int tox, int toy, Bitmap *wss)
     walk_area_granularity[dd] = 0;
   }
 
-  for (ff = 0; ff < tempw->GetHeight(); ff++) {
-    const uint8_t *tempw_scanline = tempw->GetScanLine(ff);
-    for (dd = 0; dd < tempw->GetWidth(); dd++) {
-      thisar = tempw_scanline[dd];
+  for (ff = 0; ff < walls->GetHeight(); ff++) {
+    const uint8_t *walls_scanline = walls->GetScanLine(ff);
+    for (dd = 0; dd < walls->GetWidth(); dd++) {
+      thisar = walls_scanline[dd];
       // count how high the area is at this point
       if ((thisar == lastarea) && (thisar > 0))
         inarow++;
@@ -175,12 +201,9 @@ int is_route_possible(int fromx, int fromy, int tox, int toy, Bitmap *wss)
     }
   }
 
-  for (dd = 0; dd < tempw->GetWidth(); dd++) {
-    for (ff = 0; ff < tempw->GetHeight(); ff++) {
-      uint8_t *tempw_scanline = tempw->GetScanLineForWriting(ff);
-      thisar = tempw_scanline[dd];
-      if (thisar > 0)
-        tempw_scanline[dd] = 1;
+  for (dd = 0; dd < walls->GetWidth(); dd++) {
+    for (ff = 0; ff < walls->GetHeight(); ff++) {
+      thisar = walls->GetScanLine(ff)[dd];
       // count how high the area is at this point
       if ((thisar == lastarea) && (thisar > 0))
         inarow++;
@@ -193,7 +216,6 @@ int is_route_possible(int fromx, int fromy, int tox, int toy, Bitmap *wss)
     }
   }
 
-  // find the average "width" of a path in this walkable area
   for (dd = 1; dd <= MAX_WALK_AREAS; dd++) {
     if (walk_area_times[dd] == 0) {
       walk_area_granularity[dd] = MAX_GRANULARITY;
@@ -213,6 +235,208 @@ int is_route_possible(int fromx, int fromy, int tox, int toy, Bitmap *wss)
        winalert(toprnt); */
   }
   walk_area_granularity[0] = MAX_GRANULARITY;
+}
+
+// Labels the connected parts of the walkable areas, in two passes: the
+// first gives each pixel the label of its left or upper neighbour and
+// records where the two differ, the second replaces them with the
+// merged ones
+void label_walkable_parts(Bitmap *walls)
+{
+  int cells = nav_width * nav_height;
+  if (cells > nav_label_cells) {
+    free(nav_labels);
+    nav_labels = (int *)malloc(sizeof(int) * cells);
+    nav_label_cells = cells;
+  }
+  nav_tiles_wide = (nav_width + NAV_TILE_SIZE - 1) / NAV_TILE_SIZE;
+  nav_tiles_high = (nav_height + NAV_TILE_SIZE - 1) / NAV_TILE_SIZE;
+  int tile_cells = nav_tiles_wide * nav_tiles_high;
+  if (tile_cells > nav_tile_cells) {
+    free(nav_tiles);
+    nav_tiles = (int *)malloc(sizeof(int) * tile_cells);
+    nav_tile_cells = tile_cells;
+  }
+  if ((nav_labels == NULL) || (nav_tiles == NULL))
+    quit("insufficient memory to allocate pathfinder navigation data");
+
+  int labels = 0;
+  int xx, yy;
+  for (yy = 0; yy < nav_height; yy++) {
+    const uint8_t *walls_scanline = walls->GetScanLine(yy);
+    int *row = nav_labels + yy * nav_width;
+    const int *above = row - nav_width;
+    for (xx = 0; xx < nav_width; xx++) {
+      if (walls_scanline[xx] == 0) {
+        row[xx] = 0;
+        continue;
+      }
+      int left = xx > 0 ? row[xx - 1] : 0;
+      int up = yy > 0 ? above[xx] : 0;
+      if (left && up) {
+        row[xx] = left;
+        if (left != up)
+          nav_join_labels(left, up);
+      }
+      else if (left || up) {
+        row[xx] = left | up;
+      }
+      else {
+        labels++;
+        if (labels >= nav_merge_capacity) {
+          nav_merge_capacity = nav_merge_capacity ? nav_merge_capacity * 2 : 256;
+          nav_merge = (int *)realloc(nav_merge, sizeof(int) * nav_merge_capacity);
+          if (nav_merge == NULL)
+            quit("insufficient memory to allocate pathfinder navigation data");
+        }
+        nav_merge[labels] = labels;
+        row[xx] = labels;
+      }
+    }
+  }
+
+  for (xx = 1; xx <= labels; xx++)
+    nav_merge[xx] = nav_find_label(xx);
+
+  for (xx = 0; xx < tile_cells; xx++)
+    nav_tiles[xx] = 0;
+
+  for (yy = 0; yy < nav_height; yy++) {
+    int *row = nav_labels + yy * nav_width;
+    int *tiles = nav_tiles + (yy / NAV_TILE_SIZE) * nav_tiles_wide;
+    for (xx = 0; xx < nav_width; xx++) {
+      if (row[xx] == 0)
+        continue;
+      row[xx] = nav_merge[row[xx]];
+      int &tile = tiles[xx / NAV_TILE_SIZE];
+      if (tile == 0)
+        tile = row[xx];
+      else if (tile != row[xx])
+        tile = NAV_TILE_MIXED;
+    }
+  }
+}
+
+void build_route_navigation(Bitmap *walls)
+{
+  if ((walls == NULL) || (!walls->IsMemoryBitmap()) || (walls->GetColorDepth() != 8))
+    quit("build_route_navigation: invalid walkable areas bitmap supplied");
+
+  nav_walls = walls;
+  nav_walls_changed = false;
+  nav_width = walls->GetWidth();
+  nav_height = walls->GetHeight();
+  calculate_walk_area_granularity(walls);
+  label_walkable_parts(walls);
+}
+
+void invalidate_route_navigation()
+{
+  nav_walls_changed = true;
+}
+
+// Same as find_nearest_walkable_area, but looks for the pixels in the
+// given connected part, skipping the tiles which do not have any
+int find_nearest_walkable_part(int label, int fromX, int fromY, int toX, int toY, int destX, int destY, int granularity)
+{
+  int ex, ey, nearest = 99999, thisis, nearx, neary;
+  if (fromX < 0) fromX = 0;
+  if (fromY < 0) fromY = 0;
+  if (toX >= nav_width) toX = nav_width - 1;
+  if (toY >= nav_height) toY = nav_height - 1;
+
+  for (ex = fromX; ex < toX; ex += granularity) 
+  {
+    const int *tiles = nav_tiles + ex / NAV_TILE_SIZE;
+    for (ey = fromY; ey < toY; ey += granularity) 
+    {
+      int tile = tiles[(ey / NAV_TILE_SIZE) * nav_tiles_wide];
+      if ((tile != label) && (tile != NAV_TILE_MIXED)) {
+        // jump to the last step inside this tile
+        int tile_end = (ey / NAV_TILE_SIZE + 1) * NAV_TILE_SIZE;
+        ey += ((tile_end - 1 - ey) / granularity) * granularity;
+        continue;
+      }
+      if ((nav_labels[ey * nav_width + ex] != label) || (wallscreen->GetScanLine(ey)[ex] == 0))
+        continue;
+
+      thisis = (int)::sqrt((double)((ex - destX) * (ex - destX) + (ey - destY) * (ey - destY)));
+      if (thisis < nearest)
+      {
+        nearest = thisis;
+        nearx = ex;
+        neary = ey;
+      }
+    }
+  }
+
+  if (nearest < 90000) {
+    suggestx = nearx;
+    suggesty = neary;
+    return 1;
+  }
+
+  return 0;
+}
+
+int is_route_possible(int fromx, int fromy, int tox, int toy, Bitmap *wss)
+{
+  wallscreen = wss;
+  suggestx = -1;
+
+  // ensure it's a memory bitmap, so we can use direct access to line[] array
+  if ((wss == NULL) || (!wss->IsMemoryBitmap()) || (wss->GetColorDepth() != 8))
+    quit("is_route_possible: invalid walkable areas bitmap supplied");
+
+  if (wallscreen->GetPixel(fromx, fromy) < 1)
+    return 0;
+
+  if (nav_walls_changed && (nav_walls != NULL))
+    build_route_navigation(nav_walls);
+  // the supplied areas may only have less walkable pixels than the ones
+  // the navigation data was made for; if there is none, make it for these
+  // and do not keep it for the next route
+  if ((nav_walls == NULL) || (nav_width != wss->GetWidth()) || (nav_height != wss->GetHeight())) {
+    build_route_navigation(wss);
+    nav_walls = NULL;
+  }
+
+  // if the destination is not in the same part of the walkable areas,
+  // then no characters or objects moving away will make it reachable
+  int from_label = nav_labels[fromy * nav_width + fromx];
+  if ((tox < 0) || (toy < 0) || (tox >= nav_width) || (toy >= nav_height) ||
+      (nav_labels[toy * nav_width + tox] != from_label))
+  {
+    // The pixels of the same part may still be cut off from the source by
+    // characters; then the next check from there finds the right one
+    int tryFirstX = tox - 50, tryToX = tox + 50;
+    int tryFirstY = toy - 50, tryToY = toy + 50;
+
+    if (!find_nearest_walkable_part(from_label, tryFirstX, tryFirstY, tryToX, tryToY, tox, toy, 3))
+      find_nearest_walkable_part(from_label, 0, 0, nav_width, nav_height, tox, toy, 5);
+    return 0;
+  }
+
+  if ((route_fill_bitmap == NULL) || (route_fill_bitmap->GetWidth() != wss->GetWidth()) ||
+      (route_fill_bitmap->GetHeight() != wss->GetHeight()))
+  {
+    delete route_fill_bitmap;
+    route_fill_bitmap = BitmapHelper::CreateBitmap(wss->GetWidth(), wss->GetHeight(), 8);
+  }
+  Bitmap *tempw = route_fill_bitmap;
+
+  if (tempw == NULL)
+    quit("no memory for route calculation");
+  if (!tempw->IsMemoryBitmap())
+    quit("tempw is not memory bitmap");
+
+  int dd, ff;
+  for (ff = 0; ff < tempw->GetHeight(); ff++) {
+    const uint8_t *wss_scanline = wss->GetScanLine(ff);
+    uint8_t *tempw_scanline = tempw->GetScanLineForWriting(ff);
+    for (dd = 0; dd < tempw->GetWidth(); dd++)
+      tempw_scanline[dd] = wss_scanline[dd] > 0 ? 1 : 0;
+  }
 
   tempw->FloodFill(fromx, fromy, 232);
   if (tempw->GetPixel(tox, toy) != 232) 
@@ -228,10 +452,8 @@ int is_route_possible(int fromx, int fromy, int tox, int toy, Bitmap *wss)
       find_nearest_walkable_area(tempw, 0, 0, tempw->GetWidth(), tempw->GetHeight(), tox, toy, 5);
     }
 
-    delete tempw;
     return 0;
   }
-  delete tempw;
 
   return 1;
 }
@@ -243,6 +465,8 @@ int pathbackstage = 0;
 int finalpartx = 0, finalparty = 0;
 short **beenhere = NULL;     //[200][320];
 int beenhere_array_size = 0;
+short *beenhere_buffer = NULL;
+int beenhere_buffer_cells = 0;
 const int BEENHERE_SIZE = 2;
 
 #define DIR_LEFT  0
@@ -341,23 +565,6 @@ try_again:
 }
 
 
-#define CHECK_MIN(cellx, celly) { \
-  if (beenhere[celly][cellx] == -1) {\
-    adjcount = 0; \
-    if ((wallscreen->GetScanLine(celly)[cellx] != 0) && (beenhere[j][i]+modifier <= min)) {\
-      if (beenhere[j][i]+modifier < min) { \
-        min = beenhere[j][i]+modifier; \
-        numfound = 0; } \
-      if (numfound < 40) { \
-        newcell[numfound] = (celly) * wallscreen->GetWidth() + (cellx);\
-        cheapest[numfound] = j * wallscreen->GetWidth() + i;\
-        numfound++; \
-      }\
-    } \
-  }}
-
-#define MAX_TRAIL_LENGTH 5000
-
 // Round down the supplied co-ordinates to the area granularity,
 // and move a bit if this causes them to become non-walkable
 void round_down_coords(int &tmpx, int &tmpy)
@@ -383,19 +590,124 @@ void round_down_coords(int &tmpx, int &tmpy)
   }
 }
 
-int find_route_dijkstra(int fromx, int fromy, int destx, int desty)
+// A* search state; it is kept between the searches, so that it is only
+// reallocated when the walkable area gets bigger. Cost and parent of the
+// cell are valid only if the cell is marked with the current search id.
+struct RouteNode
+{
+  int estimate;                 // cost so far plus the remaining distance
+  int cost;
+  int cell;
+};
+
+int *route_parent = NULL;
+int *route_cost = NULL;
+unsigned short *route_search_id = NULL;
+unsigned short route_current_search = 0;
+int route_arena_cells = 0;
+RouteNode *route_heap = NULL;
+int route_heap_size = 0;
+int route_heap_capacity = 0;
+// Step between the route nodes; 0 means use walkable area granularity
+int route_node_granularity = 0;
+
+void set_route_node_granularity(int granularity)
+{
+  // a longer step could jump over the destination box, which is only
+  // MAX_GRANULARITY pixels around the destination
+  if (granularity > MAX_GRANULARITY)
+    granularity = MAX_GRANULARITY;
+  route_node_granularity = granularity < 0 ? 0 : granularity;
+}
+
+void prepare_route_arena(int cells)
+{
+  if (cells > route_arena_cells) {
+    free(route_parent);
+    free(route_cost);
+    free(route_search_id);
+    route_parent = (int *)malloc(cells * sizeof(int));
+    route_cost = (int *)malloc(cells * sizeof(int));
+    route_search_id = (unsigned short *)calloc(cells, sizeof(unsigned short));
+    if ((route_parent == NULL) || (route_cost == NULL) || (route_search_id == NULL))
+      quit("insufficient memory to allocate pathfinder buffers");
+    route_arena_cells = cells;
+    route_current_search = 0;
+  }
+
+  route_current_search++;
+  if (route_current_search == 0) {
+    // ids wrapped around, forget all the old searches
+    memset(route_search_id, 0, route_arena_cells * sizeof(unsigned short));
+    route_current_search = 1;
+  }
+  route_heap_size = 0;
+}
+
+// Lower estimate goes first; of the equal ones, the one further from the
+// start, so that the search does not spread over open areas
+inline bool route_node_before(const RouteNode &a, const RouteNode &b)
 {
-  int i, j;
+  return (a.estimate < b.estimate) || ((a.estimate == b.estimate) && (a.cost > b.cost));
+}
 
+void route_heap_push(int estimate, int cost, int cell)
+{
+  if (route_heap_size == route_heap_capacity) {
+    route_heap_capacity = route_heap_capacity ? route_heap_capacity * 2 : 1024;
+    route_heap = (RouteNode *)realloc(route_heap, route_heap_capacity * sizeof(RouteNode));
+    if (route_heap == NULL)
+      quit("insufficient memory to allocate pathfinder buffers");
+  }
+
+  RouteNode node = { estimate, cost, cell };
+  int pos = route_heap_size++;
+  while (pos > 0) {
+    int up = (pos - 1) / 2;
+    if (!route_node_before(node, route_heap[up]))
+      break;
+    route_heap[pos] = route_heap[up];
+    pos = up;
+  }
+  route_heap[pos] = node;
+}
+
+RouteNode route_heap_pop()
+{
+  RouteNode top = route_heap[0];
+  RouteNode last = route_heap[--route_heap_size];
+  int pos = 0;
+  for (;;) {
+    int down = pos * 2 + 1;
+    if (down >= route_heap_size)
+      break;
+    if ((down + 1 < route_heap_size) && route_node_before(route_heap[down + 1], route_heap[down]))
+      down++;
+    if (!route_node_before(route_heap[down], last))
+      break;
+    route_heap[pos] = route_heap[down];
+    pos = down;
+  }
+  if (route_heap_size > 0)
+    route_heap[pos] = last;
+  return top;
+}
+
+// Distance from the point to the nearest point of the rectangle
+inline int route_distance_to_box(int x, int y, int left, int top, int right, int bottom)
+{
+  int dx = (x < left) ? left - x : ((x > right) ? x - right : 0);
+  int dy = (y < top) ? top - y : ((y > bottom) ? y - bottom : 0);
+  return dx + dy;
+}
+
+int find_route_astar(int fromx, int fromy, int destx, int desty)
+{
   // This algorithm doesn't behave differently the second time, so ignore
   if (leftorright == 1)
     return 0;
 
-  for (i = 0; i < wallscreen->GetHeight(); i++)
-    memset(&beenhere[i][0], 0xff, wallscreen->GetWidth() * BEENHERE_SIZE);
-
   round_down_coords(fromx, fromy);
-  beenhere[fromy][fromx] = 0;
 
   int temprd = destx, tempry = desty;
   round_down_coords(temprd, tempry);
@@ -405,163 +717,124 @@ int find_route_dijkstra(int fromx, int fromy, int destx, int desty)
     return 1;
   }
 
-  int allocsize = int (wallscreen->GetWidth()) * int (wallscreen->GetHeight()) * sizeof(int);
-  int *parent = (int *)malloc(allocsize);
-  int min = 999999, cheapest[40], newcell[40], replace[40];
-  int *visited = (int *)malloc(MAX_TRAIL_LENGTH * sizeof(int));
-  int iteration = 1;
-  visited[0] = fromy * wallscreen->GetWidth() + fromx;
-  parent[visited[0]] = -1;
+  const int width = wallscreen->GetWidth();
+  const int height = wallscreen->GetHeight();
+  prepare_route_arena(width * height);
 
-//  write_log("Pathfind starting");
-  int granularity = 3, newx = -1, newy, foundAnswer = -1, numreplace;
-  int changeiter, numfound, adjcount;
   int destxlow = destx - MAX_GRANULARITY;
   int destylow = desty - MAX_GRANULARITY;
   int destxhi = destxlow + MAX_GRANULARITY * 2;
   int destyhi = destylow + MAX_GRANULARITY * 2;
-  int modifier = 0;
-  int totalfound = 0;
-  int DIRECTION_BONUS = 0;
-
+  // edges of screen pose a problem, so if current and dest are within
+  // certain distance of the edge, say we've got it
+  bool destAtRightEdge = destx >= width - MAX_GRANULARITY;
+  bool destAtBottomEdge = desty >= height - MAX_GRANULARITY;
+
+  int startcell = fromy * width + fromx;
+  route_search_id[startcell] = route_current_search;
+  route_cost[startcell] = 0;
+  route_parent[startcell] = -1;
+  route_heap_push(route_distance_to_box(fromx, fromy, destxlow, destylow, destxhi, destyhi), 0, startcell);
+
+  int foundAnswer = -1;
+  int expanded = 0;
   update_polled_stuff_if_runtime();
 
-  while (foundAnswer < 0) {
-    min = 29999;
-    changeiter = iteration;
-    numfound = 0;
-    numreplace = 0;
-
-    for (int n = 0; n < iteration; n++) {
-      if (visited[n] == -1)
-        continue;
-
-      i = visited[n] % wallscreen->GetWidth();
-      j = visited[n] / wallscreen->GetWidth();
-      granularity = walk_area_granularity[wallscreen->GetScanLine(j)[i]];
-      adjcount = 1;
-
-//    char tempb[200]; sprintf(tempb, "checking: %d,%d\n",i,j); write_log(tempb);
-      if (i >= granularity) {
-        modifier = (destx < i) ? DIRECTION_BONUS : 0;
-        CHECK_MIN(i - granularity, j)
-      }
+  while ((foundAnswer < 0) && (route_heap_size > 0)) {
+    RouteNode node = route_heap_pop();
+    // skip the cell if it was reached cheaper after being queued
+    if (node.cost > route_cost[node.cell])
+      continue;
 
-      if (j >= granularity) {
-        modifier = (desty < j) ? DIRECTION_BONUS : 0;
-        CHECK_MIN(i, j - granularity)
+    int i = node.cell % width;
+    int j = node.cell / width;
+    int granularity = route_node_granularity > 0 ? route_node_granularity :
+      walk_area_granularity[wallscreen->GetScanLine(j)[i]];
+    int newcost = node.cost + granularity;
+
+    for (int dir = 0; dir < 4; dir++) {
+      int newx = i, newy = j;
+      if (dir == DIR_LEFT) {
+        if (i < granularity)
+          continue;
+        newx -= granularity;
       }
-
-      if (i < wallscreen->GetWidth() - granularity) {
-        modifier = (destx > i) ? DIRECTION_BONUS : 0;
-        CHECK_MIN(i + granularity, j)
+      else if (dir == DIR_UP) {
+        if (j < granularity)
+          continue;
+        newy -= granularity;
       }
-
-      if (j < wallscreen->GetHeight() - granularity) {
-        modifier = (desty > j) ? DIRECTION_BONUS : 0;
-        CHECK_MIN(i, j + granularity)
+      else if (dir == DIR_RIGHT) {
+        if (i >= width - granularity)
+          continue;
+        newx += granularity;
       }
-
-      // If all the adjacent cells have been done, stop checking this one
-      if (adjcount) {
-        if (numreplace < 40) {
-          visited[numreplace] = -1;
-          replace[numreplace] = n;
-          numreplace++;
-        }
+      else {
+        if (j >= height - granularity)
+          continue;
+        newy += granularity;
       }
-    }
-
-    if (numfound == 0) {
-      free(visited);
-      free(parent);
-      return 0;
-    }
-
-    totalfound += numfound;
-    for (int p = 0; p < numfound; p++) {
-      newx = newcell[p] % wallscreen->GetWidth();
-      newy = newcell[p] / wallscreen->GetWidth();
-      beenhere[newy][newx] = beenhere[cheapest[p] / wallscreen->GetWidth()][cheapest[p] % wallscreen->GetWidth()] + 1;
-//      int wal = walk_area_granularity[->GetPixel(wallscreen, newx, newy)];
-//      beenhere[newy - newy%wal][newx - newx%wal] = beenhere[newy][newx];
-      parent[newcell[p]] = cheapest[p];
 
-      // edges of screen pose a problem, so if current and dest are within
-      // certain distance of the edge, say we've got it
-      if ((newx >= wallscreen->GetWidth() - MAX_GRANULARITY) && (destx >= wallscreen->GetWidth() - MAX_GRANULARITY))
-        newx = destx;
-
-      if ((newy >= wallscreen->GetHeight() - MAX_GRANULARITY) && (desty >= wallscreen->GetHeight() - MAX_GRANULARITY))
-        newy = desty;
+      if (wallscreen->GetScanLine(newy)[newx] == 0)
+        continue;
+      int newcell = newy * width + newx;
+      if ((route_search_id[newcell] == route_current_search) && (route_cost[newcell] <= newcost))
+        continue;
+      route_search_id[newcell] = route_current_search;
+      route_cost[newcell] = newcost;
+      route_parent[newcell] = node.cell;
 
+      int goalx = ((newx >= width - MAX_GRANULARITY) && destAtRightEdge) ? destx : newx;
+      int goaly = ((newy >= height - MAX_GRANULARITY) && destAtBottomEdge) ? desty : newy;
       // Found the desination, abort loop
-      if ((newx >= destxlow) && (newx <= destxhi) && (newy >= destylow)
-          && (newy <= destyhi)) {
-        foundAnswer = newcell[p];
+      if ((goalx >= destxlow) && (goalx <= destxhi) && (goaly >= destylow) && (goaly <= destyhi)) {
+        foundAnswer = newcell;
         break;
       }
 
-      if (totalfound >= 1000) {
-        //Doesn't work cos it can see the destination from the point that's
-        //not nearest
-        // every so often, check if we can see the destination
-        if (can_see_from(newx, newy, destx, desty)) {
-          DIRECTION_BONUS -= 50;
-          totalfound = 0;
-        }
-
-      }
-
-      if (numreplace > 0) {
-        numreplace--;
-        changeiter = replace[numreplace];
-      } else
-        changeiter = iteration;
-
-      visited[changeiter] = newcell[p];
-      if (changeiter == iteration)
-        iteration++;
-
-      changeiter = iteration;
-      if (iteration >= MAX_TRAIL_LENGTH) {
-        free(visited);
-        free(parent);
-        return 0;
-      }
+      route_heap_push(newcost + route_distance_to_box(newx, newy, destxlow, destylow, destxhi, destyhi), newcost, newcell);
     }
-    if (totalfound >= 1000) {
+
+    if (++expanded >= 1000) {
       update_polled_stuff_if_runtime();
-      totalfound = 0;
+      expanded = 0;
     }
   }
-  free(visited);
 
-  int on;
+  if (foundAnswer < 0)
+    return 0;
+
   pathbackstage = 0;
   pathbackx[pathbackstage] = destx;
   pathbacky[pathbackstage] = desty;
   pathbackstage++;
 
-  for (on = parent[foundAnswer];; on = parent[on]) {
-    if (on == -1)
-      break;
-
-    newx = on % wallscreen->GetWidth();
-    newy = on / wallscreen->GetWidth();
+  int lastx = foundAnswer % width, lasty = foundAnswer / width;
+  for (int on = route_parent[foundAnswer]; on != -1; on = route_parent[on]) {
+    int newx = on % width;
+    int newy = on / width;
     if ((newx >= destxlow) && (newx <= destxhi) && (newy >= destylow)
         && (newy <= destyhi))
       break;
 
-    pathbackx[pathbackstage] = on % wallscreen->GetWidth();
-    pathbacky[pathbackstage] = on / wallscreen->GetWidth();
+    // leave out the middle of straight runs, only their ends may be the
+    // furthest visible points
+    int next = route_parent[on];
+    if ((next != -1) && (pathbackstage > 1) &&
+        (((newx == lastx) && (newx == next % width)) || ((newy == lasty) && (newy == next / width)))) {
+      lastx = newx;
+      lasty = newy;
+      continue;
+    }
+    lastx = newx;
+    lasty = newy;
+
+    pathbackx[pathbackstage] = newx;
+    pathbacky[pathbackstage] = newy;
     pathbackstage++;
-    if (pathbackstage >= MAXPATHBACK) {
-      free(parent);
+    if (pathbackstage >= MAXPATHBACK)
       return 0;
-    }
   }
-  free(parent);
   return 1;
 }
 
@@ -602,7 +875,7 @@ findroutebk:
 
   if (is_straight)
     ;            // don't use new algo on arrow key presses
-  else if (find_route_dijkstra(srcx, srcy, tox[0], toy[0])) {
+  else if (find_route_astar(srcx, srcy, tox[0], toy[0])) {
     return 1;
   }
 
@@ -717,6 +990,34 @@ void calculate_move_stage(MoveList * mlsp, int aaa)
 }
 
 
+void shutdown_pathfinder()
+{
+  free(pathbackx);
+  free(pathbacky);
+  pathbackx = pathbacky = NULL;
+  free(beenhere);
+  free(beenhere_buffer);
+  beenhere = NULL;
+  beenhere_buffer = NULL;
+  beenhere_array_size = beenhere_buffer_cells = 0;
+  free(route_parent);
+  free(route_cost);
+  free(route_search_id);
+  free(route_heap);
+  route_parent = route_cost = NULL;
+  route_search_id = NULL;
+  route_heap = NULL;
+  route_arena_cells = route_heap_capacity = route_heap_size = 0;
+  free(nav_labels);
+  free(nav_tiles);
+  free(nav_merge);
+  nav_labels = nav_tiles = nav_merge = NULL;
+  nav_label_cells = nav_tile_cells = nav_merge_capacity = 0;
+  nav_walls = NULL;
+  delete route_fill_bitmap;
+  route_fill_bitmap = NULL;
+}
+
 #define MAKE_INTCOORD(x,y) (((unsigned short)x << 16) | ((unsigned short)y))
 
 int find_route(short srcx, short srcy, short xx, short yy, Bitmap *onscreen, int movlst, int nocross, int ignore_walls)
@@ -747,7 +1048,16 @@ int find_route(short srcx, short srcy, short xx, short yy, Bitmap *onscreen, int
     pathbackstage = 0;
   }
   else {
-    beenhere[0] = (short *)malloc((wallscreen->GetWidth()) * (wallscreen->GetHeight()) * BEENHERE_SIZE);
+    // the buffer is kept for the next routes, unless the area gets bigger
+    int cells = wallscreen->GetWidth() * wallscreen->GetHeight();
+    if (cells > beenhere_buffer_cells) {
+      free(beenhere_buffer);
+      beenhere_buffer = (short *)malloc(cells * BEENHERE_SIZE);
+      beenhere_buffer_cells = cells;
+      if (beenhere_buffer == NULL)
+        quit("insufficient memory to allocate pathfinder beenhere buffer");
+    }
+    beenhere[0] = beenhere_buffer;
 
     for (aaa = 1; aaa < wallscreen->GetHeight(); aaa++)
       beenhere[aaa] = beenhere[0] + aaa * (wallscreen->GetWidth());
@@ -757,7 +1067,6 @@ int find_route(short srcx, short srcy, short xx, short yy, Bitmap *onscreen, int
       if (__find_route(srcx, srcy, &xx, &yy, nocross) == 0)
         pathbackstage = -1;
     }
-    free(beenhere[0]);
   }
 
   if (pathbackstage >= 0) {
@@ -772,12 +1081,14 @@ int find_route(short srcx, short srcy, short xx, short yy, Bitmap *onscreen, int
 stage_again:
     nearestpos = 0;
     aaa = 1;
-    // find the furthest point that can be seen from this stage
-    for (aaa = pathbackstage - 1; aaa >= 0; aaa--) {
+    // find the furthest point that can be seen from this stage; the
+    // path is stored backwards, so it is the first one seen from its end
+    for (aaa = 0; aaa < pathbackstage; aaa++) {
 //      fprintf(stderr,"stage %2d: %2d,%2d\n",aaa,pathbackx[aaa],pathbacky[aaa]);
       if (can_see_from(srcx, srcy, pathbackx[aaa], pathbacky[aaa])) {
         nearestpos = MAKE_INTCOORD(pathbackx[aaa], pathbacky[aaa]);
         nearestindx = aaa;
+        break;
       }
     }
 
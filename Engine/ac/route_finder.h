@@ -22,6 +22,17 @@ int can_see_from(int x1, int y1, int x2, int y2);
 
 void init_pathfinder();
 void set_route_move_speed(int speed_x, int speed_y);
+// Sets fixed step between the route nodes, up to 3 pixels, or 0 to step
+// by the walkable area granularity
+void set_route_node_granularity(int granularity);
+// Makes the navigation data for the room's walkable areas; has to be called
+// every time they change, as the routes rely on it
+void build_route_navigation(Common::Bitmap *walls);
+// Makes the navigation data again before the next route, for the walkable
+// areas which were changed in place, e.g. by a plugin
+void invalidate_route_navigation();
+// Frees the pathfinder buffers
+void shutdown_pathfinder();
 int find_route(short srcx, short srcy, short xx, short yy, Common::Bitmap *onscreen, int movlst, int nocross =
                0, int ignore_walls = 0);
 
@@ -24,9 +24,21 @@
 #endif
 
 #include "ac/spritecache.h"
+#include "core/assetmanager.h"
+#include "debug/out.h"
+#include "gfx/bitmap.h"
 #include "util/compress.h"
+#include "util/mutex.h"
+#include "util/mutex_lock.h"
+#include "util/semaphore.h"
+#include "util/stream.h"
+#include "util/thread.h"
 //
 
+using AGS::Common::Bitmap;
+using AGS::Common::Stream;
+namespace Out = AGS::Common::Out;
+
 // For engine these are defined in ac.cpp
 extern int spritewidth[], spriteheight[];
 //
@@ -49,3 +61,238 @@ void SpriteCache::initFile_initNullSpriteParams(int vv)
   offsets[vv] = offsets[0];
   flags[vv] = SPRCACHEFLAG_DOESNOTEXIST;
 }
+
+//=============================================================================
+// Background sprite prefetch
+//=============================================================================
+
+struct PrefetchedSprite
+{
+  int     index;
+  int32_t offset; // sprite is valid only if its file offset was not changed
+  Bitmap  *image;
+};
+
+struct SpritePrefetchQueue
+{
+  AGS::Engine::Thread thread;
+  AGS::Engine::Mutex  mutex;
+  // Posted when there are sprites to decode, or the thread should stop;
+  // the thread waits on it while it has nothing to do
+  AGS::Engine::Semaphore work;
+  // Posted when the sprite the main thread waits for has been decoded
+  AGS::Engine::Semaphore decoded;
+  bool stopping;
+  // Own stream of the sprite file, used only by the prefetch thread
+  Stream  *stream;
+
+  // Sprites waiting to be decoded
+  PrefetchedSprite *pending;
+  int numPending;
+  int nextPending;
+  int pendingLimit;
+  // Sprite which is being decoded right now, or -1
+  int decodingIndex;
+  // Main thread is waiting for the decodingIndex sprite
+  bool waitingForDecoded;
+  // Decoded sprites waiting to be taken by the cache
+  PrefetchedSprite *ready;
+  int numReady;
+  int readyLimit;
+
+  // Statistics for the current prefetch list
+  int hits;   // sprites taken from the queue
+  int misses; // listed sprites which had to be loaded on demand
+
+  SpritePrefetchQueue()
+    : stopping(false), stream(NULL), pending(NULL), numPending(0), nextPending(0), pendingLimit(0)
+    , decodingIndex(-1), waitingForDecoded(false), ready(NULL), numReady(0), readyLimit(0), hits(0), misses(0)
+  {
+  }
+
+  ~SpritePrefetchQueue()
+  {
+    for (int i = 0; i < numReady; i++)
+      delete ready[i].image;
+    free(pending);
+    free(ready);
+    delete stream;
+  }
+
+  // Logs usage of the finished prefetch list and clears it; must be locked
+  void ResetList()
+  {
+    if (numPending > 0)
+      Out::FPrint("Sprite prefetch: %d of %d sprites hit, %d missed, %d not used",
+        hits, numPending, misses, numReady);
+    for (int i = 0; i < numReady; i++)
+      delete ready[i].image;
+    numReady = 0;
+    numPending = 0;
+    nextPending = 0;
+    hits = 0;
+    misses = 0;
+  }
+};
+
+// Sprite file name, as opened by engine_init_sprites
+const char *prefetchSpriteFileName = "acsprset.spr";
+
+void SpriteCache::prefetchThreadEntry()
+{
+  spriteset.runPrefetch();
+}
+
+void SpriteCache::prefetchSprites(const int *indexes, int count)
+{
+  if (prefetch == NULL) {
+    // the asset manager may only be used on the main thread
+    Stream *in = Common::AssetManager::OpenAsset((char*)prefetchSpriteFileName);
+    if (in == NULL)
+      return;
+    prefetch = new SpritePrefetchQueue();
+    prefetch->stream = in;
+    if (!prefetch->thread.CreateAndStart(prefetchThreadEntry, true)) {
+      Out::FPrint("Failed to start sprite prefetch thread, sprites will be loaded on demand");
+      delete prefetch;
+      prefetch = NULL;
+      return;
+    }
+  }
+
+  AGS::Engine::MutexLock lock(prefetch->mutex);
+  prefetch->ResetList();
+  if (count > prefetch->pendingLimit) {
+    prefetch->pendingLimit = count;
+    prefetch->pending = (PrefetchedSprite*)realloc(prefetch->pending, count * sizeof(PrefetchedSprite));
+  }
+
+  // do not decode more than the cache would be able to keep
+  int32_t freeSize = maxCacheSize - cachesize;
+  for (int i = 0; i < count; i++) {
+    int index = indexes[i];
+    if ((index < 0) || (index >= elements) || (images[index] != NULL) || (offsets[index] <= 0) ||
+        ((flags[index] & SPRCACHEFLAG_DOESNOTEXIST) != 0))
+      continue;
+    // skip duplicates
+    int j;
+    for (j = 0; (j < prefetch->numPending) && (prefetch->pending[j].index != index); j++);
+    if (j < prefetch->numPending)
+      continue;
+    // the colour depth is not known yet, so assume the largest one
+    freeSize -= spritewidth[index] * spriteheight[index] * 4;
+    if (freeSize < 0)
+      break;
+
+    PrefetchedSprite &sprite = prefetch->pending[prefetch->numPending++];
+    sprite.index = index;
+    sprite.offset = offsets[index];
+    sprite.image = NULL;
+  }
+  if (prefetch->numPending > 0)
+    prefetch->work.Post();
+}
+
+void SpriteCache::stopPrefetch()
+{
+  if (prefetch == NULL)
+    return;
+  {
+    AGS::Engine::MutexLock lock(prefetch->mutex);
+    prefetch->stopping = true;
+  }
+  prefetch->work.Post();
+  prefetch->thread.Stop();
+  prefetch->ResetList();
+  delete prefetch;
+  prefetch = NULL;
+}
+
+void SpriteCache::runPrefetch()
+{
+  SpritePrefetchQueue *queue = prefetch;
+  PrefetchedSprite sprite;
+  {
+    AGS::Engine::MutexLock lock(queue->mutex);
+    if (queue->stopping)
+      return;
+    // skip sprites which were already loaded on demand
+    while ((queue->nextPending < queue->numPending) && (queue->pending[queue->nextPending].index < 0))
+      queue->nextPending++;
+    if (queue->nextPending < queue->numPending)
+    {
+      sprite = queue->pending[queue->nextPending++];
+      queue->decodingIndex = sprite.index;
+    }
+    else
+    {
+      sprite.index = -1;
+    }
+  }
+
+  if (sprite.index < 0) {
+    // nothing to do, wait for the next list
+    queue->work.Wait();
+    return;
+  }
+
+  int coldep;
+  bool readStream;
+  sprite.image = decodeSprite(sprite.offset, queue->stream, true, coldep, readStream);
+
+  AGS::Engine::MutexLock lock(queue->mutex);
+  queue->decodingIndex = -1;
+  if (queue->waitingForDecoded) {
+    queue->waitingForDecoded = false;
+    queue->decoded.Post();
+  }
+  if (sprite.image == NULL)
+    return;
+  if (queue->numReady == queue->readyLimit) {
+    queue->readyLimit += 100;
+    queue->ready = (PrefetchedSprite*)realloc(queue->ready, queue->readyLimit * sizeof(PrefetchedSprite));
+  }
+  queue->ready[queue->numReady++] = sprite;
+}
+
+Bitmap *SpriteCache::takePrefetchedSprite(int index)
+{
+  if (prefetch == NULL)
+    return NULL;
+
+  AGS::Engine::MutexLock lock(prefetch->mutex);
+  // if the sprite is being decoded right now, wait for it rather than
+  // decoding it twice
+  if (prefetch->decodingIndex == index) {
+    prefetch->waitingForDecoded = true;
+    lock.Release();
+    prefetch->decoded.Wait();
+    lock.Acquire(prefetch->mutex);
+  }
+
+  for (int i = 0; i < prefetch->numReady; i++) {
+    if (prefetch->ready[i].index != index)
+      continue;
+    Bitmap *image = prefetch->ready[i].image;
+    bool valid = (prefetch->ready[i].offset == offsets[index]);
+    prefetch->ready[i] = prefetch->ready[--prefetch->numReady];
+    if (!valid) {
+      // sprite was replaced after it was queued
+      delete image;
+      break;
+    }
+    prefetch->hits++;
+    return image;
+  }
+
+  for (int i = 0; i < prefetch->numPending; i++) {
+    if (prefetch->pending[i].index == index) {
+      prefetch->misses++;
+      // the sprite is about to be loaded, so don't decode it again
+      if (i >= prefetch->nextPending)
+        prefetch->pending[i].index = -1;
+      break;
+    }
+  }
+  return NULL;
+}
@@ -0,0 +1,187 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+
+#include <string.h>
+#include "ac/spritetransformcache.h"
+#include "ac/draw.h"
+#include "ac/gamesetup.h"
+#include "ac/gamesetupstruct.h"
+#include "ac/gamestate.h"
+#include "ac/spritecache.h"
+#include "debug/out.h"
+#include "gfx/bitmap.h"
+
+using AGS::Common::Bitmap;
+namespace BitmapHelper = AGS::Common::BitmapHelper;
+namespace Out = AGS::Common::Out;
+
+extern GameSetup usetup;
+extern GameSetupStruct game;
+extern GameState play;
+extern SpriteCache spriteset;
+
+#define TRANSFORM_CACHE_BUCKETS 1024
+
+struct TransformedSprite {
+    SpriteTransform transform;
+    unsigned int hash;
+    Bitmap *image;
+    int size;
+    TransformedSprite *next_in_bucket;
+    // neighbours in the order of use, most recent first
+    TransformedSprite *prev_used;
+    TransformedSprite *next_used;
+};
+
+TransformedSprite *transform_buckets[TRANSFORM_CACHE_BUCKETS];
+TransformedSprite *most_recent_transform = NULL;
+TransformedSprite *least_recent_transform = NULL;
+int transform_cache_size = 0;
+int transform_cache_max_size = 4096 * 1024;
+unsigned int transform_cache_hits = 0;
+unsigned int transform_cache_misses = 0;
+unsigned int transform_cache_drops = 0;
+
+unsigned int hash_sprite_transform(const SpriteTransform &transform) {
+    const int *fields = (const int*)&transform;
+    unsigned int hash = 2166136261u;
+    for (size_t i = 0; i < sizeof(SpriteTransform) / sizeof(int); ++i)
+        hash = (hash ^ (unsigned int)fields[i]) * 16777619u;
+    return hash;
+}
+
+void unlink_transformed_sprite(TransformedSprite *entry) {
+    if (entry->prev_used)
+        entry->prev_used->next_used = entry->next_used;
+    else
+        most_recent_transform = entry->next_used;
+    if (entry->next_used)
+        entry->next_used->prev_used = entry->prev_used;
+    else
+        least_recent_transform = entry->prev_used;
+}
+
+void link_transformed_sprite_first(TransformedSprite *entry) {
+    entry->prev_used = NULL;
+    entry->next_used = most_recent_transform;
+    if (most_recent_transform)
+        most_recent_transform->prev_used = entry;
+    else
+        least_recent_transform = entry;
+    most_recent_transform = entry;
+}
+
+void free_transformed_sprite(TransformedSprite *entry) {
+    TransformedSprite **link = &transform_buckets[entry->hash % TRANSFORM_CACHE_BUCKETS];
+    while (*link != entry)
+        link = &(*link)->next_in_bucket;
+    *link = entry->next_in_bucket;
+    unlink_transformed_sprite(entry);
+    transform_cache_size -= entry->size;
+    delete entry->image;
+    delete entry;
+}
+
+bool make_sprite_transform(SpriteTransform &transform, int sppic, int width, int height, int mirrored,
+                           int tint_amount, int tint_red, int tint_green, int tint_blue, int tint_light,
+                           int light_level) {
+    // the 256-colour results depend on the palette at the time
+    if ((game.color_depth == 1) || (spriteset[sppic] == NULL) || (spriteset[sppic]->GetColorDepth() == 8))
+        return false;
+
+    // every field is set, even the unused ones, as they are all hashed
+    memset(&transform, 0, sizeof(transform));
+    transform.sppic = sppic;
+    transform.width = width;
+    transform.height = height;
+    transform.mirrored = mirrored ? 1 : 0;
+    transform.antialias = (IS_ANTIALIAS_SPRITES) ? 1 : 0;
+    // a tint takes the place of the light level
+    if (tint_amount != 0) {
+        transform.tint_amount = tint_amount;
+        transform.tint_red = tint_red;
+        transform.tint_green = tint_green;
+        transform.tint_blue = tint_blue;
+        transform.tint_light = tint_light;
+    }
+    else
+        transform.light_level = light_level;
+    return true;
+}
+
+void set_sprite_transform_cache_size(int max_size) {
+    transform_cache_max_size = max_size;
+    while (least_recent_transform && (transform_cache_size > transform_cache_max_size))
+        free_transformed_sprite(least_recent_transform);
+}
+
+Bitmap *get_transformed_sprite(const SpriteTransform &transform) {
+    if (transform_cache_max_size <= 0)
+        return NULL;
+
+    unsigned int hash = hash_sprite_transform(transform);
+    for (TransformedSprite *entry = transform_buckets[hash % TRANSFORM_CACHE_BUCKETS];
+        entry; entry = entry->next_in_bucket) {
+        if ((entry->hash == hash) && (memcmp(&entry->transform, &transform, sizeof(transform)) == 0)) {
+            unlink_transformed_sprite(entry);
+            link_transformed_sprite_first(entry);
+            transform_cache_hits++;
+            return entry->image;
+        }
+    }
+    transform_cache_misses++;
+    return NULL;
+}
+
+void put_transformed_sprite(const SpriteTransform &transform, Bitmap *image) {
+    int size = image->GetDataSize();
+    if (size > transform_cache_max_size)
+        return;
+    while (least_recent_transform && (transform_cache_size + size > transform_cache_max_size)) {
+        free_transformed_sprite(least_recent_transform);
+        transform_cache_drops++;
+    }
+
+    TransformedSprite *entry = new TransformedSprite();
+    entry->transform = transform;
+    entry->hash = hash_sprite_transform(transform);
+    entry->image = BitmapHelper::CreateBitmapCopy(image);
+    entry->size = size;
+    TransformedSprite **bucket = &transform_buckets[entry->hash % TRANSFORM_CACHE_BUCKETS];
+    entry->next_in_bucket = *bucket;
+    *bucket = entry;
+    link_transformed_sprite_first(entry);
+    transform_cache_size += size;
+}
+
+void remove_transformed_sprites(int sppic) {
+    TransformedSprite *entry = most_recent_transform;
+    while (entry) {
+        TransformedSprite *next = entry->next_used;
+        if (entry->transform.sppic == sppic)
+            free_transformed_sprite(entry);
+        entry = next;
+    }
+}
+
+void clear_transformed_sprites() {
+    while (least_recent_transform)
+        free_transformed_sprite(least_recent_transform);
+}
+
+void log_sprite_transform_cache_stats() {
+    Out::FPrint("Transformed sprite cache: %u hits, %u misses, %u dropped; %d KB used (limit %d KB)",
+        transform_cache_hits, transform_cache_misses, transform_cache_drops,
+        transform_cache_size / 1024, transform_cache_max_size / 1024);
+}
@@ -0,0 +1,53 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+//
+// Cache of scaled, flipped and tinted sprite images, shared by characters
+// and objects. It is limited to a number of bytes, and the images that were
+// used least recently are dropped first.
+//
+//=============================================================================
+#ifndef __AGS_EE_AC__SPRITETRANSFORMCACHE_H
+#define __AGS_EE_AC__SPRITETRANSFORMCACHE_H
+
+namespace AGS { namespace Common { class Bitmap; } }
+using namespace AGS; // FIXME later
+
+// Everything that decides how a sprite image is drawn
+struct SpriteTransform {
+    int sppic;
+    int width, height;
+    int mirrored;
+    int antialias;
+    int tint_amount, tint_red, tint_green, tint_blue, tint_light;
+    int light_level;
+};
+
+// Fills in the transform; returns false if the result cannot be cached
+bool make_sprite_transform(SpriteTransform &transform, int sppic, int width, int height, int mirrored,
+                           int tint_amount, int tint_red, int tint_green, int tint_blue, int tint_light,
+                           int light_level);
+// Sets the cache limit in bytes; 0 disables the cache
+void set_sprite_transform_cache_size(int max_size);
+// Returns the cached image for the transform, or NULL if there is none
+Common::Bitmap *get_transformed_sprite(const SpriteTransform &transform);
+// Stores a copy of the transformed image
+void put_transformed_sprite(const SpriteTransform &transform, Common::Bitmap *image);
+// Drops the cached images of the sprite, which has changed
+void remove_transformed_sprites(int sppic);
+// Drops all the cached images
+void clear_transformed_sprites();
+// Writes the cache hit and miss counts to the log
+void log_sprite_transform_cache_stats();
+
+#endif // __AGS_EE_AC__SPRITETRANSFORMCACHE_H
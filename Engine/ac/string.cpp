@@ -21,6 +21,7 @@
 #include "ac/runtime_defines.h"
 #include "ac/dynobj/scriptstring.h"
 #include "debug/debug_log.h"
+#include "font/fonts.h"
 #include "util/string_utils.h"
 #include "script/runtimescriptvalue.h"
 
@@ -248,9 +249,19 @@ void split_lines_rightleft (char *todis, int wii, int fonnt) {
     // start on the last character
     char *thisline = todis + strlen(todis) - 1;
     char prevlwas, *prevline = NULL;
+    // width of the text from thisline to the end of the line, summed up
+    // one character at a time (see split_lines_leftright); -1 if it has
+    // to be measured as a whole
+    const int extraWidth = wgettextwidth_compensate("", fonnt);
+    int lineWidth = 0;
     // work backwards
     while (thisline >= todis) {
 
+        if (lineWidth >= 0) {
+            int charWidth = wgetcharwidth(thisline[0], fonnt);
+            lineWidth = charWidth >= 0 ? lineWidth + charWidth : -1;
+        }
+
         int needBreak = 0;
         if (thisline <= todis) 
             needBreak = 1;
@@ -260,7 +271,7 @@ void split_lines_rightleft (char *todis, int wii, int fonnt) {
             needBreak = 1;
             thisline++;
         }
-        else if (wgettextwidth_compensate(thisline, fonnt) >= wii) {
+        else if ((lineWidth >= 0 ? lineWidth + extraWidth : wgettextwidth_compensate(thisline, fonnt)) >= wii) {
             // go 'back' to the nearest word
             while ((thisline[0] != ' ') && (thisline[0] != 0))
                 thisline++;
@@ -283,6 +294,7 @@ void split_lines_rightleft (char *todis, int wii, int fonnt) {
             prevline = thisline;
             prevlwas = prevline[0];
             prevline[0] = 0;
+            lineWidth = 0;
         }
 
         thisline--;
@@ -22,6 +22,7 @@
 #include "ac/object.h"
 #include "ac/roomobject.h"
 #include "ac/roomstatus.h"
+#include "ac/route_finder.h"
 #include "ac/walkablearea.h"
 #include "gfx/bitmap.h"
 
@@ -56,6 +57,7 @@ void redo_walkable_areas() {
         }
     }
 
+    build_route_navigation(thisroom.walls);
 }
 
 int get_walkable_area_pixel(int x, int y)
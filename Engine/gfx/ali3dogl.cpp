@@ -399,6 +399,7 @@ public:
   virtual Bitmap *ConvertBitmapToSupportedColourDepth(Bitmap *bitmap);
   virtual IDriverDependantBitmap* CreateDDBFromBitmap(Bitmap *bitmap, bool hasAlpha, bool opaque);
   virtual void UpdateDDBFromBitmap(IDriverDependantBitmap* bitmapToUpdate, Bitmap *bitmap, bool hasAlpha);
+  virtual void UpdateDDBFromBitmapRect(IDriverDependantBitmap* bitmapToUpdate, Bitmap *bitmap, bool hasAlpha, const Rect &changed);
   virtual void DestroyDDB(IDriverDependantBitmap* bitmap);
   virtual void DrawSprite(int x, int y, IDriverDependantBitmap* bitmap);
   virtual void ClearDrawList();
@@ -406,6 +407,8 @@ public:
   virtual void Render();
   virtual void Render(GlobalFlipType flip);
   virtual void SetRenderOffset(int x, int y);
+  virtual void EnablePartialRedraw(bool enabled) { }
+  virtual void InvalidateRect(int x1, int y1, int x2, int y2) { }
   virtual void GetCopyOfScreenIntoBitmap(Bitmap *destination);
   virtual void EnableVsyncBeforeRender(bool enabled) { }
   virtual void Vsync();
@@ -478,7 +481,7 @@ private:
   void InitOpenGl();
   void set_up_default_vertices();
   void AdjustSizeToNearestSupportedByCard(int *width, int *height);
-  void UpdateTextureRegion(TextureTile *tile, Bitmap *bitmap, OGLBitmap *target, bool hasAlpha);
+  void UpdateTextureRegion(TextureTile *tile, Bitmap *bitmap, OGLBitmap *target, bool hasAlpha, const Rect &changed);
   void do_fade(bool fadingOut, int speed, int targetColourRed, int targetColourGreen, int targetColourBlue);
   bool IsModeSupported(int width, int height, int colDepth);
   void create_screen_tint_bitmap();
@@ -1325,7 +1328,10 @@ __inline void get_pixel_if_not_transparent32(unsigned int *pixel, unsigned int *
   (((((a)&0xff)<<24)|(((b)&0xff)<<16)|(((g)&0xff)<<8)|((r)&0xff)))
 
 
-void OGLGraphicsDriver::UpdateTextureRegion(TextureTile *tile, Bitmap *bitmap, OGLBitmap *target, bool hasAlpha)
+// Converts the part of the tile which depends on the changed area of the
+// bitmap, and uploads it into the texture. Transparent pixels take their
+// colour from the neighbours, so the area grows by one pixel each way.
+void OGLGraphicsDriver::UpdateTextureRegion(TextureTile *tile, Bitmap *bitmap, OGLBitmap *target, bool hasAlpha, const Rect &changed)
 {
   int textureHeight = tile->height;
   int textureWidth = tile->width;
@@ -1335,19 +1341,33 @@ void OGLGraphicsDriver::UpdateTextureRegion(TextureTile *tile, Bitmap *bitmap, O
   int tileWidth = (textureWidth > tile->width) ? tile->width + 1 : tile->width;
   int tileHeight = (textureHeight > tile->height) ? tile->height + 1 : tile->height;
 
+  int left = changed.Left - tile->x - 1;
+  int top = changed.Top - tile->y - 1;
+  int right = changed.Right - tile->x + 1;
+  int bottom = changed.Bottom - tile->y + 1;
+  if ((right < 0) || (bottom < 0) || (left >= tile->width) || (top >= tile->height))
+    return;
+  left = (left < 0) ? 0 : left;
+  top = (top < 0) ? 0 : top;
+  // the extra edge column and row repeat the last ones of the tile
+  right = (right >= tile->width - 1) ? tileWidth - 1 : right;
+  bottom = (bottom >= tile->height - 1) ? tileHeight - 1 : bottom;
+  int areaWidth = right - left + 1;
+  int areaHeight = bottom - top + 1;
+
   bool usingLinearFiltering = (psp_gfx_smoothing == 1); //_filter->NeedToColourEdgeLines();
   bool lastPixelWasTransparent = false;
-  char *origPtr = (char*)malloc(4 * tileWidth * tileHeight);
+  char *origPtr = (char*)malloc(4 * areaWidth * areaHeight);
   char *memPtr = origPtr;
-  for (int y = 0; y < tileHeight; y++)
+  for (int y = top; y <= bottom; y++)
   {
     // Mimic the behaviour of GL_CLAMP_EDGE for the bottom line
     if (y == tile->height)
     {
       unsigned int* memPtrLong = (unsigned int*)memPtr;
-      unsigned int* memPtrLong_previous = (unsigned int*)(memPtr - tileWidth * 4);
+      unsigned int* memPtrLong_previous = (unsigned int*)(memPtr - areaWidth * 4);
 
-      for (int x = 0; x < tileWidth; x++)
+      for (int x = 0; x < areaWidth; x++)
         memPtrLong[x] = memPtrLong_previous[x] & 0x00FFFFFF;
 
       continue;
@@ -1357,7 +1377,7 @@ void OGLGraphicsDriver::UpdateTextureRegion(TextureTile *tile, Bitmap *bitmap, O
     const uint8_t *scanline_before = bitmap->GetScanLine(y + tile->y - 1);
     const uint8_t *scanline_at     = bitmap->GetScanLine(y + tile->y);
     const uint8_t *scanline_after  = bitmap->GetScanLine(y + tile->y + 1);
-    for (int x = 0; x < tileWidth; x++)
+    for (int x = left; x <= right; x++)
     {
 
 /*    if (target->_colDepth == 15)
@@ -1405,7 +1425,7 @@ void OGLGraphicsDriver::UpdateTextureRegion(TextureTile *tile, Bitmap *bitmap, O
       else if (target->_colDepth == 32)
 */
       {
-        unsigned int* memPtrLong = (unsigned int*)memPtr;
+        unsigned int* memPtrLong = (unsigned int*)memPtr - left;
 
         if (x == tile->width)
         {
@@ -1458,18 +1478,32 @@ void OGLGraphicsDriver::UpdateTextureRegion(TextureTile *tile, Bitmap *bitmap, O
       }
     }
 
-    memPtr += tileWidth * 4;
+    // the pixel right of the area may recolour the last one in it
+    if (lastPixelWasTransparent && !hasAlpha && (right + 1 < tile->width))
+    {
+      unsigned int srcData = ((unsigned int*)scanline_at)[right + 1 + tile->x];
+      if (srcData != MASK_COLOR_32)
+        ((unsigned int*)memPtr)[areaWidth - 1] =
+          D3DCOLOR_RGBA(algetr32(srcData), algetg32(srcData), algetb32(srcData), 0xff) & 0x00FFFFFF;
+    }
+
+    memPtr += areaWidth * 4;
   }
 
   unsigned int newTexture = tile->texture;
 
   glBindTexture(GL_TEXTURE_2D, tile->texture);
-  glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, tileWidth, tileHeight, GL_RGBA, GL_UNSIGNED_BYTE, origPtr);
+  glTexSubImage2D(GL_TEXTURE_2D, 0, left, top, areaWidth, areaHeight, GL_RGBA, GL_UNSIGNED_BYTE, origPtr);
 
   free(origPtr);
 }
 
 void OGLGraphicsDriver::UpdateDDBFromBitmap(IDriverDependantBitmap* bitmapToUpdate, Bitmap *bitmap, bool hasAlpha)
+{
+  UpdateDDBFromBitmapRect(bitmapToUpdate, bitmap, hasAlpha, RectWH(0, 0, bitmap->GetWidth(), bitmap->GetHeight()));
+}
+
+void OGLGraphicsDriver::UpdateDDBFromBitmapRect(IDriverDependantBitmap* bitmapToUpdate, Bitmap *bitmap, bool hasAlpha, const Rect &changed)
 {
   OGLBitmap *target = (OGLBitmap*)bitmapToUpdate;
   Bitmap *source = bitmap;
@@ -1482,11 +1516,15 @@ void OGLGraphicsDriver::UpdateDDBFromBitmap(IDriverDependantBitmap* bitmapToUpda
       source = BitmapHelper::CreateBitmapCopy(bitmap, 32);
     }
 
+    // the alpha channel of every pixel depends on the flag
+    Rect area = changed;
+    if (target->_hasAlpha != hasAlpha)
+      area = RectWH(0, 0, target->_width, target->_height);
     target->_hasAlpha = hasAlpha;
 
     for (int i = 0; i < target->_numTiles; i++)
     {
-      UpdateTextureRegion(&target->_tiles[i], source, target, hasAlpha);
+      UpdateTextureRegion(&target->_tiles[i], source, target, hasAlpha, area);
     }
 
     if (source != bitmap)
@@ -21,12 +21,15 @@
 #include "gfx/ali3d.h"
 #include "platform/base/agsplatformdriver.h"
 #include "gfx/bitmap.h"
+#include "gfx/blender.h"
 #include "gfx/ddb.h"
 #include "gfx/gfx_util.h"
 #include "gfx/graphicsdriver.h"
 #include "main/main_allegro.h"
+#include "util/math.h"
 
 using AGS::Common::Bitmap;
+namespace Math = AGS::Common::Math;
 namespace BitmapHelper = AGS::Common::BitmapHelper;
 using namespace AGS; // FIXME later
 
@@ -56,10 +59,14 @@ extern "C" DDRAW_SURFACE *gfx_directx_primary_surface;
 #endif
 
 #define MAX_DRAW_LIST_SIZE 200
+#define MAX_INVALID_RECTS 64
 RGB faded_out_palette[256];
 
 void tint_image(Bitmap* srcimg, Bitmap* destimg, int red, int grn, int blu, int light_level, int luminance);
-unsigned long _trans_alpha_blender32(unsigned long x, unsigned long y, unsigned long n);
+
+// Changes every time a bitmap is created or updated, so that the sprites
+// with the same contents as in the last frame can be told apart
+unsigned int sw_bitmap_serial = 0;
 
 class ALSoftwareBitmap : public IDriverDependantBitmap
 {
@@ -88,10 +95,17 @@ public:
   bool _opaque;
   bool _hasAlpha;
   int _transparency;
+  unsigned int _serial;
+  // part of the bitmap changed since it was last drawn, if that was the
+  // only change
+  bool _partlyUpdated;
+  Rect _updatedArea;
 
   ALSoftwareBitmap(Bitmap *bmp, bool opaque, bool hasAlpha)
   {
     _bmp = bmp;
+    _serial = ++sw_bitmap_serial;
+    _partlyUpdated = false;
     _width = bmp->GetWidth();
     _height = bmp->GetHeight();
     _colDepth = bmp->GetColorDepth();
@@ -147,6 +161,17 @@ private:
     GFX_MODE_LIST *_gfxModeList;
 };
 
+// Sprite as it was drawn in the last frame; the bitmap may be destroyed
+// since then, so it is only compared with the new ones
+struct ALDrawnSprite
+{
+  ALSoftwareBitmap *bitmap;
+  unsigned int serial;
+  int x, y;
+  int width, height;            // 0 if nothing was drawn
+  int transparency;
+};
+
 #include "gfx/gfxfilter_allegro.h"
 
 class ALSoftwareGraphicsDriver : public IGraphicsDriver
@@ -166,6 +191,11 @@ public:
     _autoVsync = false;
     _spareTintingScreen = NULL;
     numToDraw = 0;
+    numLastDrawn = 0;
+    lastBackBuffer = NULL;
+    lastRedrawPartial = false;
+    _partialRedraw = false;
+    numInvalidRects = 0;
     _gfxModeList = NULL;
 #ifdef _WIN32
     dxGammaControl = NULL;
@@ -190,6 +220,7 @@ public:
   virtual Bitmap *ConvertBitmapToSupportedColourDepth(Bitmap *bitmap);
   virtual IDriverDependantBitmap* CreateDDBFromBitmap(Bitmap *bitmap, bool hasAlpha, bool opaque);
   virtual void UpdateDDBFromBitmap(IDriverDependantBitmap* bitmapToUpdate, Bitmap *bitmap, bool hasAlpha);
+  virtual void UpdateDDBFromBitmapRect(IDriverDependantBitmap* bitmapToUpdate, Bitmap *bitmap, bool hasAlpha, const Rect &changed);
   virtual void DestroyDDB(IDriverDependantBitmap* bitmap);
   virtual void DrawSprite(int x, int y, IDriverDependantBitmap* bitmap);
   virtual void ClearDrawList();
@@ -206,6 +237,8 @@ public:
   virtual void SetGamma(int newGamma);
   virtual void UseSmoothScaling(bool enabled) { }
   virtual void EnableVsyncBeforeRender(bool enabled) { _autoVsync = enabled; }
+  virtual void EnablePartialRedraw(bool enabled) { _partialRedraw = enabled; }
+  virtual void InvalidateRect(int x1, int y1, int x2, int y2);
   virtual void Vsync();
   virtual bool RequiresFullRedrawEachFrame() { return false; }
   virtual bool HasAcceleratedStretchAndFlip() { return false; }
@@ -238,6 +271,15 @@ private:
   ALSoftwareBitmap* drawlist[MAX_DRAW_LIST_SIZE];
   int drawx[MAX_DRAW_LIST_SIZE], drawy[MAX_DRAW_LIST_SIZE];
   int numToDraw;
+  // The list drawn in the last frame, and the parts of the screen which
+  // have to be composed again; only used when redrawing partially
+  ALDrawnSprite lastDrawn[MAX_DRAW_LIST_SIZE];
+  int numLastDrawn;
+  Bitmap *lastBackBuffer;
+  bool lastRedrawPartial;
+  bool _partialRedraw;
+  Rect invalidRects[MAX_INVALID_RECTS];
+  int numInvalidRects;
   GFX_MODE_LIST *_gfxModeList;
 
 #ifdef _WIN32
@@ -255,6 +297,13 @@ private:
   void __fade_from_range(PALLETE source, PALLETE dest, int speed, int from, int to) ;
   void __fade_out_range(int speed, int from, int to, int targetColourRed, int targetColourGreen, int targetColourBlue) ;
   bool IsModeSupported(int driver, int width, int height, int colDepth);
+  void DrawSpriteToBackBuffer(int index);
+  bool IsSameAsLastDrawn(const ALDrawnSprite &drawn, int index);
+  int  GetDrawnWidth(int index);
+  void GetDrawnSprite(int index, ALDrawnSprite &drawn);
+  void InvalidateDrawnRect(const ALDrawnSprite &drawn);
+  void InvalidateChangedSprites();
+  void ComposeInvalidRects();
   int  GetAllegroGfxDriverID(bool windowed);
 };
 
@@ -490,6 +539,30 @@ void ALSoftwareGraphicsDriver::UpdateDDBFromBitmap(IDriverDependantBitmap* bitma
   ALSoftwareBitmap* alSwBmp = (ALSoftwareBitmap*)bitmapToUpdate;
   alSwBmp->_bmp = bitmap;
   alSwBmp->_hasAlpha = hasAlpha;
+  alSwBmp->_serial = ++sw_bitmap_serial;
+  alSwBmp->_partlyUpdated = false;
+}
+
+void ALSoftwareGraphicsDriver::UpdateDDBFromBitmapRect(IDriverDependantBitmap* bitmapToUpdate, Bitmap *bitmap, bool hasAlpha, const Rect &changed)
+{
+  ALSoftwareBitmap* alSwBmp = (ALSoftwareBitmap*)bitmapToUpdate;
+  if ((alSwBmp->_bmp != bitmap) || (alSwBmp->_hasAlpha != hasAlpha))
+  {
+    UpdateDDBFromBitmap(bitmapToUpdate, bitmap, hasAlpha);
+    return;
+  }
+  // the bitmap is drawn directly, so only the screen area has to be redrawn
+  Rect &area = alSwBmp->_updatedArea;
+  if (!alSwBmp->_partlyUpdated)
+    area = changed;
+  else
+  {
+    area.Left = Math::Min(area.Left, changed.Left);
+    area.Top = Math::Min(area.Top, changed.Top);
+    area.Right = Math::Max(area.Right, changed.Right);
+    area.Bottom = Math::Max(area.Bottom, changed.Bottom);
+  }
+  alSwBmp->_partlyUpdated = true;
 }
 
 void ALSoftwareGraphicsDriver::DestroyDDB(IDriverDependantBitmap* bitmap)
@@ -522,8 +595,188 @@ void ALSoftwareGraphicsDriver::SetRenderOffset(int x, int y)
   _global_y_offset = y;
 }
 
+void ALSoftwareGraphicsDriver::InvalidateRect(int x1, int y1, int x2, int y2)
+{
+  if (x1 < 0) x1 = 0;
+  if (y1 < 0) y1 = 0;
+  if (x2 >= virtualScreen->GetWidth()) x2 = virtualScreen->GetWidth() - 1;
+  if (y2 >= virtualScreen->GetHeight()) y2 = virtualScreen->GetHeight() - 1;
+  if ((x1 > x2) || (y1 > y2))
+    return;
+
+  for (int i = 0; i < numInvalidRects; i++)
+  {
+    const Rect &rc = invalidRects[i];
+    if ((x1 >= rc.Left) && (y1 >= rc.Top) && (x2 <= rc.Right) && (y2 <= rc.Bottom))
+      return;
+  }
+
+  if (numInvalidRects >= MAX_INVALID_RECTS)
+  {
+    // too many rectangles, compose the whole screen
+    invalidRects[0] = Rect(0, 0, virtualScreen->GetWidth() - 1, virtualScreen->GetHeight() - 1);
+    numInvalidRects = 1;
+    return;
+  }
+  invalidRects[numInvalidRects++] = Rect(x1, y1, x2, y2);
+}
+
+void ALSoftwareGraphicsDriver::DrawSpriteToBackBuffer(int index)
+{
+  ALSoftwareBitmap* bitmap = drawlist[index];
+  int drawAtX = drawx[index];// + x;
+  int drawAtY = drawy[index];// + y;
+
+  if ((bitmap->_opaque) && (bitmap->_bmp == virtualScreen))
+  { }
+  else if (bitmap->_opaque)
+  {
+    virtualScreen->Blit(bitmap->_bmp, 0, 0, drawAtX, drawAtY, bitmap->_bmp->GetWidth(), bitmap->_bmp->GetHeight());
+  }
+  else if (bitmap->_transparency >= 255)
+  {
+    // fully transparent... invisible, do nothing
+  }
+  else if (bitmap->_hasAlpha)
+  {
+    if (bitmap->_transparency == 0) // this means opaque
+      set_alpha_blender();
+    else
+      // here _transparency is used as alpha (between 1 and 254)
+      set_blender_mode(NULL, NULL, _trans_alpha_blender32, 0, 0, 0, bitmap->_transparency);
+
+    virtualScreen->TransBlendBlt(bitmap->_bmp, drawAtX, drawAtY);
+  }
+  else
+  {
+    // here _transparency is used as alpha (between 1 and 254), but 0 means opaque!
+    GfxUtil::DrawSpriteWithTransparency(virtualScreen, bitmap->_bmp, drawAtX, drawAtY,
+        bitmap->_transparency ? bitmap->_transparency : 255);
+  }
+}
+
+bool ALSoftwareGraphicsDriver::IsSameAsLastDrawn(const ALDrawnSprite &drawn, int index)
+{
+  if ((drawn.bitmap != drawlist[index]) || (drawn.x != drawx[index]) || (drawn.y != drawy[index]))
+    return false;
+  // plugin hook entries only have their event in the position
+  if (drawn.bitmap == NULL)
+    return true;
+  return (drawn.serial == drawlist[index]->_serial) && (drawn.transparency == drawlist[index]->_transparency) &&
+    (drawn.width == GetDrawnWidth(index));
+}
+
+int ALSoftwareGraphicsDriver::GetDrawnWidth(int index)
+{
+  ALSoftwareBitmap* bitmap = drawlist[index];
+  if ((bitmap == NULL) || ((bitmap->_transparency >= 255) && !bitmap->_opaque))
+    return 0;
+  return bitmap->_bmp->GetWidth();
+}
+
+void ALSoftwareGraphicsDriver::InvalidateDrawnRect(const ALDrawnSprite &drawn)
+{
+  if (drawn.width > 0)
+    InvalidateRect(drawn.x, drawn.y, drawn.x + drawn.width - 1, drawn.y + drawn.height - 1);
+}
+
+void ALSoftwareGraphicsDriver::GetDrawnSprite(int index, ALDrawnSprite &drawn)
+{
+  drawn.bitmap = drawlist[index];
+  drawn.serial = drawlist[index] ? drawlist[index]->_serial : 0;
+  drawn.x = drawx[index];
+  drawn.y = drawy[index];
+  drawn.width = GetDrawnWidth(index);
+  drawn.height = drawn.width > 0 ? drawlist[index]->_bmp->GetHeight() : 0;
+  drawn.transparency = drawlist[index] ? drawlist[index]->_transparency : 0;
+}
+
+// Compares the list with the one drawn in the last frame, skipping single
+// sprites which were added or removed, and invalidates the area of the
+// ones which differ. The sprites left in both lists keep their order, so
+// the rest of the screen looks the same as before.
+void ALSoftwareGraphicsDriver::InvalidateChangedSprites()
+{
+  ALDrawnSprite drawn;
+  int last = 0, cur = 0;
+  while ((last < numLastDrawn) || (cur < numToDraw))
+  {
+    if ((last < numLastDrawn) && (cur < numToDraw) && IsSameAsLastDrawn(lastDrawn[last], cur))
+    {
+      ALSoftwareBitmap* bitmap = drawlist[cur];
+      if (bitmap && bitmap->_partlyUpdated && (lastDrawn[last].width > 0))
+      {
+        const Rect &area = bitmap->_updatedArea;
+        InvalidateRect(drawx[cur] + area.Left, drawy[cur] + area.Top,
+          drawx[cur] + area.Right, drawy[cur] + area.Bottom);
+      }
+      last++;
+      cur++;
+    }
+    else if ((last + 1 < numLastDrawn) && (cur < numToDraw) && IsSameAsLastDrawn(lastDrawn[last + 1], cur))
+    {
+      // removed from the list
+      InvalidateDrawnRect(lastDrawn[last]);
+      last++;
+    }
+    else if ((last < numLastDrawn) && (cur + 1 < numToDraw) && IsSameAsLastDrawn(lastDrawn[last], cur + 1))
+    {
+      // added to the list
+      GetDrawnSprite(cur, drawn);
+      InvalidateDrawnRect(drawn);
+      cur++;
+    }
+    else
+    {
+      if (last < numLastDrawn)
+      {
+        InvalidateDrawnRect(lastDrawn[last]);
+        last++;
+      }
+      if (cur < numToDraw)
+      {
+        GetDrawnSprite(cur, drawn);
+        InvalidateDrawnRect(drawn);
+        cur++;
+      }
+    }
+  }
+}
+
+// Draws the whole list again over every invalid rectangle. The first
+// sprite is the background, so the rectangles may overlap: each of them
+// is composed from scratch.
+void ALSoftwareGraphicsDriver::ComposeInvalidRects()
+{
+  Rect oldClip = virtualScreen->GetClip();
+  for (int r = 0; r < numInvalidRects; r++)
+  {
+    const Rect &rc = invalidRects[r];
+    virtualScreen->SetClip(rc);
+    for (int i = 0; i < numToDraw; i++)
+    {
+      ALSoftwareBitmap* bitmap = drawlist[i];
+      if ((bitmap == NULL) ||
+          (drawx[i] > rc.Right) || (drawy[i] > rc.Bottom) ||
+          (drawx[i] + bitmap->_bmp->GetWidth() <= rc.Left) ||
+          (drawy[i] + bitmap->_bmp->GetHeight() <= rc.Top))
+        continue;
+      DrawSpriteToBackBuffer(i);
+    }
+  }
+  virtualScreen->SetClip(oldClip);
+}
+
 void ALSoftwareGraphicsDriver::RenderToBackBuffer()
 {
+  bool tinted = ((_tint_red > 0) || (_tint_green > 0) || (_tint_blue > 0)) && (_colorDepth > 8);
+  // the tint is applied over the whole screen, so then it is all drawn
+  bool partial = _partialRedraw && !tinted;
+  // if the last frame was drawn differently, or to another back buffer,
+  // none of it may be kept
+  if (partial && (!lastRedrawPartial || (lastBackBuffer != virtualScreen)))
+    InvalidateRect(0, 0, virtualScreen->GetWidth() - 1, virtualScreen->GetHeight() - 1);
+
   for (int i = 0; i < numToDraw; i++)
   {
     if (drawlist[i] == NULL)
@@ -536,40 +789,29 @@ void ALSoftwareGraphicsDriver::RenderToBackBuffer()
       continue;
     }
 
-    ALSoftwareBitmap* bitmap = drawlist[i];
-    int drawAtX = drawx[i];// + x;
-    int drawAtY = drawy[i];// + y;
+    if (!partial)
+      DrawSpriteToBackBuffer(i);
+  }
 
-    if ((bitmap->_opaque) && (bitmap->_bmp == virtualScreen))
-    { }
-    else if (bitmap->_opaque)
-    {
-      virtualScreen->Blit(bitmap->_bmp, 0, 0, drawAtX, drawAtY, bitmap->_bmp->GetWidth(), bitmap->_bmp->GetHeight());
-    }
-    else if (bitmap->_transparency >= 255)
-    {
-      // fully transparent... invisible, do nothing
-    }
-    else if (bitmap->_hasAlpha)
-    {
-      if (bitmap->_transparency == 0) // this means opaque
-        set_alpha_blender();
-      else
-        // here _transparency is used as alpha (between 1 and 254)
-        set_blender_mode(NULL, NULL, _trans_alpha_blender32, 0, 0, 0, bitmap->_transparency);
+  if (partial)
+  {
+    InvalidateChangedSprites();
+    ComposeInvalidRects();
+  }
 
-	  virtualScreen->TransBlendBlt(bitmap->_bmp, drawAtX, drawAtY);
-    }
-    else
-    {
-      // here _transparency is used as alpha (between 1 and 254), but 0 means opaque!
-      GfxUtil::DrawSpriteWithTransparency(virtualScreen, bitmap->_bmp, drawAtX, drawAtY,
-          bitmap->_transparency ? bitmap->_transparency : 255);
-    }
+  for (int i = 0; i < numToDraw; i++)
+  {
+    GetDrawnSprite(i, lastDrawn[i]);
+    if (drawlist[i])
+      drawlist[i]->_partlyUpdated = false;
   }
+  numLastDrawn = numToDraw;
+  lastBackBuffer = virtualScreen;
+  lastRedrawPartial = partial;
+  numInvalidRects = 0;
+  _partialRedraw = false;
 
-  if (((_tint_red > 0) || (_tint_green > 0) || (_tint_blue > 0))
-      && (_colorDepth > 8)) {
+  if (tinted) {
     // Common::gl_ScreenBmp tint
     // This slows down the game no end, only experimental ATM
     set_trans_blender(_tint_red, _tint_green, _tint_blue, 0);
@@ -810,27 +1052,6 @@ bool ALSoftwareGraphicsDriver::PlayVideo(const char *filename, bool useAVISound,
 #endif
 }
 
-// add the alpha values together, used for compositing alpha images
-unsigned long _trans_alpha_blender32(unsigned long x, unsigned long y, unsigned long n)
-{
-   unsigned long res, g;
-
-   n = (n * geta32(x)) / 256;
-
-   if (n)
-      n++;
-
-   res = ((x & 0xFF00FF) - (y & 0xFF00FF)) * n / 256 + y;
-   y &= 0xFF00;
-   x &= 0xFF00;
-   g = (x - y) * n / 256 + y;
-
-   res &= 0xFF00FF;
-   g &= 0xFF00;
-
-   return res | g;
-}
-
 static ALSoftwareGraphicsDriver *_alsoftware_driver = NULL;
 
 IGraphicsDriver* GetSoftwareGraphicsDriver(GFXFilter *filter)
@@ -14,11 +14,23 @@
 
 #include "gfx/blender.h"
 #include "util/wgt2allg.h"
+#include "gfx/blendspan.h"
 #include "gfx/gfxfilterdefines.h"
 
+#if defined(__SSE2__) || (defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64)))
+#define BLENDER_SSE2
+#include <emmintrin.h>
+#endif
+
+using AGS::Common::TRANS_SPAN_FUNC;
+using AGS::Common::LIT_SPAN_FUNC;
+namespace BlendSpan = AGS::Common::BlendSpan;
+
 extern "C" {
     unsigned long _blender_trans16(unsigned long x, unsigned long y, unsigned long n);
     unsigned long _blender_trans15(unsigned long x, unsigned long y, unsigned long n);
+    unsigned long _blender_trans24(unsigned long x, unsigned long y, unsigned long n);
+    unsigned long _blender_alpha32(unsigned long x, unsigned long y, unsigned long n);
 }
 
 // the allegro "inline" ones are not actually inline, so #define
@@ -238,3 +250,273 @@ void set_opaque_alpha_blender()
 {
     set_blender_mode(NULL, NULL, _opaque_alpha_blender, 0, 0, 0, 0);
 }
+
+// add the alpha values together, used for compositing alpha images
+unsigned long _trans_alpha_blender32(unsigned long x, unsigned long y, unsigned long n)
+{
+   unsigned long res, g;
+
+   n = (n * geta32(x)) / 256;
+
+   if (n)
+      n++;
+
+   res = ((x & 0xFF00FF) - (y & 0xFF00FF)) * n / 256 + y;
+   y &= 0xFF00;
+   x &= 0xFF00;
+   g = (x - y) * n / 256 + y;
+
+   res &= 0xFF00FF;
+   g &= 0xFF00;
+
+   return res | g;
+}
+
+//
+// Line blenders. Each does to a line of pixels the same as the blender
+// it is registered for; the source pixels of the mask colour are skipped,
+// like Allegro does.
+//
+
+typedef unsigned long (*PIXEL_BLENDER)(unsigned long x, unsigned long y, unsigned long n);
+
+template <PIXEL_BLENDER Blend>
+void trans_span(uint32_t *dst, const uint32_t *src, int count, int alpha)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        if (src[i] != MASK_COLOR_32)
+            dst[i] = Blend(src[i], dst[i], alpha);
+    }
+}
+
+template <PIXEL_BLENDER Blend>
+void lit_span(uint32_t *dst, const uint32_t *src, int count, int color, int light)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        if (src[i] != MASK_COLOR_32)
+            dst[i] = Blend(color, src[i], light);
+    }
+}
+
+#if defined (BLENDER_SSE2)
+
+// Low 32 bits of a * n in every lane; n must be below 65536 and repeated
+// in both 16-bit halves of its lane
+inline __m128i mul32_sse2(__m128i a, __m128i n16)
+{
+    return _mm_add_epi32(_mm_mullo_epi16(a, n16), _mm_slli_epi32(_mm_mulhi_epu16(a, n16), 16));
+}
+
+// Per-lane n, as above, for 0 <= n < 65536
+inline __m128i make_n16_sse2(__m128i n)
+{
+    return _mm_or_si128(n, _mm_slli_epi32(n, 16));
+}
+
+// n + 1 for every lane where n is not 0
+inline __m128i inc_nonzero_sse2(__m128i n)
+{
+    return _mm_sub_epi32(n, _mm_cmpgt_epi32(n, _mm_setzero_si128()));
+}
+
+// The sum used by Allegro's trans blenders, with zero alpha:
+// ((x & 0xFF00FF) - (y & 0xFF00FF)) * n / 256 + y, and the same for green.
+// Only the low 24 bits are kept, so doing it in 32-bit lanes gives
+// the same result as with the 64-bit longs.
+inline __m128i blend_trans_sse2(__m128i x, __m128i y, __m128i n16)
+{
+    const __m128i rb_mask = _mm_set1_epi32(0xFF00FF);
+    const __m128i g_mask = _mm_set1_epi32(0xFF00);
+    __m128i yg = _mm_and_si128(y, g_mask);
+    __m128i rb = _mm_sub_epi32(_mm_and_si128(x, rb_mask), _mm_and_si128(y, rb_mask));
+    rb = _mm_add_epi32(_mm_srli_epi32(mul32_sse2(rb, n16), 8), y);
+    __m128i g = _mm_sub_epi32(_mm_and_si128(x, g_mask), yg);
+    g = _mm_add_epi32(_mm_srli_epi32(mul32_sse2(g, n16), 8), yg);
+    return _mm_or_si128(_mm_and_si128(rb, rb_mask), _mm_and_si128(g, g_mask));
+}
+
+// Keeps the destination where the source is of the mask colour
+inline __m128i skip_mask_sse2(__m128i src, __m128i dst, __m128i res)
+{
+    __m128i mask = _mm_cmpeq_epi32(src, _mm_set1_epi32(MASK_COLOR_32));
+    return _mm_or_si128(_mm_and_si128(mask, dst), _mm_andnot_si128(mask, res));
+}
+
+inline __m128i alpha_sse2(__m128i c)
+{
+    return _mm_srli_epi32(c, 24);
+}
+
+void trans24_span_sse2(uint32_t *dst, const uint32_t *src, int count, int alpha)
+{
+    if ((unsigned int)alpha > 255)
+    {
+        trans_span<_blender_trans24>(dst, src, count, alpha);
+        return;
+    }
+    __m128i n16 = make_n16_sse2(_mm_set1_epi32(alpha ? alpha + 1 : 0));
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i x = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i y = _mm_loadu_si128((const __m128i*)(dst + i));
+        _mm_storeu_si128((__m128i*)(dst + i), skip_mask_sse2(x, y, blend_trans_sse2(x, y, n16)));
+    }
+    trans_span<_blender_trans24>(dst + i, src + i, count - i, alpha);
+}
+
+void trans24_lit_span_sse2(uint32_t *dst, const uint32_t *src, int count, int color, int light)
+{
+    if ((unsigned int)light > 255)
+    {
+        lit_span<_blender_trans24>(dst, src, count, color, light);
+        return;
+    }
+    __m128i n16 = make_n16_sse2(_mm_set1_epi32(light ? light + 1 : 0));
+    __m128i x = _mm_set1_epi32(color);
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i y = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+        _mm_storeu_si128((__m128i*)(dst + i), skip_mask_sse2(y, d, blend_trans_sse2(x, y, n16)));
+    }
+    lit_span<_blender_trans24>(dst + i, src + i, count - i, color, light);
+}
+
+void alpha_trans24_span_sse2(uint32_t *dst, const uint32_t *src, int count, int alpha)
+{
+    if ((unsigned int)alpha > 255)
+    {
+        trans_span<_myblender_alpha_trans24>(dst, src, count, alpha);
+        return;
+    }
+    const __m128i alpha_mask = _mm_set1_epi32(0xFF000000);
+    __m128i n16 = make_n16_sse2(_mm_set1_epi32(alpha ? alpha + 1 : 0));
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i x = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i y = _mm_loadu_si128((const __m128i*)(dst + i));
+        __m128i res = _mm_or_si128(blend_trans_sse2(x, y, n16), _mm_and_si128(y, alpha_mask));
+        _mm_storeu_si128((__m128i*)(dst + i), skip_mask_sse2(x, y, res));
+    }
+    trans_span<_myblender_alpha_trans24>(dst + i, src + i, count - i, alpha);
+}
+
+void alpha_trans24_lit_span_sse2(uint32_t *dst, const uint32_t *src, int count, int color, int light)
+{
+    if ((unsigned int)light > 255)
+    {
+        lit_span<_myblender_alpha_trans24>(dst, src, count, color, light);
+        return;
+    }
+    const __m128i alpha_mask = _mm_set1_epi32(0xFF000000);
+    __m128i n16 = make_n16_sse2(_mm_set1_epi32(light ? light + 1 : 0));
+    __m128i x = _mm_set1_epi32(color);
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i y = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+        __m128i res = _mm_or_si128(blend_trans_sse2(x, y, n16), _mm_and_si128(y, alpha_mask));
+        _mm_storeu_si128((__m128i*)(dst + i), skip_mask_sse2(y, d, res));
+    }
+    lit_span<_myblender_alpha_trans24>(dst + i, src + i, count - i, color, light);
+}
+
+void alpha32_span_sse2(uint32_t *dst, const uint32_t *src, int count, int alpha)
+{
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i x = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i y = _mm_loadu_si128((const __m128i*)(dst + i));
+        __m128i n16 = make_n16_sse2(inc_nonzero_sse2(alpha_sse2(x)));
+        _mm_storeu_si128((__m128i*)(dst + i), skip_mask_sse2(x, y, blend_trans_sse2(x, y, n16)));
+    }
+    trans_span<_blender_alpha32>(dst + i, src + i, count - i, alpha);
+}
+
+void trans_alpha32_span_sse2(uint32_t *dst, const uint32_t *src, int count, int alpha)
+{
+    if ((unsigned int)alpha > 255)
+    {
+        trans_span<_trans_alpha_blender32>(dst, src, count, alpha);
+        return;
+    }
+    // alpha * 255 fits in the 16-bit product
+    __m128i alpha16 = _mm_set1_epi32(alpha);
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i x = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i y = _mm_loadu_si128((const __m128i*)(dst + i));
+        __m128i n = _mm_srli_epi32(_mm_mullo_epi16(alpha_sse2(x), alpha16), 8);
+        __m128i n16 = make_n16_sse2(inc_nonzero_sse2(n));
+        _mm_storeu_si128((__m128i*)(dst + i), skip_mask_sse2(x, y, blend_trans_sse2(x, y, n16)));
+    }
+    trans_span<_trans_alpha_blender32>(dst + i, src + i, count - i, alpha);
+}
+
+void additive_alpha_span_sse2(uint32_t *dst, const uint32_t *src, int count, int alpha)
+{
+    const __m128i alpha_mask = _mm_set1_epi32(0xFF000000);
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i x = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i y = _mm_loadu_si128((const __m128i*)(dst + i));
+        __m128i res = _mm_or_si128(_mm_andnot_si128(alpha_mask, x),
+            _mm_and_si128(_mm_adds_epu8(x, y), alpha_mask));
+        _mm_storeu_si128((__m128i*)(dst + i), skip_mask_sse2(x, y, res));
+    }
+    trans_span<_additive_alpha_copysrc_blender>(dst + i, src + i, count - i, alpha);
+}
+
+void opaque_alpha_span_sse2(uint32_t *dst, const uint32_t *src, int count, int alpha)
+{
+    const __m128i alpha_mask = _mm_set1_epi32(0xFF000000);
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i x = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i y = _mm_loadu_si128((const __m128i*)(dst + i));
+        _mm_storeu_si128((__m128i*)(dst + i), skip_mask_sse2(x, y, _mm_or_si128(x, alpha_mask)));
+    }
+    trans_span<_opaque_alpha_blender>(dst + i, src + i, count - i, alpha);
+}
+
+#endif // BLENDER_SSE2
+
+void init_span_blenders(bool allow_simd)
+{
+    BlendSpan::UnregisterAll();
+    // the line blenders take alpha from the highest byte
+    if (_rgb_a_shift_32 != 24)
+        return;
+
+    BlendSpan::Register(_blender_trans24, trans_span<_blender_trans24>, lit_span<_blender_trans24>);
+    BlendSpan::Register(_blender_alpha32, trans_span<_blender_alpha32>, NULL);
+    BlendSpan::Register(_myblender_alpha_trans24, trans_span<_myblender_alpha_trans24>, lit_span<_myblender_alpha_trans24>);
+    BlendSpan::Register(_trans_alpha_blender32, trans_span<_trans_alpha_blender32>, NULL);
+    BlendSpan::Register(_argb2argb_alpha_blender, trans_span<_argb2argb_alpha_blender>, NULL);
+    BlendSpan::Register(_additive_alpha_copysrc_blender, trans_span<_additive_alpha_copysrc_blender>, NULL);
+    BlendSpan::Register(_opaque_alpha_blender, trans_span<_opaque_alpha_blender>, NULL);
+    BlendSpan::Register(_myblender_color32, trans_span<_myblender_color32>, lit_span<_myblender_color32>);
+    BlendSpan::Register(_myblender_color32_light, trans_span<_myblender_color32_light>, lit_span<_myblender_color32_light>);
+
+#if defined (BLENDER_SSE2)
+    if (allow_simd && (cpu_capabilities & CPU_SSE2))
+    {
+        BlendSpan::Register(_blender_trans24, trans24_span_sse2, trans24_lit_span_sse2);
+        BlendSpan::Register(_blender_alpha32, alpha32_span_sse2, NULL);
+        BlendSpan::Register(_myblender_alpha_trans24, alpha_trans24_span_sse2, alpha_trans24_lit_span_sse2);
+        BlendSpan::Register(_trans_alpha_blender32, trans_alpha32_span_sse2, NULL);
+        BlendSpan::Register(_additive_alpha_copysrc_blender, additive_alpha_span_sse2, NULL);
+        BlendSpan::Register(_opaque_alpha_blender, opaque_alpha_span_sse2, NULL);
+    }
+#endif
+}
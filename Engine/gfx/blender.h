@@ -50,6 +50,13 @@ unsigned long _myblender_color32(unsigned long x, unsigned long y, unsigned long
 unsigned long _myblender_color15_light(unsigned long x, unsigned long y, unsigned long n);
 unsigned long _myblender_color16_light(unsigned long x, unsigned long y, unsigned long n);
 unsigned long _myblender_color32_light(unsigned long x, unsigned long y, unsigned long n);
+unsigned long _myblender_alpha_trans24(unsigned long x, unsigned long y, unsigned long n);
+// Transparency blender that also multiplies the supplied alpha by the
+// source alpha
+unsigned long _trans_alpha_blender32(unsigned long x, unsigned long y, unsigned long n);
+unsigned long _argb2argb_alpha_blender(unsigned long src_col, unsigned long dst_col, unsigned long src_alpha);
+unsigned long _additive_alpha_copysrc_blender(unsigned long x, unsigned long y, unsigned long n);
+unsigned long _opaque_alpha_blender(unsigned long x, unsigned long y, unsigned long n);
 // Customizable alpha blender that uses the supplied alpha value as src alpha,
 // and preserves destination's alpha channel (if there was one);
 void set_my_trans_blender(int r, int g, int b, int a);
@@ -65,4 +72,10 @@ void set_additive_alpha_blender();
 // Opaque alpha blender plain copies src over, applying opaque alpha value.
 void set_opaque_alpha_blender();
 
+// Registers line versions of the 32-bit blenders above and of Allegro's
+// standard ones, which Bitmap::TransBlendBlt and LitBlendBlt use instead
+// of calling the blender for every pixel. SIMD versions are chosen when
+// the CPU supports them, unless allow_simd is false.
+void init_span_blenders(bool allow_simd = true);
+
 #endif // __AC_BLENDER_H
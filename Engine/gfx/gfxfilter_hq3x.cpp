@@ -16,9 +16,25 @@
 #include "gfx/gfxfilter_hq3x.h"
 #include "gfx/hq2x3x.h"
 #include "gfx/gfxfilterdefines.h"
+#include "gfx/gfxfilterbands.h"
+#include "platform/base/agsplatformdriver.h"
 
 using AGS::Common::Bitmap;
 namespace BitmapHelper = AGS::Common::BitmapHelper;
+namespace FilterBands = AGS::Engine::FilterBands;
+
+struct Hq3xFrame {
+    unsigned char *in;
+    unsigned char *out;
+    int width;
+    int height;
+    int outPitch;
+};
+
+void hq3x_band(void *data, int y_start, int y_end) {
+    Hq3xFrame *frame = (Hq3xFrame*)data;
+    hq3x_32_rows(frame->in, frame->out, frame->width, frame->height, frame->outPitch, y_start, y_end);
+}
 
 const char* Hq3xGFXFilter::Initialize(int width, int height, int colDepth) {
     if (colDepth < 32)
@@ -34,10 +50,12 @@ Bitmap* Hq3xGFXFilter::ScreenInitialized(Bitmap *screen, int fakeWidth, int fake
     realScreenSizedBuffer = BitmapHelper::CreateBitmap(screen->GetWidth(), screen->GetHeight(), screen->GetColorDepth());
     fakeScreen = BitmapHelper::CreateBitmap(fakeWidth, fakeHeight, screen->GetColorDepth());
     InitLUTs();
+    FilterBands::Init(platform->GetCPUCount() - 1);
     return fakeScreen;
 }
 
 Bitmap *Hq3xGFXFilter::ShutdownAndReturnRealScreen(Bitmap *currentScreen) {
+    FilterBands::Shutdown();
     delete fakeScreen;
     delete realScreenBuffer;
     delete realScreenSizedBuffer;
@@ -47,7 +65,14 @@ Bitmap *Hq3xGFXFilter::ShutdownAndReturnRealScreen(Bitmap *currentScreen) {
 void Hq3xGFXFilter::RenderScreen(Bitmap *toRender, int x, int y) {
 
     realScreenBuffer->Acquire();
-    hq3x_32(&toRender->GetScanLineForWriting(0)[0], &realScreenBuffer->GetScanLineForWriting(0)[0], toRender->GetWidth(), toRender->GetHeight(), realScreenBuffer->GetWidth() * BYTES_PER_PIXEL(realScreenBuffer->GetColorDepth()));
+    Hq3xFrame frame;
+    frame.in = &toRender->GetScanLineForWriting(0)[0];
+    frame.out = &realScreenBuffer->GetScanLineForWriting(0)[0];
+    frame.width = toRender->GetWidth();
+    frame.height = toRender->GetHeight();
+    frame.outPitch = realScreenBuffer->GetWidth() * BYTES_PER_PIXEL(realScreenBuffer->GetColorDepth());
+    // the bands are filtered on all the processors at once
+    FilterBands::Run(hq3x_band, &frame, frame.height);
     realScreenBuffer->Release();
 
     realScreen->Blit(realScreenBuffer, 0, 0, x * MULTIPLIER, y * MULTIPLIER, realScreen->GetWidth(), realScreen->GetHeight());
@@ -0,0 +1,150 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+
+#include "gfx/gfxfilterbands.h"
+#include "util/mutex.h"
+#include "util/mutex_lock.h"
+#include "util/semaphore.h"
+#include "util/thread.h"
+
+namespace AGS
+{
+namespace Engine
+{
+
+namespace FilterBands
+{
+
+#define MAX_FILTER_WORKERS  7
+// Every thread gets more than one band, so that a thread which is late to
+// wake up does not hold the whole frame back
+#define BANDS_PER_THREAD    2
+
+Thread   *Workers[MAX_FILTER_WORKERS];
+int       WorkerCount = 0;
+volatile bool Quitting = false;
+// Posted once per worker for every frame
+Semaphore WorkSemaphore;
+// Posted by the worker that finishes the last band of a frame
+Semaphore DoneSemaphore;
+
+// The frame being rendered, guarded by BandMutex
+Mutex     BandMutex;
+BAND_FUNC BandFunc;
+void     *BandData;
+int       FrameHeight;
+int       BandCount = 0;
+int       NextBand = 0;
+int       BandsDone = 0;
+
+// Renders bands of the current frame until none are left; returns true if
+// the caller has finished the last band of the frame
+bool RunBands()
+{
+    bool finished_last = false;
+    MutexLock lock(BandMutex);
+    while (NextBand < BandCount)
+    {
+        BAND_FUNC func = BandFunc;
+        void *data = BandData;
+        int y_start = FrameHeight * NextBand / BandCount;
+        int y_end = FrameHeight * (NextBand + 1) / BandCount;
+        NextBand++;
+        lock.Release();
+        func(data, y_start, y_end);
+        lock.Acquire(BandMutex);
+        finished_last = ++BandsDone == BandCount;
+    }
+    return finished_last;
+}
+
+void WorkerEntry()
+{
+    if (Quitting)
+        return;
+    WorkSemaphore.Wait();
+    if (!Quitting && RunBands())
+        DoneSemaphore.Post();
+}
+
+void Init(int worker_count)
+{
+    Shutdown();
+    if (worker_count > MAX_FILTER_WORKERS)
+        worker_count = MAX_FILTER_WORKERS;
+    Quitting = false;
+    for (WorkerCount = 0; WorkerCount < worker_count; ++WorkerCount)
+    {
+        Thread *thread = new Thread();
+        if (!thread->CreateAndStart(WorkerEntry, true))
+        {
+            delete thread;
+            break;
+        }
+        Workers[WorkerCount] = thread;
+    }
+}
+
+void Shutdown()
+{
+    if (WorkerCount == 0)
+        return;
+    // Wake up every worker; those that are not waiting return straight away
+    // until they are stopped
+    Quitting = true;
+    for (int i = 0; i < WorkerCount; ++i)
+        WorkSemaphore.Post();
+    for (int i = 0; i < WorkerCount; ++i)
+    {
+        Workers[i]->Stop();
+        delete Workers[i];
+    }
+    WorkerCount = 0;
+}
+
+int GetWorkerCount()
+{
+    return WorkerCount;
+}
+
+void Run(BAND_FUNC func, void *data, int height)
+{
+    int band_count = (WorkerCount + 1) * BANDS_PER_THREAD;
+    if (band_count > height)
+        band_count = height;
+    if (WorkerCount == 0 || band_count < 2)
+    {
+        func(data, 0, height);
+        return;
+    }
+
+    MutexLock lock(BandMutex);
+    BandFunc = func;
+    BandData = data;
+    FrameHeight = height;
+    BandCount = band_count;
+    NextBand = 0;
+    BandsDone = 0;
+    lock.Release();
+
+    for (int i = 0; i < WorkerCount; ++i)
+        WorkSemaphore.Post();
+    if (!RunBands())
+        DoneSemaphore.Wait();
+}
+
+} // namespace FilterBands
+
+} // namespace Engine
+} // namespace AGS
@@ -0,0 +1,47 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+//
+// Splits the rendering of a filtered frame into horizontal bands and runs
+// them on several threads at once.
+//
+// The worker threads are kept running between frames; the thread that calls
+// Run takes bands too, and Run returns only when the whole frame is done.
+//
+//=============================================================================
+#ifndef __AGS_EE_GFX__GFXFILTERBANDS_H
+#define __AGS_EE_GFX__GFXFILTERBANDS_H
+
+namespace AGS
+{
+namespace Engine
+{
+
+namespace FilterBands
+{
+    // Renders the rows from y_start to y_end - 1 of a frame
+    typedef void (*BAND_FUNC)(void *data, int y_start, int y_end);
+
+    // Starts worker threads, stopping the ones started before
+    void Init(int worker_count);
+    void Shutdown();
+    // Gets the number of threads running, not counting the caller
+    int  GetWorkerCount();
+    // Runs func over all the rows from 0 to height - 1 split into bands
+    void Run(BAND_FUNC func, void *data, int height);
+} // namespace FilterBands
+
+} // namespace Engine
+} // namespace AGS
+
+#endif // __AGS_EE_GFX__GFXFILTERBANDS_H
@@ -20,6 +20,7 @@
 #define __AGS_EE_GFX__GRAPHICSDRIVER_H
 
 #include "gfx/gfxmodelist.h"
+#include "util/geometry.h"
 
 struct GFXFilter;
 
@@ -83,11 +84,15 @@ public:
   virtual Common::Bitmap *ConvertBitmapToSupportedColourDepth(Common::Bitmap *bitmap) = 0;
   virtual IDriverDependantBitmap* CreateDDBFromBitmap(Common::Bitmap *bitmap, bool hasAlpha, bool opaque = false) = 0;
   virtual void UpdateDDBFromBitmap(IDriverDependantBitmap* bitmapToUpdate, Common::Bitmap *bitmap, bool hasAlpha) = 0;
+  // Updates only the part of the bitmap which has changed since the last update
+  virtual void UpdateDDBFromBitmapRect(IDriverDependantBitmap* bitmapToUpdate, Common::Bitmap *bitmap, bool hasAlpha, const Rect &changed) = 0;
   virtual void DestroyDDB(IDriverDependantBitmap* bitmap) = 0;
   virtual void ClearDrawList() = 0;
   virtual void DrawSprite(int x, int y, IDriverDependantBitmap* bitmap) = 0;
   virtual void SetScreenTint(int red, int green, int blue) = 0;
   virtual void SetRenderOffset(int x, int y) = 0;
+  virtual void EnablePartialRedraw(bool enabled) = 0;
+  virtual void InvalidateRect(int x1, int y1, int x2, int y2) = 0;
   virtual void RenderToBackBuffer() = 0;
   virtual void Render() = 0;
   virtual void Render(GlobalFlipType flip) = 0;
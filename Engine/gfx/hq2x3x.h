@@ -19,10 +19,15 @@
 void InitLUTs(){}
 void hq2x_32( unsigned char * pIn, unsigned char * pOut, int Xres, int Yres, int BpL ){}
 void hq3x_32( unsigned char * pIn, unsigned char * pOut, int Xres, int Yres, int BpL ){}
+void hq2x_32_rows( unsigned char * pIn, unsigned char * pOut, int Xres, int Yres, int BpL, int yStart, int yEnd ){}
+void hq3x_32_rows( unsigned char * pIn, unsigned char * pOut, int Xres, int Yres, int BpL, int yStart, int yEnd ){}
 #else
 void InitLUTs();
 void hq2x_32( unsigned char * pIn, unsigned char * pOut, int Xres, int Yres, int BpL );
 void hq3x_32( unsigned char * pIn, unsigned char * pOut, int Xres, int Yres, int BpL );
+// Filter only the input rows from yStart to yEnd - 1, for rendering in bands
+void hq2x_32_rows( unsigned char * pIn, unsigned char * pOut, int Xres, int Yres, int BpL, int yStart, int yEnd );
+void hq3x_32_rows( unsigned char * pIn, unsigned char * pOut, int Xres, int Yres, int BpL, int yStart, int yEnd );
 #endif
 
 #endif // __AC_HQ2X3X_H
\ No newline at end of file
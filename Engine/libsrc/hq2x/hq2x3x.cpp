@@ -21,7 +21,6 @@
 
 static int   LUT16to32[65536];
 static int   RGBtoYUV[65536];
-static int   YUV1, YUV2;
 const  int   Ymask = 0x00FF0000;
 const  int   Umask = 0x0000FF00;
 const  int   Vmask = 0x000000FF;
@@ -146,8 +145,8 @@ inline void Interp10(unsigned char * pc, int c1, int c2, int c3)
 
 inline bool Diff(unsigned int w1, unsigned int w2)
 {
-  YUV1 = RGBtoYUV[w1];
-  YUV2 = RGBtoYUV[w2];
+  int YUV1 = RGBtoYUV[w1];
+  int YUV2 = RGBtoYUV[w2];
   return ( ( abs((YUV1 & Ymask) - (YUV2 & Ymask)) > trY ) ||
            ( abs((YUV1 & Umask) - (YUV2 & Umask)) > trU ) ||
            ( abs((YUV1 & Vmask) - (YUV2 & Vmask)) > trV ) );
@@ -156,10 +155,13 @@ inline bool Diff(unsigned int w1, unsigned int w2)
 #define INPUT_IMAGE_PIXEL_SIZE uint32_t
 #define INPUT_IMAGE_PIXEL_SIZE_IN_BYTES sizeof(INPUT_IMAGE_PIXEL_SIZE)
 
-void hq2x_32( unsigned char * pIn, unsigned char * pOut, int Xres, int Yres, int BpL )
+// Processes input rows yStart to yEnd - 1; the neighbour rows are read
+// from the whole image, so any split into row bands gives the same result
+void hq2x_32_rows( unsigned char * pIn, unsigned char * pOut, int Xres, int Yres, int BpL, int yStart, int yEnd )
 {
   int  i, j, k;
   int  prevline, nextline;
+  int  YUV1, YUV2;
   int  w[10];
   int  c[10];
 
@@ -174,7 +176,10 @@ void hq2x_32( unsigned char * pIn, unsigned char * pOut, int Xres, int Yres, int
   //   | w7 | w8 | w9 |
   //   +----+----+----+
 
-  for (j=0; j<Yres; j++)
+  pIn += yStart*Xres*INPUT_IMAGE_PIXEL_SIZE_IN_BYTES;
+  pOut += yStart*(8*Xres+BpL);
+
+  for (j=yStart; j<yEnd; j++)
   {
     if (j>0)      prevline = -Xres*4; else prevline = 0;
     if (j<Yres-1) nextline =  Xres*4; else nextline = 0;
@@ -2890,6 +2895,11 @@ void hq2x_32( unsigned char * pIn, unsigned char * pOut, int Xres, int Yres, int
   }
 }
 
+void hq2x_32( unsigned char * pIn, unsigned char * pOut, int Xres, int Yres, int BpL )
+{
+  hq2x_32_rows(pIn, pOut, Xres, Yres, BpL, 0, Yres);
+}
+
 void InitLUTs(void)
 {
   int i, j, k, r, g, b, Y, u, v;
@@ -2972,10 +2982,13 @@ void InitLUTs(void)
 
 
 
-void hq3x_32( unsigned char * pIn, unsigned char * pOut, int Xres, int Yres, int BpL )
+// Processes input rows yStart to yEnd - 1; the neighbour rows are read
+// from the whole image, so any split into row bands gives the same result
+void hq3x_32_rows( unsigned char * pIn, unsigned char * pOut, int Xres, int Yres, int BpL, int yStart, int yEnd )
 {
   int  i, j, k;
   int  prevline, nextline;
+  int  YUV1, YUV2;
   int  w[10];
   int  c[10];
 
@@ -2990,7 +3003,10 @@ void hq3x_32( unsigned char * pIn, unsigned char * pOut, int Xres, int Yres, int
   //   | w7 | w8 | w9 |
   //   +----+----+----+
 
-  for (j=0; j<Yres; j++)
+  pIn += yStart*Xres*INPUT_IMAGE_PIXEL_SIZE_IN_BYTES;
+  pOut += yStart*(12*Xres+2*BpL);
+
+  for (j=yStart; j<yEnd; j++)
   {
     if (j>0)      prevline = -Xres*4; else prevline = 0;
     if (j<Yres-1) nextline =  Xres*4; else nextline = 0;
@@ -6679,3 +6695,8 @@ void hq3x_32( unsigned char * pIn, unsigned char * pOut, int Xres, int Yres, int
     pOut+=BpL;
   }
 }
+
+void hq3x_32( unsigned char * pIn, unsigned char * pOut, int Xres, int Yres, int BpL )
+{
+  hq3x_32_rows(pIn, pOut, Xres, Yres, BpL, 0, Yres);
+}
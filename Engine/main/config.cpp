@@ -18,12 +18,18 @@
 
 #include "ac/gamesetup.h"
 #include "ac/gamestate.h"
+#include "ac/dynobj/managedobjectpool.h"
+#include "ac/route_finder.h"
 #include "debug/debug_log.h"
+#include "font/glyphcache.h"
 #include "main/mainheader.h"
 #include "main/config.h"
+#include "media/audio/audiostreamsource.h"
 #include "ac/spritecache.h"
+#include "ac/spritetransformcache.h"
 #include "platform/base/agsplatformdriver.h"
 #include "platform/base/override_defines.h" //_getcwd()
+#include "script/cc_options.h"
 #include "util/filestream.h"
 #include "util/textstreamreader.h"
 #include "util/path.h"
@@ -219,6 +225,7 @@ void read_config_file(char *argv0) {
         usetup.midicard = idx;
 #endif
         psp_audio_multithreaded = INIreadint("sound", "threaded", psp_audio_multithreaded);
+        audio_stream_lookahead = INIreadint("sound", "stream_lookahead", audio_stream_lookahead);
 
         usetup.windowed = INIreadint("misc","windowed");
         usetup.refresh = INIreadint ("misc", "refresh");
@@ -278,6 +285,23 @@ void read_config_file(char *argv0) {
         spriteset.maxCacheSize = INIreadint ("misc", "cachemax", 20) * 1024;
 #endif
 
+        // Memory for the scaled, flipped and tinted character and object
+        // images, in KB; 0 disables keeping them
+        set_sprite_transform_cache_size(INIreadint("misc", "transformcachemax", 4096) * 1024);
+
+        // Memory for the rasterised text characters, in KB; 0 disables
+        // keeping them
+        set_glyph_cache_size(INIreadint("misc", "glyphcachemax", 1024) * 1024);
+
+        // Number of unreferenced managed objects checked per game tick;
+        // 0 makes the engine sweep the whole pool once in a while instead
+        pool.SetGarbageCollectionBudget(INIreadint("misc", "gcbudget", GARBAGE_COLLECTION_DEFAULT_BUDGET));
+
+        // Pixels between the pathfinder nodes, from 1 to 3; 0 steps by the
+        // walkable area granularity, larger values make long routes faster
+        // to find
+        set_route_node_granularity(INIreadint("misc", "pathfinder_granularity", 0));
+
         char *repfile = INIreaditem ("misc", "replay");
         if (repfile != NULL) {
             strcpy (replayfile, repfile);
@@ -307,6 +331,11 @@ void read_config_file(char *argv0) {
             usetup.override_script_os = eOS_Mac;
         }
         usetup.override_upscale = INIreadint("override", "upscale") > 0;
+        // Decode script instructions as they are executed instead of
+        // translating the code on load; useful for comparing the two
+        ccSetOption(SCOPT_LEGACYRUN, INIreadint("override", "legacyscriptrun"));
+        // Collect frequencies of executed instruction sequences
+        ccSetOption(SCOPT_PROFILERUN, INIreadint("override", "scriptprofile"));
 
         // NOTE: at the moment AGS provide little means to determine whether an
         // option was overriden by command line, and since command line args
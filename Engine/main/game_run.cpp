@@ -40,6 +40,7 @@
 #include "ac/roomobject.h"
 #include "ac/roomstatus.h"
 #include "ac/roomstruct.h"
+#include "ac/dynobj/managedobjectpool.h"
 #include "debug/debugger.h"
 #include "debug/debug_log.h"
 #include "gui/guiinv.h"
@@ -97,6 +98,9 @@ int user_disabled_data3=0;
 
 int restrict_until=0;
 
+// How often the managed object collector reports its counters, in game loops
+const int GC_STATS_LOG_INTERVAL = 400;
+
 void game_loop_check_want_exit()
 {
     if (want_exit) {
@@ -222,7 +226,7 @@ void check_controls() {
 
             if (mousey < guis[aa].popupyp) {
                 set_mouse_cursor(CURS_ARROW);
-                guis[aa].on=1; guis_need_update = 1;
+                guis[aa].on=1; guis[aa].invalidate();
                 ifacepopped=aa; PauseGame();
                 break;
             }
@@ -637,6 +641,16 @@ void game_loop_update_loop_counter()
         update_ambient_sound_vol();
         update_directional_sound_vol();
     }
+
+    pool.StartGarbageCollectionTick();
+    if (loopcounter % GC_STATS_LOG_INTERVAL == 0)
+    {
+        const ManagedObjectPoolStats &gc_stats = pool.GetGarbageCollectionStats();
+        if (gc_stats.objectsFreed > 0)
+            debug_log("Managed objects: %d freed, %d alive, %d pending; collection took %d us",
+                gc_stats.objectsFreed, gc_stats.poolSize, gc_stats.pendingCandidates, gc_stats.sweepTimeUs);
+        pool.ResetGarbageCollectionStats();
+    }
 }
 
 void game_loop_check_replay_record()
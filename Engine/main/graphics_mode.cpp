@@ -34,6 +34,7 @@
 #include "platform/base/agsplatformdriver.h"
 #include "gfx/graphicsdriver.h"
 #include "gfx/bitmap.h"
+#include "gfx/blender.h"
 #include "main/main_allegro.h"
 #include "util/geometry.h"
 #include "util/math.h"
@@ -813,6 +814,9 @@ void engine_post_init_gfx_driver()
 {
 	_old_screen = BitmapHelper::GetScreenBitmap();
 
+    // the pixel format is known only now
+    init_span_blenders();
+
     if (gfxDriver->HasAcceleratedStretchAndFlip()) 
     {
         walkBehindMethod = DrawAsSeparateSprite;
@@ -431,6 +431,12 @@ int main(int argc,char*argv[]) {
 
 #ifdef _DEBUG
     Test_DoAllTests();
+    // the timing loops are only run on demand
+    if ((argc > 1) && (stricmp(argv[1], "--benchmark") == 0))
+    {
+        Test_DoAllBenchmarks();
+        return 0;
+    }
 #endif
     
     int res;
@@ -32,7 +32,10 @@
 #include "main/main.h"
 #include "main/mainheader.h"
 #include "main/quit.h"
+#include "media/audio/audiocommands.h"
+#include "media/audio/audiostreamsource.h"
 #include "ac/spritecache.h"
+#include "ac/spritetransformcache.h"
 #include "gfx/graphicsdriver.h"
 #include "gfx/bitmap.h"
 #include "core/assetmanager.h"
@@ -130,6 +133,10 @@ void quit_shutdown_audio()
 
     // Quit the sound thread.
     audioThread.Stop();
+    // destroy the clips it has not got to
+    run_audio_commands();
+    delete_closed_audio_stream_sources();
+    log_audio_command_stats();
 
     remove_sound();
 }
@@ -276,6 +283,11 @@ void quit(const char *quitmsg) {
 
     quit_shutdown_scripts();
 
+    // stop decoding sprites in background
+    spriteset.stopPrefetch();
+    clear_transformed_sprites();
+    shutdown_pathfinder();
+
     quit_shutdown_platform(qmsg);
 
     our_eip = 9019;
@@ -15,6 +15,8 @@
 #include <stdio.h>
 #include "util/wgt2allg.h"
 #include "media/audio/audio.h"
+#include "media/audio/audiocommands.h"
+#include "media/audio/audiostreamsource.h"
 #include "ac/gamesetupstruct.h"
 #include "ac/dynobj/cc_audioclip.h"
 #include "ac/dynobj/cc_audiochannel.h"
@@ -35,9 +37,6 @@
 
 using AGS::Common::Stream;
 
-AGS::Engine::Mutex _audio_mutex;
-volatile bool _audio_doing_crossfade;
-
 extern GameSetupStruct game;
 extern GameSetup usetup;
 extern GameState play;
@@ -52,6 +51,11 @@ extern volatile int switching_away_from_game;
 volatile int psp_audio_multithreaded = 0;
 #endif
 
+// set by the display switch callbacks, which must not post audio commands
+// themselves as they run on a different thread than the game
+volatile int audio_switched_out = 0;
+static int clips_paused_for_switch = 0;
+
 ScriptAudioChannel scrAudioChannel[MAX_SOUND_CHANNELS + 1];
 char acaudio_buffer[256];
 int reserved_channel_count = 0;
@@ -454,11 +458,7 @@ void stop_and_destroy_channel_ex(int chid, bool resetLegacyMusicSettings) {
     if ((chid < 0) || (chid > MAX_SOUND_CHANNELS))
         quit("!StopChannel: invalid channel ID");
 
-    if (channels[chid] != NULL) {
-        channels[chid]->destroy();
-        delete channels[chid];
-        channels[chid] = NULL;
-    }
+    destroy_channel_clip(chid);
 
     if (play.crossfading_in_channel == chid)
         play.crossfading_in_channel = 0;
@@ -708,8 +708,6 @@ int crossFading = 0, crossFadeVolumePerStep = 0, crossFadeStep = 0;
 int crossFadeVolumeAtStart = 0;
 SOUNDCLIP *cachedQueuedMusic = NULL;
 
-int musicPollIterator; // long name so it doesn't interfere with anything else
-
 volatile int mvolcounter = 0;
 int update_music_at=0;
 
@@ -827,18 +825,35 @@ extern int frames_per_second;
 
 void update_mp3_thread()
 {
-	while (switching_away_from_game) { }
-	AGS::Engine::MutexLock _lock(_audio_mutex);
-	for (musicPollIterator = 0; musicPollIterator <= MAX_SOUND_CHANNELS; ++musicPollIterator)
-	{
-		if ((channels[musicPollIterator] != NULL) && (channels[musicPollIterator]->done == 0))
-			channels[musicPollIterator]->poll();
-	}
+    run_audio_commands();
+    // the clips are being paused while switching away
+    if (!switching_away_from_game)
+        poll_audio_clips();
+}
+
+// Pauses or resumes the playing clips after the display was switched
+void update_switched_out_clips()
+{
+    int switched_out = audio_switched_out;
+    if (switched_out == clips_paused_for_switch)
+        return;
+    clips_paused_for_switch = switched_out;
+    for (int i = 0; i <= MAX_SOUND_CHANNELS; i++) {
+        if ((channels[i] != NULL) && (channels[i]->done == 0)) {
+            if (switched_out)
+                channels[i]->pause();
+            else
+                channels[i]->resume();
+        }
+    }
 }
 
 void update_mp3()
 {
-	if (!psp_audio_multithreaded) update_mp3_thread();
+    update_switched_out_clips();
+    sync_polled_clips();
+    if (!psp_audio_multithreaded) update_mp3_thread();
+    delete_closed_audio_stream_sources();
 }
 
 void update_polled_mp3() {
@@ -859,10 +874,6 @@ void update_polled_audio_and_crossfade ()
 {
 	update_polled_stuff_if_runtime ();
 
-	AGS::Engine::MutexLock _lock(_audio_mutex);
-
-    _audio_doing_crossfade = true;
-
     audio_update_polled_stuff();
 
     if (crossFading) {
@@ -893,8 +904,6 @@ void update_polled_audio_and_crossfade ()
         }
     }
 
-    _audio_doing_crossfade = false;
-
 }
 
 
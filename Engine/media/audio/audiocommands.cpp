@@ -0,0 +1,240 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+
+#include <stdio.h>
+#include "media/audio/audiocommands.h"
+#include "media/audio/audio.h"
+#include "media/audio/soundclip.h"
+#include "debug/out.h"
+#include "platform/base/agsplatformdriver.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace Out = AGS::Common::Out;
+
+// must be a power of two, so that the indexes may wrap around
+#define AUDIO_COMMAND_RING_SIZE 256
+
+enum AudioCommandType
+{
+    kAudioCmd_SetChannelClip,
+    kAudioCmd_DestroyClip,
+    kAudioCmd_SetVolume,
+    kAudioCmd_SetPanning,
+    kAudioCmd_Pause,
+    kAudioCmd_Resume,
+    kAudioCmd_Seek
+};
+
+struct AudioCommand
+{
+    AudioCommandType type;
+    int channel;
+    SOUNDCLIP *clip;
+    int value;      // volume or position
+    int panning;
+};
+
+AudioCommand audio_commands[AUDIO_COMMAND_RING_SIZE];
+// Each index is written by one thread only: the count of the posted
+// commands by the game thread, the count of the run ones by the polling thread
+volatile unsigned int audio_commands_posted = 0;
+volatile unsigned int audio_commands_run = 0;
+unsigned int audio_commands_most_pending = 0;
+unsigned int audio_command_ring_full = 0;
+
+// The clips as the polling thread will see them after running the commands
+SOUNDCLIP *posted_clips[MAX_SOUND_CHANNELS + 1];
+// The clips the polling thread works with
+SOUNDCLIP *polled_clips[MAX_SOUND_CHANNELS + 1];
+
+// Makes the command written before the index is moved on, and read after
+// the moved index is seen
+inline void audio_command_barrier()
+{
+#if defined(_MSC_VER)
+    // x86 does not reorder stores with stores or loads with loads
+    _ReadWriteBarrier();
+#elif defined(PSP_VERSION) || defined(WII_VERSION)
+    // single core, only the compiler could reorder
+    __asm__ __volatile__ ("" : : : "memory");
+#else
+    __sync_synchronize();
+#endif
+}
+
+void run_audio_command(const AudioCommand &cmd)
+{
+    switch (cmd.type)
+    {
+    case kAudioCmd_SetChannelClip:
+        polled_clips[cmd.channel] = cmd.clip;
+        break;
+    case kAudioCmd_DestroyClip:
+        for (int i = 0; i <= MAX_SOUND_CHANNELS; ++i)
+        {
+            if (polled_clips[i] == cmd.clip)
+                polled_clips[i] = NULL;
+        }
+        cmd.clip->destroy();
+        delete cmd.clip;
+        break;
+    case kAudioCmd_SetVolume:
+        cmd.clip->apply_volume(cmd.value, cmd.panning);
+        break;
+    case kAudioCmd_SetPanning:
+        cmd.clip->apply_panning(cmd.panning);
+        break;
+    case kAudioCmd_Pause:
+        cmd.clip->apply_pause();
+        break;
+    case kAudioCmd_Resume:
+        cmd.clip->apply_resume();
+        break;
+    case kAudioCmd_Seek:
+        cmd.clip->apply_seek(cmd.value);
+        break;
+    }
+}
+
+void post_audio_command(AudioCommandType type, int channel, SOUNDCLIP *clip, int value = 0, int panning = 0)
+{
+    AudioCommand cmd;
+    cmd.type = type;
+    cmd.channel = channel;
+    cmd.clip = clip;
+    cmd.value = value;
+    cmd.panning = panning;
+
+    if (!psp_audio_multithreaded)
+    {
+        // keep the order of anything posted before the audio thread failed to start
+        run_audio_commands();
+        run_audio_command(cmd);
+        return;
+    }
+
+    unsigned int posted = audio_commands_posted;
+    if (posted - audio_commands_run >= AUDIO_COMMAND_RING_SIZE)
+    {
+        // the audio thread is far behind; this is not expected to happen
+        // with the ring that large, but the command must not be lost
+        audio_command_ring_full++;
+        while (posted - audio_commands_run >= AUDIO_COMMAND_RING_SIZE)
+            AGSPlatformDriver::GetDriver()->YieldCPU();
+    }
+    audio_commands[posted % AUDIO_COMMAND_RING_SIZE] = cmd;
+    audio_command_barrier();
+    audio_commands_posted = posted + 1;
+
+    unsigned int pending = posted + 1 - audio_commands_run;
+    if (pending > audio_commands_most_pending)
+        audio_commands_most_pending = pending;
+}
+
+void sync_polled_clips()
+{
+    for (int i = 0; i <= MAX_SOUND_CHANNELS; ++i)
+    {
+        if (posted_clips[i] != channels[i])
+        {
+            posted_clips[i] = channels[i];
+            if (channels[i] != NULL)
+                channels[i]->posted = true;
+            post_audio_command(kAudioCmd_SetChannelClip, i, channels[i]);
+        }
+    }
+}
+
+void destroy_channel_clip(int chid)
+{
+    SOUNDCLIP *clip = channels[chid];
+    if (clip == NULL)
+        return;
+    channels[chid] = NULL;
+    // the clip may have been moved to another channel since the last sync
+    sync_polled_clips();
+    post_audio_command(kAudioCmd_DestroyClip, chid, clip);
+}
+
+void post_clip_command(AudioCommandType type, SOUNDCLIP *clip, int value = 0, int panning = 0)
+{
+    if (!clip->posted)
+    {
+        // the polling thread does not know the clip yet, e.g. it is being
+        // set up before playing, so the decoder may be called at once
+        AudioCommand cmd;
+        cmd.type = type;
+        cmd.channel = -1;
+        cmd.clip = clip;
+        cmd.value = value;
+        cmd.panning = panning;
+        run_audio_command(cmd);
+        return;
+    }
+    post_audio_command(type, -1, clip, value, panning);
+}
+
+void set_clip_volume(SOUNDCLIP *clip, int volume)
+{
+    post_clip_command(kAudioCmd_SetVolume, clip, volume, clip->panning);
+}
+
+void set_clip_panning(SOUNDCLIP *clip, int panning)
+{
+    post_clip_command(kAudioCmd_SetPanning, clip, 0, panning);
+}
+
+void pause_clip(SOUNDCLIP *clip)
+{
+    post_clip_command(kAudioCmd_Pause, clip);
+}
+
+void resume_clip(SOUNDCLIP *clip)
+{
+    post_clip_command(kAudioCmd_Resume, clip);
+}
+
+void seek_clip(SOUNDCLIP *clip, int pos)
+{
+    post_clip_command(kAudioCmd_Seek, clip, pos);
+}
+
+void run_audio_commands()
+{
+    unsigned int run = audio_commands_run;
+    unsigned int posted = audio_commands_posted;
+    audio_command_barrier();
+    for (; run != posted; ++run)
+        run_audio_command(audio_commands[run % AUDIO_COMMAND_RING_SIZE]);
+    audio_command_barrier();
+    audio_commands_run = run;
+}
+
+void poll_audio_clips()
+{
+    for (int i = 0; i <= MAX_SOUND_CHANNELS; ++i)
+    {
+        if ((polled_clips[i] != NULL) && (polled_clips[i]->done == 0))
+            polled_clips[i]->poll();
+    }
+}
+
+void log_audio_command_stats()
+{
+    Out::FPrint("Audio commands: %u passed to the audio thread, at most %u pending, ring full %u times",
+        audio_commands_posted, audio_commands_most_pending, audio_command_ring_full);
+}
@@ -0,0 +1,52 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+//
+// Commands from the game thread to the thread that polls audio clips.
+//
+// The game thread works with the clips through channels[], while the polling
+// thread keeps a list of its own, which changes only when the commands are
+// run. Commands are passed through a fixed-size ring with one writer and one
+// reader, so neither thread waits for the other: the game thread posts what
+// has changed in channels[] and which clips are to be destroyed, and the
+// polling thread runs the commands before each pass. A clip is destroyed by
+// the polling thread, so it is never freed while being polled. Once a clip
+// was passed to the polling thread, its volume, panning, pausing and seeking
+// are passed the same way, so that only that thread calls the decoder.
+//
+// Without the audio thread the commands are run at once by the game thread.
+//
+//=============================================================================
+#ifndef __AC_AUDIOCOMMANDS_H
+#define __AC_AUDIOCOMMANDS_H
+
+struct SOUNDCLIP;
+
+// Posts the changes made to channels[] since the last call
+void sync_polled_clips();
+// Takes the clip off the channel; it is destroyed once it is not polled
+void destroy_channel_clip(int chid);
+// Sets the volume the decoder plays at, with all modifiers applied
+void set_clip_volume(SOUNDCLIP *clip, int volume);
+void set_clip_panning(SOUNDCLIP *clip, int panning);
+void pause_clip(SOUNDCLIP *clip);
+void resume_clip(SOUNDCLIP *clip);
+void seek_clip(SOUNDCLIP *clip, int pos);
+// Polling thread: runs the pending commands
+void run_audio_commands();
+// Polling thread: polls the clips that have not finished playing
+void poll_audio_clips();
+// Writes the command counts to the log
+void log_audio_command_stats();
+
+#endif // __AC_AUDIOCOMMANDS_H
@@ -0,0 +1,193 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+
+#include <stdlib.h>
+#include <string.h>
+#include "util/wgt2allg.h"
+#include "ac/file.h"
+#include "media/audio/audiostreamsource.h"
+#include "media/audio/audiointernaldefs.h"
+#include "media/audio/soundclip.h"
+#include "debug/out.h"
+#include "util/mutex.h"
+#include "util/mutex_lock.h"
+#include "util/stream.h"
+
+using AGS::Common::Stream;
+namespace Out = AGS::Common::Out;
+
+// Largest piece of the file read on one poll
+#define AUDIO_STREAM_READ_BLOCK 8192
+
+int audio_stream_lookahead = 128;
+
+AudioStreamSource *closed_audio_stream_sources = NULL;
+AGS::Engine::Mutex _closed_audio_stream_sources_mutex;
+
+int AudioStreamSource::read(char *buffer, int size)
+{
+    if (size > remaining)
+        size = (int)remaining;
+    if (size <= 0)
+        return 0;
+
+    if (mapped)
+    {
+        memcpy(buffer, data + (length - remaining), size);
+        remaining -= size;
+        return size;
+    }
+
+    int copied = 0;
+    while ((copied < size) && (ring_filled > 0))
+    {
+        int part = size - copied;
+        if (part > ring_filled)
+            part = ring_filled;
+        if (part > ring_size - ring_start)
+            part = ring_size - ring_start;
+        memcpy(buffer + copied, ring + ring_start, part);
+        ring_start = (ring_start + part) % ring_size;
+        ring_filled -= part;
+        copied += part;
+    }
+    if ((copied < size) && (file_remaining > 0))
+    {
+        // the decoder has caught up with the look-ahead
+        readahead_misses++;
+        long got = pack_fread(buffer + copied, size - copied, file);
+        if (got > 0)
+        {
+            copied += got;
+            file_remaining -= got;
+        }
+    }
+    remaining -= copied;
+    return copied;
+}
+
+void AudioStreamSource::read_ahead()
+{
+    if ((file == NULL) || (file_remaining <= 0))
+        return;
+
+    int end = (ring_start + ring_filled) % ring_size;
+    int block = ring_size - ring_filled;
+    // read up to the end of the ring this time, the rest on the next poll
+    if (block > ring_size - end)
+        block = ring_size - end;
+    if (block > AUDIO_STREAM_READ_BLOCK)
+        block = AUDIO_STREAM_READ_BLOCK;
+    if (block > file_remaining)
+        block = (int)file_remaining;
+    if (block <= 0)
+        return;
+
+    long got = pack_fread(ring + end, block, file);
+    if (got <= 0)
+    {
+        file_remaining = 0;
+        return;
+    }
+    ring_filled += got;
+    file_remaining -= got;
+}
+
+AudioStreamSource *open_audio_stream_source(const char *filename)
+{
+    Stream *mapped_in = open_mapped_asset(filename);
+    PACKFILE *file_in = NULL;
+    if (mapped_in == NULL)
+    {
+        file_in = pack_fopen(filename, "rb");
+        if (file_in == NULL)
+            return NULL;
+    }
+
+    AudioStreamSource *source = new AudioStreamSource();
+    source->name = (char*)malloc(strlen(filename) + 1);
+    strcpy(source->name, filename);
+    source->mapped = mapped_in;
+    source->data = NULL;
+    source->file = file_in;
+    source->file_remaining = 0;
+    source->ring = NULL;
+    source->ring_size = 0;
+    source->ring_start = 0;
+    source->ring_filled = 0;
+    source->readahead_misses = 0;
+    source->next_closed = NULL;
+
+    if (mapped_in)
+    {
+        source->data = (const char*)mapped_in->GetDataAt(mapped_in->GetPosition());
+        source->length = mapped_in->GetLength() - mapped_in->GetPosition();
+    }
+    else
+    {
+        source->length = file_in->todo;
+        source->file_remaining = source->length;
+        // the decoder asks for a whole chunk at a time
+        source->ring_size = audio_stream_lookahead * 1024;
+        if (source->ring_size < MP3CHUNKSIZE)
+            source->ring_size = MP3CHUNKSIZE;
+        source->ring = (char*)malloc(source->ring_size);
+        while ((source->file_remaining > 0) && (source->ring_filled < source->ring_size))
+            source->read_ahead();
+    }
+    source->remaining = source->length;
+    return source;
+}
+
+void delete_audio_stream_source(AudioStreamSource *source)
+{
+    if (source->readahead_misses > 0)
+        Out::FPrint("Audio stream %s: %d reads missed the %d KB look-ahead",
+            source->name, source->readahead_misses, source->ring_size / 1024);
+    if (source->mapped)
+        delete source->mapped;
+    if (source->file)
+        pack_fclose(source->file);
+    free(source->ring);
+    free(source->name);
+    delete source;
+}
+
+void close_audio_stream_source(AudioStreamSource *source)
+{
+    if (!psp_audio_multithreaded)
+    {
+        delete_audio_stream_source(source);
+        return;
+    }
+
+    AGS::Engine::MutexLock _lock(_closed_audio_stream_sources_mutex);
+    source->next_closed = closed_audio_stream_sources;
+    closed_audio_stream_sources = source;
+}
+
+void delete_closed_audio_stream_sources()
+{
+    AGS::Engine::MutexLock _lock(_closed_audio_stream_sources_mutex);
+    AudioStreamSource *source = closed_audio_stream_sources;
+    closed_audio_stream_sources = NULL;
+    _lock.Release();
+
+    while (source)
+    {
+        AudioStreamSource *next = source->next_closed;
+        delete_audio_stream_source(source);
+        source = next;
+    }
+}
@@ -0,0 +1,75 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+//
+// Compressed data of a streamed clip, handed to the decoder in pieces.
+//
+// A clip in a data file mapped into memory is read in place, so playing it
+// does not read the file at all. Otherwise the data is read ahead into a
+// ring of audio_stream_lookahead KB, a small block on each poll, so that the
+// decoder finds it ready when it needs more; when it does not, the rest is
+// read at once and counted as a read-ahead miss. Either way only the
+// look-ahead is kept in memory, however long the clip is.
+//
+// Static clips do not use it: they may be seeked and looped, which the
+// decoders only do with the whole clip in memory. They play a mapped clip
+// in place, and read the whole file into the sound cache otherwise.
+//
+// Sources are opened by the game thread, which works with the AssetManager,
+// and read by the thread that polls the clips. A closed source is deleted
+// by the game thread later, in delete_closed_audio_stream_sources.
+//
+//=============================================================================
+#ifndef __AC_AUDIOSTREAMSOURCE_H
+#define __AC_AUDIOSTREAMSOURCE_H
+
+struct PACKFILE;
+namespace AGS { namespace Common { class Stream; } }
+
+struct AudioStreamSource
+{
+    char *name;
+    // Asset mapped into memory, read in place
+    AGS::Common::Stream *mapped;
+    const char *data;
+    // Or the file, read into the ring first
+    PACKFILE *file;
+    long file_remaining;
+    char *ring;
+    int ring_size;
+    int ring_start;
+    int ring_filled;
+
+    long length;
+    // Count of bytes not yet handed to the decoder
+    long remaining;
+    // Count of reads which the ring could not fill before the end of file
+    int readahead_misses;
+    AudioStreamSource *next_closed;
+
+    // Copies the next size bytes into the buffer; returns the count copied
+    int read(char *buffer, int size);
+    // Reads the next block of the file into the ring, if there is room
+    void read_ahead();
+};
+
+// Size of the ring of data read ahead, in KB
+extern int audio_stream_lookahead;
+
+AudioStreamSource *open_audio_stream_source(const char *filename);
+// Stops using the source; it is deleted by the game thread
+void close_audio_stream_source(AudioStreamSource *source);
+// Deletes the sources closed since the last call, logging their read-ahead misses
+void delete_closed_audio_stream_sources();
+
+#endif // __AC_AUDIOSTREAMSOURCE_H
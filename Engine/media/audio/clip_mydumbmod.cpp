@@ -18,6 +18,7 @@
 
 #include "media/audio/clip_mydumbmod.h"
 #include "media/audio/audiointernaldefs.h"
+#include "media/audio/audiocommands.h"
 
 void al_duh_set_loop(AL_DUH_PLAYER *dp, int loop) {
     DUH_SIGRENDERER *sr = al_duh_get_sigrenderer(dp);
@@ -50,13 +51,15 @@ int MYMOD::poll()
 void MYMOD::set_volume(int newvol)
 {
     vol = newvol;
+    newvol += volModifier + directionalVolModifier;
+    if (newvol < 0) newvol = 0;
+    set_clip_volume(this, newvol);
+}
 
+void MYMOD::apply_volume(int volume, int pan)
+{
     if (duhPlayer)
-    {
-        newvol += volModifier + directionalVolModifier;
-        if (newvol < 0) newvol = 0;
-        al_duh_set_volume(duhPlayer, VOLUME_TO_DUMB_VOL(newvol));
-    }
+        al_duh_set_volume(duhPlayer, VOLUME_TO_DUMB_VOL(volume));
 }
 
 void MYMOD::destroy()
@@ -71,7 +74,7 @@ void MYMOD::destroy()
     }
 }
 
-void MYMOD::seek(int patnum)
+void MYMOD::apply_seek(int patnum)
 {
     if ((!done) && (duhPlayer)) {
         al_stop_duh(duhPlayer);
@@ -135,13 +138,13 @@ int MYMOD::get_voice()
     return -1;
 }
 
-void MYMOD::pause() {
+void MYMOD::apply_pause() {
     if (tune != NULL) {
         al_pause_duh(duhPlayer);
     }
 }
 
-void MYMOD::resume() {
+void MYMOD::apply_resume() {
     if (tune != NULL) {
         al_resume_duh(duhPlayer);
     }
@@ -32,9 +32,11 @@ struct MYMOD : public SOUNDCLIP
 
     void set_volume(int newvol);
 
+    void apply_volume(int volume, int pan);
+
     void destroy();
 
-    void seek(int patnum);
+    void apply_seek(int patnum);
 
     // NOTE: this implementation of the virtual function returns a MOD/XM
     // "order" index, not actual playing position;
@@ -56,9 +58,9 @@ struct MYMOD : public SOUNDCLIP
 
     int get_voice();
 
-    virtual void pause();
+    virtual void apply_pause();
 
-    virtual void resume();
+    virtual void apply_resume();
 
     int get_sound_type();
 
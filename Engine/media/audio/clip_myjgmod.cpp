@@ -18,6 +18,7 @@
 
 #include "media/audio/clip_myjgmod.h"
 #include "media/audio/audiointernaldefs.h"
+#include "media/audio/audiocommands.h"
 
 int MYMOD::poll()
 {
@@ -33,8 +34,13 @@ int MYMOD::poll()
 void MYMOD::set_volume(int newvol)
 {
     vol = newvol;
+    set_clip_volume(this, newvol);
+}
+
+void MYMOD::apply_volume(int volume, int pan)
+{
     if (!done)
-        set_mod_volume(newvol);
+        set_mod_volume(volume);
 }
 
 void MYMOD::destroy()
@@ -44,7 +50,7 @@ void MYMOD::destroy()
     tune = NULL;
 }
 
-void MYMOD::seek(int patnum)
+void MYMOD::apply_seek(int patnum)
 {
     if (is_mod_playing() != 0)
         goto_mod_track(patnum);
@@ -28,9 +28,11 @@ struct MYMOD:public SOUNDCLIP
 
     void set_volume(int newvol);
 
+    void apply_volume(int volume, int pan);
+
     void destroy();
 
-    void seek(int patnum);
+    void apply_seek(int patnum);
 
     int get_pos();
 
@@ -16,6 +16,7 @@
 #include "util/wgt2allg.h"
 #include "media/audio/clip_mymidi.h"
 #include "media/audio/audiointernaldefs.h"
+#include "media/audio/audiocommands.h"
 
 int MYMIDI::poll()
 {
@@ -36,7 +37,12 @@ void MYMIDI::set_volume(int newvol)
     vol = newvol;
     newvol += volModifier + directionalVolModifier;
     if (newvol < 0) newvol = 0;
-    ::set_volume(-1, newvol);
+    set_clip_volume(this, newvol);
+}
+
+void MYMIDI::apply_volume(int volume, int pan)
+{
+    ::set_volume(-1, volume);
 }
 
 void MYMIDI::destroy()
@@ -46,7 +52,7 @@ void MYMIDI::destroy()
     tune = NULL;
 }
 
-void MYMIDI::seek(int pos)
+void MYMIDI::apply_seek(int pos)
 {
     midi_seek(pos);
 }
@@ -81,11 +87,11 @@ int MYMIDI::get_voice()
     return -1;
 }
 
-void MYMIDI::pause() {
+void MYMIDI::apply_pause() {
     midi_pause();
 }
 
-void MYMIDI::resume() {
+void MYMIDI::apply_resume() {
     midi_resume();
 }
 
@@ -31,9 +31,11 @@ struct MYMIDI:public SOUNDCLIP
 
     void set_volume(int newvol);
 
+    void apply_volume(int volume, int pan);
+
     void destroy();
 
-    void seek(int pos);
+    void apply_seek(int pos);
 
     int get_pos();
 
@@ -45,9 +47,9 @@ struct MYMIDI:public SOUNDCLIP
 
     int get_voice();
 
-    virtual void pause();
+    virtual void apply_pause();
 
-    virtual void resume();
+    virtual void apply_resume();
 
     int get_sound_type();
 
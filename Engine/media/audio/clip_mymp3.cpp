@@ -18,22 +18,13 @@
 
 #include "media/audio/clip_mymp3.h"
 #include "media/audio/audiointernaldefs.h"
+#include "media/audio/audiocommands.h"
 #include "ac/common.h"               // quit()
 #include "util/mutex_lock.h"
 
-#include "platform/base/agsplatformdriver.h"
-
 
 int MYMP3::poll()
 {
-	AGS::Engine::MutexLock _lock(_mutex);
-
-    if (!done && _destroyThis)
-    {
-      internal_destroy();
-      _destroyThis = false;
-    }
-
     if (done)
     {
         return done;
@@ -44,6 +35,7 @@ int MYMP3::poll()
     }
 
     if (!done) {
+        in->read_ahead();
         // update the buffer
 		AGS::Engine::MutexLock _lockMp3(_mp3_mutex);
         char *tempbuf = (char *)almp3_get_mp3stream_buffer(stream);
@@ -51,11 +43,11 @@ int MYMP3::poll()
 
         if (tempbuf != NULL) {
             int free_val = -1;
-            if (chunksize >= in->todo) {
-                chunksize = in->todo;
+            if (chunksize >= in->remaining) {
+                chunksize = in->remaining;
                 free_val = chunksize;
             }
-            pack_fread(tempbuf, chunksize, in);
+            in->read(tempbuf, chunksize);
 
 			_lockMp3.Acquire(_mp3_mutex);
             almp3_free_mp3stream_buffer(stream, free_val);
@@ -70,8 +62,6 @@ int MYMP3::poll()
     if (result == ALMP3_POLL_PLAYJUSTFINISHED)
     {
         done = 1;
-        if (psp_audio_multithreaded)
-            internal_destroy();
     }
 
     return done;
@@ -87,9 +77,13 @@ void MYMP3::set_volume(int newvol)
     vol = newvol;
     newvol += volModifier + directionalVolModifier;
     if (newvol < 0) newvol = 0;
+    set_clip_volume(this, newvol);
+}
 
+void MYMP3::apply_volume(int volume, int pan)
+{
 	AGS::Engine::MutexLock _lockMp3(_mp3_mutex);
-    almp3_adjust_mp3stream(stream, newvol, panning, 1000);
+    almp3_adjust_mp3stream(stream, volume, pan, 1000);
 }
 
 void MYMP3::internal_destroy()
@@ -109,25 +103,15 @@ void MYMP3::internal_destroy()
         free(buffer);
 
     buffer = NULL;
-    pack_fclose(in);
+    close_audio_stream_source(in);
+    in = NULL;
 
-    _destroyThis = false;
     done = 1;
 }
 
 void MYMP3::destroy()
 {
-	AGS::Engine::MutexLock _lock(_mutex);
-
-    if (psp_audio_multithreaded && _playing && !_audio_doing_crossfade)
-      _destroyThis = true;
-    else
-      internal_destroy();
-
-	_lock.Release();
-
-    while (!done)
-      AGSPlatformDriver::GetDriver()->YieldCPU();
+    internal_destroy();
 }
 
 void MYMP3::seek(int pos)
@@ -187,8 +171,6 @@ int MYMP3::play() {
     if (!psp_audio_multithreaded)
       poll();
 
-    _playing = true;
-
     return 1;
 }
 
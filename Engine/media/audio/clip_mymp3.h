@@ -16,20 +16,23 @@
 #define __AC_MYMP3_H
 
 #include "almp3.h"
+#include "media/audio/audiostreamsource.h"
 #include "media/audio/soundclip.h"
+#include "util/mutex.h"
 
 extern AGS::Engine::Mutex _mp3_mutex;
 
 struct MYMP3:public SOUNDCLIP
 {
     ALMP3_MP3STREAM *stream;
-    PACKFILE *in;
+    AudioStreamSource *in;
     long  filesize;
     char *buffer;
     int chunksize;
 
     int poll();
     void set_volume(int newvol);
+    void apply_volume(int volume, int pan);
     void internal_destroy();
     void destroy();
     void seek(int pos);
@@ -15,10 +15,8 @@
 #include "media/audio/audiodefines.h"
 #include "media/audio/clip_myogg.h"
 #include "media/audio/audiointernaldefs.h"
+#include "media/audio/audiocommands.h"
 #include "ac/common.h"               // quit()
-#include "util/mutex_lock.h"
-
-#include "platform/base/agsplatformdriver.h"
 
 
 extern "C" {
@@ -30,14 +28,6 @@ extern "C" {
 
 int MYOGG::poll()
 {
-    AGS::Engine::MutexLock _lock(_mutex);
-
-    if (!done && _destroyThis)
-    {
-      internal_destroy();
-      _destroyThis = false;
-    }
-
     if (done)
     {
         return done;
@@ -47,26 +37,25 @@ int MYOGG::poll()
         return 0;
     }
 
-    if ((!done) && (in->todo > 0))
+    if ((!done) && (in->remaining > 0))
     {
+        in->read_ahead();
         // update the buffer
         char *tempbuf = (char *)alogg_get_oggstream_buffer(stream);
         if (tempbuf != NULL)
         {
             int free_val = -1;
-            if (chunksize >= in->todo)
+            if (chunksize >= in->remaining)
             {
-                chunksize = in->todo;
+                chunksize = in->remaining;
                 free_val = chunksize;
             }
-            pack_fread(tempbuf, chunksize, in);
+            in->read(tempbuf, chunksize);
             alogg_free_oggstream_buffer(stream, free_val);
         }
     }
     if (alogg_poll_oggstream(stream) == ALOGG_POLL_PLAYJUSTFINISHED) {
         done = 1;
-        if (psp_audio_multithreaded)
-            internal_destroy();
     }
     else get_pos_ms();  // call this to keep the last_but_one stuff up to date
 
@@ -82,7 +71,12 @@ void MYOGG::set_volume(int newvol)
     vol = newvol;
     newvol += volModifier + directionalVolModifier;
     if (newvol < 0) newvol = 0;
-    alogg_adjust_oggstream(stream, newvol, panning, 1000);
+    set_clip_volume(this, newvol);
+}
+
+void MYOGG::apply_volume(int volume, int pan)
+{
+    alogg_adjust_oggstream(stream, volume, pan, 1000);
 }
 
 void MYOGG::internal_destroy()
@@ -95,25 +89,15 @@ void MYOGG::internal_destroy()
     if (buffer != NULL)
         free(buffer);
     buffer = NULL;
-    pack_fclose(in);
+    close_audio_stream_source(in);
+    in = NULL;
 
-    _destroyThis = false;
     done = 1;
 }
 
 void MYOGG::destroy()
 {
-	AGS::Engine::MutexLock _lock(_mutex);
-
-    if (psp_audio_multithreaded && _playing && !_audio_doing_crossfade)
-      _destroyThis = true;
-    else
-      internal_destroy();
-
-	_lock.Release();
-
-    while (!done)
-      AGSPlatformDriver::GetDriver()->YieldCPU();
+    internal_destroy();
 }
 
 void MYOGG::seek(int pos)
@@ -212,8 +196,6 @@ int MYOGG::play() {
     if (!psp_audio_multithreaded)
       poll();
 
-    _playing = true;
-
     return 1;
 }
 
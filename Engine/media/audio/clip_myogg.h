@@ -16,12 +16,13 @@
 #define __AC_MYOGG_H
 
 #include "alogg.h"
+#include "media/audio/audiostreamsource.h"
 #include "media/audio/soundclip.h"
 
 struct MYOGG:public SOUNDCLIP
 {
     ALOGG_OGGSTREAM *stream;
-    PACKFILE *in;
+    AudioStreamSource *in;
     char *buffer;
     int chunksize;
 
@@ -33,6 +34,8 @@ struct MYOGG:public SOUNDCLIP
 
     void set_volume(int newvol);
 
+    void apply_volume(int volume, int pan);
+
     void internal_destroy();
 
     void destroy();
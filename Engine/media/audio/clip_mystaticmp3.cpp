@@ -18,11 +18,10 @@
 
 #include "media/audio/clip_mystaticmp3.h"
 #include "media/audio/audiointernaldefs.h"
+#include "media/audio/audiocommands.h"
 #include "media/audio/soundcache.h"
 #include "util/mutex_lock.h"
 
-#include "platform/base/agsplatformdriver.h"
-
 extern int our_eip;
 
 // ALMP3 functions are not reentrant! This mutex should be locked before calling any
@@ -31,14 +30,6 @@ AGS::Engine::Mutex _mp3_mutex;
 
 int MYSTATICMP3::poll()
 {
-    AGS::Engine::MutexLock _lock(_mutex);
-
-    if (tune && !done && _destroyThis)
-    {
-      internal_destroy();
-      _destroyThis = false;
-    }
-
     int oldeip = our_eip;
     our_eip = 5997;
     
@@ -55,8 +46,6 @@ int MYSTATICMP3::poll()
         if (!repeat)
         {
             done = 1;
-            if (psp_audio_multithreaded)
-                internal_destroy();
         }
       }
     }
@@ -68,13 +57,17 @@ int MYSTATICMP3::poll()
 void MYSTATICMP3::set_volume(int newvol)
 {
     vol = newvol;
+    newvol += volModifier + directionalVolModifier;
+    if (newvol < 0) newvol = 0;
+    set_clip_volume(this, newvol);
+}
 
+void MYSTATICMP3::apply_volume(int volume, int pan)
+{
     if (tune != NULL)
     {
-        newvol += volModifier + directionalVolModifier;
-        if (newvol < 0) newvol = 0;
         AGS::Engine::MutexLock _lockMp3(_mp3_mutex);
-        almp3_adjust_mp3(tune, newvol, panning, 1000, repeat);
+        almp3_adjust_mp3(tune, volume, pan, 1000, repeat);
     }
 }
 
@@ -92,29 +85,15 @@ void MYSTATICMP3::internal_destroy()
       mp3buffer = NULL;
   }
 
-  _destroyThis = false;
   done = 1;
 }
 
 void MYSTATICMP3::destroy()
 {
-	AGS::Engine::MutexLock _lock(_mutex);
-
-    if (psp_audio_multithreaded && _playing && !_audio_doing_crossfade)
-      _destroyThis = true;
-    else
-      internal_destroy();
-
-	_lock.Release();
-
-    while (!done)
-      AGSPlatformDriver::GetDriver()->YieldCPU();
-
-    // Allow the last poll cycle to finish.
-	_lock.Acquire(_mutex);
+    internal_destroy();
 }
 
-void MYSTATICMP3::seek(int pos)
+void MYSTATICMP3::apply_seek(int pos)
 {
     AGS::Engine::MutexLock _lockMp3(_mp3_mutex);
     almp3_seek_abs_msecs_mp3(tune, pos);
@@ -178,7 +157,6 @@ int MYSTATICMP3::play() {
     if (!psp_audio_multithreaded)
       poll();
 
-    _playing = true;
     return 1;
 }
 
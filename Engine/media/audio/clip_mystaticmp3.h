@@ -17,6 +17,7 @@
 
 #include "almp3.h"
 #include "media/audio/soundclip.h"
+#include "util/mutex.h"
 
 extern AGS::Engine::Mutex _mp3_mutex;
 
@@ -30,11 +31,13 @@ struct MYSTATICMP3:public SOUNDCLIP
 
     void set_volume(int newvol);
 
+    void apply_volume(int volume, int pan);
+
     void internal_destroy();
 
     void destroy();
 
-    void seek(int pos);
+    void apply_seek(int pos);
 
     int get_pos();
 
@@ -15,10 +15,8 @@
 #include "media/audio/audiodefines.h"
 #include "media/audio/clip_mystaticogg.h"
 #include "media/audio/audiointernaldefs.h"
+#include "media/audio/audiocommands.h"
 #include "media/audio/soundcache.h"
-#include "util/mutex_lock.h"
-
-#include "platform/base/agsplatformdriver.h"
 
 extern "C" {
     extern int alogg_is_end_of_oggstream(ALOGG_OGGSTREAM *ogg);
@@ -31,22 +29,12 @@ extern int use_extra_sound_offset;  // defined in ac.cpp
 
 int MYSTATICOGG::poll()
 {
-	AGS::Engine::MutexLock _lock(_mutex);
-
-    if (tune && !done && _destroyThis)
-    {
-      internal_destroy();
-      _destroyThis = false;
-    }
-
     if ((tune == NULL) || (!ready))
         ; // Do nothing
     else if (alogg_poll_ogg(tune) == ALOGG_POLL_PLAYJUSTFINISHED) {
         if (!repeat)
         {
             done = 1;
-            if (psp_audio_multithreaded)
-                internal_destroy();
         }
     }
     else get_pos();  // call this to keep the last_but_one stuff up to date
@@ -57,13 +45,15 @@ int MYSTATICOGG::poll()
 void MYSTATICOGG::set_volume(int newvol)
 {
     vol = newvol;
+    newvol += volModifier + directionalVolModifier;
+    if (newvol < 0) newvol = 0;
+    set_clip_volume(this, newvol);
+}
 
+void MYSTATICOGG::apply_volume(int volume, int pan)
+{
     if (tune != NULL)
-    {
-        newvol += volModifier + directionalVolModifier;
-        if (newvol < 0) newvol = 0;
-        alogg_adjust_ogg(tune, newvol, panning, 1000, repeat);
-    }
+        alogg_adjust_ogg(tune, volume, pan, 1000, repeat);
 }
 
 void MYSTATICOGG::internal_destroy()
@@ -79,37 +69,24 @@ void MYSTATICOGG::internal_destroy()
         mp3buffer = NULL;
     }
 
-    _destroyThis = false;
     done = 1;
 }
 
 void MYSTATICOGG::destroy()
 {
-	AGS::Engine::MutexLock _lock(_mutex);
-
-    if (psp_audio_multithreaded && _playing && !_audio_doing_crossfade)
-      _destroyThis = true;
-    else
-      internal_destroy();
-
-	_lock.Release();
-
-    while (!done)
-      AGSPlatformDriver::GetDriver()->YieldCPU();
-
-    // Allow the last poll cycle to finish.
-	_lock.Acquire(_mutex);
+    internal_destroy();
 }
 
-void MYSTATICOGG::seek(int pos)
+void MYSTATICOGG::apply_seek(int pos)
 {
-	AGS::Engine::MutexLock _lock;
-    if (psp_audio_multithreaded)
-		_lock.Acquire(_mutex);
     // we stop and restart it because otherwise the buffer finishes
     // playing first and the seek isn't quite accurate
     alogg_stop_ogg(tune);
-    play_from(pos);
+    // the clip is still on its channel, so it is not destroyed here
+    if (!start_playing(pos))
+        done = 1;
+    else if (!psp_audio_multithreaded)
+        poll();
 }
 
 int MYSTATICOGG::get_pos()
@@ -199,18 +176,15 @@ int MYSTATICOGG::get_sound_type() {
     return MUS_OGG;
 }
 
-int MYSTATICOGG::play_from(int position)
+bool MYSTATICOGG::start_playing(int position)
 {
     if (use_extra_sound_offset) 
         extraOffset = ((16384 / (alogg_get_wave_is_stereo_ogg(tune) ? 2 : 1)) * 1000) / alogg_get_wave_freq_ogg(tune);
     else
         extraOffset = 0;
 
-    if (alogg_play_ex_ogg(tune, 16384, vol, panning, 1000, repeat) != ALOGG_OK) {
-        destroy();
-        delete this;
-        return 0;
-    }
+    if (alogg_play_ex_ogg(tune, 16384, vol, panning, 1000, repeat) != ALOGG_OK)
+        return false;
 
     last_ms_offs = position;
     last_but_one = position;
@@ -218,6 +192,16 @@ int MYSTATICOGG::play_from(int position)
 
     if (position > 0)
         alogg_seek_abs_msecs_ogg(tune, position);
+    return true;
+}
+
+int MYSTATICOGG::play_from(int position)
+{
+    if (!start_playing(position)) {
+        destroy();
+        delete this;
+        return 0;
+    }
 
     if (!psp_audio_multithreaded)
       poll();
@@ -226,7 +210,6 @@ int MYSTATICOGG::play_from(int position)
 }
 
 int MYSTATICOGG::play() {
-    _playing = true;
     return play_from(0);
 }
 
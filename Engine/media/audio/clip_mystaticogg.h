@@ -34,11 +34,13 @@ struct MYSTATICOGG:public SOUNDCLIP
 
     void set_volume(int newvol);
 
+    void apply_volume(int volume, int pan);
+
     void internal_destroy();
 
     void destroy();
 
-    void seek(int pos);
+    void apply_seek(int pos);
 
     int get_pos();    
 
@@ -52,6 +54,9 @@ struct MYSTATICOGG:public SOUNDCLIP
 
     int get_sound_type();
 
+    // starts playing from the position, returns false on failure
+    bool start_playing(int position);
+
     virtual int play_from(int position);
 
     int play();
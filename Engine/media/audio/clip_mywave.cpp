@@ -16,22 +16,12 @@
 #include "media/audio/audiodefines.h"
 #include "media/audio/clip_mywave.h"
 #include "media/audio/audiointernaldefs.h"
+#include "media/audio/audiocommands.h"
 #include "media/audio/soundcache.h"
-#include "util/mutex_lock.h"
-
-#include "platform/base/agsplatformdriver.h"
 
 
 int MYWAVE::poll()
 {
-    AGS::Engine::MutexLock _lock(_mutex);
-
-    if (!done && _destroyThis)
-    {
-      internal_destroy();
-      _destroyThis = false;
-    }
-
     if (wave == NULL)
     {
         return 1;
@@ -50,8 +40,6 @@ int MYWAVE::poll()
     if (voice_get_position(voice) < 0)
     {
         done = 1;
-        if (psp_audio_multithreaded)
-            internal_destroy();
     }
 
     return done;
@@ -60,13 +48,15 @@ int MYWAVE::poll()
 void MYWAVE::set_volume(int newvol)
 {
     vol = newvol;
+    newvol += volModifier + directionalVolModifier;
+    if (newvol < 0) newvol = 0;
+    set_clip_volume(this, newvol);
+}
 
+void MYWAVE::apply_volume(int volume, int pan)
+{
     if (voice >= 0)
-    {
-        newvol += volModifier + directionalVolModifier;
-        if (newvol < 0) newvol = 0;
-        voice_set_volume(voice, newvol);
-    }
+        voice_set_volume(voice, volume);
 }
 
 void MYWAVE::internal_destroy()
@@ -76,26 +66,15 @@ void MYWAVE::internal_destroy()
     sound_cache_free((char*)wave, true);
     wave = NULL;
 
-    _destroyThis = false;
     done = 1;
 }
 
 void MYWAVE::destroy()
 {
-    AGS::Engine::MutexLock _lock(_mutex);
-
-    if (psp_audio_multithreaded && _playing && !_audio_doing_crossfade)
-      _destroyThis = true;
-    else
-      internal_destroy();
-
-	_lock.Release();
-
-    while (!done)
-      AGSPlatformDriver::GetDriver()->YieldCPU();
+    internal_destroy();
 }
 
-void MYWAVE::seek(int pos)
+void MYWAVE::apply_seek(int pos)
 {
     voice_set_position(voice, pos);
 }
@@ -145,8 +124,6 @@ int MYWAVE::get_sound_type() {
 int MYWAVE::play() {
     voice = play_sample(wave, vol, panning, 1000, repeat);
 
-    _playing = true;
-
     return 1;
 }
 
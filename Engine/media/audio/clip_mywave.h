@@ -29,11 +29,13 @@ struct MYWAVE:public SOUNDCLIP
 
     void set_volume(int newvol);
 
+    void apply_volume(int volume, int pan);
+
     void internal_destroy();
 
     void destroy();
 
-    void seek(int pos);
+    void apply_seek(int pos);
 
     int get_pos();
     int get_pos_ms();
@@ -34,6 +34,7 @@
 #ifdef DUMB_MOD_PLAYER
 #include "media/audio/clip_mydumbmod.h"
 #endif
+#include "media/audio/audiostreamsource.h"
 #include "media/audio/soundcache.h"
 #include "util/mutex_lock.h"
 
@@ -86,43 +87,43 @@ SOUNDCLIP *my_load_wave(const char *filename, int voll, int loop)
     return thiswave;
 }
 
-PACKFILE *mp3in;
+AudioStreamSource *mp3in;
 
 #ifndef NO_MP3_PLAYER
 
 MYMP3 *thistune;
 SOUNDCLIP *my_load_mp3(const char *filname, int voll)
 {
-    mp3in = pack_fopen(filname, "rb");
+    mp3in = open_audio_stream_source(filname);
     if (mp3in == NULL)
         return NULL;
 
     char *tmpbuffer = (char *)malloc(MP3CHUNKSIZE);
     if (tmpbuffer == NULL) {
-        pack_fclose(mp3in);
+        close_audio_stream_source(mp3in);
         return NULL;
     }
     thistune = new MYMP3();
     thistune->in = mp3in;
     thistune->chunksize = MP3CHUNKSIZE;
-    thistune->filesize = mp3in->todo;
+    thistune->filesize = mp3in->length;
     thistune->done = 0;
     thistune->vol = voll;
 
-    if (thistune->chunksize > mp3in->todo)
-        thistune->chunksize = mp3in->todo;
+    if (thistune->chunksize > mp3in->remaining)
+        thistune->chunksize = mp3in->remaining;
 
-    pack_fread(tmpbuffer, thistune->chunksize, mp3in);
+    mp3in->read(tmpbuffer, thistune->chunksize);
 
     thistune->buffer = (char *)tmpbuffer;
 
     AGS::Engine::MutexLock _lockMp3(_mp3_mutex);
-    thistune->stream = almp3_create_mp3stream(tmpbuffer, thistune->chunksize, (mp3in->todo < 1));
+    thistune->stream = almp3_create_mp3stream(tmpbuffer, thistune->chunksize, (mp3in->remaining < 1));
 	_lockMp3.Release();
 
     if (thistune->stream == NULL) {
         free(tmpbuffer);
-        pack_fclose(mp3in);
+        close_audio_stream_source(mp3in);
         delete thistune;
         return NULL;
     }
@@ -217,13 +218,13 @@ MYOGG *thisogg;
 SOUNDCLIP *my_load_ogg(const char *filname, int voll)
 {
 
-    mp3in = pack_fopen(filname, "rb");
+    mp3in = open_audio_stream_source(filname);
     if (mp3in == NULL)
         return NULL;
 
     char *tmpbuffer = (char *)malloc(MP3CHUNKSIZE);
     if (tmpbuffer == NULL) {
-        pack_fclose(mp3in);
+        close_audio_stream_source(mp3in);
         return NULL;
     }
 
@@ -236,17 +237,17 @@ SOUNDCLIP *my_load_ogg(const char *filname, int voll)
     thisogg->last_ms_offs = 0;
     thisogg->last_but_one_but_one = 0;
 
-    if (thisogg->chunksize > mp3in->todo)
-        thisogg->chunksize = mp3in->todo;
+    if (thisogg->chunksize > mp3in->remaining)
+        thisogg->chunksize = mp3in->remaining;
 
-    pack_fread(tmpbuffer, thisogg->chunksize, mp3in);
+    mp3in->read(tmpbuffer, thisogg->chunksize);
 
     thisogg->buffer = (char *)tmpbuffer;
-    thisogg->stream = alogg_create_oggstream(tmpbuffer, thisogg->chunksize, (mp3in->todo < 1));
+    thisogg->stream = alogg_create_oggstream(tmpbuffer, thisogg->chunksize, (mp3in->remaining < 1));
 
     if (thisogg->stream == NULL) {
         free(tmpbuffer);
-        pack_fclose(mp3in);
+        close_audio_stream_source(mp3in);
         delete thisogg;
         return NULL;
     }
@@ -15,10 +15,14 @@
 #include <stdlib.h>
 #include <string.h>
 #include "util/wgt2allg.h"
+#include "ac/file.h"
 #include "media/audio/soundcache.h"
 #include "media/audio/audiointernaldefs.h"
 #include "util/mutex.h"
 #include "util/mutex_lock.h"
+#include "util/stream.h"
+
+using AGS::Common::Stream;
 
 sound_cache_entry_t* sound_cache_entries = NULL;
 unsigned int sound_cache_counter = 0;
@@ -26,6 +30,19 @@ unsigned int sound_cache_counter = 0;
 AGS::Engine::Mutex _sound_cache_mutex;
 
 
+// Frees the sound data, or gives it back to the stream it was borrowed from
+void free_sound_cache_entry_data(sound_cache_entry_t *entry)
+{
+    if (entry->stream)
+        delete entry->stream;
+    else if (entry->is_wave)
+        destroy_sample((SAMPLE*)entry->data);
+    else
+        free(entry->data);
+    entry->data = NULL;
+    entry->stream = NULL;
+}
+
 void clear_sound_cache()
 {
     AGS::Engine::MutexLock _lock(_sound_cache_mutex);
@@ -37,8 +54,7 @@ void clear_sound_cache()
         {
             if (sound_cache_entries[i].data)
             {
-                free(sound_cache_entries[i].data);
-                sound_cache_entries[i].data = NULL;
+                free_sound_cache_entry_data(&sound_cache_entries[i]);
                 free(sound_cache_entries[i].file_name);
                 sound_cache_entries[i].file_name = NULL;
                 sound_cache_entries[i].reference = 0;
@@ -121,6 +137,7 @@ char* get_cached_sound(const char* filename, bool is_wave, long* size)
     // Not found
     PACKFILE *mp3in = NULL;
     SAMPLE* wave = NULL;
+    Stream *mapped_in = NULL;
 
     if (is_wave)
     {
@@ -133,10 +150,16 @@ char* get_cached_sound(const char* filename, bool is_wave, long* size)
     }  
     else
     {
-        mp3in = pack_fopen(filename, "rb");
-        if (mp3in == NULL)
+        // compressed clips are only read by the decoders, so when the game
+        // data is mapped into memory they may use it in place
+        mapped_in = open_mapped_asset(filename);
+        if (mapped_in == NULL)
         {
-            return NULL;
+            mp3in = pack_fopen(filename, "rb");
+            if (mp3in == NULL)
+            {
+                return NULL;
+            }
         }
     }
 
@@ -176,8 +199,31 @@ char* get_cached_sound(const char* filename, bool is_wave, long* size)
         *size = 0;
         newdata = (char*)wave;
     }
+    else if (mapped_in)
+    {
+        *size = mapped_in->GetLength() - mapped_in->GetPosition();
+        const char *mapped_data = (const char*)mapped_in->GetDataAt(mapped_in->GetPosition());
+        if (i == -1)
+        {
+            // uncached sounds are freed by their users, so need a copy
+            newdata = (char *)malloc(*size);
+            if (newdata != NULL)
+                memcpy(newdata, mapped_data, *size);
+            delete mapped_in;
+            mapped_in = NULL;
+            if (newdata == NULL)
+                return NULL;
+        }
+        else
+        {
+            newdata = (char *)mapped_data;
+        }
+    }
     else
     {
+        // static clips are seeked and looped by the decoder, which needs all
+        // the data at hand, so without the mapping the whole file is read;
+        // only the streamed clips are limited to the look-ahead
         *size = mp3in->todo;
         newdata = (char *)malloc(*size);
 
@@ -206,15 +252,12 @@ char* get_cached_sound(const char* filename, bool is_wave, long* size)
         printf("..loading cached in slot %d\n", i);
 #endif	
 
-        if (sound_cache_entries[i].data) {
-            if (sound_cache_entries[i].is_wave)
-                destroy_sample((SAMPLE*)sound_cache_entries[i].data);
-            else
-                free(sound_cache_entries[i].data);
-	}
+        if (sound_cache_entries[i].data)
+            free_sound_cache_entry_data(&sound_cache_entries[i]);
 	
         sound_cache_entries[i].size = *size;
         sound_cache_entries[i].data = newdata;
+        sound_cache_entries[i].stream = mapped_in;
 
         if (sound_cache_entries[i].file_name)
             free(sound_cache_entries[i].file_name);
@@ -27,6 +27,8 @@
 #include <psprtc.h>
 #endif
 
+namespace AGS { namespace Common { class Stream; } }
+
 typedef struct
 {
     char* file_name;
@@ -35,6 +37,9 @@ typedef struct
     unsigned int last_used;
     unsigned int size;
     char* data;
+    // Stream the data is borrowed from, if it is mapped into memory;
+    // the data must not be freed then, but the stream deleted
+    AGS::Common::Stream* stream;
     int reference;
     bool is_wave;
 } sound_cache_entry_t;
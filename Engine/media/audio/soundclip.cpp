@@ -16,6 +16,7 @@
 #include "media/audio/audiodefines.h"
 #include "media/audio/soundclip.h"
 #include "media/audio/audiointernaldefs.h"
+#include "media/audio/audiocommands.h"
 
 SOUNDCLIP *channels[MAX_SOUND_CHANNELS+1]; // needed for update_mp3_thread
 
@@ -30,29 +31,47 @@ int SOUNDCLIP::play_from(int position)
 }
 
 void SOUNDCLIP::set_panning(int newPanning) {
-    int voice = get_voice();
-    if (voice >= 0) {
-        voice_set_pan(voice, newPanning);
-        panning = newPanning;
-    }
+    panning = newPanning;
+    set_clip_panning(this, newPanning);
 }
 
 void SOUNDCLIP::pause() {
+    pause_clip(this);
+}
+void SOUNDCLIP::resume() {
+    resume_clip(this);
+}
+
+void SOUNDCLIP::seek(int pos) {
+    seek_clip(this, pos);
+}
+
+void SOUNDCLIP::apply_panning(int pan) {
+    int voice = get_voice();
+    if (voice >= 0)
+        voice_set_pan(voice, pan);
+}
+
+void SOUNDCLIP::apply_pause() {
     int voice = get_voice();
     if (voice >= 0) {
         voice_stop(voice);
         paused = 1;
     }
 }
-void SOUNDCLIP::resume() {
+void SOUNDCLIP::apply_resume() {
     int voice = get_voice();
     if (voice >= 0)
         voice_start(voice);
     paused = 0;
 }
 
+void SOUNDCLIP::apply_seek(int pos) {
+}
+
 SOUNDCLIP::SOUNDCLIP() {
     ready = false;
+    posted = false;
     done = 0;
     paused = 0;
     priority = 50;
@@ -66,8 +85,6 @@ SOUNDCLIP::SOUNDCLIP() {
     ySource = -1;
     maximumPossibleDistanceAway = 0;
     directionalVolModifier = 0;
-    _destroyThis = false;
-    _playing = false;
 }
 
 SOUNDCLIP::~SOUNDCLIP()
@@ -20,17 +20,12 @@
 #define __AC_SOUNDCLIP_H
 
 #undef BITMAP
-#include "util/mutex.h"
 
 // JJS: This is needed for the derieved classes
 extern volatile int psp_audio_multithreaded;
-extern volatile bool _audio_doing_crossfade;
 
 struct SOUNDCLIP
 {
-    bool _destroyThis;
-    bool _playing;
-
     int done;
     int priority;
     int soundType;
@@ -53,13 +48,15 @@ struct SOUNDCLIP
     bool repeat;
     void *sourceClip;
     bool ready;
-    AGS::Engine::Mutex _mutex;
+    // the clip was passed to the polling thread, which makes all the calls
+    // to the decoder from then on
+    bool posted;
 
     virtual int poll() = 0;
     virtual void destroy() = 0;
     virtual void set_volume(int) = 0;
     virtual void restart() = 0;
-    virtual void seek(int) = 0;
+    virtual void seek(int);
     virtual int get_pos() = 0;    // return 0 to indicate seek not supported
     virtual int get_pos_ms() = 0; // this must always return valid value if poss
     virtual int get_length_ms() = 0; // return total track length in ms (or 0)
@@ -74,6 +71,14 @@ struct SOUNDCLIP
     virtual void pause();
     virtual void resume();
 
+    // These are run by the polling thread, when it runs the commands posted
+    // by the methods above (see audiocommands.h)
+    virtual void apply_volume(int volume, int pan) = 0;
+    virtual void apply_panning(int pan);
+    virtual void apply_pause();
+    virtual void apply_resume();
+    virtual void apply_seek(int pos);
+
     inline int get_volume() const
     {
         return originalVolAsPercentage;
@@ -44,6 +44,8 @@ struct AGSPlatformDriver
     virtual void Delay(int millis) = 0;
     virtual void DisplayAlert(const char*, ...) = 0;
     virtual const char *GetAllUsersDataDirectory() { return NULL; }
+    // Get the number of processors that threads may run on
+    virtual int  GetCPUCount() { return 1; }
     // Get default directory for program output (logs)
     virtual const char *GetAppOutputDirectory() { return "."; }
     virtual const char *GetGraphicsTroubleshootingText() { return ""; }
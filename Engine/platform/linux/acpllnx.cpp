@@ -29,6 +29,7 @@
 
 #include <pwd.h>
 #include <sys/stat.h>
+#include <unistd.h>
 
 using AGS::Common::String;
 
@@ -45,6 +46,7 @@ struct AGSLinux : AGSPlatformDriver {
   virtual void Delay(int millis);
   virtual void DisplayAlert(const char*, ...);
   virtual const char *GetAppOutputDirectory();
+  virtual int  GetCPUCount();
   virtual unsigned long GetDiskFreeSpaceMB();
   virtual const char* GetNoMouseErrorString();
   virtual eScriptSystemOSID GetSystemOSID();
@@ -134,6 +136,11 @@ void AGSLinux::Delay(int millis) {
   usleep(millis);
 }
 
+int AGSLinux::GetCPUCount() {
+  long count = sysconf(_SC_NPROCESSORS_ONLN);
+  return count > 0 ? count : 1;
+}
+
 unsigned long AGSLinux::GetDiskFreeSpaceMB() {
   // placeholder
   return 100;
@@ -27,6 +27,7 @@
 
 #include <pwd.h>
 #include <sys/stat.h>
+#include <unistd.h>
 
 bool PlayMovie(char const *name, int skipType);
 
@@ -36,6 +37,7 @@ struct AGSMac : AGSPlatformDriver {
   virtual int  CDPlayerCommand(int cmdd, int datt);
   virtual void Delay(int millis);
   virtual void DisplayAlert(const char*, ...);
+  virtual int  GetCPUCount();
   virtual unsigned long GetDiskFreeSpaceMB();
   virtual const char* GetNoMouseErrorString();
   virtual eScriptSystemOSID GetSystemOSID();
@@ -71,6 +73,11 @@ void AGSMac::Delay(int millis) {
   usleep(millis);
 }
 
+int AGSMac::GetCPUCount() {
+  long count = sysconf(_SC_NPROCESSORS_ONLN);
+  return count > 0 ? count : 1;
+}
+
 unsigned long AGSMac::GetDiskFreeSpaceMB() {
   // placeholder
   return 100;
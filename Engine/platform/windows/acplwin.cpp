@@ -103,6 +103,7 @@ struct AGSWin32 : AGSPlatformDriver {
   virtual const char *GetAllUsersDataDirectory();
   virtual const char *GetAppOutputDirectory();
   virtual const char *GetGraphicsTroubleshootingText();
+  virtual int  GetCPUCount();
   virtual unsigned long GetDiskFreeSpaceMB();
   virtual const char* GetNoMouseErrorString();
   virtual eScriptSystemOSID GetSystemOSID();
@@ -699,6 +700,12 @@ void AGSWin32::Delay(int millis)
     Sleep(millis);
 }
 
+int AGSWin32::GetCPUCount() {
+  SYSTEM_INFO sys_info;
+  GetSystemInfo(&sys_info);
+  return sys_info.dwNumberOfProcessors;
+}
+
 unsigned long AGSWin32::GetDiskFreeSpaceMB() {
   DWORD returnMb = 0;
   BOOL fResult;
@@ -299,6 +299,7 @@ public:
   virtual Bitmap *ConvertBitmapToSupportedColourDepth(Bitmap *bitmap);
   virtual IDriverDependantBitmap* CreateDDBFromBitmap(Bitmap *bitmap, bool hasAlpha, bool opaque);
   virtual void UpdateDDBFromBitmap(IDriverDependantBitmap* bitmapToUpdate, Bitmap *bitmap, bool hasAlpha);
+  virtual void UpdateDDBFromBitmapRect(IDriverDependantBitmap* bitmapToUpdate, Bitmap *bitmap, bool hasAlpha, const Rect &changed);
   virtual void DestroyDDB(IDriverDependantBitmap* bitmap);
   virtual void DrawSprite(int x, int y, IDriverDependantBitmap* bitmap);
   virtual void ClearDrawList();
@@ -306,6 +307,8 @@ public:
   virtual void Render();
   virtual void Render(GlobalFlipType flip);
   virtual void SetRenderOffset(int x, int y);
+  virtual void EnablePartialRedraw(bool enabled) { }
+  virtual void InvalidateRect(int x1, int y1, int x2, int y2) { }
   virtual void GetCopyOfScreenIntoBitmap(Bitmap *destination);
   virtual void EnableVsyncBeforeRender(bool enabled) { }
   virtual void Vsync();
@@ -380,7 +383,7 @@ private:
   void set_up_default_vertices();
   void make_translated_scaling_matrix(D3DMATRIX *matrix, float x, float y, float xScale, float yScale);
   void AdjustSizeToNearestSupportedByCard(int *width, int *height);
-  void UpdateTextureRegion(TextureTile *tile, Bitmap *bitmap, D3DBitmap *target, bool hasAlpha);
+  void UpdateTextureRegion(TextureTile *tile, Bitmap *bitmap, D3DBitmap *target, bool hasAlpha, const Rect &changed);
   void do_fade(bool fadingOut, int speed, int targetColourRed, int targetColourGreen, int targetColourBlue);
   bool IsTextureFormatOk( D3DFORMAT TextureFormat, D3DFORMAT AdapterFormat );
   bool IsModeSupported(int width, int height, int colDepth);
@@ -1588,12 +1591,26 @@ __inline void get_pixel_if_not_transparent32(unsigned long *pixel, unsigned long
   }
 }
 
-void D3DGraphicsDriver::UpdateTextureRegion(TextureTile *tile, Bitmap *bitmap, D3DBitmap *target, bool hasAlpha)
+// Converts the part of the tile which depends on the changed area of the
+// bitmap. Transparent pixels take their colour from the neighbours, so the
+// area grows by one pixel each way.
+void D3DGraphicsDriver::UpdateTextureRegion(TextureTile *tile, Bitmap *bitmap, D3DBitmap *target, bool hasAlpha, const Rect &changed)
 {
   IDirect3DTexture9* newTexture = tile->texture;
 
+  RECT area;
+  area.left = MAX(changed.Left - tile->x - 1, 0);
+  area.top = MAX(changed.Top - tile->y - 1, 0);
+  area.right = MIN(changed.Right - tile->x + 2, tile->width);
+  area.bottom = MIN(changed.Bottom - tile->y + 2, tile->height);
+  if ((area.left >= area.right) || (area.top >= area.bottom))
+    return;
+  bool wholeTile = (area.left == 0) && (area.top == 0) &&
+    (area.right == tile->width) && (area.bottom == tile->height);
+
   D3DLOCKED_RECT lockedRegion;
-  HRESULT hr = newTexture->LockRect(0, &lockedRegion, NULL, D3DLOCK_NOSYSLOCK | D3DLOCK_DISCARD);
+  HRESULT hr = newTexture->LockRect(0, &lockedRegion, wholeTile ? NULL : &area,
+    wholeTile ? (D3DLOCK_NOSYSLOCK | D3DLOCK_DISCARD) : D3DLOCK_NOSYSLOCK);
   if (hr != D3D_OK)
   {
     throw Ali3DException("Unable to lock texture");
@@ -1601,14 +1618,15 @@ void D3DGraphicsDriver::UpdateTextureRegion(TextureTile *tile, Bitmap *bitmap, D
 
   bool usingLinearFiltering = _filter->NeedToColourEdgeLines();
   bool lastPixelWasTransparent = false;
-  char *memPtr = (char*)lockedRegion.pBits;
-  for (int y = 0; y < tile->height; y++)
+  // the locked memory starts at the area corner
+  char *memPtr = (char*)lockedRegion.pBits - area.left * ((target->_colDepth == 15) ? 2 : 4);
+  for (int y = area.top; y < area.bottom; y++)
   {
     lastPixelWasTransparent = false;
     const uint8_t *scanline_before = bitmap->GetScanLine(y + tile->y - 1);
     const uint8_t *scanline_at     = bitmap->GetScanLine(y + tile->y);
     const uint8_t *scanline_after  = bitmap->GetScanLine(y + tile->y + 1);
-    for (int x = 0; x < tile->width; x++)
+    for (int x = area.left; x < area.right; x++)
     {
       if (target->_colDepth == 15)
       {
@@ -1700,6 +1718,25 @@ void D3DGraphicsDriver::UpdateTextureRegion(TextureTile *tile, Bitmap *bitmap, D
       }
     }
 
+    // the pixel right of the area may recolour the last one in it
+    if (lastPixelWasTransparent && (area.right < tile->width))
+    {
+      int x = area.right;
+      if (target->_colDepth == 15)
+      {
+        unsigned short srcData = ((unsigned short*)scanline_at)[x + tile->x];
+        if (srcData != MASK_COLOR_15)
+          ((unsigned short*)memPtr)[x - 1] = (algetr15(srcData) << 10) | (algetg15(srcData) << 5) | algetb15(srcData);
+      }
+      else if ((target->_colDepth == 32) && !hasAlpha)
+      {
+        unsigned long srcData = ((unsigned long*)scanline_at)[x + tile->x];
+        if (srcData != MASK_COLOR_32)
+          ((unsigned long*)memPtr)[x - 1] =
+            D3DCOLOR_RGBA(algetr32(srcData), algetg32(srcData), algetb32(srcData), 0xff) & 0x00FFFFFF;
+      }
+    }
+
     memPtr += lockedRegion.Pitch;
   }
 
@@ -1707,6 +1744,11 @@ void D3DGraphicsDriver::UpdateTextureRegion(TextureTile *tile, Bitmap *bitmap, D
 }
 
 void D3DGraphicsDriver::UpdateDDBFromBitmap(IDriverDependantBitmap* bitmapToUpdate, Bitmap *bitmap, bool hasAlpha)
+{
+  UpdateDDBFromBitmapRect(bitmapToUpdate, bitmap, hasAlpha, RectWH(0, 0, bitmap->GetWidth(), bitmap->GetHeight()));
+}
+
+void D3DGraphicsDriver::UpdateDDBFromBitmapRect(IDriverDependantBitmap* bitmapToUpdate, Bitmap *bitmap, bool hasAlpha, const Rect &changed)
 {
   D3DBitmap *target = (D3DBitmap*)bitmapToUpdate;
   if ((target->_width == bitmap->GetWidth()) &&
@@ -1717,11 +1759,15 @@ void D3DGraphicsDriver::UpdateDDBFromBitmap(IDriverDependantBitmap* bitmapToUpda
       throw Ali3DException("Mismatched colour depths");
     }
 
+    // the alpha channel of every pixel depends on the flag
+    Rect area = changed;
+    if (target->_hasAlpha != hasAlpha)
+      area = RectWH(0, 0, target->_width, target->_height);
     target->_hasAlpha = hasAlpha;
 
     for (int i = 0; i < target->_numTiles; i++)
     {
-      UpdateTextureRegion(&target->_tiles[i], bitmap, target, hasAlpha);
+      UpdateTextureRegion(&target->_tiles[i], bitmap, target, hasAlpha, area);
     }
   }
 }
@@ -34,6 +34,7 @@
 #include "ac/parser.h"
 #include "ac/record.h"
 #include "ac/roomstatus.h"
+#include "ac/route_finder.h"
 #include "ac/string.h"
 #include "font/fonts.h"
 #include "util/string_utils.h"
@@ -47,6 +48,7 @@
 #include "script/script.h"
 #include "script/script_runtime.h"
 #include "ac/spritecache.h"
+#include "ac/spritetransformcache.h"
 #include "util/stream.h"
 #include "gfx/graphicsdriver.h"
 #include "gfx/bitmap.h"
@@ -417,7 +419,11 @@ BITMAP *IAGSEngine::GetSpriteGraphic (int32 num) {
 }
 BITMAP *IAGSEngine::GetRoomMask (int32 index) {
     if (index == MASK_WALKABLE)
+    {
+        // the plugin may change the walkable areas
+        invalidate_route_navigation();
         return (BITMAP*)thisroom.walls->GetAllegroBitmap();
+    }
     else if (index == MASK_WALKBEHIND)
         return (BITMAP*)thisroom.object->GetAllegroBitmap();
     else if (index == MASK_HOTSPOT)
@@ -630,6 +636,8 @@ void IAGSEngine::NotifySpriteUpdated(int32 slot) {
             objcache[ff].image = NULL;
         }
     }
+
+    remove_transformed_sprites(slot);
 }
 
 void IAGSEngine::SetSpriteAlphaBlended(int32 slot, int32 isAlphaBlended) {
@@ -638,6 +646,9 @@ void IAGSEngine::SetSpriteAlphaBlended(int32 slot, int32 isAlphaBlended) {
 
     if (isAlphaBlended)
         game.spriteflags[slot] |= SPF_ALPHACHANNEL;
+
+    // the anti-aliasing of scaled images depends on the flag
+    remove_transformed_sprites(slot);
 }
 
 void IAGSEngine::QueueGameScriptFunction(const char *name, int32 globalScript, int32 numArgs, long arg1, long arg2) {
@@ -824,6 +835,14 @@ void pl_startup_plugins() {
     }
 }
 
+bool pl_any_want_hook (int event) {
+    for (int i = 0; i < numPlugins; i++) {
+        if (plugins[i].wantHook & event)
+            return true;
+    }
+    return false;
+}
+
 int pl_run_plugin_hooks (int event, long data) {
     int i, retval = 0;
     for (i = 0; i < numPlugins; i++) {
@@ -162,6 +162,100 @@ const char *regnames[] = { "null", "sp", "mar", "ax", "bx", "cx", "op", "dx" };
 
 const char *fixupnames[] = { "null", "fix_gldata", "fix_func", "fix_string", "fix_import", "fix_datadata", "fix_stack" };
 
+// Engine-only superinstructions; these are never written by compiler, but
+// replace the common sequences of operations in the pre-decoded code.
+// Each does the work of two instructions in one dispatch: pushing a literal,
+// reading a local variable, and comparing two registers followed by a
+// conditional jump. Instruction pair counts of a particular game may be
+// written to the log with SCOPT_PROFILERUN.
+enum ScriptSuperCommand
+{
+    SCMD_SUPER_LITTOREG_PUSHREG = CC_NUM_SCCMDS, // reg1 = arg2; push reg
+    SCMD_SUPER_LOADSPOFFS_MEMREAD,  // MAR = SP - arg1; reg = m[MAR]
+    SCMD_SUPER_ISEQUAL_JZ,          // reg1 == reg2; jz
+    SCMD_SUPER_NOTEQUAL_JZ,         // reg1 != reg2; jz
+    SCMD_SUPER_GREATER_JZ,          // reg1 > reg2; jz
+    SCMD_SUPER_LESSTHAN_JZ,         // reg1 < reg2; jz
+    SCMD_SUPER_GTE_JZ,              // reg1 >= reg2; jz
+    SCMD_SUPER_LTE_JZ               // reg1 <= reg2; jz
+};
+
+// Number of slots in the table of instruction triples
+#define NGRAM_TRIPLE_SLOTS 4096
+
+// Counts how often each pair and triple of instructions was executed
+struct ScriptNGramProfile
+{
+    struct Entry
+    {
+        int32_t  Key;
+        uint32_t Count;
+    };
+
+    ScriptNGramProfile()
+    {
+        memset(Pairs, 0, sizeof(Pairs));
+        for (int i = 0; i < NGRAM_TRIPLE_SLOTS; ++i)
+        {
+            Triples[i].Key   = -1;
+            Triples[i].Count = 0;
+        }
+        Total           = 0;
+        TriplesDropped  = 0;
+    }
+
+    // Registers executed instruction, along with the two that preceded it
+    inline void Count(int32_t cmd, int32_t prev1, int32_t prev2)
+    {
+        Total++;
+        if (prev1 < 0)
+        {
+            return;
+        }
+        Pairs[prev1][cmd]++;
+        if (prev2 >= 0)
+        {
+            CountTriple((prev2 * CC_NUM_SCCMDS + prev1) * CC_NUM_SCCMDS + cmd);
+        }
+    }
+
+    void CountTriple(int32_t key)
+    {
+        uint32_t slot = ((uint32_t)key * 2654435761u) % NGRAM_TRIPLE_SLOTS;
+        for (int i = 0; i < NGRAM_TRIPLE_SLOTS; ++i, slot = (slot + 1) % NGRAM_TRIPLE_SLOTS)
+        {
+            if (Triples[slot].Key == key)
+            {
+                Triples[slot].Count++;
+                return;
+            }
+            if (Triples[slot].Key < 0)
+            {
+                Triples[slot].Key   = key;
+                Triples[slot].Count = 1;
+                return;
+            }
+        }
+        TriplesDropped++;
+    }
+
+    uint32_t Pairs[CC_NUM_SCCMDS][CC_NUM_SCCMDS];
+    Entry    Triples[NGRAM_TRIPLE_SLOTS];
+    uint32_t Total;
+    uint32_t TriplesDropped;
+};
+
+static int ngram_entry_cmp(const void *a, const void *b)
+{
+    const uint32_t count_a = ((const ScriptNGramProfile::Entry*)a)->Count;
+    const uint32_t count_b = ((const ScriptNGramProfile::Entry*)b)->Count;
+    if (count_a != count_b)
+    {
+        return count_a > count_b ? -1 : 1;
+    }
+    return ((const ScriptNGramProfile::Entry*)a)->Key - ((const ScriptNGramProfile::Entry*)b)->Key;
+}
+
 ccInstance *current_instance;
 // [IKM] 2012-10-21:
 // NOTE: This is temporary solution (*sigh*, one of many) which allows certain
@@ -245,6 +339,10 @@ ccInstance::ccInstance()
     returnValue         = 0;
 
     code_fixups         = NULL;
+    code_ops            = NULL;
+    num_code_ops        = 0;
+    code_op_index       = NULL;
+    ngram_profile       = NULL;
 }
 
 ccInstance::~ccInstance()
@@ -488,6 +586,15 @@ int ccInstance::PrepareTextScript(char**tsname) {
     currentline = line_number
 
 #define MAXNEST 50  // number of recursive function calls allowed
+
+// Compares registers, then performs following SCMD_JZ
+#define SUPER_COMPARE_JZ(CONDITION) \
+    reg1.SetInt32AsBool(CONDITION); \
+    pc += op->ArgCount + 1; \
+    op++; \
+    if (registers[SREG_AX].IsNull()) \
+        pc += op->Args[0].IValue
+
 int ccInstance::Run(int32_t curpc)
 {
     pc = curpc;
@@ -510,101 +617,157 @@ int ccInstance::Run(int32_t curpc)
     current_instance = this;
     ccInstance *codeInst = runningInst;
     int write_debug_dump = ccGetOption(SCOPT_DEBUGRUN);
+    ScriptNGramProfile *ngram_profile = codeInst->ngram_profile;
+    int32_t ngram_prev1 = -1;
+    int32_t ngram_prev2 = -1;
+    // Superinstructions are not used when each instruction has to be seen
+    const bool exec_plain_ops = write_debug_dump || ngram_profile;
 	ScriptOperation codeOp;
+    ScriptOperation *op;
 
     FunctionCallStack func_callstack;
 
     while (1) {
 
-        /*
-		if (!codeInst->ReadOperation(codeOp, pc))
+        if (codeInst->code_ops)
         {
-            return -1;
+            // Fetch pre-decoded operation
+            //=====================================================================
+            int32_t op_index = -1;
+            if (pc >= 0 && pc < codeInst->codesize)
+            {
+                op_index = codeInst->code_op_index[pc];
+            }
+            if (op_index < 0)
+            {
+                cc_error("invalid code offset %d, not an instruction", pc);
+                return -1;
+            }
+            op = &codeInst->code_ops[op_index];
+            if (op->HasLateFixups)
+            {
+                // some arguments depend on the current state of stack or imports
+                codeOp = *op;
+                for (int i = 0; i < codeOp.ArgCount; ++i)
+                {
+                    if (codeOp.LateFixups[i] > 0 &&
+                        !FixupArgument(codeOp.Args[i].IValue, codeOp.LateFixups[i], codeOp.Args[i]))
+                    {
+                        return -1;
+                    }
+                }
+                op = &codeOp;
+            }
         }
-        */
-        /* ReadOperation */
-        //=====================================================================
-        codeOp.Instruction.Code			= codeInst->code[pc];
-        codeOp.Instruction.InstanceId	= (codeOp.Instruction.Code >> INSTANCE_ID_SHIFT) & INSTANCE_ID_MASK;
-        codeOp.Instruction.Code		   &= INSTANCE_ID_REMOVEMASK; // now this is pure instruction code
-
-        int want_args = sccmd_info[codeOp.Instruction.Code].ArgCount;
-        if (pc + want_args >= codeInst->codesize)
+        else
         {
-            cc_error("unexpected end of code data at %d", pc + want_args);
-            return -1;
-        }
-        codeOp.ArgCount = want_args;
+            /*
+            if (!codeInst->ReadOperation(codeOp, pc))
+            {
+                return -1;
+            }
+            */
+            /* ReadOperation */
+            //=====================================================================
+            codeOp.Instruction.Code			= codeInst->code[pc];
+            codeOp.Instruction.InstanceId	= (codeOp.Instruction.Code >> INSTANCE_ID_SHIFT) & INSTANCE_ID_MASK;
+            codeOp.Instruction.Code		   &= INSTANCE_ID_REMOVEMASK; // now this is pure instruction code
+
+            int want_args = sccmd_info[codeOp.Instruction.Code].ArgCount;
+            if (pc + want_args >= codeInst->codesize)
+            {
+                cc_error("unexpected end of code data at %d", pc + want_args);
+                return -1;
+            }
+            codeOp.ArgCount = want_args;
 
-        int pc_at = pc + 1;
-        for (int i = 0; i < want_args; ++i, ++pc_at)
-        {
-            char fixup = codeInst->code_fixups[pc_at];
-            if (fixup > 0)
+            int pc_at = pc + 1;
+            for (int i = 0; i < want_args; ++i, ++pc_at)
             {
-                // could be relative pointer or import address
-                /*
-                if (!FixupArgument(code[pc], fixup, codeOp.Args[i]))
+                char fixup = codeInst->code_fixups[pc_at];
+                if (fixup > 0)
                 {
-                    return -1;
-                }
-                */
-                /* FixupArgument */
-                //=====================================================================
-                switch (fixup)
-                {
-                case FIXUP_GLOBALDATA:
+                    // could be relative pointer or import address
+                    /*
+                    if (!FixupArgument(code[pc], fixup, codeOp.Args[i]))
                     {
-                        ScriptVariable *gl_var = (ScriptVariable*)codeInst->code[pc_at];
-                        codeOp.Args[i].SetGlobalVar(&gl_var->RValue);
+                        return -1;
                     }
-                    break;
-                case FIXUP_FUNCTION:
-                    // originally commented -- CHECKME: could this be used in very old versions of AGS?
-                    //      code[fixup] += (long)&code[0];
-                    // This is a program counter value, presumably will be used as SCMD_CALL argument
-                    codeOp.Args[i].SetInt32((int32_t)codeInst->code[pc_at]);
-                    break;
-                case FIXUP_STRING:
-                    codeOp.Args[i].SetStringLiteral(&codeInst->strings[0] + codeInst->code[pc_at]);
-                    break;
-                case FIXUP_IMPORT:
+                    */
+                    /* FixupArgument */
+                    //=====================================================================
+                    switch (fixup)
                     {
-                        const ScriptImport *import = simp.getByIndex((int32_t)codeInst->code[pc_at]);
-                        if (import)
+                    case FIXUP_GLOBALDATA:
                         {
-                            codeOp.Args[i] = import->Value;
+                            ScriptVariable *gl_var = (ScriptVariable*)codeInst->code[pc_at];
+                            codeOp.Args[i].SetGlobalVar(&gl_var->RValue);
                         }
-                        else
+                        break;
+                    case FIXUP_FUNCTION:
+                        // originally commented -- CHECKME: could this be used in very old versions of AGS?
+                        //      code[fixup] += (long)&code[0];
+                        // This is a program counter value, presumably will be used as SCMD_CALL argument
+                        codeOp.Args[i].SetInt32((int32_t)codeInst->code[pc_at]);
+                        break;
+                    case FIXUP_STRING:
+                        codeOp.Args[i].SetStringLiteral(&codeInst->strings[0] + codeInst->code[pc_at]);
+                        break;
+                    case FIXUP_IMPORT:
                         {
-                            cc_error("cannot resolve import, key = %ld", codeInst->code[pc_at]);
-                            return -1;
+                            const ScriptImport *import = simp.getByIndex((int32_t)codeInst->code[pc_at]);
+                            if (import)
+                            {
+                                codeOp.Args[i] = import->Value;
+                            }
+                            else
+                            {
+                                cc_error("cannot resolve import, key = %ld", codeInst->code[pc_at]);
+                                return -1;
+                            }
                         }
+                        break;
+                    case FIXUP_STACK:
+                        codeOp.Args[i] = GetStackPtrOffsetFw((int32_t)codeInst->code[pc_at]);
+                        break;
+                    default:
+                        cc_error("internal fixup type error: %d", fixup);
+                        return -1;
                     }
-                    break;
-                case FIXUP_STACK:
-                    codeOp.Args[i] = GetStackPtrOffsetFw((int32_t)codeInst->code[pc_at]);
-                    break;
-                default:
-                    cc_error("internal fixup type error: %d", fixup);
-                    return -1;
+                    /* End FixupArgument */
+                    //=====================================================================
+                }
+                else
+                {
+                    // should be a numeric literal (int32 or float)
+                    codeOp.Args[i].SetInt32( (int32_t)codeInst->code[pc_at] );
                 }
-                /* End FixupArgument */
-                //=====================================================================
+            }
+            /* End ReadOperation */
+            //=====================================================================
+            codeOp.SuperCode = codeOp.Instruction.Code;
+            op = &codeOp;
+        }
+
+        const int32_t cmd = exec_plain_ops ? op->Instruction.Code : op->SuperCode;
+        if (ngram_profile)
+        {
+            if ((uint32_t)cmd < CC_NUM_SCCMDS)
+            {
+                ngram_profile->Count(cmd, ngram_prev1, ngram_prev2);
+                ngram_prev2 = ngram_prev1;
+                ngram_prev1 = cmd;
             }
             else
             {
-                // should be a numeric literal (int32 or float)
-                codeOp.Args[i].SetInt32( (int32_t)codeInst->code[pc_at] );
+                ngram_prev1 = ngram_prev2 = -1;
             }
         }
-        /* End ReadOperation */
-        //=====================================================================
 
         // save the arguments for quick access
-        RuntimeScriptValue &arg1 = codeOp.Args[0];
-        RuntimeScriptValue &arg2 = codeOp.Args[1];
-        RuntimeScriptValue &arg3 = codeOp.Args[2];
+        RuntimeScriptValue &arg1 = op->Args[0];
+        RuntimeScriptValue &arg2 = op->Args[1];
+        RuntimeScriptValue &arg3 = op->Args[2];
         RuntimeScriptValue &reg1 = 
             registers[arg1.IValue >= 0 && arg1.IValue < CC_NUM_REGISTERS ? arg1.IValue : 0];
         RuntimeScriptValue &reg2 = 
@@ -615,10 +778,10 @@ int ccInstance::Run(int32_t curpc)
 
         if (write_debug_dump)
         {
-            DumpInstruction(codeOp);
+            DumpInstruction(*op);
         }
 
-        switch (codeOp.Instruction.Code) {
+        switch (cmd) {
       case SCMD_LINENUM:
           line_number = arg1.IValue;
           currentline = arg1.IValue;
@@ -815,7 +978,7 @@ int ccInstance::Run(int32_t curpc)
           PUSH_CALL_STACK;
 
           ASSERT_STACK_SPACE_AVAILABLE(1);
-          PushValueToStack(RuntimeScriptValue().SetInt32(pc + sccmd_info[codeOp.Instruction.Code].ArgCount + 1));
+          PushValueToStack(RuntimeScriptValue().SetInt32(pc + op->ArgCount + 1));
           if (ccError)
           {
               return -1;
@@ -1083,7 +1246,7 @@ int ccInstance::Run(int32_t curpc)
           ccInstance *wasRunning = runningInst;
 
           // extract the instance ID
-          int32_t instId = codeOp.Instruction.InstanceId;
+          int32_t instId = op->Instruction.InstanceId;
           // determine the offset into the code of the instance we want
           runningInst = loadedInstances[instId];
           intptr_t callAddr = reg1.Ptr - (char*)&runningInst->code[0];
@@ -1352,15 +1515,57 @@ int ccInstance::Run(int32_t curpc)
           if (loopIterationCheckDisabled == 0)
               loopIterationCheckDisabled++;
           break;
+
+          // Superinstructions: each executes the first operation, then
+          // advances to the next one, which is finished by the common code
+      case SCMD_SUPER_LITTOREG_PUSHREG:
+          reg1 = arg2;
+          pc += op->ArgCount + 1;
+          op++;
+          ASSERT_STACK_SPACE_AVAILABLE(1);
+          PushValueToStack(registers[op->Args[0].IValue]);
+          if (ccError)
+          {
+              return -1;
+          }
+          break;
+      case SCMD_SUPER_LOADSPOFFS_MEMREAD:
+          registers[SREG_MAR] = GetStackPtrOffsetRw(arg1.IValue);
+          if (ccError)
+          {
+              return -1;
+          }
+          pc += op->ArgCount + 1;
+          op++;
+          registers[op->Args[0].IValue] = registers[SREG_MAR].ReadValue();
+          break;
+      case SCMD_SUPER_ISEQUAL_JZ:
+          SUPER_COMPARE_JZ(reg1 == reg2);
+          break;
+      case SCMD_SUPER_NOTEQUAL_JZ:
+          SUPER_COMPARE_JZ(reg1 != reg2);
+          break;
+      case SCMD_SUPER_GREATER_JZ:
+          SUPER_COMPARE_JZ(reg1.IValue > reg2.IValue);
+          break;
+      case SCMD_SUPER_LESSTHAN_JZ:
+          SUPER_COMPARE_JZ(reg1.IValue < reg2.IValue);
+          break;
+      case SCMD_SUPER_GTE_JZ:
+          SUPER_COMPARE_JZ(reg1.IValue >= reg2.IValue);
+          break;
+      case SCMD_SUPER_LTE_JZ:
+          SUPER_COMPARE_JZ(reg1.IValue <= reg2.IValue);
+          break;
       default:
-          cc_error("invalid instruction %d found in code stream", codeOp.Instruction.Code);
+          cc_error("invalid instruction %d found in code stream", op->Instruction.Code);
           return -1;
         }
 
         if (flags & INSTF_ABORTED)
             return 0;
 
-        pc += sccmd_info[codeOp.Instruction.Code].ArgCount + 1;
+        pc += op->ArgCount + 1;
     }
 }
 
@@ -1647,6 +1852,10 @@ bool ccInstance::_Create(ccScript * scri, ccInstance * joined)
     {
         resolved_imports = joined->resolved_imports;
         code_fixups = joined->code_fixups;
+        code_ops = joined->code_ops;
+        num_code_ops = joined->num_code_ops;
+        code_op_index = joined->code_op_index;
+        ngram_profile = joined->ngram_profile;
     }
     else
     {
@@ -1662,6 +1871,14 @@ bool ccInstance::_Create(ccScript * scri, ccInstance * joined)
         {
             return false;
         }
+        if (!CreateDecodedOperations())
+        {
+            return false;
+        }
+        if (ccGetOption(SCOPT_PROFILERUN))
+        {
+            ngram_profile = new ScriptNGramProfile();
+        }
     }
 
     exports = new RuntimeScriptValue[scri->numexports];
@@ -1749,9 +1966,20 @@ void ccInstance::Free()
     {
         delete [] resolved_imports;
         delete [] code_fixups;
+        delete [] code_ops;
+        delete [] code_op_index;
+        if (ngram_profile)
+        {
+            DumpNGramProfile();
+            delete ngram_profile;
+        }
     }
     resolved_imports = NULL;
     code_fixups = NULL;
+    code_ops = NULL;
+    num_code_ops = 0;
+    code_op_index = NULL;
+    ngram_profile = NULL;
 }
 
 bool ccInstance::ResolveScriptImports(ccScript * scri)
@@ -2008,6 +2236,207 @@ bool ccInstance::CreateRuntimeCodeFixups(ccScript * scri)
     return true;
 }
 
+bool ccInstance::CreateDecodedOperations()
+{
+    code_ops = NULL;
+    num_code_ops = 0;
+    code_op_index = NULL;
+    ngram_profile = NULL;
+    if (codesize <= 0 || ccGetOption(SCOPT_LEGACYRUN))
+    {
+        return true;
+    }
+
+    // Step One: count the instructions and make sure the code is consistent;
+    // if it is not, leave the script to the legacy decoder, which reports
+    // errors only when reaching the broken instruction
+    int32_t at_pc = 0;
+    int op_count = 0;
+    while (at_pc < codesize)
+    {
+        int32_t cmd = (int32_t)(code[at_pc] & INSTANCE_ID_REMOVEMASK);
+        if (cmd < 0 || cmd >= CC_NUM_SCCMDS)
+        {
+            Common::Out::FPrint("WARNING: invalid instruction %d found in code stream at %d, script will use legacy decoder", cmd, at_pc);
+            return true;
+        }
+        at_pc += sccmd_info[cmd].ArgCount + 1;
+        op_count++;
+    }
+    if (at_pc != codesize)
+    {
+        Common::Out::FPrint("WARNING: unexpected end of code data at %d, script will use legacy decoder", at_pc);
+        return true;
+    }
+
+    // Step Two: decode instructions and resolve the arguments which
+    // do not depend on script's execution state
+    code_ops = new ScriptOperation[op_count];
+    num_code_ops = op_count;
+    code_op_index = new int32_t[codesize];
+    for (int32_t i = 0; i < codesize; ++i)
+    {
+        code_op_index[i] = -1;
+    }
+
+    at_pc = 0;
+    for (int op_index = 0; op_index < op_count; ++op_index)
+    {
+        ScriptOperation &op = code_ops[op_index];
+        code_op_index[at_pc] = op_index;
+        op.Instruction.Code         = (int32_t)code[at_pc];
+        op.Instruction.InstanceId   = (op.Instruction.Code >> INSTANCE_ID_SHIFT) & INSTANCE_ID_MASK;
+        op.Instruction.Code        &= INSTANCE_ID_REMOVEMASK;
+        op.ArgCount                 = sccmd_info[op.Instruction.Code].ArgCount;
+
+        at_pc++;
+        for (int i = 0; i < op.ArgCount; ++i, ++at_pc)
+        {
+            char fixup = code_fixups[at_pc];
+            switch (fixup)
+            {
+            case 0:
+                // should be a numeric literal (int32 or float)
+                op.Args[i].SetInt32((int32_t)code[at_pc]);
+                break;
+            case FIXUP_GLOBALDATA:
+            case FIXUP_FUNCTION:
+            case FIXUP_STRING:
+                if (!FixupArgument(code[at_pc], fixup, op.Args[i]))
+                {
+                    return false;
+                }
+                break;
+            default:
+                // imports may be replaced while the game runs and stack
+                // offsets depend on the current stack state
+                op.Args[i].SetInt32((int32_t)code[at_pc]);
+                op.LateFixups[i] = fixup;
+                op.HasLateFixups = true;
+                break;
+            }
+        }
+        op.SuperCode = op.Instruction.Code;
+    }
+
+    CreateSuperInstructions();
+    return true;
+}
+
+void ccInstance::CreateSuperInstructions()
+{
+    for (int i = 0; i + 1 < num_code_ops; ++i)
+    {
+        ScriptOperation &op = code_ops[i];
+        const ScriptOperation &next_op = code_ops[i + 1];
+        // Superinstruction reads the following operation's arguments directly
+        if (op.HasLateFixups || next_op.HasLateFixups)
+        {
+            continue;
+        }
+
+        const int32_t next_cmd = next_op.Instruction.Code;
+        const bool next_reg_valid = next_op.ArgCount > 0 &&
+            next_op.Args[0].IValue >= 0 && next_op.Args[0].IValue < CC_NUM_REGISTERS;
+        switch (op.Instruction.Code)
+        {
+        case SCMD_LITTOREG:
+            // PUSHREG followed by POPREG is optimized on its own, see SCMD_PUSHREG
+            if (next_cmd == SCMD_PUSHREG && next_reg_valid &&
+                (i + 2 >= num_code_ops || code_ops[i + 2].Instruction.Code != SCMD_POPREG))
+            {
+                op.SuperCode = SCMD_SUPER_LITTOREG_PUSHREG;
+            }
+            break;
+        case SCMD_LOADSPOFFS:
+            if (next_cmd == SCMD_MEMREAD && next_reg_valid)
+            {
+                op.SuperCode = SCMD_SUPER_LOADSPOFFS_MEMREAD;
+            }
+            break;
+        case SCMD_ISEQUAL:
+        case SCMD_NOTEQUAL:
+        case SCMD_GREATER:
+        case SCMD_LESSTHAN:
+        case SCMD_GTE:
+        case SCMD_LTE:
+            if (next_cmd == SCMD_JZ)
+            {
+                op.SuperCode = SCMD_SUPER_ISEQUAL_JZ + (op.Instruction.Code - SCMD_ISEQUAL);
+            }
+            break;
+        }
+    }
+}
+
+void ccInstance::DumpNGramProfile()
+{
+    Stream *out = ci_fopen("script_profile.log", Common::kFile_Create, Common::kFile_Write);
+    if (!out)
+    {
+        return;
+    }
+    TextStreamWriter writer(out);
+    const char *script_name = instanceof && instanceof->numSections > 0 ? instanceof->sectionNames[0] : "(unknown section)";
+    writer.WriteFormat("Script \"%s\": %u instructions executed", script_name, ngram_profile->Total);
+    writer.WriteLineBreak();
+
+    ScriptNGramProfile::Entry *entries = new ScriptNGramProfile::Entry[CC_NUM_SCCMDS * CC_NUM_SCCMDS];
+    int num_entries = 0;
+    for (int i = 0; i < CC_NUM_SCCMDS; ++i)
+    {
+        for (int j = 0; j < CC_NUM_SCCMDS; ++j)
+        {
+            if (ngram_profile->Pairs[i][j] > 0)
+            {
+                entries[num_entries].Key   = i * CC_NUM_SCCMDS + j;
+                entries[num_entries].Count = ngram_profile->Pairs[i][j];
+                num_entries++;
+            }
+        }
+    }
+    qsort(entries, num_entries, sizeof(ScriptNGramProfile::Entry), ngram_entry_cmp);
+    writer.WriteLine("Instruction pairs:");
+    for (int i = 0; i < num_entries; ++i)
+    {
+        const int32_t cmd1 = entries[i].Key / CC_NUM_SCCMDS;
+        const int32_t cmd2 = entries[i].Key % CC_NUM_SCCMDS;
+        writer.WriteFormat("%10u  %s(%d) %s(%d)", entries[i].Count,
+            sccmd_info[cmd1].CmdName, cmd1, sccmd_info[cmd2].CmdName, cmd2);
+        writer.WriteLineBreak();
+    }
+    delete [] entries;
+
+    entries = new ScriptNGramProfile::Entry[NGRAM_TRIPLE_SLOTS];
+    num_entries = 0;
+    for (int i = 0; i < NGRAM_TRIPLE_SLOTS; ++i)
+    {
+        if (ngram_profile->Triples[i].Key >= 0)
+        {
+            entries[num_entries++] = ngram_profile->Triples[i];
+        }
+    }
+    qsort(entries, num_entries, sizeof(ScriptNGramProfile::Entry), ngram_entry_cmp);
+    writer.WriteLine("Instruction triples:");
+    for (int i = 0; i < num_entries; ++i)
+    {
+        const int32_t cmd1 = entries[i].Key / (CC_NUM_SCCMDS * CC_NUM_SCCMDS);
+        const int32_t cmd2 = (entries[i].Key / CC_NUM_SCCMDS) % CC_NUM_SCCMDS;
+        const int32_t cmd3 = entries[i].Key % CC_NUM_SCCMDS;
+        writer.WriteFormat("%10u  %s(%d) %s(%d) %s(%d)", entries[i].Count,
+            sccmd_info[cmd1].CmdName, cmd1, sccmd_info[cmd2].CmdName, cmd2, sccmd_info[cmd3].CmdName, cmd3);
+        writer.WriteLineBreak();
+    }
+    if (ngram_profile->TriplesDropped > 0)
+    {
+        writer.WriteFormat("(%u triples were not counted, table is full)", ngram_profile->TriplesDropped);
+        writer.WriteLineBreak();
+    }
+    writer.WriteLineBreak();
+    delete [] entries;
+    // the writer will delete data stream internally
+}
+
 /*
 bool ccInstance::ReadOperation(ScriptOperation &op, int32_t at_pc)
 {
@@ -2045,7 +2474,8 @@ bool ccInstance::ReadOperation(ScriptOperation &op, int32_t at_pc)
     return true;
 }
 */
-/*
+// NOTE: the legacy decoder in Run() has this inlined for the sake of speed;
+// this is used to resolve late fixups of pre-decoded operations
 bool ccInstance::FixupArgument(intptr_t code_value, char fixup_type, RuntimeScriptValue &argument)
 {
     switch (fixup_type)
@@ -2084,11 +2514,10 @@ bool ccInstance::FixupArgument(intptr_t code_value, char fixup_type, RuntimeScri
         break;
     default:
         cc_error("internal fixup type error: %d", fixup_type);
-        return false;;
+        return false;
     }
     return true;
 }
-*/
 //-----------------------------------------------------------------------------
 
 void ccInstance::PushValueToStack(const RuntimeScriptValue &rval)
@@ -61,11 +61,25 @@ struct ScriptOperation
 	ScriptOperation()
 	{
 		ArgCount = 0;
+		for (int i = 0; i < MAX_SCMD_ARGS; ++i)
+		{
+			LateFixups[i] = 0;
+		}
+		HasLateFixups = false;
+		SuperCode = 0;
 	}
 
 	ScriptInstruction   Instruction;
 	RuntimeScriptValue	Args[MAX_SCMD_ARGS];
 	int				    ArgCount;
+	// Fixup types of the arguments which cannot be resolved when the script
+	// is loaded and must be resolved each time operation is executed
+	// (imports and stack offsets); these arguments keep raw code value
+	char                LateFixups[MAX_SCMD_ARGS];
+	bool                HasLateFixups;
+	// Code of the engine's superinstruction, which executes this and
+	// following operation(s) at once; equals Instruction.Code if none
+	int32_t             SuperCode;
 };
 
 struct ScriptVariable
@@ -81,6 +95,7 @@ struct ScriptVariable
 };
 
 struct FunctionCallStack;
+struct ScriptNGramProfile;
 
 struct ScriptPosition
 {
@@ -141,6 +156,16 @@ public:
 
     char *code_fixups;
 
+    // Pre-decoded operations, with argument fixups resolved on load;
+    // NULL if the script is run by the legacy instruction decoder
+    ScriptOperation *code_ops;
+    int  num_code_ops;
+    // Index of pre-decoded operation for each code offset,
+    // or -1 if the offset is not the beginning of instruction
+    int32_t *code_op_index;
+    // Frequencies of executed instruction sequences, if profiling is on
+    ScriptNGramProfile *ngram_profile;
+
     // returns the currently executing instance, or NULL if none
     static ccInstance *GetCurrentInstance(void);
     // create a runnable instance of the supplied script
@@ -185,10 +210,16 @@ protected:
     ScriptVariable *FindGlobalVar(int32_t var_addr, int *pindex = NULL);
     void    AddGlobalVar(const ScriptVariable &glvar, int at_index);
     bool    CreateRuntimeCodeFixups(ccScript * scri);
+    // Translates code into the array of pre-decoded operations
+    bool    CreateDecodedOperations();
+    // Replaces common sequences of pre-decoded operations with superinstructions
+    void    CreateSuperInstructions();
+    // Writes collected instruction frequencies to the profile log
+    void    DumpNGramProfile();
 	//bool    ReadOperation(ScriptOperation &op, int32_t at_pc);
 
     // Runtime fixups
-    //bool    FixupArgument(intptr_t code_value, char fixup_type, RuntimeScriptValue &argument);
+    bool    FixupArgument(intptr_t code_value, char fixup_type, RuntimeScriptValue &argument);
 
     // Stack processing
     // Push writes new value and increments stack ptr;
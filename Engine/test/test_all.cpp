@@ -24,8 +24,30 @@ void Test_DoAllTests()
     Test_String();
     Test_Version();
     Test_File();
+    Test_BufferedStream();
 
     Test_Gfx();
+    Test_ManagedObjectPool();
+    Test_Compress();
+    Test_AssetManager();
+    Test_Audio();
+}
+
+void Test_DoAllBenchmarks()
+{
+    // needs allegro, which the startup tests run without
+    Test_Font();
+    Test_FontBenchmark();
+    Test_AudioDriver();
+    Test_AudioBenchmark();
+    Test_BufferedStreamBenchmark();
+#if !defined(ANDROID_VERSION) && !defined(PSP_VERSION)
+    Test_FilterBenchmark();
+#endif
+    Test_SpriteCompressionBenchmark();
+    Test_ManagedObjectPoolBenchmark();
+    Test_AssetManagerBenchmark();
+    Test_RouteFinderBenchmark();
 }
 
 #endif // _DEBUG
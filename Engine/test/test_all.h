@@ -14,7 +14,24 @@
 
 #ifdef _DEBUG
 
+// Runs the tests which need nothing initialized, at the engine start
 void Test_DoAllTests();
+// Runs the timing loops and the tests which install allegro themselves,
+// when the engine is started with --benchmark
+void Test_DoAllBenchmarks();
 void Test_Gfx();
+void Test_FilterBenchmark();
+void Test_Font();
+void Test_FontBenchmark();
+void Test_ManagedObjectPool();
+void Test_ManagedObjectPoolBenchmark();
+void Test_Compress();
+void Test_SpriteCompressionBenchmark();
+void Test_AssetManager();
+void Test_AssetManagerBenchmark();
+void Test_Audio();
+void Test_AudioDriver();
+void Test_AudioBenchmark();
+void Test_RouteFinderBenchmark();
 
 #endif // _DEBUG
@@ -0,0 +1,155 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+
+#ifdef _DEBUG
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "core/assetmanager.h"
+#include "debug/assert.h"
+#include "debug/out.h"
+#include "util/file.h"
+#include "util/stream.h"
+
+using AGS::Common::AssetManager;
+using AGS::Common::Stream;
+using AGS::Common::String;
+namespace File = AGS::Common::File;
+namespace Out = AGS::Common::Out;
+
+const int TEST_ASSET_COUNT = 10000;
+
+// Writes a version 10 library, the newest one without encryption, where
+// every asset holds its own index
+void Test_WriteAssetLib(const char *lib_name)
+{
+    Stream *out = File::OpenFile(lib_name, AGS::Common::kFile_CreateAlways, AGS::Common::kFile_Write);
+    out->Write("CLIB\x1a", 5);
+    out->WriteInt8(10); // version
+    out->WriteInt8(0);  // first part of library
+    char name[25];
+    out->WriteInt32(1);
+    memset(name, 0, sizeof(name));
+    strcpy(name, lib_name);
+    out->Write(name, 20);
+    out->WriteInt32(TEST_ASSET_COUNT);
+    for (int i = 0; i < TEST_ASSET_COUNT; ++i)
+    {
+        memset(name, 0, sizeof(name));
+        sprintf(name, "asset%05d.dat", i);
+        out->Write(name, 25);
+    }
+    int data_offset = out->GetPosition() + TEST_ASSET_COUNT * (sizeof(int32_t) * 2 + 1);
+    for (int i = 0; i < TEST_ASSET_COUNT; ++i)
+        out->WriteInt32(data_offset + i * sizeof(int32_t));
+    for (int i = 0; i < TEST_ASSET_COUNT; ++i)
+        out->WriteInt32(sizeof(int32_t));
+    for (int i = 0; i < TEST_ASSET_COUNT; ++i)
+        out->WriteInt8(0);
+    for (int i = 0; i < TEST_ASSET_COUNT; ++i)
+        out->WriteInt32(i);
+    delete out;
+}
+
+void Test_AssetManager()
+{
+    const char *lib_name = "test.tmp";
+    Test_WriteAssetLib(lib_name);
+
+    AssetManager::CreateInstance();
+    AssetManager::SetSearchPriority(AGS::Common::kAssetPriorityLib);
+    assert(AssetManager::SetDataFile(lib_name) == AGS::Common::kAssetNoError);
+    assert(AssetManager::GetAssetCount() == TEST_ASSET_COUNT);
+
+    // names are found regardless of case
+    char name[25];
+    assert(AssetManager::GetAssetSize("ASSET00042.DAT") == sizeof(int32_t));
+    assert(AssetManager::DoesAssetExist("Asset09999.Dat"));
+    assert(!AssetManager::DoesAssetExist("asset10000.dat"));
+    assert(AssetManager::GetAssetOffset("asset") == -1);
+
+    // open some of the assets in the library
+    for (int i = 0; i < TEST_ASSET_COUNT; i += 97)
+    {
+        sprintf(name, "asset%05d.dat", i);
+        Stream *in = AssetManager::OpenAsset(name);
+        assert(in != NULL);
+        assert(in->ReadInt32() == i);
+        delete in;
+    }
+
+    // assets read from the library mapped into memory report file positions,
+    // end where the asset does, and keep the mapping after library is closed
+    Stream *mapped_in = AssetManager::OpenAsset("asset00005.dat");
+    assert(mapped_in != NULL);
+    size_t asset_pos = mapped_in->GetPosition();
+    assert(asset_pos == (size_t)AssetManager::GetAssetOffset("asset00005.dat"));
+    bool is_mapped = mapped_in->GetDataAt(asset_pos) != NULL;
+
+    AssetManager::DestroyInstance();
+
+    if (is_mapped)
+    {
+        assert(mapped_in->GetLength() == asset_pos + sizeof(int32_t));
+        assert(mapped_in->ReadInt32() == 5);
+        assert(mapped_in->EOS());
+        assert(mapped_in->ReadByte() == -1);
+        assert(mapped_in->Seek(AGS::Common::kSeekCurrent, -2) == asset_pos + 2);
+        assert(mapped_in->Seek(AGS::Common::kSeekBegin, 0) == asset_pos);
+        assert(*mapped_in->GetDataAt(asset_pos) == 5);
+    }
+    delete mapped_in;
+    File::DeleteFile(lib_name);
+}
+
+void Test_AssetManagerBenchmark()
+{
+    const char *lib_name = "test.tmp";
+    Test_WriteAssetLib(lib_name);
+    AssetManager::CreateInstance();
+    AssetManager::SetSearchPriority(AGS::Common::kAssetPriorityLib);
+    assert(AssetManager::SetDataFile(lib_name) == AGS::Common::kAssetNoError);
+
+    // open every asset in the library
+    char name[25];
+    clock_t start = clock();
+    for (int i = 0; i < TEST_ASSET_COUNT; ++i)
+    {
+        sprintf(name, "asset%05d.dat", i);
+        Stream *in = AssetManager::OpenAsset(name);
+        assert(in != NULL);
+        delete in;
+    }
+    clock_t elapsed = clock() - start;
+    Out::FPrint("AssetManager: opening %d assets took %d ms",
+        TEST_ASSET_COUNT, (int)(elapsed * 1000 / CLOCKS_PER_SEC));
+
+    // asset lookups alone
+    const int num_lookups = 100000;
+    start = clock();
+    for (int i = 0, at = 0; i < num_lookups; ++i, at = (at + 7919) % TEST_ASSET_COUNT)
+    {
+        sprintf(name, "asset%05d.dat", at);
+        AssetManager::GetAssetSize(name);
+    }
+    elapsed = clock() - start;
+    Out::FPrint("AssetManager: %d lookups among %d assets took %d ms",
+        num_lookups, TEST_ASSET_COUNT, (int)(elapsed * 1000 / CLOCKS_PER_SEC));
+
+    AssetManager::DestroyInstance();
+    File::DeleteFile(lib_name);
+}
+
+#endif // _DEBUG
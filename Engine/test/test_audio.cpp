@@ -0,0 +1,332 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+
+#ifdef _DEBUG
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "util/wgt2allg.h"
+#include "core/assetmanager.h"
+#include "media/audio/audio.h"
+#include "media/audio/audiocommands.h"
+#include "media/audio/audiointernaldefs.h"
+#include "media/audio/audiostreamsource.h"
+#include "media/audio/clip_mywave.h"
+#include "media/audio/soundcache.h"
+#include "media/audio/soundclip.h"
+#include "debug/assert.h"
+#include "debug/out.h"
+#include "platform/base/agsplatformdriver.h"
+#include "util/file.h"
+#include "util/stream.h"
+#include "util/thread.h"
+
+using AGS::Common::AssetManager;
+using AGS::Common::Stream;
+namespace File = AGS::Common::File;
+namespace Out = AGS::Common::Out;
+
+const int TEST_AUDIO_OPERATIONS = 2000;
+const int TEST_AUDIO_BENCHMARK_OPERATIONS = 100000;
+const int TEST_STREAM_SIZE = 300000;
+
+// Count of the passes made by the polling thread
+volatile unsigned int test_audio_passes = 0;
+int test_clips_created = 0;
+int test_clips_destroyed = 0;
+// Count of the clips destroyed later than the pass after they were posted;
+// that happens only if the game thread was preempted before posting
+int test_late_destroys = 0;
+
+// Clip which plays nothing, so that no audio driver is needed
+struct TestClip : SOUNDCLIP {
+    int Polls;
+    bool Destroyed;
+    unsigned int DestroyPostedAt;
+
+    TestClip() : Polls(0), Destroyed(false), DestroyPostedAt(0) { test_clips_created++; }
+
+    virtual int poll() {
+        assert(!Destroyed);
+        Polls++;
+        return done;
+    }
+    virtual void destroy() {
+        assert(!Destroyed);
+        Destroyed = true;
+        test_clips_destroyed++;
+        if (test_audio_passes - DestroyPostedAt > 1)
+            test_late_destroys++;
+    }
+    virtual void set_volume(int newvol) { vol = newvol; set_clip_volume(this, newvol); }
+    virtual void restart() {}
+    virtual void apply_volume(int, int) { assert(!Destroyed); }
+    virtual void apply_panning(int) { assert(!Destroyed); }
+    virtual void apply_pause() { assert(!Destroyed); paused = 1; }
+    virtual void apply_resume() { assert(!Destroyed); paused = 0; }
+    virtual void apply_seek(int) { assert(!Destroyed); }
+    virtual int get_pos() { return 0; }
+    virtual int get_pos_ms() { return 0; }
+    virtual int get_length_ms() { return 0; }
+    virtual int get_voice() { return -1; }
+    virtual int get_sound_type() { return MUS_WAVE; }
+    virtual int play() { return 1; }
+};
+
+void Test_AudioThreadPass()
+{
+    run_audio_commands();
+    poll_audio_clips();
+    test_audio_passes++;
+    AGSPlatformDriver::GetDriver()->YieldCPU();
+}
+
+void Test_DestroyTestClip(int chid)
+{
+    if (channels[chid] == NULL)
+        return;
+    ((TestClip*)channels[chid])->DestroyPostedAt = test_audio_passes;
+    destroy_channel_clip(chid);
+}
+
+// Changes the clip the way the game does, or takes it off the channel
+void Test_ChangeChannelClip(int chid, void (*destroy_clip)(int chid))
+{
+    switch (rand() % 8)
+    {
+    case 0:
+        destroy_clip(chid);
+        break;
+    case 1:
+        // the way a track goes to the crossfade channel
+        {
+            int to_chid = rand() % (MAX_SOUND_CHANNELS + 1);
+            if (to_chid == chid)
+                break;
+            destroy_clip(to_chid);
+            channels[to_chid] = channels[chid];
+            channels[chid] = NULL;
+        }
+        break;
+    case 2:
+        channels[chid]->done = 1;
+        break;
+    case 3:
+        channels[chid]->set_volume_origin(rand() % 101);
+        break;
+    case 4:
+        channels[chid]->set_panning(rand() % 256);
+        break;
+    case 5:
+        channels[chid]->pause();
+        break;
+    case 6:
+        channels[chid]->resume();
+        break;
+    case 7:
+        channels[chid]->seek(rand() % 1000);
+        break;
+    }
+}
+
+// The game thread plays, changes, moves and stops clips as fast as it can,
+// while the polling thread works on them
+void Test_AudioCommandQueue(int operations, bool report)
+{
+    test_audio_passes = 0;
+    test_clips_created = 0;
+    test_clips_destroyed = 0;
+    test_late_destroys = 0;
+    int old_multithreaded = psp_audio_multithreaded;
+    psp_audio_multithreaded = 1;
+    AGS::Engine::Thread poll_thread;
+    bool started = poll_thread.CreateAndStart(Test_AudioThreadPass, true);
+    assert(started);
+
+    clock_t start = clock();
+    for (int i = 0; i < operations; ++i)
+    {
+        int chid = rand() % (MAX_SOUND_CHANNELS + 1);
+        if (channels[chid] == NULL)
+            channels[chid] = new TestClip();
+        else
+            Test_ChangeChannelClip(chid, Test_DestroyTestClip);
+        if (i % 16 == 0)
+            sync_polled_clips();
+    }
+
+    for (int i = 0; i <= MAX_SOUND_CHANNELS; ++i)
+        Test_DestroyTestClip(i);
+    poll_thread.Stop();
+    run_audio_commands();
+    assert(test_clips_destroyed == test_clips_created);
+
+    if (report)
+    {
+        Out::FPrint("Audio commands: %d operations took %d ms, %d clips destroyed in %u polling passes, %d of them later than the next pass",
+            operations, (int)((clock() - start) * 1000 / CLOCKS_PER_SEC), test_clips_destroyed, test_audio_passes, test_late_destroys);
+        log_audio_command_stats();
+    }
+    psp_audio_multithreaded = old_multithreaded;
+}
+
+int test_waves_destroyed = 0;
+
+// Wave clip which counts its destruction
+struct TestWave : MYWAVE {
+    virtual void destroy() {
+        test_waves_destroyed++;
+        MYWAVE::destroy();
+    }
+};
+
+// Real clips played by the null sound driver, so that the commands reach
+// the actual decoder calls
+void Test_AudioDriver()
+{
+    if (install_allegro(SYSTEM_NONE, &errno, atexit) != 0)
+    {
+        Out::FPrint("Audio driver test: could not install allegro, skipped");
+        return;
+    }
+    if (install_sound(DIGI_NONE, MIDI_NONE, NULL) != 0)
+    {
+        Out::FPrint("Audio driver test: could not install the null sound driver, skipped");
+        allegro_exit();
+        return;
+    }
+    clear_sound_cache();
+    int old_multithreaded = psp_audio_multithreaded;
+    psp_audio_multithreaded = 1;
+    AGS::Engine::Thread poll_thread;
+    bool started = poll_thread.CreateAndStart(Test_AudioThreadPass, true);
+    assert(started);
+
+    test_waves_destroyed = 0;
+    int waves_created = 0;
+    for (int i = 0; i < TEST_AUDIO_OPERATIONS; ++i)
+    {
+        int chid = rand() % (MAX_SOUND_CHANNELS + 1);
+        if (channels[chid] == NULL)
+        {
+            TestWave *wave = new TestWave();
+            wave->wave = create_sample(8, 0, 11025, 1024);
+            wave->vol = 255;
+            wave->firstTime = 1;
+            wave->repeat = 0;
+            wave->set_volume_origin(rand() % 101);
+            wave->play();
+            waves_created++;
+            if (wave->voice < 0)
+            {
+                // the driver has no voice left, the clip could not be polled
+                wave->destroy();
+                delete wave;
+                continue;
+            }
+            channels[chid] = wave;
+        }
+        else
+        {
+            Test_ChangeChannelClip(chid, destroy_channel_clip);
+        }
+        if (i % 16 == 0)
+            sync_polled_clips();
+    }
+
+    for (int i = 0; i <= MAX_SOUND_CHANNELS; ++i)
+        destroy_channel_clip(i);
+    poll_thread.Stop();
+    run_audio_commands();
+    assert(test_waves_destroyed == waves_created);
+
+    psp_audio_multithreaded = old_multithreaded;
+    remove_sound();
+    allegro_exit();
+}
+
+// Reads the whole source in pieces of random size, as the decoder would;
+// returns the count of reads which missed the look-ahead
+int Test_ReadStreamSource(const char *file_name, const char *expect, bool read_ahead)
+{
+    AudioStreamSource *source = open_audio_stream_source(file_name);
+    assert(source != NULL);
+    assert(source->length == TEST_STREAM_SIZE);
+    char *buffer = (char*)malloc(MP3CHUNKSIZE);
+    long pos = 0;
+    while (source->remaining > 0)
+    {
+        // polls made while the decoder had enough data
+        for (int i = 0; read_ahead && (i < MP3CHUNKSIZE / 1024); ++i)
+            source->read_ahead();
+        int size = 1 + rand() % MP3CHUNKSIZE;
+        int read = source->read(buffer, size);
+        assert((read == size) || (pos + read == TEST_STREAM_SIZE));
+        assert(memcmp(buffer, expect + pos, read) == 0);
+        pos += read;
+    }
+    assert(pos == TEST_STREAM_SIZE);
+    assert(source->read(buffer, MP3CHUNKSIZE) == 0);
+    int misses = source->readahead_misses;
+    free(buffer);
+    close_audio_stream_source(source);
+    return misses;
+}
+
+void Test_AudioStreamSource()
+{
+    AssetManager::CreateInstance();
+    AssetManager::SetSearchPriority(AGS::Common::kAssetPriorityDir);
+    int old_multithreaded = psp_audio_multithreaded;
+    psp_audio_multithreaded = 0;
+    int old_lookahead = audio_stream_lookahead;
+
+    const char *file_name = "stream.tmp";
+    char *data = (char*)malloc(TEST_STREAM_SIZE);
+    for (int i = 0; i < TEST_STREAM_SIZE; ++i)
+        data[i] = (char)rand();
+    Stream *out = File::OpenFile(file_name, AGS::Common::kFile_CreateAlways, AGS::Common::kFile_Write);
+    out->Write(data, TEST_STREAM_SIZE);
+    delete out;
+
+    audio_stream_lookahead = 64;
+    // the look-ahead kept full is never caught up with
+    assert(Test_ReadStreamSource(file_name, data, true) == 0);
+    // without polls in between the data is read at once, all the same
+    assert(Test_ReadStreamSource(file_name, data, false) > 0);
+    // no look-ahead given is the same as one chunk
+    audio_stream_lookahead = 0;
+    assert(Test_ReadStreamSource(file_name, data, true) == 0);
+
+    File::DeleteFile(file_name);
+    free(data);
+    audio_stream_lookahead = old_lookahead;
+    psp_audio_multithreaded = old_multithreaded;
+    AssetManager::DestroyInstance();
+}
+
+void Test_Audio()
+{
+    Test_AudioCommandQueue(TEST_AUDIO_OPERATIONS, false);
+    Test_AudioStreamSource();
+}
+
+void Test_AudioBenchmark()
+{
+    Test_AudioCommandQueue(TEST_AUDIO_BENCHMARK_OPERATIONS, true);
+}
+
+#endif // _DEBUG
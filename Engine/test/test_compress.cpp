@@ -0,0 +1,340 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+
+#ifdef _DEBUG
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "debug/assert.h"
+#include "debug/out.h"
+#include "util/compress.h"
+#include "util/file.h"
+#include "util/lz4.h"
+#include "util/stream.h"
+
+using AGS::Common::Stream;
+namespace File = AGS::Common::File;
+namespace Out = AGS::Common::Out;
+
+const int TEST_LINE_LENGTH = 700;
+const int TEST_MAX_PACKED_SIZE = TEST_LINE_LENGTH * 5;
+
+// Legacy encoder, writing one value at a time; the packed data it makes
+// is what all the existing sprite files contain
+template <typename T>
+int Test_LegacyPackLine(const T *line, int size, unsigned char *out)
+{
+    unsigned char *p = out;
+    int cnt = 0;
+    while (cnt < size) {
+        int i = cnt;
+        int j = i + 1;
+        int jmax = i + 126;
+        if (jmax >= size)
+            jmax = size - 1;
+
+        int first, count;
+        if (i == size - 1) {
+            *p++ = 0;
+            first = i;
+            count = 1;
+            cnt++;
+        } else if (line[i] == line[j]) {
+            while ((j < jmax) && (line[j] == line[j + 1]))
+                j++;
+            *p++ = (unsigned char)(i - j);
+            first = i;
+            count = 1;
+            cnt += j - i + 1;
+        } else {
+            while ((j < jmax) && (line[j] != line[j + 1]))
+                j++;
+            *p++ = (unsigned char)(j - i);
+            first = i;
+            count = j - i + 1;
+            cnt += j - i + 1;
+        }
+        for (int n = first; n < first + count; ++n) {
+            for (size_t b = 0; b < sizeof(T); ++b)
+                *p++ = (unsigned char)((line[n] >> (b * 8)) & 0xFF);
+        }
+    }
+    return p - out;
+}
+
+// Makes a line of runs of various length mixed with literal sequences
+template <typename T>
+void Test_MakeLine(T *line, int size, unsigned int seed)
+{
+    srand(seed);
+    int i = 0;
+    while (i < size) {
+        int len = 1 + rand() % 200;
+        T value = (T)(rand() * 2654435761u);
+        bool run = (rand() % 2) == 0;
+        for (int n = 0; n < len && i < size; ++n, ++i)
+            line[i] = run ? value : (T)(value + n * 0x01010101u);
+    }
+}
+
+template <typename T>
+void Test_PackLine(T *line, int size, Stream *out);
+template <> void Test_PackLine(unsigned char *line, int size, Stream *out) { cpackbitl(line, size, out); }
+template <> void Test_PackLine(unsigned short *line, int size, Stream *out) { cpackbitl16(line, size, out); }
+template <> void Test_PackLine(unsigned int *line, int size, Stream *out) { cpackbitl32(line, size, out); }
+
+template <typename T>
+int Test_UnpackLine(T *line, int size, Stream *in);
+template <> int Test_UnpackLine(unsigned char *line, int size, Stream *in) { return cunpackbitl(line, size, in); }
+template <> int Test_UnpackLine(unsigned short *line, int size, Stream *in) { return cunpackbitl16(line, size, in); }
+template <> int Test_UnpackLine(unsigned int *line, int size, Stream *in) { return cunpackbitl32(line, size, in); }
+
+template <typename T>
+int Test_UnpackLine(T *line, int size, const unsigned char *&data, const unsigned char *data_end);
+template <> int Test_UnpackLine(unsigned char *line, int size, const unsigned char *&data, const unsigned char *data_end)
+    { return cunpackbitl(line, size, data, data_end); }
+template <> int Test_UnpackLine(unsigned short *line, int size, const unsigned char *&data, const unsigned char *data_end)
+    { return cunpackbitl16(line, size, data, data_end); }
+template <> int Test_UnpackLine(unsigned int *line, int size, const unsigned char *&data, const unsigned char *data_end)
+    { return cunpackbitl32(line, size, data, data_end); }
+
+template <typename T>
+void Test_CompressLine(int size, unsigned int seed)
+{
+    T line[TEST_LINE_LENGTH];
+    T unpacked[TEST_LINE_LENGTH];
+    unsigned char legacy[TEST_MAX_PACKED_SIZE];
+    unsigned char packed[TEST_MAX_PACKED_SIZE];
+
+    Test_MakeLine(line, size, seed);
+    int legacy_size = Test_LegacyPackLine(line, size, legacy);
+
+    // Encoder must make exactly the same data as before
+    Stream *out = File::OpenFile("test.tmp", AGS::Common::kFile_CreateAlways, AGS::Common::kFile_Write);
+    Test_PackLine(line, size, out);
+    delete out;
+
+    Stream *in = File::OpenFile("test.tmp", AGS::Common::kFile_Open, AGS::Common::kFile_Read);
+    assert((int)in->GetLength() == legacy_size);
+    in->Read(packed, legacy_size);
+    assert(memcmp(packed, legacy, legacy_size) == 0);
+
+    // Both decoders must restore the line, and stop right at its end
+    memset(unpacked, 0, sizeof(unpacked));
+    in->Seek(AGS::Common::kSeekBegin, 0);
+    assert(Test_UnpackLine(unpacked, size, in) == 0);
+    assert((int)in->GetPosition() == legacy_size);
+    assert(memcmp(unpacked, line, size * sizeof(T)) == 0);
+    delete in;
+
+    memset(unpacked, 0, sizeof(unpacked));
+    const unsigned char *data = packed;
+    assert(Test_UnpackLine(unpacked, size, data, packed + legacy_size) == 0);
+    assert(data == packed + legacy_size);
+    assert(memcmp(unpacked, line, size * sizeof(T)) == 0);
+
+    // Truncated data must be reported rather than read past the end
+    if (legacy_size > 1) {
+        data = packed;
+        assert(Test_UnpackLine(unpacked, size, data, packed + legacy_size - 1) == -1);
+    }
+
+    File::DeleteFile("test.tmp");
+}
+
+void Test_CompressLZ4(size_t size, unsigned int seed)
+{
+    unsigned char *block = (unsigned char*)malloc(size + 1);
+    unsigned char *packed = (unsigned char*)malloc(lz4_compress_bound(size));
+    unsigned char *unpacked = (unsigned char*)malloc(size + 1);
+
+    // Mix of runs, repeating patterns and noise
+    srand(seed);
+    for (size_t i = 0; i < size; ) {
+        size_t len = 1 + rand() % 300;
+        int kind = rand() % 3;
+        unsigned char value = (unsigned char)rand();
+        for (size_t n = 0; n < len && i < size; ++n, ++i)
+            block[i] = kind == 0 ? value : kind == 1 ? (unsigned char)(value + n % 7) : (unsigned char)rand();
+    }
+
+    size_t packed_size = lz4_compress(block, size, packed, lz4_compress_bound(size));
+    assert(packed_size > 0);
+    assert(lz4_decompress(packed, packed_size, unpacked, size));
+    assert(memcmp(unpacked, block, size) == 0);
+
+    // Corrupt or truncated data, and wrong expected size, must be reported
+    assert(!lz4_decompress(packed, packed_size - 1, unpacked, size));
+    assert(!lz4_decompress(packed, packed_size, unpacked, size + 1));
+    if (size > 0)
+        assert(!lz4_decompress(packed, packed_size, unpacked, size - 1));
+    // Compression fails rather than overrun the small buffer
+    if (packed_size > 1)
+        assert(lz4_compress(block, size, packed, packed_size - 1) == 0);
+
+    free(block);
+    free(packed);
+    free(unpacked);
+}
+
+void Test_Compress()
+{
+    const int sizes[] = { 1, 2, 3, 126, 127, 128, 129, 320, TEST_LINE_LENGTH };
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+        Test_CompressLine<unsigned char>(sizes[i], i);
+        Test_CompressLine<unsigned short>(sizes[i], i);
+        Test_CompressLine<unsigned int>(sizes[i], i);
+    }
+
+    const size_t block_sizes[] = { 0, 1, 12, 13, 100, 4096, 65536, 200000 };
+    for (size_t i = 0; i < sizeof(block_sizes) / sizeof(block_sizes[0]); ++i)
+        Test_CompressLZ4(block_sizes[i], i);
+}
+
+const int TEST_SPRITE_COUNT = 300;
+const int TEST_SPRITE_MAX_SIZE = 128;
+
+// Colour of the given shade 0-255, and the transparent colour, at each depth
+template <typename T> T Test_SpriteColour(int shade);
+template <> unsigned char Test_SpriteColour(int shade) { return (unsigned char)(16 + shade * 15 / 64); }
+template <> unsigned short Test_SpriteColour(int shade)
+    { return (unsigned short)(((shade >> 3) << 11) | ((shade * 3 / 4 >> 2) << 5) | (shade / 2 >> 3)); }
+template <> unsigned int Test_SpriteColour(int shade)
+    { return 0xFF000000u | (shade << 16) | ((shade * 3 / 4) << 8) | (shade / 2); }
+template <typename T> T Test_MaskColour();
+template <> unsigned char Test_MaskColour() { return 0; }
+template <> unsigned short Test_MaskColour() { return 0xF81F; }
+template <> unsigned int Test_MaskColour() { return 0x00FF00FF; }
+
+// Makes a shaded ellipse with anti-aliased edges on the transparent
+// background, roughly like a character frame
+template <typename T>
+void Test_MakeSprite(T *pixels, int width, int height)
+{
+    const int cx = width / 2, cy = height / 2;
+    const int rx = width / 2 - 1, ry = height / 2 - 1;
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            // distance from the centre, where 256 is on the edge
+            int dx = (x - cx) * 256 / rx;
+            int dy = (y - cy) * 256 / ry;
+            int dist = dx * dx / 256 + dy * dy / 256;
+            int shade = 255 - (x + y) * 192 / (width + height);
+            if (dist > 256)
+                pixels[y * width + x] = Test_MaskColour<T>();
+            else if (dist > 224)
+                pixels[y * width + x] = Test_SpriteColour<T>(shade * (256 - dist) / 32);
+            else
+                pixels[y * width + x] = Test_SpriteColour<T>(shade);
+        }
+    }
+}
+
+// Compares size and decoding speed of the RLE and LZ4 compression on a set
+// of sprites of the given colour depth, decoded from memory
+template <typename T>
+void Test_SpriteCompressionBenchmark(const char *file_name)
+{
+    const int repeats = 20;
+    T *sprites[TEST_SPRITE_COUNT];
+    int widths[TEST_SPRITE_COUNT];
+    int heights[TEST_SPRITE_COUNT];
+    size_t raw_size = 0;
+    for (int i = 0; i < TEST_SPRITE_COUNT; ++i) {
+        widths[i] = 16 + (i * 37) % (TEST_SPRITE_MAX_SIZE - 16);
+        heights[i] = 16 + (i * 53) % (TEST_SPRITE_MAX_SIZE - 16);
+        sprites[i] = new T[widths[i] * heights[i]];
+        Test_MakeSprite(sprites[i], widths[i], heights[i]);
+        raw_size += widths[i] * heights[i] * sizeof(T);
+    }
+    T *unpacked = new T[TEST_SPRITE_MAX_SIZE * TEST_SPRITE_MAX_SIZE];
+
+    // RLE packs each line separately, as the sprite file does
+    Stream *out = File::CreateFile(file_name);
+    for (int i = 0; i < TEST_SPRITE_COUNT; ++i) {
+        for (int y = 0; y < heights[i]; ++y)
+            Test_PackLine(sprites[i] + y * widths[i], widths[i], out);
+    }
+    delete out;
+    Stream *in = File::OpenFileRead(file_name);
+    size_t rle_size = in->GetLength();
+    unsigned char *rle_data = (unsigned char*)malloc(rle_size);
+    in->Read(rle_data, rle_size);
+    delete in;
+    File::DeleteFile(file_name);
+
+    // the first, untimed pass checks the decoded sprites
+    clock_t start = 0;
+    for (int r = 0; r <= repeats; ++r) {
+        if (r == 1)
+            start = clock();
+        const unsigned char *data = rle_data;
+        for (int i = 0; i < TEST_SPRITE_COUNT; ++i) {
+            for (int y = 0; y < heights[i]; ++y)
+                assert(Test_UnpackLine(unpacked + y * widths[i], widths[i], data, rle_data + rle_size) == 0);
+            if (r == 0)
+                assert(memcmp(unpacked, sprites[i], widths[i] * heights[i] * sizeof(T)) == 0);
+        }
+    }
+    clock_t rle_time = clock() - start;
+
+    // LZ4 compresses each sprite as one block
+    unsigned char *lz4_data[TEST_SPRITE_COUNT];
+    size_t lz4_sizes[TEST_SPRITE_COUNT];
+    size_t lz4_size = 0;
+    for (int i = 0; i < TEST_SPRITE_COUNT; ++i) {
+        size_t sprite_size = widths[i] * heights[i] * sizeof(T);
+        size_t bound = lz4_compress_bound(sprite_size);
+        lz4_data[i] = (unsigned char*)malloc(bound);
+        lz4_sizes[i] = lz4_compress((const unsigned char*)sprites[i], sprite_size, lz4_data[i], bound);
+        assert(lz4_sizes[i] > 0);
+        lz4_size += lz4_sizes[i];
+    }
+
+    for (int r = 0; r <= repeats; ++r) {
+        if (r == 1)
+            start = clock();
+        for (int i = 0; i < TEST_SPRITE_COUNT; ++i) {
+            assert(lz4_decompress(lz4_data[i], lz4_sizes[i], (unsigned char*)unpacked,
+                widths[i] * heights[i] * sizeof(T)));
+            if (r == 0)
+                assert(memcmp(unpacked, sprites[i], widths[i] * heights[i] * sizeof(T)) == 0);
+        }
+    }
+    clock_t lz4_time = clock() - start;
+
+    // megabytes of decoded pixels per second
+    double decoded_mb = (double)raw_size * repeats / (1024 * 1024);
+    Out::FPrint("SpriteCompression: %d-bit, %d sprites of %d KB: RLE %d KB at %d MB/s, LZ4 %d KB at %d MB/s",
+        (int)sizeof(T) * 8, TEST_SPRITE_COUNT, (int)(raw_size / 1024),
+        (int)(rle_size / 1024), (int)(decoded_mb * CLOCKS_PER_SEC / (rle_time > 0 ? rle_time : 1)),
+        (int)(lz4_size / 1024), (int)(decoded_mb * CLOCKS_PER_SEC / (lz4_time > 0 ? lz4_time : 1)));
+
+    for (int i = 0; i < TEST_SPRITE_COUNT; ++i) {
+        delete [] sprites[i];
+        free(lz4_data[i]);
+    }
+    delete [] unpacked;
+    free(rle_data);
+}
+
+void Test_SpriteCompressionBenchmark()
+{
+    Test_SpriteCompressionBenchmark<unsigned char>("test.tmp");
+    Test_SpriteCompressionBenchmark<unsigned short>("test.tmp");
+    Test_SpriteCompressionBenchmark<unsigned int>("test.tmp");
+}
+
+#endif // _DEBUG
@@ -16,14 +16,22 @@
 
 #include <stdio.h>
 #include <string.h>
+#include <time.h>
 #include "util/alignedstream.h"
+#include "util/bbop.h"
+#include "util/bufferedstream.h"
+#include "util/filemapping.h"
 #include "util/filestream.h"
 #include "debug/assert.h"
+#include "debug/out.h"
 
 using AGS::Common::String;
 using AGS::Common::Stream;
 using AGS::Common::AlignedStream;
+using AGS::Common::BufferedStream;
 namespace File = AGS::Common::File;
+namespace Out = AGS::Common::Out;
+namespace BBOp = AGS::Common::BBOp;
 
 struct TTrickyAlignedData
 {
@@ -173,6 +181,23 @@ void Test_File()
 
     delete in;
 
+    //-----------------------------------------------------
+    // Mapping a section which does not start at page boundary
+    bool mapped_ok = true;
+    int64_t mapped_int64val = 0;
+    in = File::OpenFile("test.tmp", AGS::Common::kFile_Open, AGS::Common::kFile_Read);
+    {
+        AGS::Common::FileMapping mapping;
+        if (mapping.Map(((AGS::Common::FileStream*)in)->GetHandle(), sizeof(int16_t), sizeof(int64_t)))
+        {
+            memcpy(&mapped_int64val, mapping.GetData(), sizeof(int64_t));
+            mapped_ok = mapping.GetSize() == sizeof(int64_t);
+        }
+        // section beyond the end of file cannot be mapped
+        mapped_ok &= !mapping.Map(((AGS::Common::FileStream*)in)->GetHandle(), in->GetLength(), 1);
+    }
+    delete in;
+
     File::DeleteFile("test.tmp");
 
     //-----------------------------------------------------
@@ -189,7 +214,132 @@ void Test_File()
     assert(ptr32_array_in[2] == 0xFEEDBEEF);
     assert(ptr32_array_in[3] == 0xBEEFFEED);
 
+#if !defined (AGS_NO_FILE_MAPPING) && !defined (AGS_BIG_ENDIAN)
+    assert(mapped_ok);
+    assert(mapped_int64val == -20202);
+#endif
+
+    assert(!File::TestReadFile("test.tmp"));
+}
+
+void Test_BufferedStream()
+{
+    //-----------------------------------------------------
+    // Buffer smaller than some of the values, to test reading across blocks
+    Stream *out = new BufferedStream("test.tmp", AGS::Common::kFile_CreateAlways, AGS::Common::kFile_Write,
+        AGS::Common::kLittleEndian, 7);
+    int32_t int32_array_out[100];
+    for (int i = 0; i < 100; ++i)
+        int32_array_out[i] = i * 1000003;
+    out->WriteInt16(10);
+    out->WriteInt64(-20202);
+    out->WriteByte(0xAB);
+    out->WriteArrayOfInt32(int32_array_out, 100);
+    out->WriteInt32(20);
+    // overwrite a value written before
+    out->Seek(AGS::Common::kSeekBegin, 0);
+    out->WriteInt16(11);
+    out->Seek(AGS::Common::kSeekEnd, 0);
+    out->WriteInt8(5);
+    size_t length_written = out->GetLength();
+    delete out;
+
+    Stream *in = new BufferedStream("test.tmp", AGS::Common::kFile_Open, AGS::Common::kFile_Read,
+        AGS::Common::kLittleEndian, 5);
+    size_t length_read = in->GetLength();
+    int16_t int16val = in->ReadInt16();
+    int64_t int64val = in->ReadInt64();
+    int32_t byteval = in->ReadByte();
+    int32_t int32_array_in[100];
+    in->ReadArrayOfInt32(int32_array_in, 100);
+    int32_t int32val = in->ReadInt32();
+    int8_t int8val = in->ReadInt8();
+    bool eos_at_end = in->EOS() || in->ReadByte() == -1;
+    bool eos_after_end = in->EOS();
+    // seek back into the buffer, and before it
+    in->Seek(AGS::Common::kSeekCurrent, -5);
+    int32_t int32val_again = in->ReadInt32();
+    in->Seek(AGS::Common::kSeekBegin, sizeof(int16_t));
+    int64_t int64val_again = in->ReadInt64();
+    size_t pos_after_seek = in->GetPosition();
+    delete in;
+
+    //-----------------------------------------------------
+    // Byte swapping of arrays
+    int16_t int16_swap[3] = { 0x0102, (int16_t)0xFF00, 0x7F80 };
+    int32_t int32_swap[3] = { 0x01020304, (int32_t)0xFF000080, 0x7F00FF01 };
+    int64_t int64_swap[2] = { 0x0102030405060708LL, (int64_t)0xFF00000000000080LL };
+    BBOp::SwapBytesArrayOfInt16(int16_swap, 3);
+    BBOp::SwapBytesArrayOfInt32(int32_swap, 3);
+    BBOp::SwapBytesArrayOfInt64(int64_swap, 2);
+
+    //-----------------------------------------------------
+    // Reading a file larger than the default buffer one value at a time
+    const int num_values = 10000;
+    out = File::CreateFile("test.tmp");
+    for (int i = 0; i < num_values; ++i)
+        out->WriteInt32(i);
+    delete out;
+
+    in = File::OpenFileBuffered("test.tmp", AGS::Common::kFile_Open, AGS::Common::kFile_Read);
+    bool buffered_ok = true;
+    for (int i = 0; i < num_values; ++i)
+        buffered_ok &= in->ReadInt32() == i;
+    buffered_ok &= in->EOS() || in->ReadByte() == -1;
+    delete in;
+
+    File::DeleteFile("test.tmp");
+
+    //-----------------------------------------------------
+    // Assertions
+    assert(length_written == sizeof(int16_t) + sizeof(int64_t) + 1 + sizeof(int32_array_out) + sizeof(int32_t) + 1);
+    assert(length_read == length_written);
+    assert(int16val == 11);
+    assert(int64val == -20202);
+    assert(byteval == 0xAB);
+    assert(memcmp(int32_array_in, int32_array_out, sizeof(int32_array_in)) == 0);
+    assert(int32val == 20);
+    assert(int8val == 5);
+    assert(eos_at_end);
+    assert(eos_after_end);
+    assert(int32val_again == 20);
+    assert(int64val_again == -20202);
+    assert(pos_after_seek == sizeof(int16_t) + sizeof(int64_t));
+
+    assert(int16_swap[0] == 0x0201 && int16_swap[1] == 0x00FF && int16_swap[2] == (int16_t)0x807F);
+    assert(int32_swap[0] == 0x04030201 && int32_swap[1] == (int32_t)0x800000FF && int32_swap[2] == 0x01FF007F);
+    assert(int64_swap[0] == 0x0807060504030201LL && int64_swap[1] == (int64_t)0x80000000000000FFLL);
+
+    assert(buffered_ok);
     assert(!File::TestReadFile("test.tmp"));
 }
 
+void Test_BufferedStreamBenchmark()
+{
+    // Reading a file one value at a time, directly and through the buffer
+    const int num_values = 1000000;
+    Stream *out = File::CreateFile("test.tmp");
+    for (int i = 0; i < num_values; ++i)
+        out->WriteInt32(i);
+    delete out;
+
+    clock_t start = clock();
+    Stream *in = File::OpenFileRead("test.tmp");
+    for (int i = 0; i < num_values; ++i)
+        in->ReadInt32();
+    delete in;
+    clock_t direct_time = clock() - start;
+
+    start = clock();
+    in = File::OpenFileBuffered("test.tmp", AGS::Common::kFile_Open, AGS::Common::kFile_Read);
+    for (int i = 0; i < num_values; ++i)
+        in->ReadInt32();
+    delete in;
+    clock_t buffered_time = clock() - start;
+    Out::FPrint("BufferedStream: reading %d values took %d ms, unbuffered %d ms", num_values,
+        (int)(buffered_time * 1000 / CLOCKS_PER_SEC), (int)(direct_time * 1000 / CLOCKS_PER_SEC));
+
+    File::DeleteFile("test.tmp");
+}
+
 #endif // _DEBUG
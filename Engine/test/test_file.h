@@ -15,5 +15,7 @@
 #ifdef _DEBUG
 
 void Test_File();
+void Test_BufferedStream();
+void Test_BufferedStreamBenchmark();
 
 #endif // _DEBUG
@@ -0,0 +1,364 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+
+#ifdef _DEBUG
+
+#ifndef USE_ALFONT
+#define USE_ALFONT
+#endif
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "util/wgt2allg.h"
+#include "alfont.h"
+#include "ac/gamesetupstruct.h"
+#include "core/assetmanager.h"
+#include "debug/assert.h"
+#include "debug/out.h"
+#include "font/agsfontrenderer.h"
+#include "font/fonts.h"
+#include "font/glyphcache.h"
+#include "font/wfnfont.h"
+#include "gfx/bitmap.h"
+#include "util/directory.h"
+#include "util/file.h"
+#include "util/stream.h"
+
+using AGS::Common::AssetManager;
+using AGS::Common::Bitmap;
+using AGS::Common::Stream;
+using AGS::Common::String;
+namespace BitmapHelper = AGS::Common::BitmapHelper;
+namespace Directory = AGS::Common::Directory;
+namespace File = AGS::Common::File;
+namespace Out = AGS::Common::Out;
+
+extern GameSetupStruct game;
+extern ALFONT_FONT *get_ttf_block(IFont *fontptr);
+
+const int TEST_FONT = MAX_FONTS - 1;
+const int TEST_WFN_CHAR_COUNT = 128;
+const int TEST_WFN_CHAR_HEIGHT = 11;
+const int TEST_TEXT_REPEATS = 20000;
+const char *TEST_TEXT = "The quick brown fox jumps over the lazy dog 0123456789!";
+
+// Writes a font with random pixels and widths, so that every kind of run
+// and gap is met
+void Test_WriteWFNFont(const char *file_name)
+{
+    Stream *out = File::OpenFile(file_name, AGS::Common::kFile_CreateAlways, AGS::Common::kFile_Write);
+    out->Write("WGT Font File  ", 15);
+    int offsets[TEST_WFN_CHAR_COUNT];
+    int data_size = 0;
+    int widths[TEST_WFN_CHAR_COUNT];
+    for (int i = 0; i < TEST_WFN_CHAR_COUNT; ++i)
+    {
+        widths[i] = 1 + rand() % 19;
+        offsets[i] = 15 + sizeof(int16_t) + data_size;
+        data_size += sizeof(int16_t) * 2 + ((widths[i] - 1) / 8 + 1) * TEST_WFN_CHAR_HEIGHT;
+    }
+    out->WriteInt16(15 + sizeof(int16_t) + data_size);
+    for (int i = 0; i < TEST_WFN_CHAR_COUNT; ++i)
+    {
+        out->WriteInt16(widths[i]);
+        out->WriteInt16(TEST_WFN_CHAR_HEIGHT);
+        for (int j = 0; j < ((widths[i] - 1) / 8 + 1) * TEST_WFN_CHAR_HEIGHT; ++j)
+            out->WriteInt8(rand() & 0xFF);
+    }
+    for (int i = 0; i < TEST_WFN_CHAR_COUNT; ++i)
+        out->WriteInt16(offsets[i]);
+    delete out;
+}
+
+// Draws the text one pixel at a time, the way WFN renderer used to
+void Test_RenderWFNText(Bitmap *ds, int x, int y, color_t color, const char *text, const WFNFont &font)
+{
+    for (; *text; ++text)
+    {
+        const WFNFont::WFNChar &wfn_char = font.GetChar((unsigned char)*text);
+        for (int h = 0; h < wfn_char.Height; ++h)
+        {
+            for (int w = 0; w < wfn_char.Width; ++w)
+            {
+                if ((wfn_char.Data[h * wfn_char.GetRowByteCount() + w / 8] & (0x80 >> (w % 8))) == 0)
+                    continue;
+                if (wtext_multiply > 1)
+                    ds->FillRect(RectWH(x + w * wtext_multiply, y + h * wtext_multiply,
+                        wtext_multiply, wtext_multiply), color);
+                else
+                    ds->PutPixel(x + w, y + h, color);
+            }
+        }
+        x += wfn_char.Width * wtext_multiply;
+    }
+}
+
+bool Test_SameBitmaps(Bitmap *a, Bitmap *b)
+{
+    for (int y = 0; y < a->GetHeight(); ++y)
+    {
+        if (memcmp(a->GetScanLine(y), b->GetScanLine(y), a->GetWidth() * a->GetBPP()) != 0)
+            return false;
+    }
+    return true;
+}
+
+int Test_ElapsedMs(clock_t start)
+{
+    return (int)((clock() - start) * 1000 / CLOCKS_PER_SEC);
+}
+
+const int TEST_WFN_WIDTH = 2200;
+const int TEST_WFN_HEIGHT = 40;
+const color_t TEST_TEXT_COLOR = 0x00C08040;
+
+// Writes the test font, loads it into the test slot and reads it as well
+// for the reference renderer
+void Test_LoadWFNFont(WFNFont &font)
+{
+    String file_name = String::FromFormat("agsfnt%d.wfn", TEST_FONT);
+    Test_WriteWFNFont(file_name);
+    bool loaded = wloadfont_size(TEST_FONT, 0);
+    assert(loaded);
+    Stream *in = File::OpenFileRead(file_name);
+    loaded = font.ReadFromFile(in);
+    assert(loaded);
+    delete in;
+}
+
+void Test_FreeTestFont(const char *extension)
+{
+    wfreefont(TEST_FONT);
+    File::DeleteFile(String::FromFormat("agsfnt%d.%s", TEST_FONT, extension));
+}
+
+void Test_WFNTextRendering()
+{
+    WFNFont font;
+    Test_LoadWFNFont(font);
+
+    Bitmap *expect = BitmapHelper::CreateBitmap(TEST_WFN_WIDTH, TEST_WFN_HEIGHT, 32);
+    Bitmap *result = BitmapHelper::CreateBitmap(TEST_WFN_WIDTH, TEST_WFN_HEIGHT, 32);
+    for (wtext_multiply = 1; wtext_multiply <= 2; ++wtext_multiply)
+    {
+        expect->Clear(0x00204060);
+        Test_RenderWFNText(expect, 3, 2, TEST_TEXT_COLOR, TEST_TEXT, font);
+        // the first time characters are rasterised, then taken from cache
+        for (int i = 0; i < 2; ++i)
+        {
+            result->Clear(0x00204060);
+            wouttextxy(result, 3, 2, TEST_FONT, TEST_TEXT_COLOR, TEST_TEXT);
+            assert(Test_SameBitmaps(expect, result));
+        }
+        // characters dropped for lack of space are drawn all the same
+        set_glyph_cache_size(1024);
+        result->Clear(0x00204060);
+        wouttextxy(result, 3, 2, TEST_FONT, TEST_TEXT_COLOR, TEST_TEXT);
+        assert(Test_SameBitmaps(expect, result));
+        set_glyph_cache_size(1024 * 1024);
+    }
+    wtext_multiply = 1;
+
+    delete expect;
+    delete result;
+    Test_FreeTestFont("wfn");
+}
+
+void Test_WFNTextBenchmark()
+{
+    WFNFont font;
+    Test_LoadWFNFont(font);
+    Bitmap *ds = BitmapHelper::CreateBitmap(TEST_WFN_WIDTH, TEST_WFN_HEIGHT, 32);
+
+    clock_t start = clock();
+    for (int i = 0; i < TEST_TEXT_REPEATS; ++i)
+        Test_RenderWFNText(ds, 3, 2, TEST_TEXT_COLOR, TEST_TEXT, font);
+    int pixel_ms = Test_ElapsedMs(start);
+    start = clock();
+    for (int i = 0; i < TEST_TEXT_REPEATS; ++i)
+        wouttextxy(ds, 3, 2, TEST_FONT, TEST_TEXT_COLOR, TEST_TEXT);
+    Out::FPrint("WFN text: %d lines took %d ms with pixel plotting, %d ms from glyph cache",
+        TEST_TEXT_REPEATS, pixel_ms, Test_ElapsedMs(start));
+
+    delete ds;
+    Test_FreeTestFont("wfn");
+}
+
+// Copies the first TrueType font found among the system ones; there is none
+// that could be shipped with the tests
+bool Test_CopyTTFFont(const char *file_name)
+{
+    const char *system_fonts[] = {
+        "C:\\Windows\\Fonts\\arial.ttf",
+        "/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf",
+        "/Library/Fonts/Arial.ttf"
+    };
+    for (size_t i = 0; i < sizeof(system_fonts) / sizeof(system_fonts[0]); ++i)
+    {
+        Stream *in = File::OpenFileRead(system_fonts[i]);
+        if (!in)
+            continue;
+        size_t size = in->GetLength();
+        char *data = new char[size];
+        in->Read(data, size);
+        delete in;
+        Stream *out = File::OpenFile(file_name, AGS::Common::kFile_CreateAlways, AGS::Common::kFile_Write);
+        out->Write(data, size);
+        delete out;
+        delete [] data;
+        return true;
+    }
+    return false;
+}
+
+const int TEST_TTF_WIDTH = 600;
+const int TEST_TTF_HEIGHT = 40;
+
+// Draws the text straight through alfont, as the glyph cache should
+void Test_RenderTTFText(Bitmap *ds, const char *text, bool antialias)
+{
+    ALFONT_FONT *alfpt = get_ttf_block(fonts[TEST_FONT]);
+    // the renderer draws one pixel higher than asked
+    if (antialias)
+        alfont_textout_aa((BITMAP*)ds->GetAllegroBitmap(), alfpt, text, 3, 1, TEST_TEXT_COLOR);
+    else
+        alfont_textout((BITMAP*)ds->GetAllegroBitmap(), alfpt, text, 3, 1, TEST_TEXT_COLOR);
+}
+
+bool Test_LoadTTFFont()
+{
+    if (!Test_CopyTTFFont(String::FromFormat("agsfnt%d.ttf", TEST_FONT)))
+    {
+        Out::FPrint("TTF text: no system font found, skipped");
+        return false;
+    }
+    bool loaded = wloadfont_size(TEST_FONT, 14);
+    assert(loaded);
+    return true;
+}
+
+void Test_TTFTextRendering()
+{
+    if (!Test_LoadTTFFont())
+        return;
+
+    Bitmap *expect = BitmapHelper::CreateBitmap(TEST_TTF_WIDTH, TEST_TTF_HEIGHT, 32);
+    Bitmap *result = BitmapHelper::CreateBitmap(TEST_TTF_WIDTH, TEST_TTF_HEIGHT, 32);
+    int old_antialias = game.options[OPT_ANTIALIASFONTS];
+    for (int antialias = 0; antialias < 2; ++antialias)
+    {
+        game.options[OPT_ANTIALIASFONTS] = antialias;
+        expect->Clear(0x00204060);
+        Test_RenderTTFText(expect, TEST_TEXT, antialias != 0);
+        for (int i = 0; i < 2; ++i)
+        {
+            result->Clear(0x00204060);
+            wouttextxy(result, 3, 2, TEST_FONT, TEST_TEXT_COLOR, TEST_TEXT);
+            assert(Test_SameBitmaps(expect, result));
+        }
+    }
+    game.options[OPT_ANTIALIASFONTS] = old_antialias;
+
+    delete expect;
+    delete result;
+    Test_FreeTestFont("ttf");
+}
+
+void Test_TTFTextBenchmark()
+{
+    if (!Test_LoadTTFFont())
+        return;
+
+    Bitmap *ds = BitmapHelper::CreateBitmap(TEST_TTF_WIDTH, TEST_TTF_HEIGHT, 32);
+    int old_antialias = game.options[OPT_ANTIALIASFONTS];
+    for (int antialias = 0; antialias < 2; ++antialias)
+    {
+        game.options[OPT_ANTIALIASFONTS] = antialias;
+        clock_t start = clock();
+        for (int i = 0; i < TEST_TEXT_REPEATS; ++i)
+            Test_RenderTTFText(ds, TEST_TEXT, antialias != 0);
+        int alfont_ms = Test_ElapsedMs(start);
+        start = clock();
+        for (int i = 0; i < TEST_TEXT_REPEATS; ++i)
+            wouttextxy(ds, 3, 2, TEST_FONT, TEST_TEXT_COLOR, TEST_TEXT);
+        Out::FPrint("TTF text%s: %d lines took %d ms through alfont, %d ms from glyph cache",
+            antialias ? " (anti-aliased)" : "", TEST_TEXT_REPEATS, alfont_ms, Test_ElapsedMs(start));
+    }
+    game.options[OPT_ANTIALIASFONTS] = old_antialias;
+
+    delete ds;
+    Test_FreeTestFont("ttf");
+}
+
+String test_font_old_directory;
+
+// Directory to write the test fonts to, so that the game's own stay intact
+String Test_GetTempDirectory()
+{
+    const char *env_vars[] = { "TMPDIR", "TEMP", "TMP" };
+    for (size_t i = 0; i < sizeof(env_vars) / sizeof(env_vars[0]); ++i)
+    {
+        const char *dir = getenv(env_vars[i]);
+        if (dir && dir[0])
+            return dir;
+    }
+    return "/tmp";
+}
+
+// Fonts are rendered through Allegro, which is not installed before the
+// engine starts; the fonts are loaded from the temporary directory
+bool Test_FontStartup()
+{
+    if (install_allegro(SYSTEM_NONE, &errno, atexit) != 0)
+    {
+        Out::FPrint("Font tests: could not install allegro, skipped");
+        return false;
+    }
+    test_font_old_directory = Directory::GetCurrentDirectory();
+    Directory::SetCurrentDirectory(Test_GetTempDirectory());
+    AssetManager::CreateInstance();
+    AssetManager::SetSearchPriority(AGS::Common::kAssetPriorityDir);
+    init_font_renderer();
+    return true;
+}
+
+void Test_FontShutdown()
+{
+    shutdown_font_renderer();
+    AssetManager::DestroyInstance();
+    Directory::SetCurrentDirectory(test_font_old_directory);
+    allegro_exit();
+}
+
+void Test_Font()
+{
+    if (!Test_FontStartup())
+        return;
+    Test_WFNTextRendering();
+    Test_TTFTextRendering();
+    Test_FontShutdown();
+}
+
+void Test_FontBenchmark()
+{
+    if (!Test_FontStartup())
+        return;
+    Test_WFNTextBenchmark();
+    Test_TTFTextBenchmark();
+    Test_FontShutdown();
+}
+
+#endif // _DEBUG
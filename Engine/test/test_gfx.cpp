@@ -14,10 +14,231 @@
 
 #ifdef _DEBUG
 
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "util/wgt2allg.h"
+#include "gfx/blender.h"
+#include "gfx/blendspan.h"
 #include "gfx/gfx_util.h"
+#include "gfx/gfxfilterbands.h"
+#if !defined(ANDROID_VERSION) && !defined(PSP_VERSION)
+#include "gfx/hq2x3x.h"
+#endif
 #include "debug/assert.h"
+#include "debug/out.h"
 
 namespace GfxUtil = AGS::Engine::GfxUtil;
+namespace BlendSpan = AGS::Common::BlendSpan;
+namespace FilterBands = AGS::Engine::FilterBands;
+namespace Out = AGS::Common::Out;
+
+extern "C" {
+    unsigned long _blender_trans24(unsigned long x, unsigned long y, unsigned long n);
+    unsigned long _blender_alpha32(unsigned long x, unsigned long y, unsigned long n);
+}
+
+// odd, so that the lines do not split evenly among the SIMD lanes
+const int TEST_SPAN_LENGTH = 259;
+
+void Test_FillBlendLine(uint32_t *line, int count)
+{
+    // every alpha and channel value is met, along with the mask colour
+    for (int i = 0; i < count; ++i)
+        line[i] = ((rand() & 0xFFFF) << 16) | (rand() & 0xFFFF);
+    line[0] = MASK_COLOR_32;
+    line[1] = 0x00000000;
+    line[2] = 0xFFFFFFFF;
+    line[3] = 0x00FFFFFF;
+    line[4] = 0xFF000000;
+}
+
+// Checks that the line blender gives the same result as its pixel blender
+void Test_BlendSpan(BLENDER_FUNC blender, const int *params, int param_count, bool opaque_dst = false)
+{
+    AGS::Common::TRANS_SPAN_FUNC trans_span = BlendSpan::GetTransSpan(blender);
+    AGS::Common::LIT_SPAN_FUNC lit_span = BlendSpan::GetLitSpan(blender);
+    assert(trans_span || lit_span);
+
+    uint32_t src[TEST_SPAN_LENGTH];
+    uint32_t dst[TEST_SPAN_LENGTH];
+    uint32_t res[TEST_SPAN_LENGTH];
+    for (int p = 0; p < param_count; ++p)
+    {
+        Test_FillBlendLine(src, TEST_SPAN_LENGTH);
+        Test_FillBlendLine(dst, TEST_SPAN_LENGTH);
+        if (opaque_dst)
+        {
+            for (int i = 0; i < TEST_SPAN_LENGTH; ++i)
+                dst[i] |= 0x01000000;
+        }
+        if (trans_span)
+        {
+            memcpy(res, dst, sizeof(res));
+            trans_span(res, src, TEST_SPAN_LENGTH, params[p]);
+            for (int i = 0; i < TEST_SPAN_LENGTH; ++i)
+            {
+                uint32_t expect = src[i] == MASK_COLOR_32 ? dst[i] : (uint32_t)blender(src[i], dst[i], params[p]);
+                assert(res[i] == expect);
+            }
+        }
+        if (lit_span)
+        {
+            int color = dst[TEST_SPAN_LENGTH - 1] & 0xFFFFFF;
+            memcpy(res, dst, sizeof(res));
+            lit_span(res, src, TEST_SPAN_LENGTH, color, params[p]);
+            for (int i = 0; i < TEST_SPAN_LENGTH; ++i)
+            {
+                uint32_t expect = src[i] == MASK_COLOR_32 ? dst[i] : (uint32_t)blender(color, src[i], params[p]);
+                assert(res[i] == expect);
+            }
+        }
+    }
+}
+
+void Test_BlendSpans()
+{
+    const int params[] = {0, 1, 2, 63, 127, 128, 200, 254, 255};
+    const int param_count = sizeof(params) / sizeof(params[0]);
+
+    // the check for SIMD support is done by Allegro on init
+    check_cpu();
+    for (int simd = 0; simd < 2; ++simd)
+    {
+        init_span_blenders(simd != 0);
+        Test_BlendSpan(_blender_trans24, params, param_count);
+        Test_BlendSpan(_blender_alpha32, params, param_count);
+        Test_BlendSpan(_myblender_alpha_trans24, params, param_count);
+        Test_BlendSpan(_trans_alpha_blender32, params, param_count);
+        // it divides by the resulting alpha, which must not be zero
+        Test_BlendSpan(_argb2argb_alpha_blender, params, param_count, true);
+        Test_BlendSpan(_additive_alpha_copysrc_blender, params, param_count);
+        Test_BlendSpan(_opaque_alpha_blender, params, param_count);
+        Test_BlendSpan(_myblender_color32, params, param_count);
+        Test_BlendSpan(_myblender_color32_light, params, param_count);
+    }
+    // they are registered again once the pixel format is known
+    BlendSpan::UnregisterAll();
+}
+
+#if !defined(ANDROID_VERSION) && !defined(PSP_VERSION)
+
+const int TEST_FRAME_WIDTH = 67;
+const int TEST_FRAME_HEIGHT = 53;
+
+struct TestFilterFrame
+{
+    void (*filter)(unsigned char*, unsigned char*, int, int, int, int, int);
+    unsigned char *in;
+    unsigned char *out;
+    int width;
+    int height;
+    int multiplier;
+};
+
+void Test_FilterBand(void *data, int y_start, int y_end)
+{
+    TestFilterFrame *frame = (TestFilterFrame*)data;
+    frame->filter(frame->in, frame->out, frame->width, frame->height,
+        frame->width * frame->multiplier * 4, y_start, y_end);
+}
+
+// Fills the frame with a few colours only, so that the filters find edges
+// to smooth
+void Test_MakeFilterFrame(uint32_t *in, int size)
+{
+    const uint32_t colors[] = { 0x000000, 0xFFFFFF, 0xFF0000, 0x00FF00, 0x0000FF, 0x808080 };
+    for (int i = 0; i < size; ++i)
+        in[i] = colors[rand() % (sizeof(colors) / sizeof(colors[0]))];
+}
+
+// Checks that a frame filtered in bands is the same as one filtered whole
+void Test_FilterBands()
+{
+    InitLUTs();
+    uint32_t *in = new uint32_t[TEST_FRAME_WIDTH * TEST_FRAME_HEIGHT];
+    Test_MakeFilterFrame(in, TEST_FRAME_WIDTH * TEST_FRAME_HEIGHT);
+
+    const int out_size = TEST_FRAME_WIDTH * TEST_FRAME_HEIGHT * 3 * 3;
+    uint32_t *whole_out = new uint32_t[out_size];
+    uint32_t *band_out = new uint32_t[out_size];
+    for (int workers = 0; workers <= 3; ++workers)
+    {
+        FilterBands::Init(workers);
+        for (int multiplier = 2; multiplier <= 3; ++multiplier)
+        {
+            memset(whole_out, 0, out_size * sizeof(uint32_t));
+            memset(band_out, 0, out_size * sizeof(uint32_t));
+            TestFilterFrame frame;
+            frame.filter = multiplier == 2 ? hq2x_32_rows : hq3x_32_rows;
+            frame.in = (unsigned char*)in;
+            frame.out = (unsigned char*)whole_out;
+            frame.width = TEST_FRAME_WIDTH;
+            frame.height = TEST_FRAME_HEIGHT;
+            frame.multiplier = multiplier;
+            Test_FilterBand(&frame, 0, TEST_FRAME_HEIGHT);
+            frame.out = (unsigned char*)band_out;
+            FilterBands::Run(Test_FilterBand, &frame, TEST_FRAME_HEIGHT);
+            assert(memcmp(whole_out, band_out, out_size * sizeof(uint32_t)) == 0);
+        }
+    }
+    FilterBands::Shutdown();
+    delete [] in;
+    delete [] whole_out;
+    delete [] band_out;
+}
+
+// Measures how fast the hq filters go on one thread and in bands on
+// several; the nearest-neighbour scaling filters stretch straight onto
+// the screen through allegro, and are not split into bands
+void Test_FilterBenchmark()
+{
+    const int width = 640;
+    const int height = 400;
+    // the frames are counted over whole seconds, as clock() adds up the
+    // time of all the threads
+    const int seconds = 2;
+    InitLUTs();
+    uint32_t *in = new uint32_t[width * height];
+    Test_MakeFilterFrame(in, width * height);
+    uint32_t *out = new uint32_t[width * height * 3 * 3];
+    const double frame_mb = (double)width * height * sizeof(uint32_t) / (1024 * 1024);
+
+    const int worker_counts[] = { 0, 1, 3 };
+    for (int multiplier = 2; multiplier <= 3; ++multiplier)
+    {
+        for (size_t w = 0; w < sizeof(worker_counts) / sizeof(worker_counts[0]); ++w)
+        {
+            FilterBands::Init(worker_counts[w]);
+            TestFilterFrame frame;
+            frame.filter = multiplier == 2 ? hq2x_32_rows : hq3x_32_rows;
+            frame.in = (unsigned char*)in;
+            frame.out = (unsigned char*)out;
+            frame.width = width;
+            frame.height = height;
+            frame.multiplier = multiplier;
+
+            time_t start = time(NULL);
+            while (time(NULL) == start);
+            start = time(NULL);
+            int frames = 0;
+            for (; time(NULL) - start < seconds; ++frames)
+            {
+                if (worker_counts[w] == 0)
+                    Test_FilterBand(&frame, 0, height);
+                else
+                    FilterBands::Run(Test_FilterBand, &frame, height);
+            }
+            Out::FPrint("Filters: hq%dx on %dx%d, %d worker threads: %d MB/s", multiplier, width, height,
+                worker_counts[w], (int)(frames * frame_mb / seconds));
+        }
+    }
+    FilterBands::Shutdown();
+    delete [] in;
+    delete [] out;
+}
+
+#endif // !ANDROID_VERSION && !PSP_VERSION
 
 void Test_Gfx()
 {
@@ -34,6 +255,11 @@ void Test_Gfx()
         trans100_back[i] = GfxUtil::LegacyTrans255ToTrans100(trans255[i]);
         assert(trans100[i] == trans100_back[i]);
     }
+
+    Test_BlendSpans();
+#if !defined(ANDROID_VERSION) && !defined(PSP_VERSION)
+    Test_FilterBands();
+#endif
 }
 
 #endif // _DEBUG
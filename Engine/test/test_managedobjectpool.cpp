@@ -0,0 +1,227 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+
+#ifdef _DEBUG
+
+#include <time.h>
+#include "ac/dynobj/cc_agsdynamicobject.h"
+#include "ac/dynobj/managedobjectpool.h"
+#include "debug/assert.h"
+#include "debug/out.h"
+
+namespace Out = AGS::Common::Out;
+
+// Object manager which counts disposed objects
+struct TestDisposableObject : AGSCCDynamicObject {
+    int Disposed;
+
+    TestDisposableObject() : Disposed(0) {}
+    virtual int Dispose(const char *address, bool force) { Disposed++; return 1; }
+    virtual const char *GetType() { return "TestDisposable"; }
+    virtual int Serialize(const char *address, char *buffer, int bufsize) { return 0; }
+    virtual void Unserialize(int index, const char *serializedData, int dataSize) {}
+};
+
+void Test_ManagedObjectPoolIncrementalGC()
+{
+    ManagedObjectPool test_pool;
+    TestDisposableObject manager;
+    const int num_objects = 1000;
+    char data[num_objects];
+    int32_t handles[num_objects];
+
+    // A new object is not collected until enough objects were created, as
+    // the script which has created it may not have stored it yet
+    test_pool.SetGarbageCollectionBudget(100);
+    char fresh;
+    test_pool.AddObject(&fresh, &manager, false);
+    test_pool.RunGarbageCollectionIfAppropriate();
+    assert(manager.Disposed == 0);
+    test_pool.RemoveObject(&fresh);
+    manager.Disposed = 0;
+
+    // Referenced objects survive, unreferenced ones are disposed no more
+    // than budget allows per tick; budget counts every checked candidate
+    for (int i = 0; i < num_objects; ++i)
+    {
+        handles[i] = test_pool.AddObject(&data[i], &manager, false);
+        if (i % 2)
+            test_pool.AddRef(handles[i]);
+    }
+    test_pool.RunGarbageCollectionIfAppropriate();
+    assert(manager.Disposed == 50);
+    test_pool.RunGarbageCollectionIfAppropriate();
+    assert(manager.Disposed == 50);
+    for (int tick = 0; tick < 9; ++tick)
+    {
+        test_pool.StartGarbageCollectionTick();
+        test_pool.RunGarbageCollectionIfAppropriate();
+    }
+    assert(manager.Disposed == num_objects / 2);
+    for (int i = 0; i < num_objects; ++i)
+    {
+        assert(test_pool.AddressToHandle(&data[i]) == ((i % 2) ? handles[i] : 0));
+    }
+    const ManagedObjectPoolStats &stats = test_pool.GetGarbageCollectionStats();
+    assert(stats.objectsFreed == num_objects / 2);
+    assert(stats.poolSize == num_objects / 2);
+    assert(stats.pendingCandidates == 0);
+
+    // Object which lost its last reference becomes a candidate again
+    test_pool.SubRef(handles[1]);
+    assert(manager.Disposed == num_objects / 2 + 1);
+    assert(test_pool.AddressToHandle(&data[1]) == 0);
+    test_pool.disableDisposeForObject = &data[3];
+    test_pool.SubRef(handles[3]);
+    test_pool.disableDisposeForObject = NULL;
+    assert(test_pool.AddressToHandle(&data[3]) == handles[3]);
+    test_pool.StartGarbageCollectionTick();
+    test_pool.RunGarbageCollectionIfAppropriate();
+    assert(test_pool.AddressToHandle(&data[3]) == handles[3]);
+    // ...and is collected with the others once the collection is due
+    const int num_kept = GARBAGE_COLLECTION_INTERVAL + 1;
+    char kept[num_kept];
+    for (int i = 0; i < num_kept; ++i)
+    {
+        test_pool.AddRef(test_pool.AddObject(&kept[i], &manager, false));
+    }
+    for (int tick = 0; tick < 2; ++tick)
+    {
+        test_pool.StartGarbageCollectionTick();
+        test_pool.RunGarbageCollectionIfAppropriate();
+    }
+    assert(test_pool.AddressToHandle(&data[3]) == 0);
+    assert(manager.Disposed == num_objects / 2 + 2);
+
+    // Candidates above the pending limit are collected regardless of budget
+    const int num_many = GARBAGE_COLLECTION_MAX_PENDING + 500;
+    char *many = new char[num_many];
+    test_pool.SetGarbageCollectionBudget(1);
+    manager.Disposed = 0;
+    for (int i = 0; i < num_many; ++i)
+    {
+        test_pool.AddObject(&many[i], &manager, false);
+    }
+    test_pool.RunGarbageCollectionIfAppropriate();
+    assert(manager.Disposed == 500);
+    assert(test_pool.GetGarbageCollectionStats().pendingCandidates == GARBAGE_COLLECTION_MAX_PENDING);
+
+    // Zero budget falls back to the full sweeps
+    test_pool.SetGarbageCollectionBudget(0);
+    test_pool.RunGarbageCollection();
+    assert(manager.Disposed == num_many);
+    assert(test_pool.GetGarbageCollectionStats().pendingCandidates == 0);
+    assert(test_pool.GetGarbageCollectionStats().poolSize == num_objects / 2 - 2 + num_kept);
+    delete [] many;
+}
+
+// Measures the time of handle lookups in the pool with given number
+// of live objects; lookup time should not depend on the pool size
+void Test_ManagedObjectPoolLookups(int num_objects)
+{
+    ManagedObjectPool test_pool;
+    char *data = new char[num_objects];
+    int32_t *handles = new int32_t[num_objects];
+    for (int i = 0; i < num_objects; ++i)
+    {
+        handles[i] = test_pool.AddObject(&data[i], NULL, false);
+    }
+
+    const int num_lookups = 1000000;
+    clock_t start = clock();
+    for (int i = 0, at = 0; i < num_lookups; ++i, at = (at + 7919) % num_objects)
+    {
+        assert(test_pool.AddressToHandle(&data[at]) == handles[at]);
+    }
+    clock_t elapsed = clock() - start;
+    Out::FPrint("ManagedObjectPool: %d lookups with %d live objects took %d ms",
+        num_lookups, num_objects, (int)(elapsed * 1000 / CLOCKS_PER_SEC));
+
+    delete [] handles;
+    delete [] data;
+}
+
+void Test_ManagedObjectPool()
+{
+    ManagedObjectPool test_pool;
+    char data[16];
+
+    // Add and find objects
+    int32_t h1 = test_pool.AddObject(&data[1], NULL, false);
+    int32_t h2 = test_pool.AddObject(&data[2], NULL, false);
+    int32_t h3 = test_pool.AddObject(&data[3], NULL, true);
+    assert(h1 > 0 && h2 > 0 && h3 > 0);
+    assert(h1 != h2 && h2 != h3 && h1 != h3);
+    assert(test_pool.AddressToHandle(&data[1]) == h1);
+    assert(test_pool.AddressToHandle(&data[2]) == h2);
+    assert(test_pool.AddressToHandle(&data[3]) == h3);
+    assert(test_pool.AddressToHandle(&data[4]) == 0);
+    assert(test_pool.AddressToHandle(NULL) == 0);
+    assert(test_pool.HandleToAddress(h2) == &data[2]);
+
+    // Remove objects; their slots should be reused by the new ones
+    assert(test_pool.RemoveObject(&data[2]) == 1);
+    assert(test_pool.RemoveObject(&data[2]) == 0);
+    assert(test_pool.AddressToHandle(&data[2]) == 0);
+    assert(test_pool.HandleToAddress(h2) == NULL);
+    assert(test_pool.AddressToHandle(&data[1]) == h1);
+    assert(test_pool.AddressToHandle(&data[3]) == h3);
+    int32_t h4 = test_pool.AddObject(&data[4], NULL, false);
+    assert(h4 == h2);
+    assert(test_pool.AddressToHandle(&data[4]) == h4);
+
+    // Many objects, which force the index to grow, then removal of every
+    // second one, which shifts the entries of the probe sequences
+    const int num_many = 5000;
+    char *many = new char[num_many];
+    int32_t *many_handles = new int32_t[num_many];
+    for (int i = 0; i < num_many; ++i)
+    {
+        many_handles[i] = test_pool.AddObject(&many[i], NULL, false);
+    }
+    for (int i = 0; i < num_many; i += 2)
+    {
+        assert(test_pool.RemoveObject(&many[i]) == 1);
+    }
+    for (int i = 0; i < num_many; ++i)
+    {
+        assert(test_pool.AddressToHandle(&many[i]) == ((i % 2) ? many_handles[i] : 0));
+    }
+    // Freed slots are reused before the array is expanded
+    for (int i = 0; i < num_many; i += 2)
+    {
+        many_handles[i] = test_pool.AddObject(&many[i], NULL, false);
+        assert(many_handles[i] <= num_many + 4);
+    }
+    for (int i = 0; i < num_many; ++i)
+    {
+        assert(test_pool.AddressToHandle(&many[i]) == many_handles[i]);
+    }
+
+    test_pool.reset();
+    assert(test_pool.AddressToHandle(&data[1]) == 0);
+    assert(test_pool.AddressToHandle(&many[1]) == 0);
+    delete [] many_handles;
+    delete [] many;
+
+    Test_ManagedObjectPoolIncrementalGC();
+}
+
+void Test_ManagedObjectPoolBenchmark()
+{
+    Test_ManagedObjectPoolLookups(10000);
+    Test_ManagedObjectPoolLookups(100000);
+}
+
+#endif // _DEBUG
@@ -0,0 +1,96 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+
+#ifdef _DEBUG
+
+#include <errno.h>
+#include <stdlib.h>
+#include <time.h>
+#include "ac/route_finder.h"
+#include "debug/out.h"
+#include "gfx/bitmap.h"
+#include "util/geometry.h"
+
+using AGS::Common::Bitmap;
+namespace BitmapHelper = AGS::Common::BitmapHelper;
+namespace Out = AGS::Common::Out;
+
+extern int find_route_astar(int fromx, int fromy, int destx, int desty);
+
+const int TEST_ROUTE_COUNT = 60;
+
+// Makes the walkable area crossed by walls, each with a gap at the opposite
+// end from the one before, so that the routes have to wind between them
+Bitmap *Test_MakeCorridorMask(int width, int height, int wall_step)
+{
+    Bitmap *mask = BitmapHelper::CreateBitmap(width, height, 8);
+    mask->Clear(1);
+    const int wall_width = 4;
+    const int gap = height / 8;
+    for (int x = wall_step, n = 0; x + wall_width < width; x += wall_step, ++n) {
+        if (n % 2 == 0)
+            mask->FillRect(Rect(x, 0, x + wall_width - 1, height - gap - 1), 0);
+        else
+            mask->FillRect(Rect(x, gap, x + wall_width - 1, height - 1), 0);
+    }
+    return mask;
+}
+
+void Test_RandomWalkablePoint(Bitmap *mask, int &x, int &y)
+{
+    do {
+        x = rand() % mask->GetWidth();
+        y = rand() % mask->GetHeight();
+    } while (mask->GetPixel(x, y) == 0);
+}
+
+// Finds the routes between the random walkable points of the mask
+void Test_RouteFinderBenchmark(const char *name, Bitmap *mask)
+{
+    build_route_navigation(mask);
+    wallscreen = mask;
+    srand(1);
+    int found = 0;
+    clock_t elapsed = 0;
+    for (int i = 0; i < TEST_ROUTE_COUNT; ++i) {
+        int fromx, fromy, tox, toy;
+        Test_RandomWalkablePoint(mask, fromx, fromy);
+        Test_RandomWalkablePoint(mask, tox, toy);
+        clock_t start = clock();
+        found += find_route_astar(fromx, fromy, tox, toy);
+        elapsed += clock() - start;
+    }
+    Out::FPrint("RouteFinder: %d routes on %s %dx%d took %d ms, %d found",
+        TEST_ROUTE_COUNT, name, mask->GetWidth(), mask->GetHeight(),
+        (int)(elapsed * 1000 / CLOCKS_PER_SEC), found);
+    delete mask;
+}
+
+void Test_RouteFinderBenchmark()
+{
+    // the walkable areas are allegro bitmaps
+    if (install_allegro(SYSTEM_NONE, &errno, atexit) != 0)
+    {
+        Out::FPrint("RouteFinder benchmark: could not install allegro, skipped");
+        return;
+    }
+    init_pathfinder();
+    Test_RouteFinderBenchmark("open", Test_MakeCorridorMask(1280, 720, 1280));
+    Test_RouteFinderBenchmark("corridors", Test_MakeCorridorMask(1280, 720, 80));
+    Test_RouteFinderBenchmark("corridors", Test_MakeCorridorMask(320, 200, 40));
+    shutdown_pathfinder();
+    allegro_exit();
+}
+
+#endif // _DEBUG
@@ -0,0 +1,73 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+
+#ifndef __AGS_EE_UTIL__SEMAPHORE_PTHREAD_H
+#define __AGS_EE_UTIL__SEMAPHORE_PTHREAD_H
+
+#include <pthread.h>
+
+namespace AGS
+{
+namespace Engine
+{
+
+
+// Unnamed POSIX semaphores are not available on Mac OS X, so the count is
+// kept under a mutex and waited on with a condition variable
+class PThreadSemaphore : public BaseSemaphore
+{
+public:
+  inline PThreadSemaphore()
+  {
+    _count = 0;
+    pthread_mutex_init(&_mutex, NULL);
+    pthread_cond_init(&_cond, NULL);
+  }
+
+  inline ~PThreadSemaphore()
+  {
+    pthread_cond_destroy(&_cond);
+    pthread_mutex_destroy(&_mutex);
+  }
+
+  inline void Wait()
+  {
+    pthread_mutex_lock(&_mutex);
+    while (_count == 0)
+      pthread_cond_wait(&_cond, &_mutex);
+    _count--;
+    pthread_mutex_unlock(&_mutex);
+  }
+
+  inline void Post()
+  {
+    pthread_mutex_lock(&_mutex);
+    _count++;
+    pthread_cond_signal(&_cond);
+    pthread_mutex_unlock(&_mutex);
+  }
+
+private:
+  pthread_mutex_t _mutex;
+  pthread_cond_t  _cond;
+  unsigned int    _count;
+};
+
+typedef PThreadSemaphore Semaphore;
+
+
+} // namespace Engine
+} // namespace AGS
+
+#endif // __AGS_EE_UTIL__SEMAPHORE_PTHREAD_H
@@ -0,0 +1,60 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+
+#ifndef __AGS_EE_UTIL__WII_SEMAPHORE_H
+#define __AGS_EE_UTIL__WII_SEMAPHORE_H
+
+#include <gccore.h>
+
+namespace AGS
+{
+namespace Engine
+{
+
+
+class WiiSemaphore : public BaseSemaphore
+{
+public:
+  inline WiiSemaphore()
+  {
+    LWP_SemInit(&_semaphore, 0, 0x7FFFFFFF);
+  }
+
+  inline ~WiiSemaphore()
+  {
+    LWP_SemDestroy(_semaphore);
+  }
+
+  inline void Wait()
+  {
+    LWP_SemWait(_semaphore);
+  }
+
+  inline void Post()
+  {
+    LWP_SemPost(_semaphore);
+  }
+
+private:
+  sem_t _semaphore;
+};
+
+
+typedef WiiSemaphore Semaphore;
+
+
+} // namespace Engine
+} // namespace AGS
+
+#endif // __AGS_EE_UTIL__WII_SEMAPHORE_H